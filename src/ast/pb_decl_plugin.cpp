@@ -0,0 +1,132 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    pb_decl_plugin.cpp
+
+Abstract:
+
+    Cardinality and pseudo-Boolean constraints over Boolean arguments.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#include"pb_decl_plugin.h"
+
+pb_decl_plugin::pb_decl_plugin():
+    m_at_most_sym("at-most"),
+    m_at_least_sym("at-least"),
+    m_pble_sym("pble"),
+    m_pbge_sym("pbge") {
+}
+
+func_decl * pb_decl_plugin::mk_card(decl_kind k, unsigned num_parameters, parameter const * parameters, unsigned arity) {
+    if (num_parameters != 1 || !parameters[0].is_int() || parameters[0].get_int() < 0) {
+        m_manager->raise_exception("invalid cardinality constraint, expected one non-negative integer parameter");
+        return 0;
+    }
+    symbol const & sym = k == OP_AT_MOST_K ? m_at_most_sym : m_at_least_sym;
+    ptr_buffer<sort> domain;
+    for (unsigned i = 0; i < arity; i++)
+        domain.push_back(m_manager->mk_bool_sort());
+    func_decl_info info(m_family_id, k, num_parameters, parameters);
+    return m_manager->mk_func_decl(sym, arity, domain.c_ptr(), m_manager->mk_bool_sort(), info);
+}
+
+func_decl * pb_decl_plugin::mk_pb(decl_kind k, unsigned num_parameters, parameter const * parameters, unsigned arity) {
+    if (num_parameters != arity + 1) {
+        m_manager->raise_exception("invalid pseudo-Boolean constraint, expected one coefficient per argument");
+        return 0;
+    }
+    for (unsigned i = 0; i < num_parameters; i++) {
+        if (!parameters[i].is_int() || parameters[i].get_int() < 0) {
+            m_manager->raise_exception("invalid pseudo-Boolean constraint, coefficients and bound must be non-negative integers");
+            return 0;
+        }
+    }
+    symbol const & sym = k == OP_PB_LE ? m_pble_sym : m_pbge_sym;
+    ptr_buffer<sort> domain;
+    for (unsigned i = 0; i < arity; i++)
+        domain.push_back(m_manager->mk_bool_sort());
+    func_decl_info info(m_family_id, k, num_parameters, parameters);
+    return m_manager->mk_func_decl(sym, arity, domain.c_ptr(), m_manager->mk_bool_sort(), info);
+}
+
+func_decl * pb_decl_plugin::mk_func_decl(decl_kind k, unsigned num_parameters, parameter const * parameters,
+                                         unsigned arity, sort * const * domain, sort * range) {
+    for (unsigned i = 0; i < arity; i++) {
+        if (!m_manager->is_bool(domain[i])) {
+            m_manager->raise_exception("invalid pseudo-Boolean constraint, arguments must be Boolean");
+            return 0;
+        }
+    }
+    switch (k) {
+    case OP_AT_MOST_K:
+    case OP_AT_LEAST_K:
+        return mk_card(k, num_parameters, parameters, arity);
+    case OP_PB_LE:
+    case OP_PB_GE:
+        return mk_pb(k, num_parameters, parameters, arity);
+    default:
+        UNREACHABLE();
+        return 0;
+    }
+}
+
+void pb_decl_plugin::get_op_names(svector<builtin_name> & op_names, symbol const & logic) {
+    if (logic == symbol::null) {
+        op_names.push_back(builtin_name(m_at_most_sym.bare_str(), OP_AT_MOST_K));
+        op_names.push_back(builtin_name(m_at_least_sym.bare_str(), OP_AT_LEAST_K));
+        op_names.push_back(builtin_name(m_pble_sym.bare_str(), OP_PB_LE));
+        op_names.push_back(builtin_name(m_pbge_sym.bare_str(), OP_PB_GE));
+    }
+}
+
+pb_util::pb_util(ast_manager & _m):
+    m(_m),
+    m_fid(_m.mk_family_id("pb")) {
+}
+
+app * pb_util::mk_at_most_k(unsigned num_args, expr * const * args, unsigned k) {
+    parameter param(k);
+    return m.mk_app(m_fid, OP_AT_MOST_K, 1, &param, num_args, args, m.mk_bool_sort());
+}
+
+app * pb_util::mk_at_least_k(unsigned num_args, expr * const * args, unsigned k) {
+    parameter param(k);
+    return m.mk_app(m_fid, OP_AT_LEAST_K, 1, &param, num_args, args, m.mk_bool_sort());
+}
+
+app * pb_util::mk_le(unsigned num_args, unsigned const * coeffs, expr * const * args, unsigned k) {
+    vector<parameter> params;
+    params.push_back(parameter(k));
+    for (unsigned i = 0; i < num_args; i++)
+        params.push_back(parameter(coeffs[i]));
+    return m.mk_app(m_fid, OP_PB_LE, params.size(), params.c_ptr(), num_args, args, m.mk_bool_sort());
+}
+
+app * pb_util::mk_ge(unsigned num_args, unsigned const * coeffs, expr * const * args, unsigned k) {
+    vector<parameter> params;
+    params.push_back(parameter(k));
+    for (unsigned i = 0; i < num_args; i++)
+        params.push_back(parameter(coeffs[i]));
+    return m.mk_app(m_fid, OP_PB_GE, params.size(), params.c_ptr(), num_args, args, m.mk_bool_sort());
+}
+
+unsigned pb_util::get_k(func_decl const * f) const {
+    SASSERT(f->get_family_id() == m_fid);
+    return static_cast<unsigned>(f->get_parameter(0).get_int());
+}
+
+unsigned pb_util::get_coeff(func_decl const * f, unsigned i) const {
+    SASSERT(f->get_family_id() == m_fid);
+    if (f->get_decl_kind() == OP_AT_MOST_K || f->get_decl_kind() == OP_AT_LEAST_K)
+        return 1;
+    SASSERT(i + 1 < f->get_num_parameters());
+    return static_cast<unsigned>(f->get_parameter(i + 1).get_int());
+}
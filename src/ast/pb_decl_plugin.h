@@ -0,0 +1,108 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    pb_decl_plugin.h
+
+Abstract:
+
+    Cardinality and pseudo-Boolean constraints over Boolean arguments.
+
+    (at-most-k  k p_1 ... p_n)          p_1 + ... + p_n <= k
+    (at-least-k k p_1 ... p_n)          p_1 + ... + p_n >= k
+    (pble k c_1 ... c_n p_1 ... p_n)    c_1*p_1 + ... + c_n*p_n <= k
+    (pbge k c_1 ... c_n p_1 ... p_n)    c_1*p_1 + ... + c_n*p_n >= k
+
+    The bound k and the coefficients c_i are parameters of the declaration.
+    They are non-negative integers.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#ifndef _PB_DECL_PLUGIN_H_
+#define _PB_DECL_PLUGIN_H_
+
+#include"ast.h"
+
+enum pb_op_kind {
+    OP_AT_MOST_K,  // at most K Booleans are true.
+    OP_AT_LEAST_K, // at least K Booleans are true.
+    OP_PB_LE,      // pseudo-Boolean <=
+    OP_PB_GE,      // pseudo-Boolean >=
+    LAST_PB_OP
+};
+
+
+class pb_decl_plugin : public decl_plugin {
+    symbol m_at_most_sym;
+    symbol m_at_least_sym;
+    symbol m_pble_sym;
+    symbol m_pbge_sym;
+    func_decl * mk_card(decl_kind k, unsigned num_parameters, parameter const * parameters, unsigned arity);
+    func_decl * mk_pb(decl_kind k, unsigned num_parameters, parameter const * parameters, unsigned arity);
+public:
+    pb_decl_plugin();
+    virtual ~pb_decl_plugin() {}
+
+    virtual sort * mk_sort(decl_kind k, unsigned num_parameters, parameter const * parameters) {
+        UNREACHABLE();
+        return 0;
+    }
+
+    virtual decl_plugin * mk_fresh() {
+        return alloc(pb_decl_plugin);
+    }
+
+    //
+    // Contract for func_decl:
+    //   parameters[0]     - integer (at most k elements)
+    //   parameters[1..n]  - integer coefficients of the pseudo-Boolean constraints (OP_PB_LE, OP_PB_GE only)
+    //
+    virtual func_decl * mk_func_decl(decl_kind k, unsigned num_parameters, parameter const * parameters,
+                                     unsigned arity, sort * const * domain, sort * range);
+
+    virtual void get_op_names(svector<builtin_name> & op_names, symbol const & logic);
+};
+
+
+class pb_util {
+    ast_manager & m;
+    family_id     m_fid;
+public:
+    pb_util(ast_manager & _m);
+
+    ast_manager & get_manager() const { return m; }
+    family_id get_family_id() const { return m_fid; }
+
+    app * mk_at_most_k(unsigned num_args, expr * const * args, unsigned k);
+    app * mk_at_least_k(unsigned num_args, expr * const * args, unsigned k);
+    app * mk_le(unsigned num_args, unsigned const * coeffs, expr * const * args, unsigned k);
+    app * mk_ge(unsigned num_args, unsigned const * coeffs, expr * const * args, unsigned k);
+
+    bool is_pb(expr const * n) const { return is_app(n) && to_app(n)->get_family_id() == m_fid; }
+    bool is_at_most_k(expr const * n) const { return is_app_of(n, m_fid, OP_AT_MOST_K); }
+    bool is_at_least_k(expr const * n) const { return is_app_of(n, m_fid, OP_AT_LEAST_K); }
+    bool is_le(expr const * n) const { return is_app_of(n, m_fid, OP_PB_LE); }
+    bool is_ge(expr const * n) const { return is_app_of(n, m_fid, OP_PB_GE); }
+
+    /**
+       \brief Return the bound of a cardinality or pseudo-Boolean constraint.
+    */
+    unsigned get_k(func_decl const * f) const;
+    unsigned get_k(expr const * n) const { SASSERT(is_pb(n)); return get_k(to_app(n)->get_decl()); }
+
+    /**
+       \brief Return the coefficient of the i-th argument.
+       It is 1 for cardinality constraints.
+    */
+    unsigned get_coeff(func_decl const * f, unsigned i) const;
+    unsigned get_coeff(expr const * n, unsigned i) const { SASSERT(is_pb(n)); return get_coeff(to_app(n)->get_decl(), i); }
+};
+
+
+#endif /* _PB_DECL_PLUGIN_H_ */
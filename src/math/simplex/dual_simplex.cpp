@@ -0,0 +1,391 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    dual_simplex.cpp
+
+Abstract:
+
+    Floating point revised dual simplex with bound flipping.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include<math.h>
+#include<algorithm>
+#include"dual_simplex.h"
+#include"debug.h"
+
+struct dual_simplex::candidate_lt {
+    bool operator()(candidate const & c1, candidate const & c2) const {
+        if (c1.m_ratio != c2.m_ratio)
+            return c1.m_ratio < c2.m_ratio;
+        return fabs(c1.m_alpha) > fabs(c2.m_alpha);
+    }
+};
+
+dual_simplex::dual_simplex():
+    m_infeasible(UINT_MAX),
+    m_max_iterations(UINT_MAX),
+    m_refactor_period(64),
+    m_singular(false),
+    m_feas_tol(1e-9),
+    m_pivot_tol(1e-7) {
+}
+
+void dual_simplex::reset(unsigned num_vars) {
+    m_rows.reset();
+    m_cols.reset();
+    m_cols.resize(num_vars);
+    m_vars.reset();
+    m_vars.resize(num_vars);
+    m_value.reset();
+    m_value.resize(num_vars, 0.0);
+    m_cost.reset();
+    m_cost.resize(num_vars, 0.0);
+    m_d.reset();
+    m_d.resize(num_vars, 0.0);
+    m_basis.reset();
+    m_row.reset();
+    m_row.resize(num_vars, 0.0);
+    m_in_row.reset();
+    m_in_row.resize(num_vars, false);
+    m_row_vars.reset();
+    m_infeasible = UINT_MAX;
+}
+
+void dual_simplex::set_lower(unsigned v, double lo) {
+    m_vars[v].m_has_lo = true;
+    m_vars[v].m_lo     = lo;
+}
+
+void dual_simplex::set_upper(unsigned v, double hi) {
+    m_vars[v].m_has_hi = true;
+    m_vars[v].m_hi     = hi;
+}
+
+void dual_simplex::add_row(unsigned base_var, unsigned sz, unsigned const * vars, double const * coeffs) {
+    SASSERT(!is_basic(base_var));
+    unsigned r = m_rows.size();
+    m_rows.push_back(entries());
+    entries & row = m_rows.back();
+    for (unsigned i = 0; i < sz; i++) {
+        row.push_back(entry(vars[i], coeffs[i]));
+        m_cols[vars[i]].push_back(entry(r, coeffs[i]));
+    }
+    m_vars[base_var].m_pos = m_basis.size();
+    m_basis.push_back(base_var);
+}
+
+/**
+   \brief Return the amount by which v violates its bounds.
+*/
+double dual_simplex::violation(unsigned v) const {
+    var_info const & vi = m_vars[v];
+    double x = m_value[v];
+    if (vi.m_has_lo && x < vi.m_lo - m_feas_tol * (1.0 + fabs(vi.m_lo)))
+        return vi.m_lo - x;
+    if (vi.m_has_hi && x > vi.m_hi + m_feas_tol * (1.0 + fabs(vi.m_hi)))
+        return x - vi.m_hi;
+    return 0.0;
+}
+
+/**
+   \brief Return the position of the basic variable with the largest violation,
+   or UINT_MAX if all basic variables are feasible.
+*/
+unsigned dual_simplex::select_leaving() const {
+    unsigned best = UINT_MAX;
+    double best_violation = 0.0;
+    for (unsigned r = 0; r < m_basis.size(); r++) {
+        double vio = violation(m_basis[r]);
+        if (vio > best_violation) {
+            best = r;
+            best_violation = vio;
+        }
+    }
+    return best;
+}
+
+/**
+   \brief Move the non-basic variables to one of their bounds, and assign
+   the costs that make the initial basis dual feasible.
+*/
+void dual_simplex::init_nonbasic() {
+    for (unsigned v = 0; v < m_vars.size(); v++) {
+        var_info const & vi = m_vars[v];
+        m_cost[v] = 0.0;
+        if (is_basic(v))
+            continue;
+        double & x = m_value[v];
+        if (vi.m_has_lo && vi.m_has_hi)
+            x = x - vi.m_lo <= vi.m_hi - x ? vi.m_lo : vi.m_hi;
+        else if (vi.m_has_lo)
+            x = vi.m_lo;
+        else if (vi.m_has_hi)
+            x = vi.m_hi;
+        double c = 1.0 + static_cast<double>(m_rand(1024)) / 1024.0;
+        if (at_lower(v))
+            m_cost[v] = c;
+        else if (at_upper(v))
+            m_cost[v] = -c;
+    }
+}
+
+bool dual_simplex::refactor() {
+    m_stats.m_num_factorizations++;
+    vector<entries> cols;
+    for (unsigned r = 0; r < m_basis.size(); r++)
+        cols.push_back(m_cols[m_basis[r]]);
+    m_singular = !m_lu.factor(m_basis.size(), cols);
+    return !m_singular;
+}
+
+/**
+   \brief x_B = -B^{-1} N x_N
+*/
+void dual_simplex::compute_basic_values() {
+    unsigned m = m_rows.size();
+    m_dense.reset();
+    m_dense.resize(m, 0.0);
+    for (unsigned i = 0; i < m; i++) {
+        entries const & row = m_rows[i];
+        double s = 0.0;
+        for (unsigned k = 0; k < row.size(); k++) {
+            if (!is_basic(row[k].m_idx))
+                s -= row[k].m_val * m_value[row[k].m_idx];
+        }
+        m_dense[i] = s;
+    }
+    m_lu.ftran(m_dense);
+    for (unsigned r = 0; r < m; r++)
+        m_value[m_basis[r]] = m_dense[r];
+}
+
+/**
+   \brief d_N = c_N - A_N^T y, where y = B^{-T} c_B
+*/
+void dual_simplex::compute_reduced_costs() {
+    unsigned m = m_rows.size();
+    m_dense.reset();
+    for (unsigned r = 0; r < m; r++)
+        m_dense.push_back(m_cost[m_basis[r]]);
+    m_lu.btran(m_dense);
+    for (unsigned v = 0; v < m_vars.size(); v++)
+        m_d[v] = is_basic(v) ? 0.0 : m_cost[v];
+    for (unsigned i = 0; i < m; i++) {
+        double y = m_dense[i];
+        if (y == 0.0)
+            continue;
+        entries const & row = m_rows[i];
+        for (unsigned k = 0; k < row.size(); k++) {
+            if (!is_basic(row[k].m_idx))
+                m_d[row[k].m_idx] -= y * row[k].m_val;
+        }
+    }
+}
+
+/**
+   \brief Store in m_row the coefficients of the non-basic variables in row r of B^{-1} A.
+*/
+void dual_simplex::compute_pivot_row(unsigned r) {
+    for (unsigned k = 0; k < m_row_vars.size(); k++)
+        m_in_row[m_row_vars[k]] = false;
+    m_row_vars.reset();
+    unsigned m = m_rows.size();
+    m_dense.reset();
+    m_dense.resize(m, 0.0);
+    m_dense[r] = 1.0;
+    m_lu.btran(m_dense);
+    for (unsigned i = 0; i < m; i++) {
+        double rho = m_dense[i];
+        if (rho == 0.0)
+            continue;
+        entries const & row = m_rows[i];
+        for (unsigned k = 0; k < row.size(); k++) {
+            unsigned v = row[k].m_idx;
+            if (is_basic(v))
+                continue;
+            if (!m_in_row[v]) {
+                m_in_row[v] = true;
+                m_row[v]    = 0.0;
+                m_row_vars.push_back(v);
+            }
+            m_row[v] += rho * row[k].m_val;
+        }
+    }
+}
+
+void dual_simplex::load_column(unsigned v, double coeff, svector<double> & col) const {
+    entries const & c = m_cols[v];
+    for (unsigned k = 0; k < c.size(); k++)
+        col[c[k].m_idx] += coeff * c[k].m_val;
+}
+
+/**
+   \brief Given col = B^{-1} (sum_j A_j * delta_j), where delta_j is the change of the
+   non-basic variable x_j, update the values of the basic variables.
+*/
+void dual_simplex::update_basic_values(svector<double> const & col, double step) {
+    for (unsigned r = 0; r < m_basis.size(); r++)
+        m_value[m_basis[r]] -= step * col[r];
+}
+
+/**
+   \brief Remove the basic variable at position r from the basis. Return false if
+   the row of this variable is infeasible.
+
+   The leaving variable x_i moves to its violated bound. Moving x_i by 
+   delta = sign * |delta| changes the reduced cost of a non-basic variable x_j 
+   by sign * t * alpha_j, where t is the dual step length.
+*/
+bool dual_simplex::iterate(unsigned r) {
+    unsigned x_i = m_basis[r];
+    var_info const & vi = m_vars[x_i];
+    bool below    = vi.m_has_lo && m_value[x_i] < vi.m_lo;
+    double sign   = below ? 1.0 : -1.0;
+    double target = below ? vi.m_lo : vi.m_hi;
+
+    compute_pivot_row(r);
+    double max_alpha = 0.0;
+    for (unsigned k = 0; k < m_row_vars.size(); k++)
+        max_alpha = std::max(max_alpha, fabs(m_row[m_row_vars[k]]));
+
+    // x_i changes by -alpha_j * d when the non-basic variable x_j changes by d.
+    // The candidates are the variables that can move x_i towards its violated bound.
+    m_candidates.reset();
+    for (unsigned k = 0; k < m_row_vars.size(); k++) {
+        unsigned v = m_row_vars[k];
+        double a   = m_row[v];
+        if (fabs(a) <= m_pivot_tol * max_alpha)
+            continue;
+        var_info const & vj = m_vars[v];
+        double ratio;
+        if (!vj.m_has_lo && !vj.m_has_hi)
+            ratio = 0.0;
+        else if (sign * a < 0 && at_lower(v) && !(vj.m_has_hi && vj.m_hi <= vj.m_lo))
+            ratio = std::max(m_d[v], 0.0) / fabs(a);
+        else if (sign * a > 0 && at_upper(v) && !(vj.m_has_lo && vj.m_lo >= vj.m_hi))
+            ratio = std::max(-m_d[v], 0.0) / fabs(a);
+        else
+            continue;
+        m_candidates.push_back(candidate(v, a, ratio));
+    }
+    std::sort(m_candidates.begin(), m_candidates.end(), candidate_lt());
+
+    // bound flipping ratio test
+    double slope     = fabs(target - m_value[x_i]);
+    unsigned x_j     = UINT_MAX;
+    unsigned num_flips = 0;
+    for (; num_flips < m_candidates.size(); num_flips++) {
+        unsigned v = m_candidates[num_flips].m_var;
+        var_info const & vj = m_vars[v];
+        if (!vj.m_has_lo || !vj.m_has_hi) {
+            x_j = v;
+            break;
+        }
+        double cap = fabs(m_candidates[num_flips].m_alpha) * (vj.m_hi - vj.m_lo);
+        if (cap >= slope) {
+            x_j = v;
+            break;
+        }
+        slope -= cap;
+    }
+    if (x_j == UINT_MAX) {
+        m_infeasible = x_i;
+        return false;
+    }
+
+    unsigned m = m_rows.size();
+    m_column.reset();
+    m_column.resize(m, 0.0);
+    load_column(x_j, 1.0, m_column);
+    m_lu.ftran(m_column, true);
+    double d_r   = m_column[r];
+    double alpha = m_row[x_j];
+    if (fabs(d_r - alpha) > 1e-6 * (1.0 + fabs(alpha)) || fabs(d_r) <= m_pivot_tol * max_alpha) {
+        // the factorization is not accurate enough.
+        if (refactor()) {
+            compute_basic_values();
+            compute_reduced_costs();
+        }
+        return true;
+    }
+
+    // flip the variables whose breakpoints were passed
+    if (num_flips > 0) {
+        m_dense.reset();
+        m_dense.resize(m, 0.0);
+        for (unsigned k = 0; k < num_flips; k++) {
+            unsigned v = m_candidates[k].m_var;
+            var_info const & vj = m_vars[v];
+            double step = at_lower(v) ? vj.m_hi - vj.m_lo : vj.m_lo - vj.m_hi;
+            m_value[v]  = at_lower(v) ? vj.m_hi : vj.m_lo;
+            load_column(v, step, m_dense);
+        }
+        m_lu.ftran(m_dense);
+        update_basic_values(m_dense, 1.0);
+        m_stats.m_num_flips += num_flips;
+    }
+
+    // dual update
+    double t = m_candidates[num_flips].m_ratio;
+    for (unsigned k = 0; k < m_row_vars.size(); k++) {
+        unsigned v = m_row_vars[k];
+        m_d[v] += sign * t * m_row[v];
+    }
+    m_d[x_j] = 0.0;
+    m_d[x_i] = sign * t;
+
+    // primal update
+    double theta = (m_value[x_i] - target) / d_r;
+    m_value[x_j] += theta;
+    update_basic_values(m_column, theta);
+    m_value[x_i] = target;
+
+    m_basis[r]         = x_j;
+    m_vars[x_j].m_pos  = r;
+    m_vars[x_i].m_pos  = UINT_MAX;
+    m_stats.m_num_pivots++;
+    if (!m_lu.update(r) || m_lu.num_updates() >= m_refactor_period) {
+        if (refactor()) {
+            compute_basic_values();
+            compute_reduced_costs();
+        }
+    }
+    return true;
+}
+
+lbool dual_simplex::operator()() {
+    m_infeasible = UINT_MAX;
+    init_nonbasic();
+    if (!refactor())
+        return l_undef;
+    compute_basic_values();
+    compute_reduced_costs();
+    unsigned m        = m_rows.size();
+    unsigned max_iter = std::min(m_max_iterations, 50 * m + 1000);
+    for (unsigned it = 0; it < max_iter; it++) {
+        if (m_singular)
+            return l_undef;
+        unsigned r = select_leaving();
+        if (r == UINT_MAX)
+            return l_true;
+        m_stats.m_num_iterations++;
+        if (!iterate(r))
+            return l_false;
+    }
+    return l_undef;
+}
+
+void dual_simplex::collect_statistics(statistics & st) const {
+    st.update("dual simplex iterations", m_stats.m_num_iterations);
+    st.update("dual simplex pivots", m_stats.m_num_pivots);
+    st.update("dual simplex flips", m_stats.m_num_flips);
+    st.update("dual simplex factorizations", m_stats.m_num_factorizations);
+}
@@ -0,0 +1,166 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    dual_simplex.h
+
+Abstract:
+
+    Floating point revised dual simplex for finding a feasible basis
+    of a system of the form
+
+        A x = 0, lo <= x <= hi
+
+    where some of the bounds may be missing. Every row has an initial
+    basic variable. The basis matrix is kept as a sparse LU
+    factorization (see sparse_lu.h) updated using Forrest-Tomlin
+    updates.
+
+    The dual simplex minimizes a random cost vector for which the
+    initial basis is dual feasible: non-basic variables at their lower
+    (upper) bound get a positive (negative) cost, and the basic and
+    free variables get cost zero. Any objective is good enough to find
+    a feasible point, and the random costs prevent the dual degeneracy
+    of a zero objective.
+
+    In each iteration, the basic variable with the largest bound
+    violation leaves the basis. The pivot row is computed using
+    BTRAN, and the entering variable is selected using the bound
+    flipping ratio test: the breakpoints |d_j / alpha_j| of the
+    candidates are processed in increasing order, and boxed variables
+    are flipped to their opposite bound as long as the remaining
+    violation of the leaving variable (the slope of the dual objective)
+    is positive. When there is no candidate, the dual is unbounded,
+    that is, the row of the leaving variable is infeasible.
+
+    The result is only a hint: the assignment and the basis are computed
+    using floating point numbers. Clients are expected to repair the
+    solution using exact arithmetic.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#ifndef _DUAL_SIMPLEX_H_
+#define _DUAL_SIMPLEX_H_
+
+#include"sparse_lu.h"
+#include"lbool.h"
+#include"statistics.h"
+#include"util.h"
+
+class dual_simplex {
+    typedef sparse_lu::entry   entry;
+    typedef sparse_lu::entries entries;
+
+    struct var_info {
+        double   m_lo;
+        double   m_hi;
+        bool     m_has_lo;
+        bool     m_has_hi;
+        unsigned m_pos;      // position in the basis, UINT_MAX if the variable is not basic
+        var_info(): m_lo(0), m_hi(0), m_has_lo(false), m_has_hi(false), m_pos(UINT_MAX) {}
+    };
+
+    struct candidate {
+        unsigned m_var;
+        double   m_alpha;
+        double   m_ratio;
+        candidate(unsigned v, double a, double r): m_var(v), m_alpha(a), m_ratio(r) {}
+        candidate(): m_var(0), m_alpha(0), m_ratio(0) {}
+    };
+    struct candidate_lt;
+
+    struct stats {
+        unsigned m_num_iterations;
+        unsigned m_num_pivots;
+        unsigned m_num_flips;
+        unsigned m_num_factorizations;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    sparse_lu          m_lu;
+    vector<entries>    m_rows;          // rows of A. The index of an entry is a variable.
+    vector<entries>    m_cols;          // columns of A. The index of an entry is a row.
+    svector<var_info>  m_vars;
+    svector<double>    m_value;
+    svector<double>    m_cost;
+    svector<double>    m_d;             // reduced costs of the non-basic variables
+    unsigned_vector    m_basis;         // basic variable in each position
+    unsigned           m_infeasible;    // basic variable whose row is infeasible
+    unsigned           m_max_iterations;
+    unsigned           m_refactor_period;
+    bool               m_singular;      // the last factorization failed
+    double             m_feas_tol;
+    double             m_pivot_tol;
+    stats              m_stats;
+    random_gen         m_rand;
+
+    svector<double>    m_row;           // pivot row: dense over variables
+    unsigned_vector    m_row_vars;      // non-zero variables of m_row
+    svector<bool>      m_in_row;
+    svector<double>    m_dense;         // dense vector over the rows
+    svector<double>    m_column;        // column of the entering variable
+    svector<candidate> m_candidates;
+
+    double violation(unsigned v) const;
+    unsigned select_leaving() const;
+    void init_nonbasic();
+    bool refactor();
+    void compute_basic_values();
+    void compute_reduced_costs();
+    void compute_pivot_row(unsigned r);
+    void update_basic_values(svector<double> const & col, double step);
+    void load_column(unsigned v, double coeff, svector<double> & col) const;
+    bool iterate(unsigned r);
+
+public:
+    dual_simplex();
+
+    /**
+       \brief Reset the solver, and create num_vars variables without bounds.
+    */
+    void reset(unsigned num_vars);
+
+    unsigned num_vars() const { return m_vars.size(); }
+
+    void set_lower(unsigned v, double lo);
+    void set_upper(unsigned v, double hi);
+
+    /**
+       \brief Set the initial value of a variable. The values of the basic variables
+       are recomputed from the values of the non-basic ones.
+    */
+    void set_value(unsigned v, double val) { m_value[v] = val; }
+
+    /**
+       \brief Add the row sum coeffs[i] * vars[i] = 0, where base_var is the
+       initial basic variable of the row. base_var must occur in the row.
+    */
+    void add_row(unsigned base_var, unsigned sz, unsigned const * vars, double const * coeffs);
+
+    void set_max_iterations(unsigned n) { m_max_iterations = n; }
+
+    /**
+       \brief Search for a basis and an assignment satisfying the bounds.
+       Return l_true if one was found, l_false if the row of the variable
+       get_infeasible_var() implies a violated bound, and l_undef if the
+       iteration limit was reached or the basis became singular.
+    */
+    lbool operator()();
+
+    bool is_basic(unsigned v) const { return m_vars[v].m_pos != UINT_MAX; }
+    double get_value(unsigned v) const { return m_value[v]; }
+    bool at_lower(unsigned v) const { return m_vars[v].m_has_lo && m_value[v] == m_vars[v].m_lo; }
+    bool at_upper(unsigned v) const { return m_vars[v].m_has_hi && m_value[v] == m_vars[v].m_hi; }
+    unsigned get_infeasible_var() const { return m_infeasible; }
+
+    void collect_statistics(statistics & st) const;
+};
+
+#endif
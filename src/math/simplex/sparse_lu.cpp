@@ -0,0 +1,512 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sparse_lu.cpp
+
+Abstract:
+
+    Sparse LU factorization with Forrest-Tomlin updates.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include<math.h>
+#include"sparse_lu.h"
+#include"debug.h"
+
+sparse_lu::sparse_lu():
+    m_size(0),
+    m_pivot_tol(0.01),
+    m_zero_tol(1e-11),
+    m_num_dead(0),
+    m_has_spike(false),
+    m_num_updates(0) {
+}
+
+// -----------------------------------
+//
+// Markowitz factorization
+//
+// -----------------------------------
+
+void sparse_lu::row_link(unsigned i) {
+    unsigned c    = m_row_count[i];
+    unsigned head = m_row_head[c];
+    m_row_prev[i] = UINT_MAX;
+    m_row_next[i] = head;
+    if (head != UINT_MAX)
+        m_row_prev[head] = i;
+    m_row_head[c] = i;
+}
+
+void sparse_lu::row_unlink(unsigned i) {
+    unsigned prev = m_row_prev[i];
+    unsigned next = m_row_next[i];
+    if (prev == UINT_MAX)
+        m_row_head[m_row_count[i]] = next;
+    else
+        m_row_next[prev] = next;
+    if (next != UINT_MAX)
+        m_row_prev[next] = prev;
+}
+
+void sparse_lu::col_link(unsigned j) {
+    unsigned c    = m_col_count[j];
+    unsigned head = m_col_head[c];
+    m_col_prev[j] = UINT_MAX;
+    m_col_next[j] = head;
+    if (head != UINT_MAX)
+        m_col_prev[head] = j;
+    m_col_head[c] = j;
+}
+
+void sparse_lu::col_unlink(unsigned j) {
+    unsigned prev = m_col_prev[j];
+    unsigned next = m_col_next[j];
+    if (prev == UINT_MAX)
+        m_col_head[m_col_count[j]] = next;
+    else
+        m_col_next[prev] = next;
+    if (next != UINT_MAX)
+        m_col_prev[next] = prev;
+}
+
+double sparse_lu::get_active(unsigned i, unsigned j) const {
+    entries const & row = m_arows[i];
+    for (unsigned k = 0; k < row.size(); k++) {
+        if (row[k].m_idx == j)
+            return row[k].m_val;
+    }
+    return 0.0;
+}
+
+double sparse_lu::col_max(unsigned j) const {
+    double r = 0.0;
+    unsigned_vector const & col = m_acols[j];
+    for (unsigned k = 0; k < col.size(); k++) {
+        double v = fabs(get_active(col[k], j));
+        if (v > r)
+            r = v;
+    }
+    return r;
+}
+
+/**
+   \brief Select the next pivot (p, q) of the active submatrix.
+   Column singletons are used first. Otherwise, a few columns and rows
+   with the smallest number of entries are inspected, and the entry
+   with the smallest Markowitz cost (r_i - 1)(c_j - 1) that passes
+   the threshold test |a_ij| >= m_pivot_tol * max_k |a_kj| is selected.
+*/
+bool sparse_lu::select_pivot(unsigned & p, unsigned & q) {
+    if (m_col_head[0] != UINT_MAX)
+        return false; // empty column
+    unsigned j = m_col_head[1];
+    if (j != UINT_MAX) {
+        unsigned i = m_acols[j][0];
+        if (fabs(get_active(i, j)) <= m_zero_tol)
+            return false;
+        p = i;
+        q = j;
+        return true;
+    }
+    static const unsigned max_tries = 4;
+    unsigned tries   = 0;
+    double best_cost = -1;
+    for (unsigned c = 1; c <= m_size; c++) {
+        for (j = m_col_head[c]; j != UINT_MAX; j = m_col_next[j]) {
+            double max = col_max(j);
+            unsigned_vector const & col = m_acols[j];
+            for (unsigned k = 0; k < col.size(); k++) {
+                unsigned i = col[k];
+                double v   = fabs(get_active(i, j));
+                if (v <= m_zero_tol || v < m_pivot_tol * max)
+                    continue;
+                double cost = static_cast<double>(m_row_count[i] - 1) * static_cast<double>(c - 1);
+                if (best_cost < 0 || cost < best_cost) {
+                    best_cost = cost;
+                    p = i;
+                    q = j;
+                }
+            }
+            if (best_cost >= 0 && ++tries >= max_tries)
+                return true;
+        }
+        for (unsigned i = m_row_head[c]; i != UINT_MAX; i = m_row_next[i]) {
+            entries const & row = m_arows[i];
+            for (unsigned k = 0; k < row.size(); k++) {
+                j = row[k].m_idx;
+                double v = fabs(row[k].m_val);
+                if (v <= m_zero_tol || v < m_pivot_tol * col_max(j))
+                    continue;
+                double cost = static_cast<double>(c - 1) * static_cast<double>(m_col_count[j] - 1);
+                if (best_cost < 0 || cost < best_cost) {
+                    best_cost = cost;
+                    p = i;
+                    q = j;
+                }
+            }
+            if (best_cost >= 0 && ++tries >= max_tries)
+                return true;
+        }
+        // rows and columns with more entries cannot produce a smaller cost.
+        if (best_cost >= 0 && best_cost <= static_cast<double>(c - 1) * static_cast<double>(c - 1))
+            return true;
+    }
+    return best_cost >= 0;
+}
+
+/**
+   \brief Use the pivot (p, q) to eliminate q from the other rows of the
+   active submatrix. Row p becomes a row of U, and the multipliers are
+   stored as a column eta of L.
+*/
+void sparse_lu::eliminate(unsigned p, unsigned q) {
+    double piv = get_active(p, q);
+    row_unlink(p);
+    col_unlink(q);
+    m_row_done[p] = true;
+    m_col_done[q] = true;
+
+    entries & urow = m_urows[p];
+    urow.reset();
+    entries & prow = m_arows[p];
+    for (unsigned k = 0; k < prow.size(); k++) {
+        unsigned j = prow[k].m_idx;
+        if (j == q)
+            continue;
+        urow.push_back(prow[k]);
+        m_ucols[j].push_back(p);
+        unsigned_vector & col = m_acols[j];
+        for (unsigned l = 0; l < col.size(); l++) {
+            if (col[l] == p) {
+                col[l] = col.back();
+                col.pop_back();
+                break;
+            }
+        }
+        col_unlink(j);
+        m_col_count[j]--;
+        col_link(j);
+    }
+    m_diag[p]    = piv;
+    m_row2col[p] = q;
+    m_col2row[q] = p;
+    m_rank[p]    = m_order.size();
+    m_order.push_back(p);
+
+    unsigned begin = m_eta_entries.size();
+    unsigned_vector const & qcol = m_acols[q];
+    for (unsigned k = 0; k < qcol.size(); k++) {
+        unsigned i = qcol[k];
+        if (i == p)
+            continue;
+        entries & row = m_arows[i];
+        for (unsigned l = 0; l < row.size(); l++)
+            m_pos[row[l].m_idx] = l;
+        unsigned qpos = m_pos[q];
+        double mult   = row[qpos].m_val / piv;
+        row[qpos]     = row.back();
+        m_pos[row[qpos].m_idx] = qpos;
+        row.pop_back();
+        m_pos[q] = UINT_MAX;
+        for (unsigned l = 0; l < urow.size(); l++) {
+            unsigned j = urow[l].m_idx;
+            if (m_pos[j] != UINT_MAX) {
+                row[m_pos[j]].m_val -= mult * urow[l].m_val;
+            }
+            else {
+                // fill-in
+                m_pos[j] = row.size();
+                row.push_back(entry(j, -mult * urow[l].m_val));
+                m_acols[j].push_back(i);
+                col_unlink(j);
+                m_col_count[j]++;
+                col_link(j);
+            }
+        }
+        for (unsigned l = 0; l < row.size(); l++)
+            m_pos[row[l].m_idx] = UINT_MAX;
+        row_unlink(i);
+        m_row_count[i] = row.size();
+        row_link(i);
+        m_eta_entries.push_back(entry(i, mult));
+    }
+    if (begin < m_eta_entries.size())
+        m_letas.push_back(eta(p, begin, m_eta_entries.size()));
+    m_acols[q].reset();
+    prow.reset();
+}
+
+bool sparse_lu::factor(unsigned n, vector<entries> const & cols) {
+    SASSERT(cols.size() == n);
+    m_size        = n;
+    m_num_dead    = 0;
+    m_num_updates = 0;
+    m_has_spike   = false;
+    m_letas.reset();
+    m_retas.reset();
+    m_eta_entries.reset();
+    m_order.reset();
+    m_urows.reset();
+    m_ucols.reset();
+    m_arows.reset();
+    m_acols.reset();
+    m_urows.resize(n);
+    m_ucols.resize(n);
+    m_arows.resize(n);
+    m_acols.resize(n);
+    m_diag.reset();
+    m_diag.resize(n, 0.0);
+    m_row2col.reset();
+    m_row2col.resize(n, UINT_MAX);
+    m_col2row.reset();
+    m_col2row.resize(n, UINT_MAX);
+    m_rank.reset();
+    m_rank.resize(n, UINT_MAX);
+    m_row_head.reset();
+    m_row_head.resize(n + 1, UINT_MAX);
+    m_col_head.reset();
+    m_col_head.resize(n + 1, UINT_MAX);
+    m_row_next.resize(n);
+    m_row_prev.resize(n);
+    m_col_next.resize(n);
+    m_col_prev.resize(n);
+    m_row_count.reset();
+    m_row_count.resize(n, 0);
+    m_col_count.reset();
+    m_col_count.resize(n, 0);
+    m_row_done.reset();
+    m_row_done.resize(n, false);
+    m_col_done.reset();
+    m_col_done.resize(n, false);
+    m_pos.reset();
+    m_pos.resize(n, UINT_MAX);
+    m_work.reset();
+    m_work.resize(n, 0.0);
+    m_dense.reset();
+    m_dense.resize(n, 0.0);
+
+    for (unsigned j = 0; j < n; j++) {
+        entries const & col = cols[j];
+        for (unsigned k = 0; k < col.size(); k++) {
+            SASSERT(col[k].m_idx < n);
+            if (col[k].m_val == 0.0)
+                continue;
+            m_arows[col[k].m_idx].push_back(entry(j, col[k].m_val));
+            m_acols[j].push_back(col[k].m_idx);
+        }
+    }
+    for (unsigned i = 0; i < n; i++) {
+        m_row_count[i] = m_arows[i].size();
+        row_link(i);
+    }
+    for (unsigned j = 0; j < n; j++) {
+        m_col_count[j] = m_acols[j].size();
+        col_link(j);
+    }
+    for (unsigned k = 0; k < n; k++) {
+        unsigned p = UINT_MAX, q = UINT_MAX;
+        if (!select_pivot(p, q))
+            return false;
+        eliminate(p, q);
+    }
+    return true;
+}
+
+// -----------------------------------
+//
+// Solving
+//
+// -----------------------------------
+
+void sparse_lu::ftran(svector<double> & v, bool save_spike) {
+    SASSERT(v.size() == m_size);
+    for (unsigned k = 0; k < m_letas.size(); k++) {
+        eta const & e = m_letas[k];
+        double vp = v[e.m_pivot];
+        if (vp == 0.0)
+            continue;
+        for (unsigned l = e.m_begin; l < e.m_end; l++)
+            v[m_eta_entries[l].m_idx] -= m_eta_entries[l].m_val * vp;
+    }
+    for (unsigned k = 0; k < m_retas.size(); k++) {
+        eta const & e = m_retas[k];
+        double s = 0.0;
+        for (unsigned l = e.m_begin; l < e.m_end; l++)
+            s += m_eta_entries[l].m_val * v[m_eta_entries[l].m_idx];
+        v[e.m_pivot] -= s;
+    }
+    if (save_spike) {
+        m_spike.reset();
+        m_spike.append(v);
+        m_has_spike = true;
+    }
+    for (unsigned k = m_order.size(); k-- > 0; ) {
+        unsigned p = m_order[k];
+        if (p == UINT_MAX)
+            continue;
+        double s = v[p];
+        entries const & row = m_urows[p];
+        for (unsigned l = 0; l < row.size(); l++)
+            s -= row[l].m_val * m_work[row[l].m_idx];
+        m_work[m_row2col[p]] = s / m_diag[p];
+    }
+    v.swap(m_work);
+    if (save_spike) {
+        m_spike_sol.reset();
+        m_spike_sol.append(v);
+    }
+}
+
+void sparse_lu::btran(svector<double> & v) {
+    SASSERT(v.size() == m_size);
+    for (unsigned k = 0; k < m_order.size(); k++) {
+        unsigned p = m_order[k];
+        if (p == UINT_MAX)
+            continue;
+        double w = v[m_row2col[p]] / m_diag[p];
+        m_work[p] = w;
+        if (w == 0.0)
+            continue;
+        entries const & row = m_urows[p];
+        for (unsigned l = 0; l < row.size(); l++)
+            v[row[l].m_idx] -= row[l].m_val * w;
+    }
+    for (unsigned k = m_retas.size(); k-- > 0; ) {
+        eta const & e = m_retas[k];
+        double w = m_work[e.m_pivot];
+        if (w == 0.0)
+            continue;
+        for (unsigned l = e.m_begin; l < e.m_end; l++)
+            m_work[m_eta_entries[l].m_idx] -= m_eta_entries[l].m_val * w;
+    }
+    for (unsigned k = m_letas.size(); k-- > 0; ) {
+        eta const & e = m_letas[k];
+        double s = 0.0;
+        for (unsigned l = e.m_begin; l < e.m_end; l++)
+            s += m_eta_entries[l].m_val * m_work[m_eta_entries[l].m_idx];
+        m_work[e.m_pivot] -= s;
+    }
+    v.swap(m_work);
+}
+
+// -----------------------------------
+//
+// Forrest-Tomlin update
+//
+// -----------------------------------
+
+void sparse_lu::remove_from_ucol(unsigned j, unsigned i) {
+    unsigned_vector & col = m_ucols[j];
+    for (unsigned k = 0; k < col.size(); k++) {
+        if (col[k] == i) {
+            col[k] = col.back();
+            col.pop_back();
+            return;
+        }
+    }
+}
+
+void sparse_lu::compress_order() {
+    unsigned j = 0;
+    for (unsigned k = 0; k < m_order.size(); k++) {
+        unsigned p = m_order[k];
+        if (p == UINT_MAX)
+            continue;
+        m_order[j] = p;
+        m_rank[p]  = j;
+        j++;
+    }
+    m_order.shrink(j);
+    m_num_dead = 0;
+}
+
+bool sparse_lu::update(unsigned r) {
+    SASSERT(m_has_spike);
+    SASSERT(r < m_size);
+    m_has_spike = false;
+    unsigned p  = m_col2row[r];
+    unsigned k  = m_rank[p];
+
+    // remove the column r from U
+    unsigned_vector & rcol = m_ucols[r];
+    for (unsigned l = 0; l < rcol.size(); l++) {
+        entries & row = m_urows[rcol[l]];
+        for (unsigned t = 0; t < row.size(); t++) {
+            if (row[t].m_idx == r) {
+                row[t] = row.back();
+                row.pop_back();
+                break;
+            }
+        }
+    }
+    rcol.reset();
+
+    // insert the spike as the new column r
+    for (unsigned i = 0; i < m_size; i++) {
+        double s = m_spike[i];
+        if (i == p || fabs(s) <= m_zero_tol * 1e-3)
+            continue;
+        m_urows[i].push_back(entry(r, s));
+        rcol.push_back(i);
+    }
+
+    // row p is moved to the end of the pivot order. Its entries are
+    // eliminated using the rows that follow it in the current order.
+    double d = m_spike[p];
+    entries & prow = m_urows[p];
+    for (unsigned l = 0; l < prow.size(); l++) {
+        m_dense[prow[l].m_idx] = prow[l].m_val;
+        remove_from_ucol(prow[l].m_idx, p);
+    }
+    prow.reset();
+    unsigned begin = m_eta_entries.size();
+    for (unsigned t = k + 1; t < m_order.size(); t++) {
+        unsigned pt = m_order[t];
+        if (pt == UINT_MAX)
+            continue;
+        unsigned c = m_row2col[pt];
+        double w   = m_dense[c];
+        if (w == 0.0)
+            continue;
+        m_dense[c]  = 0.0;
+        double mult = w / m_diag[pt];
+        m_eta_entries.push_back(entry(pt, mult));
+        entries const & row = m_urows[pt];
+        for (unsigned l = 0; l < row.size(); l++) {
+            if (row[l].m_idx == r)
+                d -= mult * row[l].m_val;
+            else
+                m_dense[row[l].m_idx] -= mult * row[l].m_val;
+        }
+    }
+    if (begin < m_eta_entries.size())
+        m_retas.push_back(eta(p, begin, m_eta_entries.size()));
+    m_order[k] = UINT_MAX;
+    m_num_dead++;
+    m_rank[p]  = m_order.size();
+    m_order.push_back(p);
+    // In exact arithmetic, the determinant of the basis is multiplied by
+    // the r-th component of B^{-1} a. A large deviation indicates that the
+    // update is numerically unstable.
+    double expected = m_spike_sol[r] * m_diag[p];
+    m_diag[p]  = d;
+    m_num_updates++;
+    if (m_num_dead > m_size)
+        compress_order();
+    return fabs(d) > m_zero_tol && fabs(d - expected) <= 1e-9 * (1.0 + fabs(d));
+}
+
+unsigned sparse_lu::num_nonzeros() const {
+    unsigned r = m_eta_entries.size() + m_size;
+    for (unsigned i = 0; i < m_urows.size(); i++)
+        r += m_urows[i].size();
+    return r;
+}
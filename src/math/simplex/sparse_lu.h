@@ -0,0 +1,145 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sparse_lu.h
+
+Abstract:
+
+    Sparse LU factorization of a square floating point matrix B.
+
+    The factorization is computed using Markowitz pivoting with a
+    threshold test (column singletons and row singletons are pivoted
+    first). L is stored as a sequence of column etas, and U is stored
+    row-wise together with its pivot order.
+
+    Column replacements B' = B + (a - B e_r) e_r^T are handled using
+    Forrest-Tomlin updates: the column r of U is replaced by the
+    spike L^{-1} a, and the row owning the old pivot is eliminated
+    using a row eta and moved to the end of the pivot order.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+    Rows of B are identified by their index in the input. Columns of B
+    are identified by their position (e.g., a position in the basis of
+    a simplex solver).
+
+--*/
+#ifndef _SPARSE_LU_H_
+#define _SPARSE_LU_H_
+
+#include"vector.h"
+
+class sparse_lu {
+public:
+    struct entry {
+        unsigned m_idx;
+        double   m_val;
+        entry(unsigned idx, double val): m_idx(idx), m_val(val) {}
+        entry(): m_idx(0), m_val(0) {}
+    };
+    typedef svector<entry> entries;
+
+private:
+    struct eta {
+        unsigned m_pivot;     // pivot row
+        unsigned m_begin;     // range of the eta in m_eta_entries
+        unsigned m_end;
+        eta(unsigned p, unsigned b, unsigned e): m_pivot(p), m_begin(b), m_end(e) {}
+    };
+
+    unsigned           m_size;
+    double             m_pivot_tol;      // relative threshold used to select pivots.
+    double             m_zero_tol;       // pivots smaller than this value are considered zero.
+
+    // L factor: column etas v[i] -= l * v[p]
+    svector<eta>       m_letas;
+    // row etas created by Forrest-Tomlin updates: v[p] -= l * v[i]
+    svector<eta>       m_retas;
+    entries            m_eta_entries;
+
+    // U factor
+    vector<entries>    m_urows;          // off diagonal entries of each row. The index of an entry is a column.
+    vector<unsigned_vector> m_ucols;     // rows containing an off diagonal entry in a given column (may contain stale rows).
+    svector<double>    m_diag;           // pivot of each row
+    unsigned_vector    m_row2col;        // column pivoted in each row
+    unsigned_vector    m_col2row;        // row pivoted in each column
+    unsigned_vector    m_order;          // pivot order (rows), UINT_MAX for removed slots
+    unsigned_vector    m_rank;           // position of each row in m_order
+    unsigned           m_num_dead;
+
+    // Forrest-Tomlin update
+    svector<double>    m_spike;
+    svector<double>    m_spike_sol;      // solution computed together with the spike
+    bool               m_has_spike;
+    unsigned           m_num_updates;
+
+    // Markowitz factorization
+    vector<entries>    m_arows;          // active submatrix, row-wise
+    vector<unsigned_vector> m_acols;     // active submatrix, column pattern
+    unsigned_vector    m_row_head, m_row_next, m_row_prev;   // rows bucketed by number of entries
+    unsigned_vector    m_col_head, m_col_next, m_col_prev;   // columns bucketed by number of entries
+    unsigned_vector    m_row_count, m_col_count;
+    svector<bool>      m_row_done, m_col_done;
+    unsigned_vector    m_pos;            // position of a column in the row being updated
+
+    svector<double>    m_work;           // result of ftran and btran
+    svector<double>    m_dense;          // row being eliminated in update, all zeros otherwise
+
+    void row_link(unsigned i);
+    void row_unlink(unsigned i);
+    void col_link(unsigned j);
+    void col_unlink(unsigned j);
+    double get_active(unsigned i, unsigned j) const;
+    double col_max(unsigned j) const;
+    bool select_pivot(unsigned & p, unsigned & q);
+    void eliminate(unsigned p, unsigned q);
+    void remove_from_ucol(unsigned j, unsigned i);
+    void compress_order();
+
+public:
+    sparse_lu();
+
+    unsigned size() const { return m_size; }
+
+    /**
+       \brief Factorize the n x n matrix whose columns are given by cols.
+       Return false if the matrix is (numerically) singular.
+    */
+    bool factor(unsigned n, vector<entries> const & cols);
+
+    /**
+       \brief Solve B x = v. On input v is indexed by rows, on output by columns.
+       If save_spike is true, then the spike of v is stored for a subsequent call to update.
+    */
+    void ftran(svector<double> & v, bool save_spike = false);
+
+    /**
+       \brief Solve x B = v. On input v is indexed by columns, on output by rows.
+    */
+    void btran(svector<double> & v);
+
+    /**
+       \brief Replace the column r of B by the column used in the last call to ftran with save_spike = true.
+       Return false if the updated matrix is (numerically) singular, the factorization
+       must then be recomputed.
+    */
+    bool update(unsigned r);
+
+    /**
+       \brief Number of updates since the last factorization.
+    */
+    unsigned num_updates() const { return m_num_updates; }
+
+    /**
+       \brief Number of nonzeros in the L and U factors, including the etas created by updates.
+    */
+    unsigned num_nonzeros() const;
+};
+
+#endif
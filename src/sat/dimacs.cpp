@@ -127,6 +127,9 @@ void parse_dimacs_core(Buffer & in, sat::solver & solver) {
 }
 
 void parse_dimacs(std::istream & in, sat::solver & solver) {
+    // DIMACS variables start at 1, variable 0 is not used and must not be a case split.
+    if (solver.num_vars() == 0)
+        solver.mk_var(false, false);
     stream_buffer _in(in);
     parse_dimacs_core(_in, solver);
 }
@@ -165,7 +165,7 @@ namespace sat {
             literal l = c[i];
             switch (s.value(l)) {
             case l_undef:
-                c[j] = l;
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             case l_false:
@@ -195,7 +195,7 @@ namespace sat {
             SASSERT(s.m_qhead == s.m_trail.size());
             return false;
         default:
-            c.shrink(new_sz);
+            s.shrink_clause(c, new_sz);
             s.attach_clause(c);
             SASSERT(s.m_qhead == s.m_trail.size());
             return true;
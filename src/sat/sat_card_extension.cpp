@@ -0,0 +1,276 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_card_extension.cpp
+
+Abstract:
+
+    Cardinality and pseudo-Boolean constraints as a SAT extension.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#include"sat_card_extension.h"
+#include<algorithm>
+
+namespace sat {
+
+    card_extension::card_extension():
+        m_solver(0) {
+    }
+
+    card_extension::~card_extension() {
+        std::for_each(m_constraints.begin(), m_constraints.end(), delete_proc<constraint>());
+    }
+
+    struct wlit_lt {
+        bool operator()(std::pair<unsigned, literal> const & a, std::pair<unsigned, literal> const & b) const {
+            return a.first > b.first || (a.first == b.first && a.second.index() < b.second.index());
+        }
+    };
+
+    struct lit_idx_lt {
+        bool operator()(std::pair<unsigned, literal> const & a, std::pair<unsigned, literal> const & b) const {
+            return a.second.index() < b.second.index();
+        }
+    };
+
+    void card_extension::add_at_least(unsigned k, unsigned sz, literal const * lits, unsigned const * weights) {
+        add_constraint(k, sz, lits, weights);
+    }
+
+    void card_extension::add_at_most(unsigned k, unsigned sz, literal const * lits, unsigned const * weights) {
+        // w_1*l_1 + ... + w_n*l_n <= k  iff  w_1*~l_1 + ... + w_n*~l_n >= w_1 + ... + w_n - k
+        uint64 sum = 0;
+        literal_vector neg_lits;
+        for (unsigned i = 0; i < sz; i++) {
+            sum += weights ? weights[i] : 1;
+            neg_lits.push_back(~lits[i]);
+        }
+        if (sum <= k)
+            return; // trivially satisfied
+        sum -= k;
+        if (sum > UINT_MAX)
+            throw solver_exception("pseudo-Boolean constraint is too big");
+        add_constraint(static_cast<unsigned>(sum), sz, neg_lits.c_ptr(), weights);
+    }
+
+    /**
+       \brief Normalize and assert w_1*l_1 + ... + w_n*l_n >= k.
+       Constraints that are equivalent to clauses are asserted as clauses.
+    */
+    void card_extension::add_constraint(unsigned k, unsigned sz, literal const * lits, unsigned const * weights) {
+        SASSERT(m_solver);
+        // the solver is left at the search level after a satisfiable check.
+        s().pop_to_base_level();
+        if (s().inconsistent())
+            return;
+        svector<std::pair<unsigned, literal> > wlits;
+        for (unsigned i = 0; i < sz; i++) {
+            unsigned w = weights ? weights[i] : 1;
+            if (w > 0)
+                wlits.push_back(std::make_pair(w, lits[i]));
+        }
+        // merge occurrences of the same variable,
+        // l and ~l are adjacent after sorting.
+        std::sort(wlits.begin(), wlits.end(), lit_idx_lt());
+        uint64 bound = k;
+        unsigned j = 0;
+        for (unsigned i = 0; i < wlits.size(); i++) {
+            std::pair<unsigned, literal> p = wlits[i];
+            if (j > 0 && wlits[j-1].second == p.second) {
+                uint64 w = static_cast<uint64>(wlits[j-1].first) + p.first;
+                if (w > UINT_MAX)
+                    throw solver_exception("pseudo-Boolean constraint is too big");
+                wlits[j-1].first = static_cast<unsigned>(w);
+            }
+            else if (j > 0 && wlits[j-1].second == ~p.second) {
+                // w1*l + w2*~l = min(w1, w2) + (w1 - min)*l + (w2 - min)*~l
+                unsigned w1 = wlits[j-1].first;
+                unsigned w2 = p.first;
+                unsigned m  = std::min(w1, w2);
+                bound = bound > m ? bound - m : 0;
+                if (w1 > w2)
+                    wlits[j-1].first = w1 - w2;
+                else if (w2 > w1)
+                    wlits[j-1] = std::make_pair(w2 - w1, p.second);
+                else
+                    --j;
+            }
+            else {
+                wlits[j++] = p;
+            }
+        }
+        wlits.shrink(j);
+        // remove literals assigned at the base level
+        j = 0;
+        for (unsigned i = 0; i < wlits.size(); i++) {
+            switch (s().value(wlits[i].second)) {
+            case l_true:
+                bound = bound > wlits[i].first ? bound - wlits[i].first : 0;
+                break;
+            case l_false:
+                break;
+            case l_undef:
+                wlits[j++] = wlits[i];
+                break;
+            }
+        }
+        wlits.shrink(j);
+        if (bound == 0)
+            return; // trivially satisfied
+        k = static_cast<unsigned>(bound);
+        uint64 sum   = 0;
+        bool is_clause = true;
+        for (unsigned i = 0; i < wlits.size(); i++) {
+            // coefficients bigger than k can be trimmed
+            if (wlits[i].first > k)
+                wlits[i].first = k;
+            if (wlits[i].first < k)
+                is_clause = false;
+            sum += wlits[i].first;
+        }
+        literal_vector clause;
+        if (sum < k) {
+            // trivially unsatisfiable
+            s().mk_clause(0, clause.c_ptr());
+            return;
+        }
+        if (is_clause) {
+            for (unsigned i = 0; i < wlits.size(); i++)
+                clause.push_back(wlits[i].second);
+            s().mk_clause(clause.size(), clause.c_ptr());
+            return;
+        }
+        if (sum == k) {
+            // all literals must be true
+            for (unsigned i = 0; i < wlits.size(); i++) {
+                literal l = wlits[i].second;
+                s().mk_clause(1, &l);
+            }
+            return;
+        }
+        std::sort(wlits.begin(), wlits.end(), wlit_lt());
+        unsigned idx = m_constraints.size();
+        constraint * c = alloc(constraint, k);
+        c->m_sum = sum;
+        m_constraints.push_back(c);
+        for (unsigned i = 0; i < wlits.size(); i++) {
+            literal l = wlits[i].second;
+            unsigned w = wlits[i].first;
+            c->m_lits.push_back(l);
+            c->m_weights.push_back(w);
+            // variables in constraints must not be eliminated by the simplifier.
+            s().set_external(l.var());
+            // the occurrence is processed when l is assigned to false.
+            s().get_wlist(~l).push_back(watched(m_occs.size()));
+            m_occs.push_back(occurrence(idx, w));
+        }
+        m_stats.m_num_constraints++;
+        TRACE("card_extension", display(tout););
+        propagate_constraint(idx);
+    }
+
+    justification card_extension::mk_justification(unsigned idx) {
+        // justifications are not needed at the base level.
+        if (s().scope_lvl() == 0)
+            return justification();
+        m_justs.push_back(justification_info(idx, m_constraints[idx]->m_false.size()));
+        return justification::mk_ext_justification(m_justs.size() - 1);
+    }
+
+    /**
+       \brief Check constraint idx for conflicts and implied literals.
+    */
+    void card_extension::propagate_constraint(unsigned idx) {
+        constraint & c = *m_constraints[idx];
+        if (c.m_sum < c.m_k) {
+            TRACE("card_extension", tout << "conflict: " << idx << "\n";);
+            m_stats.m_num_conflicts++;
+            s().set_conflict(mk_justification(idx));
+            return;
+        }
+        uint64 slack = c.m_sum - c.m_k;
+        justification js;
+        bool has_js = false;
+        unsigned sz = c.m_lits.size();
+        // literals are sorted by decreasing weight
+        for (unsigned i = 0; i < sz && c.m_weights[i] > slack; i++) {
+            literal l = c.m_lits[i];
+            if (s().value(l) != l_undef)
+                continue;
+            if (!has_js) {
+                js     = mk_justification(idx);
+                has_js = true;
+            }
+            TRACE("card_extension", tout << "propagate: " << l << " from: " << idx << "\n";);
+            m_stats.m_num_propagations++;
+            s().assign(l, js);
+        }
+    }
+
+    void card_extension::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        keep = true;
+        occurrence const & occ = m_occs[idx];
+        constraint & c = *m_constraints[occ.m_constraint];
+        SASSERT(c.m_sum >= occ.m_weight);
+        c.m_false.push_back(~l);
+        c.m_sum -= occ.m_weight;
+        m_undo.push_back(idx);
+        propagate_constraint(occ.m_constraint);
+    }
+
+    void card_extension::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        justification_info const & js = m_justs[idx];
+        constraint const & c = *m_constraints[js.m_constraint];
+        SASSERT(js.m_num_false <= c.m_false.size());
+        for (unsigned i = 0; i < js.m_num_false; i++)
+            r.push_back(~c.m_false[i]);
+    }
+
+    void card_extension::push() {
+        m_undo_lim.push_back(m_undo.size());
+        m_justs_lim.push_back(m_justs.size());
+    }
+
+    void card_extension::pop(unsigned n) {
+        SASSERT(n <= m_undo_lim.size());
+        unsigned new_lvl = m_undo_lim.size() - n;
+        unsigned old_sz  = m_undo_lim[new_lvl];
+        unsigned i = m_undo.size();
+        while (i > old_sz) {
+            --i;
+            occurrence const & occ = m_occs[m_undo[i]];
+            constraint & c = *m_constraints[occ.m_constraint];
+            c.m_false.pop_back();
+            c.m_sum += occ.m_weight;
+        }
+        m_undo.shrink(old_sz);
+        m_justs.shrink(m_justs_lim[new_lvl]);
+        m_undo_lim.shrink(new_lvl);
+        m_justs_lim.shrink(new_lvl);
+    }
+
+    void card_extension::collect_statistics(statistics & st) const {
+        st.update("pb constraints", m_stats.m_num_constraints);
+        st.update("pb propagations", m_stats.m_num_propagations);
+        st.update("pb conflicts", m_stats.m_num_conflicts);
+    }
+
+    void card_extension::display(std::ostream & out) const {
+        for (unsigned i = 0; i < m_constraints.size(); i++) {
+            constraint const & c = *m_constraints[i];
+            out << i << ":";
+            for (unsigned j = 0; j < c.m_lits.size(); j++)
+                out << " " << c.m_weights[j] << "*" << c.m_lits[j];
+            out << " >= " << c.m_k << " (sum: " << c.m_sum << ")\n";
+        }
+    }
+
+};
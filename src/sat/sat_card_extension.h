@@ -0,0 +1,125 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_card_extension.h
+
+Abstract:
+
+    Cardinality and pseudo-Boolean constraints as a SAT extension.
+
+    A constraint has the form
+
+        w_1*l_1 + ... + w_n*l_n >= k
+
+    where the w_i are positive integers and the l_i are literals.
+    At-most-k constraints are handled by negating the literals.
+
+    Propagation is based on counters: for each constraint we maintain
+    the sum of the weights of the literals that are not false. The
+    constraint is in conflict when this sum is smaller than k, and an
+    unassigned literal l_i is implied if removing its weight from the
+    sum makes it smaller than k.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#ifndef _SAT_CARD_EXTENSION_H_
+#define _SAT_CARD_EXTENSION_H_
+
+#include"sat_extension.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    class card_extension : public extension {
+        struct stats {
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            unsigned m_num_constraints;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        class constraint {
+        public:
+            unsigned        m_k;
+            uint64          m_sum;     // sum of the weights of the literals that are not false.
+            literal_vector  m_lits;    // sorted by decreasing weight.
+            unsigned_vector m_weights;
+            literal_vector  m_false;   // false literals, in the order they were processed.
+            constraint(unsigned k):m_k(k), m_sum(0) {}
+        };
+
+        // A literal occurrence in a constraint, it is the index used in watch lists.
+        struct occurrence {
+            unsigned m_constraint;
+            unsigned m_weight;
+            occurrence(unsigned c, unsigned w):m_constraint(c), m_weight(w) {}
+        };
+
+        // A justification is the set of the first m_num_false false literals of a constraint.
+        struct justification_info {
+            unsigned m_constraint;
+            unsigned m_num_false;
+            justification_info(unsigned c, unsigned n):m_constraint(c), m_num_false(n) {}
+        };
+
+        solver *                    m_solver;
+        ptr_vector<constraint>      m_constraints;
+        svector<occurrence>         m_occs;
+        svector<justification_info> m_justs;
+        unsigned_vector             m_justs_lim;
+        unsigned_vector             m_undo;      // occurrences made false, used for backtracking.
+        unsigned_vector             m_undo_lim;
+        stats                       m_stats;
+
+        solver & s() const { return *m_solver; }
+        justification mk_justification(unsigned idx);
+        void add_constraint(unsigned k, unsigned sz, literal const * lits, unsigned const * weights);
+        void propagate_constraint(unsigned idx);
+    public:
+        card_extension();
+        virtual ~card_extension();
+
+        /**
+           \brief Assert w_1*l_1 + ... + w_n*l_n >= k.
+           If weights is 0, then all weights are 1.
+
+           The solver backtracks to the base level before the constraint is added.
+        */
+        void add_at_least(unsigned k, unsigned sz, literal const * lits, unsigned const * weights = 0);
+
+        /**
+           \brief Assert w_1*l_1 + ... + w_n*l_n <= k.
+           If weights is 0, then all weights are 1.
+
+           The solver backtracks to the base level before the constraint is added.
+        */
+        void add_at_most(unsigned k, unsigned sz, literal const * lits, unsigned const * weights = 0);
+
+        unsigned num_constraints() const { return m_constraints.size(); }
+
+        virtual void set_solver(solver * s) { m_solver = s; }
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l) {}
+        virtual check_result check() { return CR_DONE; }
+        virtual void push();
+        virtual void pop(unsigned n);
+        virtual void simplify() {}
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+        virtual void collect_statistics(statistics & st) const;
+
+        void display(std::ostream & out) const;
+    };
+
+};
+
+#endif
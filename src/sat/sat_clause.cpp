@@ -31,6 +31,7 @@ namespace sat {
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_vivified(false),
         m_inact_rounds(0) {
         memcpy(m_lits, lits, sizeof(literal) * sz);
         mark_strengthened();
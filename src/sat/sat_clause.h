@@ -45,6 +45,7 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_vivified:1;
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8; 
         unsigned           m_psm:8;  // transient field used during gc
@@ -72,6 +73,8 @@ namespace sat {
         bool check_approx() const; // for debugging
         literal * begin() { return m_lits; }
         literal * end() { return m_lits + m_size; }
+        literal const * begin() const { return m_lits; }
+        literal const * end() const { return m_lits + m_size; }
         bool contains(literal l) const;
         bool contains(bool_var v) const;
         bool satisfied_by(model const & m) const;
@@ -92,6 +95,8 @@ namespace sat {
 
         bool on_reinit_stack() const { return m_reinit_stack; }
         void set_reinit_stack(bool f) { m_reinit_stack = f; }
+        bool vivified() const { return m_vivified; }
+        void set_vivified(bool f) { m_vivified = f; }
     };
 
     std::ostream & operator<<(std::ostream & out, clause const & c);
@@ -99,7 +99,8 @@ namespace sat {
                     m_elim_literals++;
                     break;
                 case l_undef:
-                    c[j] = c[i];
+                    // swap instead of copy, so that c still contains its original literals when it is deleted.
+                    std::swap(c[j], c[i]);
                     j++;
                     break;
                 }
@@ -139,7 +140,7 @@ namespace sat {
                         s.del_clause(c);
                     }
                     else {
-                        c.shrink(new_sz);
+                        s.shrink_clause(c, new_sz);
                         *it2 = *it;
                         it2++;
                         if (!c.frozen()) {
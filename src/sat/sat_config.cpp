@@ -29,11 +29,13 @@ namespace sat {
         m_random("random"),
         m_geometric("geometric"),
         m_luby("luby"),
+        m_ema("ema"),
         m_dyn_psm("dyn_psm"),
         m_psm("psm"),
         m_glue("glue"),
         m_glue_psm("glue_psm"),
-        m_psm_glue("psm_glue") {
+        m_psm_glue("psm_glue"),
+        m_tiered("tiered") {
         updt_params(p); 
     }
 
@@ -46,6 +48,8 @@ namespace sat {
             m_restart = RS_LUBY;
         else if (s == m_geometric)
             m_restart = RS_GEOMETRIC;
+        else if (s == m_ema)
+            m_restart = RS_EMA;
         else
             throw sat_param_exception("invalid restart strategy");
 
@@ -66,6 +70,11 @@ namespace sat {
 
         m_restart_initial = p.restart_initial();
         m_restart_factor  = p.restart_factor();
+        m_restart_margin  = p.restart_margin();
+        m_restart_fast_glue = p.restart_emafastglue();
+        m_restart_slow_glue = p.restart_emaslowglue();
+        m_restart_blocking  = p.restart_blocking();
+        m_restart_blocking_min = p.restart_blocking_min();
         
         m_random_freq     = p.random_freq();
         m_random_seed     = p.random_seed();
@@ -82,12 +91,17 @@ namespace sat {
         m_simplify_max    = _p.get_uint("simplify_max", 500000);
         // --------------------------------
 
+        m_inprocess_interval = p.inprocess_interval();
+        m_inprocess_ratio    = p.inprocess_ratio();
+
         s = p.gc();
-        if (s == m_dyn_psm) {
-            m_gc_strategy     = GC_DYN_PSM;
+        if (s == m_dyn_psm || s == m_tiered) {
+            m_gc_strategy     = s == m_dyn_psm ? GC_DYN_PSM : GC_TIERED;
             m_gc_initial      = p.gc_initial();
             m_gc_increment    = p.gc_increment();
             m_gc_small_lbd    = p.gc_small_lbd();
+            m_gc_tier1_glue   = p.gc_tier1_glue();
+            m_gc_tier2_glue   = p.gc_tier2_glue();
             m_gc_k            = p.gc_k();
             if (m_gc_k > 255)
                 m_gc_k = 255;
@@ -108,6 +122,13 @@ namespace sat {
         }
         m_minimize_lemmas = p.minimize_lemmas();
         m_dyn_sub_res     = p.dyn_sub_res();
+
+        m_num_threads     = p.threads();
+        m_share_size      = p.threads_share_size();
+        m_share_glue      = p.threads_share_glue();
+        m_drat_file       = p.drat_file();
+        m_drat            = m_drat_file.size() > 0;
+        m_drat_binary     = p.drat_binary();
     }
 
     void config::collect_param_descrs(param_descrs & r) {
@@ -33,7 +33,8 @@ namespace sat {
 
     enum restart_strategy {
         RS_GEOMETRIC,
-        RS_LUBY
+        RS_LUBY,
+        RS_EMA
     };
 
     enum gc_strategy {
@@ -41,7 +42,8 @@ namespace sat {
         GC_PSM,
         GC_GLUE,
         GC_GLUE_PSM,
-        GC_PSM_GLUE
+        GC_PSM_GLUE,
+        GC_TIERED
     };
 
     struct config {
@@ -52,6 +54,11 @@ namespace sat {
         restart_strategy   m_restart;
         unsigned           m_restart_initial;
         double             m_restart_factor; // for geometric case
+        double             m_restart_margin; // for ema case
+        double             m_restart_fast_glue;
+        double             m_restart_slow_glue;
+        double             m_restart_blocking;
+        unsigned           m_restart_blocking_min;
         double             m_random_freq;
         unsigned           m_random_seed;
         unsigned           m_burst_search;
@@ -61,27 +68,42 @@ namespace sat {
         double             m_simplify_mult2;
         unsigned           m_simplify_max;
 
+        unsigned           m_inprocess_interval;
+        double             m_inprocess_ratio;
+
         gc_strategy        m_gc_strategy;
         unsigned           m_gc_initial;
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        unsigned           m_gc_tier1_glue;
+        unsigned           m_gc_tier2_glue;
 
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
 
+        unsigned           m_num_threads;
+        unsigned           m_share_size;
+        unsigned           m_share_glue;
+
+        bool               m_drat;
+        symbol             m_drat_file;
+        bool               m_drat_binary;
+
         symbol             m_always_true;
         symbol             m_always_false;
         symbol             m_caching;
         symbol             m_random;
         symbol             m_geometric;
         symbol             m_luby;
+        symbol             m_ema;
         
         symbol             m_dyn_psm;
         symbol             m_psm;        
         symbol             m_glue;        
         symbol             m_glue_psm;        
         symbol             m_psm_glue;        
+        symbol             m_tiered;
         
         config(params_ref const & p);
         void updt_params(params_ref const & p);
@@ -0,0 +1,117 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    DRAT proof output for the SAT solver.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#include"sat_drat.h"
+
+namespace sat {
+
+    drat::drat():
+        m_binary(false),
+        m_buffer_size(1 << 16),
+        m_num_add(0),
+        m_num_del(0) {
+    }
+
+    drat::~drat() {
+        if (is_open()) {
+            flush();
+            m_out.close();
+        }
+    }
+
+    void drat::open(char const * file_name, bool binary) {
+        if (is_open()) {
+            flush();
+            m_out.close();
+        }
+        m_binary = binary;
+        m_out.open(file_name, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (m_out.fail())
+            throw solver_exception("could not open DRAT proof file");
+    }
+
+    void drat::flush() {
+        if (!m_buffer.empty() && is_open()) {
+            m_out.write(m_buffer.c_ptr(), m_buffer.size());
+            m_out.flush();
+        }
+        m_buffer.reset();
+    }
+
+    void drat::put_literal(literal l) {
+        if (m_binary) {
+            unsigned u = 2 * l.var() + (l.sign() ? 1 : 0);
+            while (u > 127) {
+                put(static_cast<char>(128 | (u & 127)));
+                u >>= 7;
+            }
+            put(static_cast<char>(u));
+        }
+        else {
+            char digits[16];
+            unsigned n = 0;
+            unsigned v = l.var();
+            do {
+                digits[n++] = '0' + (v % 10);
+                v /= 10;
+            }
+            while (v > 0);
+            if (l.sign())
+                put('-');
+            while (n > 0)
+                put(digits[--n]);
+            put(' ');
+        }
+    }
+
+    void drat::put_clause(char kind, unsigned n, literal const * lits) {
+        if (!is_open())
+            return;
+        if (kind == 'a')
+            m_num_add++;
+        else
+            m_num_del++;
+        if (m_binary) {
+            put(kind);
+        }
+        else if (kind == 'd') {
+            put('d');
+            put(' ');
+        }
+        for (unsigned i = 0; i < n; i++)
+            put_literal(lits[i]);
+        if (m_binary) {
+            put(0);
+        }
+        else {
+            put('0');
+            put('\n');
+        }
+    }
+
+    void drat::collect_statistics(statistics & st) const {
+        st.update("drat added clauses", m_num_add);
+        st.update("drat deleted clauses", m_num_del);
+    }
+
+    void drat::reset_statistics() {
+        m_num_add = 0;
+        m_num_del = 0;
+    }
+
+};
@@ -0,0 +1,85 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.h
+
+Abstract:
+
+    DRAT proof output for the SAT solver.
+
+    The solver logs every clause it derives (learned clauses, units
+    and the clauses produced by the simplifier) and every clause it
+    deletes. The resulting trace can be checked offline by a DRAT
+    checker such as drat-trim against the original DIMACS problem.
+
+    Variables are written with the solver numbering, which coincides
+    with the DIMACS numbering when the problem is read by the DIMACS
+    frontend.
+
+    The output is buffered, and written to the file in large blocks.
+    In binary mode, each clause is written as 'a' or 'd' followed by
+    the literals encoded as variable-length integers (2*var + sign),
+    and terminated by 0.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#ifndef _SAT_DRAT_H_
+#define _SAT_DRAT_H_
+
+#include<fstream>
+#include"sat_types.h"
+#include"sat_clause.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class drat {
+        std::ofstream  m_out;
+        bool           m_binary;
+        svector<char>  m_buffer;
+        unsigned       m_buffer_size;
+        unsigned       m_num_add;
+        unsigned       m_num_del;
+
+        void flush();
+        void put(char c) {
+            m_buffer.push_back(c);
+            if (m_buffer.size() >= m_buffer_size)
+                flush();
+        }
+        void put_literal(literal l);
+        void put_clause(char kind, unsigned n, literal const * lits);
+    public:
+        drat();
+        ~drat();
+
+        /**
+           \brief Start writing the proof to the given file.
+        */
+        void open(char const * file_name, bool binary);
+        bool is_open() const { return m_out.is_open(); }
+
+        void add() { put_clause('a', 0, 0); flush(); }
+        void add(literal l) { put_clause('a', 1, &l); }
+        void add(literal l1, literal l2) { literal ls[2] = { l1, l2 }; put_clause('a', 2, ls); }
+        void add(unsigned n, literal const * lits) { put_clause('a', n, lits); }
+        void add(clause const & c) { put_clause('a', c.size(), c.begin()); }
+
+        void del(literal l1, literal l2) { literal ls[2] = { l1, l2 }; put_clause('d', 2, ls); }
+        void del(unsigned n, literal const * lits) { put_clause('d', n, lits); }
+        void del(clause const & c) { put_clause('d', c.size(), c.begin()); }
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
+    };
+
+};
+
+#endif
@@ -47,6 +47,13 @@ namespace sat {
                 if (it2->is_binary_clause()) {
                     literal l2 = it2->get_literal();
                     literal r2 = norm(roots, l2);
+                    if (m_solver.m_config.m_drat && (l1 != r1 || l2 != r2) && l1.index() < l2.index()) {
+                        // each binary clause is in two watch lists, log it only once.
+                        if (r1 != r2 && r1 != ~r2)
+                            m_solver.m_drat.add(r1, r2);
+                        m_drat_bins.push_back(l1);
+                        m_drat_bins.push_back(l2);
+                    }
                     if (r1 == r2) {
                         m_solver.assign(r1, justification());
                         if (m_solver.inconsistent())
@@ -95,6 +102,10 @@ namespace sat {
             }
             if (!c.frozen())
                 m_solver.dettach_clause(c);
+            bool drat = m_solver.m_config.m_drat;
+            literal_vector old_lits;
+            if (drat)
+                old_lits.append(sz, c.begin());
             // apply substitution
             for (i = 0; i < sz; i++) {
                 SASSERT(!m_solver.was_eliminated(c[i].var()));
@@ -122,6 +133,11 @@ namespace sat {
             }
             if (i < sz) {
                 // clause is a tautology or was simplified
+                if (drat) {
+                    // restore the original literals, they are logged when c is deleted.
+                    for (i = 0; i < sz; i++)
+                        c[i] = old_lits[i];
+                }
                 m_solver.del_clause(c);
                 continue; 
             }
@@ -131,6 +147,10 @@ namespace sat {
                 return;
             }
             TRACE("elim_eqs", tout << "after removing duplicates: " << c << " j: " << j << "\n";);
+            if (drat) {
+                m_solver.m_drat.add(j, c.begin());
+                m_solver.m_drat.del(old_lits.size(), old_lits.c_ptr());
+            }
             if (j < sz)
                 c.shrink(j);
             else
@@ -206,6 +226,12 @@ namespace sat {
         return true;
     }
 
+    void elim_eqs::drat_delete_bins() {
+        for (unsigned i = 0; i < m_drat_bins.size(); i += 2)
+            m_solver.m_drat.del(m_drat_bins[i], m_drat_bins[i+1]);
+        m_drat_bins.reset();
+    }
+
     void elim_eqs::operator()(literal_vector const & roots, bool_var_vector const & to_elim) {
         cleanup_bin_watches(roots);
         TRACE("elim_eqs", tout << "after bin cleanup\n"; m_solver.display(tout););
@@ -214,6 +240,7 @@ namespace sat {
         cleanup_clauses(roots, m_solver.m_learned);
         if (m_solver.inconsistent()) return;
         save_elim(roots, to_elim);
+        drat_delete_bins();
         m_solver.propagate(false);
         SASSERT(check_clauses(roots));
     }
@@ -25,7 +25,11 @@ namespace sat {
     class solver;
     
     class elim_eqs {
-        solver & m_solver;
+        solver &       m_solver;
+        // binary clauses rewritten by cleanup_bin_watches, their deletion is logged in the DRAT
+        // proof only after all clauses were rewritten, since the equivalences are binary clauses.
+        literal_vector m_drat_bins;
+        void drat_delete_bins();
         void save_elim(literal_vector const & roots, bool_var_vector const & to_elim);
         void cleanup_clauses(literal_vector const & roots, clause_vector & cs);
         void cleanup_bin_watches(literal_vector const & roots);
@@ -21,8 +21,10 @@ Revision History:
 
 #include"sat_types.h"
 #include"params.h"
+#include"statistics.h"
 
 namespace sat {
+    class solver;
 
     enum check_result {
         CR_DONE, CR_CONTINUE, CR_GIVEUP
@@ -30,6 +32,8 @@ namespace sat {
 
     class extension {
     public:
+        virtual ~extension() {}
+        virtual void set_solver(solver * s) = 0;
         virtual void propagate(literal l, ext_constraint_idx idx, bool & keep) = 0;
         virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) = 0;
         virtual void asserted(literal l) = 0;
@@ -39,6 +43,7 @@ namespace sat {
         virtual void simplify() = 0;
         virtual void clauses_modifed() = 0;
         virtual lbool get_phase(bool_var v) = 0;
+        virtual void collect_statistics(statistics & st) const = 0;
     };
 
 };
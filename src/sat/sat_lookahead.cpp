@@ -0,0 +1,201 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.cpp
+
+Abstract:
+
+    Lookahead based cuber for cube and conquer.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#include"sat_lookahead.h"
+#include"sat_solver.h"
+#include"sat_params.hpp"
+#include<algorithm>
+
+namespace sat {
+
+    lookahead::lookahead(solver & _s, params_ref const & p):
+        s(_s) {
+        updt_params(p);
+        reset_statistics();
+    }
+
+    /**
+       \brief Return the number of literals assigned by propagating l,
+       or UINT_MAX if l is a failed literal.
+    */
+    unsigned lookahead::try_lit(literal l) {
+        SASSERT(s.value(l) == l_undef);
+        s.push();
+        unsigned old_tr_sz = s.m_trail.size();
+        s.assign(l, justification());
+        s.propagate(false);
+        bool failed = s.inconsistent();
+        unsigned r  = s.m_trail.size() - old_tr_sz;
+        s.pop(1);
+        return failed ? UINT_MAX : r;
+    }
+
+    struct occs_gt {
+        unsigned_vector const & m_occs;
+        occs_gt(unsigned_vector const & occs):m_occs(occs) {}
+        bool operator()(bool_var v1, bool_var v2) const {
+            return m_occs[v1] > m_occs[v2];
+        }
+    };
+
+    /**
+       \brief Store in m_candidates the unassigned decision variables with the largest number of occurrences.
+    */
+    void lookahead::collect_candidates() {
+        m_candidates.reset();
+        for (bool_var v = 0; v < s.num_vars(); v++) {
+            if (s.value(v) == l_undef && !s.was_eliminated(v) && s.m_decision[v])
+                m_candidates.push_back(v);
+        }
+        if (m_candidates.size() > m_num_candidates) {
+            m_occs.reset();
+            m_occs.resize(s.num_vars(), 0);
+            for (unsigned i = 0; i < m_candidates.size(); i++) {
+                bool_var v = m_candidates[i];
+                m_occs[v] = s.get_wlist(literal(v, false)).size() + s.get_wlist(literal(v, true)).size();
+            }
+            std::partial_sort(m_candidates.begin(), m_candidates.begin() + m_num_candidates, m_candidates.end(), occs_gt(m_occs));
+            m_candidates.shrink(m_num_candidates);
+        }
+    }
+
+    /**
+       \brief Return the branching variable, or null_bool_var if all variables are assigned.
+       Failed literals are asserted in the current scope, and the solver is
+       inconsistent if both phases of a variable fail.
+    */
+    bool_var lookahead::select() {
+        while (true) {
+            collect_candidates();
+            if (m_candidates.empty())
+                return null_bool_var;
+            bool_var best       = null_bool_var;
+            uint64   best_score = 0;
+            for (unsigned i = 0; i < m_candidates.size(); i++) {
+                s.checkpoint();
+                bool_var v = m_candidates[i];
+                if (s.value(v) != l_undef)
+                    continue; // assigned by a failed literal
+                literal  l(v, false);
+                unsigned pos = try_lit(l);
+                unsigned neg = try_lit(~l);
+                if (pos == UINT_MAX || neg == UINT_MAX) {
+                    m_num_failed++;
+                    if (pos == UINT_MAX && neg == UINT_MAX) {
+                        s.set_conflict(justification());
+                        return null_bool_var;
+                    }
+                    s.assign(pos == UINT_MAX ? ~l : l, justification());
+                    s.propagate(false);
+                    if (s.inconsistent())
+                        return null_bool_var;
+                    continue;
+                }
+                uint64 score = static_cast<uint64>(pos + 1) * static_cast<uint64>(neg + 1);
+                if (best == null_bool_var || score > best_score) {
+                    best       = v;
+                    best_score = score;
+                }
+            }
+            if (best != null_bool_var && s.value(best) == l_undef)
+                return best;
+        }
+    }
+
+    void lookahead::split(vector<literal_vector> & cubes) {
+        bool_var v = select();
+        if (s.inconsistent()) {
+            m_num_refuted++;
+            return;
+        }
+        if (v == null_bool_var || m_cube.size() >= m_cube_depth) {
+            TRACE("sat_lookahead", tout << "cube: " << m_cube << "\n";);
+            cubes.push_back(m_cube);
+            m_num_cubes++;
+            return;
+        }
+        for (unsigned i = 0; i < 2; i++) {
+            literal l(v, i == 1);
+            s.push();
+            m_cube.push_back(l);
+            s.assign(l, justification());
+            s.propagate(false);
+            if (s.inconsistent())
+                m_num_refuted++;
+            else
+                split(cubes);
+            m_cube.pop_back();
+            s.pop(1);
+        }
+    }
+
+    struct lookahead::report {
+        lookahead & m_lookahead;
+        stopwatch   m_watch;
+        unsigned    m_num_cubes;
+        report(lookahead & l):
+            m_lookahead(l),
+            m_num_cubes(l.m_num_cubes) {
+            m_watch.start();
+        }
+
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(SAT_VB_LVL,
+                       verbose_stream() << " (sat-lookahead :cubes " << (m_lookahead.m_num_cubes - m_num_cubes)
+                       << " :failed-literals " << m_lookahead.m_num_failed
+                       << mem_stat() << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
+        }
+    };
+
+    lbool lookahead::operator()(vector<literal_vector> & cubes) {
+        SASSERT(!s.tracking_assumptions());
+        cubes.reset();
+        s.pop_to_base_level();
+        s.propagate(false);
+        if (s.inconsistent())
+            return l_false;
+        report rpt(*this);
+        m_cube.reset();
+        split(cubes);
+        // failed literals at the base level are kept.
+        if (s.inconsistent())
+            return l_false;
+        return cubes.empty() ? l_false : l_undef;
+    }
+
+    void lookahead::updt_params(params_ref const & _p) {
+        sat_params p(_p);
+        m_cube_depth     = p.lookahead_cube_depth();
+        m_num_candidates = p.lookahead_candidates();
+        if (m_num_candidates == 0)
+            m_num_candidates = 1;
+    }
+
+    void lookahead::collect_statistics(statistics & st) const {
+        st.update("lookahead cubes", m_num_cubes);
+        st.update("lookahead failed literals", m_num_failed);
+        st.update("lookahead refuted branches", m_num_refuted);
+    }
+
+    void lookahead::reset_statistics() {
+        m_num_cubes   = 0;
+        m_num_failed  = 0;
+        m_num_refuted = 0;
+    }
+};
@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.h
+
+Abstract:
+
+    Lookahead based cuber for cube and conquer.
+
+    The search space is split into cubes (conjunctions of literals) using
+    a lookahead procedure: at every node, each candidate variable is
+    assigned to true and false, and the branching variable is the one that
+    maximizes the product of the number of implied literals in both
+    branches. Failed literals are asserted on the way, and branches that
+    are refuted by propagation do not produce cubes.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#ifndef _SAT_LOOKAHEAD_H_
+#define _SAT_LOOKAHEAD_H_
+
+#include"sat_types.h"
+#include"params.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class lookahead {
+        solver &        s;
+        literal_vector  m_cube;        // decisions on the current branch
+        bool_var_vector m_candidates;
+        unsigned_vector m_occs;        // number of watches of candidate variables
+
+        // config
+        unsigned        m_cube_depth;
+        unsigned        m_num_candidates;
+
+        // stats
+        unsigned        m_num_cubes;
+        unsigned        m_num_failed;
+        unsigned        m_num_refuted;
+
+        struct report;
+
+        unsigned try_lit(literal l);
+        void collect_candidates();
+        bool_var select();
+        void split(vector<literal_vector> & cubes);
+
+    public:
+        lookahead(solver & s, params_ref const & p);
+
+        /**
+           \brief Split the search space of the solver into cubes.
+           The solver must not be tracking assumptions.
+           Return l_false if the problem was refuted by lookahead, and l_undef otherwise.
+        */
+        lbool operator()(vector<literal_vector> & cubes);
+
+        unsigned cube_depth() const { return m_cube_depth; }
+
+        void updt_params(params_ref const & p);
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
+    };
+
+};
+
+#endif
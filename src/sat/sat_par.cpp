@@ -0,0 +1,80 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_par.cpp
+
+Abstract:
+
+    Clause exchange for a portfolio of SAT solvers running in parallel.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#include"sat_par.h"
+#include"z3_omp.h"
+
+namespace sat {
+
+    par::par(unsigned num_solvers):
+        m_max_pool_size(1 << 20) {
+        m_heads.resize(num_solvers, 0);
+    }
+
+    void par::share_clause(unsigned owner, unsigned num_lits, literal const * lits) {
+        SASSERT(owner < num_solvers());
+        #pragma omp critical (par_sat)
+        {
+            if (m_pool.size() + num_lits + 2 <= m_max_pool_size) {
+                m_pool.push_back(owner);
+                m_pool.push_back(num_lits);
+                for (unsigned i = 0; i < num_lits; i++)
+                    m_pool.push_back(lits[i].index());
+            }
+        }
+    }
+
+    void par::get_clauses(unsigned owner, unsigned_vector & r) {
+        SASSERT(owner < num_solvers());
+        r.reset();
+        #pragma omp critical (par_sat)
+        {
+            unsigned i  = m_heads[owner];
+            unsigned sz = m_pool.size();
+            while (i < sz) {
+                unsigned num_lits = m_pool[i+1];
+                if (m_pool[i] != owner) {
+                    r.push_back(num_lits);
+                    for (unsigned j = 0; j < num_lits; j++)
+                        r.push_back(m_pool[i + 2 + j]);
+                }
+                i += num_lits + 2;
+            }
+            m_heads[owner] = sz;
+            compact();
+        }
+    }
+
+    /**
+       \brief Remove the prefix of m_pool that was already imported by all solvers.
+    */
+    void par::compact() {
+        unsigned min_head = UINT_MAX;
+        for (unsigned i = 0; i < m_heads.size(); i++)
+            min_head = std::min(min_head, m_heads[i]);
+        if (min_head == 0 || 2 * min_head < m_pool.size())
+            return;
+        unsigned sz = m_pool.size();
+        for (unsigned i = min_head; i < sz; i++)
+            m_pool[i - min_head] = m_pool[i];
+        m_pool.shrink(sz - min_head);
+        for (unsigned i = 0; i < m_heads.size(); i++)
+            m_heads[i] -= min_head;
+    }
+
+};
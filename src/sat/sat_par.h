@@ -0,0 +1,59 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_par.h
+
+Abstract:
+
+    Clause exchange for a portfolio of SAT solvers running in parallel.
+
+    Each solver exports short learned clauses with small glue, and
+    imports the clauses exported by the other solvers when it restarts.
+    The exchange is protected by an OpenMP critical section, the
+    solvers only access it when they learn a clause that is worth
+    sharing or restart, so there is little contention.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#ifndef _SAT_PAR_H_
+#define _SAT_PAR_H_
+
+#include"sat_types.h"
+
+namespace sat {
+
+    class par {
+        // exported clauses, each entry is: owner, number of literals, literal indices.
+        unsigned_vector m_pool;
+        // position in m_pool of the next clause to be imported by each solver.
+        unsigned_vector m_heads;
+        unsigned        m_max_pool_size;
+        void compact();
+    public:
+        par(unsigned num_solvers);
+
+        unsigned num_solvers() const { return m_heads.size(); }
+
+        /**
+           \brief Export a clause learned by solver owner.
+           The clause is dropped if the other solvers are lagging behind.
+        */
+        void share_clause(unsigned owner, unsigned num_lits, literal const * lits);
+
+        /**
+           \brief Store in r the clauses exported by the other solvers since the last
+           call for owner. Each clause is stored as its size followed by the literals.
+        */
+        void get_clauses(unsigned owner, unsigned_vector & r);
+    };
+
+};
+
+#endif
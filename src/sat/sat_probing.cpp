@@ -66,6 +66,8 @@ namespace sat {
             literal_vector::iterator end = implied_lits->end();
             for (; it != end; ++it) {
                 if (m_assigned.contains(*it)) {
+                    if (s.m_config.m_drat)
+                        s.m_drat.add(~l, *it);
                     s.assign(*it, justification());
                     m_num_assigned++;
                 }
@@ -99,6 +101,9 @@ namespace sat {
             literal_vector::iterator it  = m_to_assert.begin();
             literal_vector::iterator end = m_to_assert.end();
             for (; it != end; ++it) {
+                // *it is implied by l and by the literal probed before l.
+                if (s.m_config.m_drat)
+                    s.m_drat.add(~l, *it);
                 s.assign(*it, justification());
                 m_num_assigned++;
             }
@@ -246,7 +251,8 @@ namespace sat {
     void probing::updt_params(params_ref const & p) {
         m_probing             = p.get_bool("probing", true);
         m_probing_limit       = p.get_uint("probing_limit", 5000000);
-        m_probing_cache       = p.get_bool("probing_cache", true);
+        // cached implications may depend on deleted clauses, and cannot be justified in DRAT proofs.
+        m_probing_cache       = p.get_bool("probing_cache", true) && !s.m_config.m_drat;
         m_probing_binary      = p.get_bool("probing_binary", true);
         m_probing_cache_limit = megabytes_to_bytes(p.get_uint("probing_chache_limit", 1024));
     }
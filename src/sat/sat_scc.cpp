@@ -173,6 +173,9 @@ namespace sat {
                             l2_idx = s[j];
                             j--;
                             if (to_literal(l2_idx) == ~l) {
+                                // ~l implies l, and l implies ~l
+                                if (m_solver.m_config.m_drat)
+                                    m_solver.m_drat.add(l);
                                 m_solver.set_conflict(justification());
                                 return 0;
                             }
@@ -179,17 +179,15 @@ namespace sat {
 
         bool vars_eliminated = m_num_elim_vars > old_num_elim_vars;
 
-        if (!m_need_cleanup) {
+        if (!m_need_cleanup && !vars_eliminated) {
             TRACE("after_simplifier", tout << "skipping cleanup...\n";);
-            if (vars_eliminated) {
-                // must remove learned clauses with eliminated variables
-                cleanup_clauses(s.m_learned, true, true, learned_in_use_lists);
-            }
             CASSERT("sat_solver", s.check_invariant());
             TRACE("after_simplifier", s.display(tout); tout << "model_converter:\n"; s.m_mc.display(tout););
             free_memory();
             return;
         }
+        // cleanup_clauses attaches the clauses it keeps, so the watches must be removed first.
+        // This is also needed when only learned clauses with eliminated variables must be removed.
         TRACE("after_simplifier", tout << "cleanning watches...\n";);
         cleanup_watches();
         cleanup_clauses(s.m_learned, true, vars_eliminated,  learned_in_use_lists);
@@ -529,7 +527,8 @@ namespace sat {
             literal l = c[i];
             switch (value(l)) {
             case l_undef:
-                c[j] = l;
+                // swap instead of copy, so that c still contains its original literals when it is shrunk.
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             case l_false:
@@ -542,12 +541,12 @@ namespace sat {
                 break;
             case l_true:
                 r = true;
-                c[j] = l;
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             }
         }
-        c.shrink(j);
+        s.shrink_clause(c, j);
         return r;
     }
 
@@ -616,7 +615,15 @@ namespace sat {
         m_need_cleanup = true;
         m_num_elim_lits++;
         insert_todo(l.var());
-        c.elim(l);
+        if (s.m_config.m_drat) {
+            literal_vector old_lits(c.size(), c.begin());
+            c.elim(l);
+            s.m_drat.add(c);
+            s.m_drat.del(old_lits.size(), old_lits.c_ptr());
+        }
+        else {
+            c.elim(l);
+        }
         clause_use_list & occurs = m_use_list.get(l);
         occurs.erase_not_removed(c);
         m_sub_counter -= occurs.size()/2;
@@ -1379,6 +1386,8 @@ namespace sat {
                     break;
                 case 2:
                     s.m_stats.m_mk_bin_clause++;
+                    if (s.m_config.m_drat)
+                        s.m_drat.add(m_new_cls[0], m_new_cls[1]);
                     add_non_learned_binary_clause(m_new_cls[0], m_new_cls[1]);
                     back_subsumption1(m_new_cls[0], m_new_cls[1], false);
                     break;
@@ -1387,6 +1396,8 @@ namespace sat {
                         s.m_stats.m_mk_ter_clause++;
                     else
                         s.m_stats.m_mk_clause++;
+                    if (s.m_config.m_drat)
+                        s.m_drat.add(m_new_cls.size(), m_new_cls.c_ptr());
                     clause * new_c = s.m_cls_allocator.mk_clause(m_new_cls.size(), m_new_cls.c_ptr(), false);
                     s.m_clauses.push_back(new_c);
                     m_use_list.insert(*new_c);
@@ -20,6 +20,8 @@ Revision History:
 #include"sat_integrity_checker.h"
 #include"luby.h"
 #include"trace.h"
+#include"z3_omp.h"
+#include"scoped_ptr_vector.h"
 
 // define to update glue during propagation
 #define UPDATE_GLUE
@@ -39,14 +41,28 @@ namespace sat {
         m_scc(*this, p),
         m_asymm_branch(*this, p),
         m_probing(*this, p),
+        m_vivify(*this, p),
+        m_lookahead(*this, p),
         m_inconsistent(false),
         m_num_frozen(0),
         m_activity_inc(128),
         m_case_split_queue(m_activity),
         m_qhead(0),
         m_scope_lvl(0),
-        m_params(p) {
+        m_params(p),
+        m_par(0),
+        m_par_id(0),
+        m_par_cancel(false) {
         updt_params(p);
+        if (ext)
+            ext->set_solver(this);
+    }
+
+    void solver::set_extension(extension * ext) {
+        SASSERT(!m_ext);
+        m_ext = ext;
+        if (ext)
+            ext->set_solver(this);
     }
 
     solver::~solver() {
@@ -60,22 +76,44 @@ namespace sat {
         }
     }
 
+    /**
+       \brief Remove the literals at positions >= new_sz from c.
+       The shorter clause is added to the DRAT proof, and the original one deleted.
+    */
+    void solver::shrink_clause(clause & c, unsigned new_sz) {
+        SASSERT(new_sz <= c.size());
+        if (m_config.m_drat && new_sz < c.size()) {
+            m_drat.add(new_sz, c.begin());
+            m_drat.del(c);
+        }
+        c.shrink(new_sz);
+    }
+
     void solver::copy(solver const & src) {
-        SASSERT(m_mc.empty() && src.m_mc.empty());
+        SASSERT(m_mc.empty());
+        SASSERT(src.scope_lvl() == 0);
         // create new vars
         if (num_vars() < src.num_vars()) {
             for (bool_var v = num_vars(); v < src.num_vars(); v++) {
-                SASSERT(!src.was_eliminated(v));
                 bool ext  = src.m_external[v] != 0;
-                bool dvar = src.m_decision[v] != 0;
+                bool dvar = src.m_decision[v] != 0 && !src.was_eliminated(v);
                 bool_var new_v = mk_var(ext, dvar);
                 SASSERT(v == new_v);
             }
         }
+        {
+            // copy units
+            literal_vector::const_iterator it  = src.m_trail.begin();
+            literal_vector::const_iterator end = src.m_trail.end();
+            for (; it != end; ++it) {
+                literal l = *it;
+                mk_clause(1, &l);
+            }
+        }
         {
             // copy binary clauses
             vector<watch_list>::const_iterator it  = src.m_watches.begin();
-            vector<watch_list>::const_iterator end = src.m_watches.begin();
+            vector<watch_list>::const_iterator end = src.m_watches.end();
             for (unsigned l_idx = 0; it != end; ++it, ++l_idx) {
                 watch_list const & wlist = *it;
                 literal l = ~to_literal(l_idx);
@@ -85,7 +123,9 @@ namespace sat {
                     if (!it2->is_binary_non_learned_clause())
                         continue;
                     literal l2 = it2->get_literal();
-                    mk_clause(l, l2);
+                    // each binary clause occurs in two watch lists
+                    if (l.index() < l2.index())
+                        mk_clause(l, l2);
                 }
             }
         }
@@ -154,15 +194,23 @@ namespace sat {
     }
 
     clause * solver::mk_clause_core(unsigned num_lits, literal * lits, bool learned) {
+        // input clauses are in the original problem, and are not logged in the proof unless simplified.
+        bool log = learned;
         if (!learned) {
             TRACE("sat_mk_clause", tout << "mk_clause: " << mk_lits_pp(num_lits, lits) << "\n";);
+            unsigned old_num_lits = num_lits;
             bool keep = simplify_clause(num_lits, lits);
             TRACE("sat_mk_clause", tout << "mk_clause (after simp), keep: " << keep << "\n" << mk_lits_pp(num_lits, lits) << "\n";);
             if (!keep) {
                 return 0; // clause is equivalent to true.
             }
+            log = num_lits < old_num_lits;
         }
 
+        // units and binary clauses are logged by assign and mk_bin_clause.
+        if (m_config.m_drat && log && num_lits > 2)
+            m_drat.add(num_lits, lits);
+
         switch (num_lits) {
         case 0:
             set_conflict(justification());
@@ -181,6 +229,8 @@ namespace sat {
     }
 
     void solver::mk_bin_clause(literal l1, literal l2, bool learned) {
+        if (m_config.m_drat)
+            m_drat.add(l1, l2);
         if (propagate_bin_clause(l1, l2)) {
             if (scope_lvl() == 0)
                 return;
@@ -462,13 +512,18 @@ namespace sat {
         m_inconsistent = true;
         m_conflict = c;
         m_not_l    = not_l;
+        if (m_config.m_drat && scope_lvl() == 0)
+            m_drat.add();
     }
 
     void solver::assign_core(literal l, justification j) {
         SASSERT(value(l) == l_undef);
         TRACE("sat_assign_core", tout << l << "\n";);
-        if (scope_lvl() == 0)
+        if (scope_lvl() == 0) {
             j = justification(); // erase justification for level 0
+            if (m_config.m_drat)
+                m_drat.add(l);
+        }
         m_assignment[l.index()]    = l_true;
         m_assignment[(~l).index()] = l_false;
         bool_var v = l.var();
@@ -650,14 +705,17 @@ namespace sat {
                 case watched::EXT_CONSTRAINT:
                     SASSERT(m_ext);
                     m_ext->propagate(l, it->get_ext_constraint_idx(), keep);
-                    if (keep) {
-                        *it2 = *it;
-                        it2++;
-                    }
                     if (m_inconsistent) {
+                        // CONFLICT_CLEANUP copies the current watch, skip it if it must be removed.
+                        if (!keep)
+                            ++it;
                         CONFLICT_CLEANUP();
                         return false;
                     }
+                    if (keep) {
+                        *it2 = *it;
+                        it2++;
+                    }
                     break;
                 default:
                     UNREACHABLE();
@@ -682,8 +740,16 @@ namespace sat {
     // Search
     //
     // -----------------------
-    lbool solver::check() {
+    lbool solver::check(unsigned num_lits, literal const * lits) {
+        pop_to_base_level();
         SASSERT(scope_lvl() == 0);
+        m_assumptions.reset();
+        m_assumption_set.reset();
+        m_core.reset();
+        if (use_cubes(num_lits))
+            return check_cubes();
+        if (use_par())
+            return check_par(num_lits, lits);
 #ifdef CLONE_BEFORE_SOLVING
         if (m_mc.empty()) {
             m_clone = alloc(solver, m_params, 0 /* do not clone extension */);
@@ -696,11 +762,18 @@ namespace sat {
             propagate(false);
             if (inconsistent()) return l_false;
             cleanup();
+            init_assumptions(num_lits, lits);
+            if (check_inconsistent()) return l_false;
             if (m_config.m_max_conflicts > 0 && m_config.m_burst_search > 0) {
                 m_restart_threshold = m_config.m_burst_search;
                 lbool r = bounded_search();
                 if (r != l_undef)
                     return r;
+                if (m_conflicts > m_config.m_max_conflicts) {
+                    // do not pay for simplify_problem if the budget is already exhausted.
+                    IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "\"abort: max-conflicts = " << m_conflicts << "\"\n";);
+                    return l_undef;
+                }
                 pop(scope_lvl());
                 m_conflicts_since_restart = 0;
                 m_restart_threshold       = m_config.m_restart_initial;
@@ -710,6 +783,8 @@ namespace sat {
             simplify_problem();
 
             if (inconsistent()) return l_false;
+            reinit_assumptions();
+            if (check_inconsistent()) return l_false;
             m_next_simplify = m_config.m_restart_initial * m_config.m_simplify_mult1;
 
             if (m_config.m_max_conflicts == 0) {
@@ -730,8 +805,21 @@ namespace sat {
                 }
 
                 restart();
+                import_par_clauses();
+                reinit_assumptions();
+                if (check_inconsistent()) return l_false;
+                if (m_config.m_inprocess_interval > 0 && m_conflicts >= m_next_inprocess) {
+                    inprocess();
+                    if (inconsistent()) return l_false;
+                    reinit_assumptions();
+                    if (check_inconsistent()) return l_false;
+                }
                 if (m_conflicts >= m_next_simplify) {
+                    pop(scope_lvl());
                     simplify_problem();
+                    if (inconsistent()) return l_false;
+                    reinit_assumptions();
+                    if (check_inconsistent()) return l_false;
                     m_next_simplify = static_cast<unsigned>(m_conflicts * m_config.m_simplify_mult2);
                     if (m_next_simplify > m_conflicts + m_config.m_simplify_max)
                         m_next_simplify = m_conflicts + m_config.m_simplify_max;
@@ -744,6 +832,302 @@ namespace sat {
         }
     }
 
+    // -----------------------
+    //
+    // Parallel portfolio
+    //
+    // -----------------------
+
+    bool solver::use_par() const {
+#ifdef _NO_OMP_
+        return false;
+#else
+        // extensions cannot be copied, and nested parallelism is not supported.
+        // the proof of a portfolio cannot be written to a single DRAT file.
+        return m_config.m_num_threads > 1 && !m_par && !m_ext && !m_config.m_drat && !inconsistent() && 0 == omp_in_parallel();
+#endif
+    }
+
+    /**
+       \brief Run m_config.m_num_threads solvers in parallel. This solver is one of them, the other
+       ones are copies using different random seeds, phase selection and restart strategies.
+       The solvers exchange short learned clauses, and the first one to finish cancels the others.
+    */
+    lbool solver::check_par(unsigned num_lits, literal const * lits) {
+        SASSERT(scope_lvl() == 0);
+        int num_threads = static_cast<int>(m_config.m_num_threads);
+        symbol phases[3] = { m_config.m_always_false, m_config.m_random, m_config.m_caching };
+        par p(num_threads);
+        scoped_ptr_vector<solver> solvers;
+        for (int i = 1; i < num_threads; i++) {
+            params_ref ps(m_params);
+            ps.set_uint("threads", 1);
+            ps.set_uint("random_seed", m_config.m_random_seed + i);
+            ps.set_sym("phase", phases[i % 3]);
+            ps.set_sym("restart", i % 2 == 0 ? m_config.m_luby : m_config.m_geometric);
+            solver * s = alloc(solver, ps, 0);
+            s->copy(*this);
+            s->set_par(&p, i);
+            solvers.push_back(s);
+        }
+        set_par(&p, 0);
+
+        int         finished_id = -1;
+        lbool       result      = l_undef;
+        bool        has_ex      = false;
+        std::string ex_msg;
+        #pragma omp parallel for num_threads(num_threads)
+        for (int i = 0; i < num_threads; i++) {
+            solver & s = i == 0 ? *this : *(solvers[i-1]);
+            bool first = false;
+            bool stop  = false;
+            try {
+                lbool r = s.check(num_lits, lits);
+                if (r != l_undef) {
+                    #pragma omp critical (par_solver)
+                    {
+                        if (finished_id == -1) {
+                            finished_id = i;
+                            result = r;
+                            first = true;
+                        }
+                    }
+                    stop = first;
+                }
+            }
+            catch (z3_exception & ex) {
+                // exceptions of canceled solvers are ignored.
+                #pragma omp critical (par_solver)
+                {
+                    if (finished_id == -1 && !has_ex) {
+                        has_ex = true;
+                        ex_msg = ex.msg();
+                        stop = true;
+                    }
+                }
+            }
+            if (stop) {
+                for (int j = 0; j < num_threads; j++) {
+                    if (i != j)
+                        (j == 0 ? *this : *(solvers[j-1])).m_par_cancel = true;
+                }
+            }
+        }
+        set_par(0, 0);
+        m_par_cancel = false;
+        if (finished_id == -1 && has_ex)
+            throw solver_exception(ex_msg.c_str());
+        if (finished_id > 0) {
+            IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat.par :winner " << finished_id << ")\n";);
+            solver & s = *(solvers[finished_id-1]);
+            pop_to_base_level();
+            if (result == l_true) {
+                import_model(s);
+            }
+            else {
+                m_core.reset();
+                m_core.append(s.get_core());
+                if (num_lits == 0)
+                    set_conflict(justification());
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Use the model of src, a solver created using copy(*this).
+       Variables eliminated in this solver are assigned by its model converter.
+    */
+    void solver::import_model(solver const & src) {
+        model const & md = src.get_model();
+        m_model.reset();
+        m_model.resize(num_vars(), l_undef);
+        for (bool_var v = 0; v < num_vars(); v++) {
+            if (!was_eliminated(v))
+                m_model[v] = md[v];
+        }
+        m_mc(m_model);
+    }
+
+    // -----------------------
+    //
+    // Cube and conquer
+    //
+    // -----------------------
+
+    lbool solver::cube(vector<literal_vector> & cubes) {
+        pop_to_base_level();
+        m_assumptions.reset();
+        m_assumption_set.reset();
+        if (inconsistent())
+            return l_false;
+        lbool r = m_lookahead(cubes);
+        if (r == l_false && !inconsistent())
+            set_conflict(justification());
+        return r;
+    }
+
+    bool solver::use_cubes(unsigned num_lits) const {
+        // cubes are not combined with assumptions.
+        return m_lookahead.cube_depth() > 0 && num_lits == 0 && !m_par && !m_ext && !m_config.m_drat && !inconsistent();
+    }
+
+    /**
+       \brief Split the problem into cubes using lookahead, and solve each cube as
+       assumptions using m_config.m_num_threads solvers: this solver and copies of it.
+       The solvers exchange learned clauses, so lemmas learned for one cube are used in the others.
+    */
+    lbool solver::check_cubes() {
+        vector<literal_vector> cubes;
+        if (cube(cubes) == l_false)
+            return l_false;
+        unsigned num_workers = std::max(1u, std::min(m_config.m_num_threads, cubes.size()));
+#ifdef _NO_OMP_
+        num_workers = 1;
+#else
+        if (omp_in_parallel())
+            num_workers = 1;
+#endif
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat.cube :cubes " << cubes.size() << " :workers " << num_workers << ")\n";);
+        par p(num_workers);
+        scoped_ptr_vector<solver> copies;
+        ptr_vector<solver>        workers;
+        workers.push_back(this);
+        for (unsigned i = 1; i < num_workers; i++) {
+            params_ref ps(m_params);
+            ps.set_uint("threads", 1);
+            ps.set_uint("lookahead.cube_depth", 0);
+            ps.set_uint("random_seed", m_config.m_random_seed + i);
+            solver * s = alloc(solver, ps, 0);
+            s->copy(*this);
+            copies.push_back(s);
+            workers.push_back(s);
+        }
+        // the clause exchange also prevents this solver from splitting again.
+        for (unsigned i = 0; i < num_workers; i++)
+            workers[i]->set_par(&p, i);
+
+        unsigned    next_cube = 0;
+        int         sat_id    = -1;
+        bool        is_unsat  = false;
+        bool        is_undef  = false;
+        bool        has_ex    = false;
+        std::string ex_msg;
+        #pragma omp parallel for num_threads(num_workers)
+        for (int i = 0; i < static_cast<int>(num_workers); i++) {
+            solver & s = *(workers[i]);
+            bool stop  = false;
+            try {
+                while (!stop) {
+                    unsigned idx = UINT_MAX;
+                    #pragma omp critical (par_solver)
+                    {
+                        if (sat_id == -1 && !is_unsat && !has_ex && next_cube < cubes.size())
+                            idx = next_cube++;
+                    }
+                    if (idx == UINT_MAX)
+                        break;
+                    literal_vector const & c = cubes[idx];
+                    lbool r = s.check(c.size(), c.c_ptr());
+                    #pragma omp critical (par_solver)
+                    {
+                        if (r == l_true && sat_id == -1 && !is_unsat) {
+                            sat_id = i;
+                            stop   = true;
+                        }
+                        else if (r == l_false && s.get_core().empty() && sat_id == -1 && !is_unsat) {
+                            // the conflict does not depend on the cube.
+                            is_unsat = true;
+                            stop     = true;
+                        }
+                        else if (r == l_undef) {
+                            is_undef = true;
+                        }
+                    }
+                }
+            }
+            catch (z3_exception & ex) {
+                // exceptions of canceled solvers are ignored.
+                #pragma omp critical (par_solver)
+                {
+                    if (sat_id == -1 && !is_unsat && !has_ex) {
+                        has_ex = true;
+                        ex_msg = ex.msg();
+                        stop   = true;
+                    }
+                }
+            }
+            if (stop) {
+                for (unsigned j = 0; j < num_workers; j++) {
+                    if (static_cast<unsigned>(i) != j)
+                        workers[j]->m_par_cancel = true;
+                }
+            }
+        }
+        set_par(0, 0);
+        m_par_cancel = false;
+        if (sat_id != -1) {
+            if (sat_id > 0)
+                import_model(*(workers[sat_id]));
+            return l_true;
+        }
+        pop_to_base_level();
+        m_assumptions.reset();
+        m_assumption_set.reset();
+        m_core.reset();
+        if (has_ex)
+            throw solver_exception(ex_msg.c_str());
+        if (is_undef && !is_unsat)
+            return l_undef;
+        // all cubes were refuted.
+        set_conflict(justification());
+        return l_false;
+    }
+
+    /**
+       \brief Import the clauses exported by the other solvers of the portfolio.
+       Clauses that contain variables eliminated by this solver are ignored.
+    */
+    void solver::import_par_clauses() {
+        if (!m_par)
+            return;
+        m_par->get_clauses(m_par_id, m_par_clauses);
+        if (m_par_clauses.empty())
+            return;
+        pop_to_base_level();
+        literal_vector lits;
+        unsigned i  = 0;
+        unsigned sz = m_par_clauses.size();
+        while (i < sz && !inconsistent()) {
+            unsigned num_lits = m_par_clauses[i++];
+            bool keep = true;
+            lits.reset();
+            for (unsigned j = 0; keep && j < num_lits; j++) {
+                literal l = to_literal(m_par_clauses[i + j]);
+                if (l.var() >= num_vars() || was_eliminated(l.var())) {
+                    keep = false;
+                    continue;
+                }
+                switch (value(l)) {
+                case l_true:
+                    keep = false;
+                    break;
+                case l_false:
+                    break;
+                case l_undef:
+                    lits.push_back(l);
+                    break;
+                }
+            }
+            i += num_lits;
+            if (!keep)
+                continue;
+            clause * c = mk_clause_core(lits.size(), lits.c_ptr(), true);
+            if (c)
+                c->set_glue(lits.size());
+        }
+    }
+
     bool_var solver::next_var() {
         bool_var next;
 
@@ -815,7 +1199,7 @@ namespace sat {
                     return l_false;
                 if (m_conflicts > m_config.m_max_conflicts)
                     return l_undef;
-                if (m_conflicts_since_restart > m_restart_threshold)
+                if (should_restart())
                     return l_undef;
                 if (scope_lvl() == 0) {
                     cleanup(); // cleaner may propagate frozen clauses
@@ -823,6 +1207,11 @@ namespace sat {
                         return l_false;
                     gc();
                 }
+                if (scope_lvl() < search_lvl()) {
+                    // a unit lemma was learned, assumptions must be asserted again.
+                    // a conflict is detected by propagate in the next iteration.
+                    reinit_assumptions();
+                }
             }
 
             gc();
@@ -847,6 +1236,165 @@ namespace sat {
         }
     }
 
+    // -----------------------
+    //
+    // Assumptions
+    //
+    // -----------------------
+
+    void solver::init_assumptions(unsigned num_lits, literal const * lits) {
+        SASSERT(scope_lvl() == 0);
+        for (unsigned i = 0; i < num_lits; i++) {
+            literal l = lits[i];
+            SASSERT(l.var() < num_vars());
+            SASSERT(!was_eliminated(l.var()));
+            // assumptions must survive simplification
+            m_external[l.var()] = true;
+            if (is_assumption(l))
+                continue;
+            m_assumptions.push_back(l);
+            m_assumption_set.insert(l);
+        }
+        TRACE("sat_assumptions", tout << "assumptions: " << m_assumptions << "\n";);
+        reinit_assumptions();
+    }
+
+    /**
+       \brief Assert the assumptions in a new scope.
+       The scope is only created if the solver is at the base level and consistent.
+    */
+    void solver::reinit_assumptions() {
+        if (!tracking_assumptions() || scope_lvl() > 0 || inconsistent())
+            return;
+        propagate(false);
+        if (inconsistent())
+            return;
+        push();
+        literal_vector::const_iterator it  = m_assumptions.begin();
+        literal_vector::const_iterator end = m_assumptions.end();
+        for (; it != end && !inconsistent(); ++it) {
+            literal l = *it;
+            switch (value(l)) {
+            case l_true:
+                break;
+            case l_false:
+                set_conflict(justification(), ~l);
+                break;
+            case l_undef:
+                assign_core(l, justification());
+                break;
+            }
+        }
+        if (!inconsistent())
+            propagate(false);
+    }
+
+    /**
+       \brief Return true if the solver is inconsistent. If assumptions are
+       being tracked, the unsat core is also computed.
+    */
+    bool solver::check_inconsistent() {
+        if (!inconsistent())
+            return false;
+        if (tracking_assumptions())
+            resolve_conflict_for_unsat_core();
+        return true;
+    }
+
+    void solver::process_antecedent_for_unsat_core(literal antecedent) {
+        bool_var var = antecedent.var();
+        if (!is_marked(var) && lvl(var) > 0) {
+            mark(var);
+            m_unmark.push_back(var);
+        }
+    }
+
+    void solver::process_consequent_for_unsat_core(literal consequent, justification const & js) {
+        switch (js.get_kind()) {
+        case justification::NONE:
+            break;
+        case justification::BINARY:
+            process_antecedent_for_unsat_core(~(js.get_literal()));
+            break;
+        case justification::TERNARY:
+            process_antecedent_for_unsat_core(~(js.get_literal1()));
+            process_antecedent_for_unsat_core(~(js.get_literal2()));
+            break;
+        case justification::CLAUSE: {
+            clause & c = *(m_cls_allocator.get_clause(js.get_clause_offset()));
+            unsigned i = 0;
+            if (consequent != null_literal) {
+                SASSERT(c[0] == consequent || c[1] == consequent);
+                if (c[0] == consequent) {
+                    i = 1;
+                }
+                else {
+                    process_antecedent_for_unsat_core(~c[0]);
+                    i = 2;
+                }
+            }
+            unsigned sz = c.size();
+            for (; i < sz; i++)
+                process_antecedent_for_unsat_core(~c[i]);
+            break;
+        }
+        case justification::EXT_JUSTIFICATION: {
+            fill_ext_antecedents(consequent, js);
+            literal_vector::iterator it  = m_ext_antecedents.begin();
+            literal_vector::iterator end = m_ext_antecedents.end();
+            for (; it != end; ++it)
+                process_antecedent_for_unsat_core(*it);
+            break;
+        }
+        default:
+            UNREACHABLE();
+            break;
+        }
+    }
+
+    /**
+       \brief Compute the subset of the assumptions that is responsible for
+       the current conflict. It is stored at m_core.
+       
+       The conflict is traced back on the trail. Every marked literal assigned
+       above the base level is either an assumption or has a justification that
+       is expanded.
+    */
+    void solver::resolve_conflict_for_unsat_core() {
+        SASSERT(inconsistent());
+        m_core.reset();
+        if (!tracking_assumptions())
+            return;
+        m_unmark.reset();
+        if (m_not_l != null_literal) {
+            process_antecedent_for_unsat_core(m_not_l);
+            // the assumption ~m_not_l was already assigned to false
+            if (m_conflict.get_kind() == justification::NONE && is_assumption(~m_not_l))
+                m_core.push_back(~m_not_l);
+        }
+        process_consequent_for_unsat_core(m_not_l, m_conflict);
+
+        unsigned idx = m_trail.size();
+        unsigned lim = m_scopes.empty() ? m_trail.size() : m_scopes[0].m_trail_lim;
+        while (idx > lim) {
+            --idx;
+            literal l  = m_trail[idx];
+            bool_var v = l.var();
+            if (!is_marked(v))
+                continue;
+            justification js = m_justification[v];
+            if (js.get_kind() == justification::NONE) {
+                if (is_assumption(l))
+                    m_core.push_back(l);
+            }
+            else {
+                process_consequent_for_unsat_core(l, js);
+            }
+        }
+        reset_unmark(0);
+        TRACE("sat_unsat_core", tout << "core: " << m_core << "\n";);
+    }
+
     void solver::init_search() {
         m_phase_counter           = 0;
         m_phase_cache_on          = false;
@@ -858,6 +1406,11 @@ namespace sat {
         m_gc_threshold            = m_config.m_gc_initial;
         m_min_d_tk                = 1.0;
         m_next_simplify           = 0;
+        m_next_inprocess          = m_config.m_inprocess_interval;
+        m_last_inprocess          = num_propagations();
+        m_fast_glue_avg           = 0;
+        m_slow_glue_avg           = 0;
+        m_trail_avg               = 0;
         m_stopwatch.reset();
         m_stopwatch.start();
         TRACE("sat", display(tout););
@@ -902,6 +1455,24 @@ namespace sat {
         }
     }
 
+    /**
+       \brief Cheap simplifications interleaved with the search between calls to simplify_problem.
+       The effort of a round, measured in propagations, is at most sat.inprocess.ratio times the
+       number of propagations of the search since the last round. Each pass also adjusts its own
+       frequency to the number of clauses and literals it eliminates.
+    */
+    void solver::inprocess() {
+        m_next_inprocess = m_conflicts + m_config.m_inprocess_interval;
+        double budget = m_config.m_inprocess_ratio * (num_propagations() - m_last_inprocess);
+        pop(scope_lvl());
+        m_vivify(static_cast<unsigned>(std::min(budget, static_cast<double>(UINT_MAX))));
+        CASSERT("sat_missed_prop", check_missed_propagation());
+        CASSERT("sat_simplify_bug", check_invariant());
+        if (m_ext)
+            m_ext->clauses_modifed();
+        m_last_inprocess = num_propagations();
+    }
+
     void solver::sort_watch_lits() {
         vector<watch_list>::iterator it  = m_watches.begin();
         vector<watch_list>::iterator end = m_watches.end();
@@ -982,7 +1553,8 @@ namespace sat {
                    << " :restarts " << m_stats.m_restart << mk_stat(*this)
                    << " :time " << std::fixed << std::setprecision(2) << m_stopwatch.get_current_seconds() << ")\n";);
         IF_VERBOSE(30, display_status(verbose_stream()););
-        pop(scope_lvl());
+        if (scope_lvl() > search_lvl())
+            pop(scope_lvl() - search_lvl());
         m_conflicts_since_restart = 0;
         switch (m_config.m_restart) {
         case RS_GEOMETRIC:
@@ -992,6 +1564,9 @@ namespace sat {
             m_luby_idx++;
             m_restart_threshold = m_config.m_restart_initial * get_luby(m_luby_idx);
             break;
+        case RS_EMA:
+            // the threshold is only a lower bound, see should_restart.
+            break;
         default:
             UNREACHABLE();
             break;
@@ -999,6 +1574,44 @@ namespace sat {
         CASSERT("sat_restart", check_invariant());
     }
 
+    /**
+       \brief Return true if the search should be restarted.
+       For ema restarts, restart when the recent lemmas are of worse quality (larger glue)
+       than the lemmas learned so far.
+    */
+    bool solver::should_restart() const {
+        if (m_conflicts_since_restart <= m_restart_threshold)
+            return false;
+        if (m_config.m_restart != RS_EMA)
+            return true;
+        return m_fast_glue_avg > m_config.m_restart_margin * m_slow_glue_avg;
+    }
+
+    static void update_avg(double & avg, double decay, double value, unsigned n) {
+        // use the plain average for the first conflicts, so that the averages do not start biased towards 0.
+        if (decay < 1.0 / n)
+            decay = 1.0 / n;
+        avg += decay * (value - avg);
+    }
+
+    /**
+       \brief Update the moving averages used by ema restarts with the glue of a new lemma.
+       Restarts are blocked (postponed) when the trail is much larger than usual, since the
+       solver is then likely approaching a satisfying assignment.
+    */
+    void solver::update_restart_avgs(unsigned glue) {
+        update_avg(m_fast_glue_avg, m_config.m_restart_fast_glue, glue, m_conflicts);
+        update_avg(m_slow_glue_avg, m_config.m_restart_slow_glue, glue, m_conflicts);
+        if (m_config.m_restart_blocking > 0 &&
+            m_conflicts > m_config.m_restart_blocking_min &&
+            m_conflicts_since_restart > m_restart_threshold &&
+            m_trail.size() > m_config.m_restart_blocking * m_trail_avg) {
+            m_stats.m_blocked_restart++;
+            m_conflicts_since_restart = 0;
+        }
+        update_avg(m_trail_avg, 1.0 / 5000, m_trail.size(), m_conflicts);
+    }
+
     // -----------------------
     //
     // GC
@@ -1027,6 +1640,9 @@ namespace sat {
                 return;
             gc_dyn_psm();
             break;
+        case GC_TIERED:
+            gc_tiered();
+            break;
         default:
             UNREACHABLE();
             break;
@@ -1121,8 +1737,15 @@ namespace sat {
        \brief GC (the second) half of the clauses in the database.
     */
     void solver::gc_half(char const * st_name) {
+        gc_suffix(m_learned.size()/2, st_name);
+    }
+
+    /**
+       \brief GC the clauses in m_learned[start, m_learned.size()).
+    */
+    void solver::gc_suffix(unsigned start, char const * st_name) {
         unsigned sz     = m_learned.size();
-        unsigned new_sz = sz/2;
+        unsigned new_sz = start;
         unsigned j      = new_sz;
         for (unsigned i = new_sz; i < sz; i++) {
             clause & c = *(m_learned[i]);
@@ -1235,6 +1858,43 @@ namespace sat {
                    " :frozen " << frozen << " :activated " << activated << " :deleted " << deleted << ")\n";);
     }
 
+    /**
+       \brief Use gc based on three tiers of learned clauses:
+       - core: clauses with glue <= gc.tier1_glue are never deleted.
+       - tier2: clauses with glue <= gc.tier2_glue are kept while they are used in one of the last gc.k rounds.
+       - local: the remaining clauses. Clauses used since the last round are kept, and the worst half of the
+         others is deleted.
+       Only the local clauses that are candidates for deletion are partially sorted.
+    */
+    void solver::gc_tiered() {
+        unsigned sz = m_learned.size();
+        unsigned j  = 0;
+        for (unsigned i = 0; i < sz; i++) {
+            clause & c = *(m_learned[i]);
+            bool keep;
+            if (c.glue() <= m_config.m_gc_tier1_glue) {
+                keep = true;
+            }
+            else if (c.was_used()) {
+                c.unmark_used();
+                c.reset_inact_rounds();
+                keep = true;
+            }
+            else {
+                c.inc_inact_rounds();
+                keep = c.glue() <= m_config.m_gc_tier2_glue && c.inact_rounds() <= m_config.m_gc_k;
+            }
+            if (keep) {
+                std::swap(m_learned[i], m_learned[j]);
+                j++;
+            }
+        }
+        // m_learned[j, sz) contains the deletion candidates, the best half of them is kept.
+        unsigned mid = j + (sz - j)/2;
+        std::nth_element(m_learned.begin() + j, m_learned.begin() + mid, m_learned.end(), glue_lt());
+        gc_suffix(mid, "tiered");
+    }
+
     // return true if should keep the clause, and false if we should delete it.
     bool solver::activate_frozen_clause(clause & c) {
         TRACE("sat_gc", tout << "reactivating:\n" << c << "\n";);
@@ -1250,7 +1910,8 @@ namespace sat {
             case l_false:
                 break;
             case l_undef:
-                c[j] = c[i];
+                // swap instead of copy, so that c still contains its original literals when it is deleted.
+                std::swap(c[j], c[i]);
                 j++;
                 break;
             }
@@ -1268,7 +1929,7 @@ namespace sat {
             mk_bin_clause(c[0], c[1], true);
             return false;
         default:
-            c.shrink(new_sz);
+            shrink_clause(c, new_sz);
             attach_clause(c);
             return true;
         }
@@ -1321,8 +1982,11 @@ namespace sat {
         m_conflicts_since_gc++;
 
         m_conflict_lvl = get_max_lvl(m_not_l, m_conflict);
-        if (m_conflict_lvl == 0)
+        if (m_conflict_lvl <= search_lvl()) {
+            // conflict does not depend on decisions.
+            resolve_conflict_for_unsat_core();
             return false;
+        }
         m_lemma.reset();
 
         forget_phase_of_vars(m_conflict_lvl);
@@ -1425,6 +2089,8 @@ namespace sat {
         }
 
         unsigned glue = num_diff_levels(m_lemma.size(), m_lemma.c_ptr());
+        if (m_config.m_restart == RS_EMA)
+            update_restart_avgs(glue);
 
         pop(m_scope_lvl - new_scope_lvl);
         TRACE("sat_conflict_detail", display(tout); tout << "assignment:\n"; display_assignment(tout););
@@ -1432,6 +2098,8 @@ namespace sat {
         if (lemma) {
             lemma->set_glue(glue);
         }
+        if (m_par && m_lemma.size() <= m_config.m_share_size && glue <= m_config.m_share_glue)
+            m_par->share_clause(m_par_id, m_lemma.size(), m_lemma.c_ptr());
         decay_activity();
         updt_phase_counters();
         return true;
@@ -1969,8 +2637,12 @@ namespace sat {
         m_simplifier.updt_params(p);
         m_asymm_branch.updt_params(p);
         m_probing.updt_params(p);
+        m_vivify.updt_params(p);
+        m_lookahead.updt_params(p);
         m_scc.updt_params(p);
         m_rand.set_seed(m_config.m_random_seed);
+        if (m_config.m_drat && !m_drat.is_open())
+            m_drat.open(m_config.m_drat_file.bare_str(), m_config.m_drat_binary);
     }
 
     void solver::collect_param_descrs(param_descrs & d) {
@@ -1978,6 +2650,7 @@ namespace sat {
         simplifier::collect_param_descrs(d);
         asymm_branch::collect_param_descrs(d);
         probing::collect_param_descrs(d);
+        vivify::collect_param_descrs(d);
         scc::collect_param_descrs(d);
     }
 
@@ -1992,6 +2665,11 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        m_vivify.collect_statistics(st);
+        m_lookahead.collect_statistics(st);
+        m_drat.collect_statistics(st);
+        if (m_ext)
+            m_ext->collect_statistics(st);
     }
 
     void solver::reset_statistics() {
@@ -2000,6 +2678,9 @@ namespace sat {
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        m_vivify.reset_statistics();
+        m_lookahead.reset_statistics();
+        m_drat.reset_statistics();
     }
 
     // -----------------------
@@ -2350,6 +3031,7 @@ namespace sat {
         st.update("binary propagations", m_bin_propagate);
         st.update("ternary propagations", m_ter_propagate);
         st.update("restarts", m_restart);
+        st.update("blocked restarts", m_blocked_restart);
         st.update("minimized lits", m_minimized_lits);
         st.update("dyn subsumption resolution", m_dyn_sub_res);
     }
@@ -2365,6 +3047,7 @@ namespace sat {
         m_ter_propagate = 0;
         m_decision = 0;
         m_restart = 0;
+        m_blocked_restart = 0;
         m_gc_clause = 0;
         m_del_clause = 0;
         m_minimized_lits = 0;
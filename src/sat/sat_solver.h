@@ -30,8 +30,12 @@ Revision History:
 #include"sat_simplifier.h"
 #include"sat_scc.h"
 #include"sat_asymm_branch.h"
+#include"sat_vivify.h"
 #include"sat_iff3_finder.h"
 #include"sat_probing.h"
+#include"sat_par.h"
+#include"sat_lookahead.h"
+#include"sat_drat.h"
 #include"params.h"
 #include"statistics.h"
 #include"stopwatch.h"
@@ -53,6 +57,7 @@ namespace sat {
         unsigned m_ter_propagate;
         unsigned m_decision;
         unsigned m_restart;
+        unsigned m_blocked_restart;
         unsigned m_gc_clause;
         unsigned m_del_clause;
         unsigned m_minimized_lits;
@@ -69,7 +74,7 @@ namespace sat {
         volatile bool           m_cancel;
         config                  m_config;
         stats                   m_stats;
-        extension *             m_ext;
+        scoped_ptr<extension>   m_ext;
         random_gen              m_rand;
         clause_allocator        m_cls_allocator;
         cleaner                 m_cleaner;
@@ -79,6 +84,9 @@ namespace sat {
         scc                     m_scc;
         asymm_branch            m_asymm_branch;
         probing                 m_probing;
+        vivify                  m_vivify;
+        lookahead               m_lookahead;
+        drat                    m_drat;   // proof output, see sat.drat.file
         bool                    m_inconsistent;
         // A conflict is usually a single justification. That is, a justification
         // for false. If m_not_l is not null_literal, then m_conflict is a
@@ -118,6 +126,9 @@ namespace sat {
         stopwatch               m_stopwatch;
         params_ref              m_params;
         scoped_ptr<solver>      m_clone; // for debugging purposes
+        par *                   m_par;    // clause exchange, when the solver is part of a parallel portfolio
+        unsigned                m_par_id;
+        volatile bool           m_par_cancel; // set by the portfolio to stop this solver, the caller uses m_cancel
 
         void del_clauses(clause * const * begin, clause * const * end);
 
@@ -127,13 +138,27 @@ namespace sat {
         friend class scc;
         friend class elim_eqs;
         friend class asymm_branch;
+        friend class vivify;
         friend class probing;
+        friend class lookahead;
         friend class iff3_finder;
         friend struct mk_stat;
+        friend class card_extension;
     public:
+        /**
+           \brief Create a SAT solver. The solver takes ownership of the extension ext (if it is not 0).
+        */
         solver(params_ref const & p, extension * ext);
         ~solver();
 
+        /**
+           \brief Install the extension ext. The solver takes ownership of it.
+           
+           \pre The solver does not have an extension yet.
+        */
+        void set_extension(extension * ext);
+        extension * get_extension() const { return m_ext.get(); }
+
         // -----------------------
         //
         // Misc
@@ -148,10 +173,11 @@ namespace sat {
         void display_status(std::ostream & out) const;
         
         /**
-           \brief Copy (non learned) clauses from src to this solver.
-           Create missing variables if needed.
+           \brief Copy (non learned) clauses and the units at the base level from src to this solver.
+           Create missing variables if needed, variables eliminated in src are not
+           decision variables in this solver.
            
-           \pre the model converter of src and this must be empty
+           \pre the model converter of this must be empty, and src is at the base level
         */
         void copy(solver const & src);
         
@@ -166,7 +192,8 @@ namespace sat {
         void mk_clause(literal l1, literal l2, literal l3);
 
     protected:
-        void del_clause(clause & c) { m_cls_allocator.del_clause(&c); m_stats.m_del_clause++; }
+        void del_clause(clause & c) { if (m_config.m_drat) m_drat.del(c); m_cls_allocator.del_clause(&c); m_stats.m_del_clause++; }
+        void shrink_clause(clause & c, unsigned new_sz);
         clause * mk_clause_core(unsigned num_lits, literal * lits, bool learned);
         void mk_bin_clause(literal l1, literal l2, bool learned);
         bool propagate_bin_clause(literal l1, literal l2);
@@ -198,6 +225,7 @@ namespace sat {
         bool inconsistent() const { return m_inconsistent; }
         unsigned num_vars() const { return m_level.size(); }
         bool is_external(bool_var v) const { return m_external[v] != 0; }
+        void set_external(bool_var v) { m_external[v] = true; }
         bool was_eliminated(bool_var v) const { return m_eliminated[v] != 0; }
         unsigned scope_lvl() const { return m_scope_lvl; }
         lbool value(literal l) const { return m_assignment[l.index()]; }
@@ -218,7 +246,7 @@ namespace sat {
         lbool status(clause const & c) const;
         clause_offset get_offset(clause const & c) const { return m_cls_allocator.get_offset(&c); }
         void checkpoint() {
-            if (m_cancel) throw solver_exception(Z3_CANCELED_MSG);
+            if (m_cancel || m_par_cancel) throw solver_exception(Z3_CANCELED_MSG);
             if (memory::get_allocation_size() > m_config.m_max_memory) throw solver_exception(Z3_MAX_MEMORY_MSG);
         }
     protected:
@@ -250,9 +278,30 @@ namespace sat {
         //
         // -----------------------
     public:
-        lbool check();
+        /**
+           \brief Check satisfiability of the clause database under the given assumptions.
+           If the result is l_false, then get_core() contains a subset of the assumptions
+           that is inconsistent with the clause database.
+           Learned clauses are preserved between calls.
+
+           \remark the variables in the assumptions are marked as external, and
+           are not eliminated by the simplifier.
+        */
+        lbool check(unsigned num_lits = 0, literal const * lits = 0);
         model const & get_model() const { return m_model; }
         model_converter const & get_model_converter() const { return m_mc; }
+        literal_vector const & get_core() const { return m_core; }
+
+        /**
+           \brief Attach the solver to the clause exchange p as solver id, or detach it if p is 0.
+        */
+        void set_par(par * p, unsigned id) { m_par = p; m_par_id = id; }
+
+        /**
+           \brief Split the search space into cubes using lookahead, see sat.lookahead.cube_depth.
+           Return l_false if the problem is unsatisfiable, and l_undef otherwise.
+        */
+        lbool cube(vector<literal_vector> & cubes);
 
     protected:
         unsigned m_conflicts;
@@ -263,16 +312,62 @@ namespace sat {
         unsigned m_gc_threshold;
         double   m_min_d_tk;
         unsigned m_next_simplify;
+        unsigned m_next_inprocess;
+        unsigned m_last_inprocess; // number of propagations at the end of the last round of inprocessing
+        double   m_fast_glue_avg; // moving averages used by ema restarts
+        double   m_slow_glue_avg;
+        double   m_trail_avg;
         bool decide();
         bool_var next_var();
         lbool bounded_search();
         void init_search();
         void simplify_problem();
+        void inprocess();
+        unsigned num_propagations() const { return m_stats.m_propagate + m_stats.m_bin_propagate + m_stats.m_ter_propagate; }
         void mk_model();
         bool check_model(model const & m) const;
         void restart();
+        bool should_restart() const;
+        void update_restart_avgs(unsigned glue);
         void sort_watch_lits();
 
+        // -----------------------
+        //
+        // Parallel portfolio
+        //
+        // -----------------------
+    protected:
+        unsigned_vector m_par_clauses;
+        bool use_par() const;
+        lbool check_par(unsigned num_lits, literal const * lits);
+        void import_par_clauses();
+        void import_model(solver const & src);
+        bool use_cubes(unsigned num_lits) const;
+        lbool check_cubes();
+
+        // -----------------------
+        //
+        // Assumptions
+        //
+        // -----------------------
+    protected:
+        literal_vector m_assumptions;
+        literal_set    m_assumption_set;
+        literal_vector m_core;
+        /**
+           \brief Assumptions are asserted at scope level 1. The search never
+           backtracks below this level while assumptions are being tracked.
+        */
+        unsigned search_lvl() const { return m_assumptions.empty() ? 0 : 1; }
+        bool tracking_assumptions() const { return !m_assumptions.empty(); }
+        bool is_assumption(literal l) const { return m_assumption_set.contains(l); }
+        void init_assumptions(unsigned num_lits, literal const * lits);
+        void reinit_assumptions();
+        bool check_inconsistent();
+        void resolve_conflict_for_unsat_core();
+        void process_antecedent_for_unsat_core(literal antecedent);
+        void process_consequent_for_unsat_core(literal consequent, justification const & js);
+
         // -----------------------
         //
         // GC
@@ -286,14 +381,23 @@ namespace sat {
         void gc_psm_glue();
         void save_psm();
         void gc_half(char const * st_name);
+        void gc_suffix(unsigned start, char const * st_name);
         void gc_dyn_psm();
+        void gc_tiered();
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
+        bool is_ter_reason(clause const & c) const {
+            for (unsigned i = 0; i < 3; i++) {
+                if (value(c[i]) == l_true && m_justification[c[i].var()].is_ternary_clause())
+                    return true;
+            }
+            return false;
+        }
         bool can_delete(clause const & c) const {
             if (c.on_reinit_stack())
                 return false;
             if (c.size() == 3)
-                return true; // not needed to justify anything.
+                return !m_config.m_drat || !is_ter_reason(c); // not needed to justify anything, but DRAT checkers need the reason.
             literal l0 = c[0];
             if (value(l0) != l_true)
                 return true;
@@ -342,6 +446,7 @@ namespace sat {
     public:
         void push();
         void pop(unsigned num_scopes);
+        void pop_to_base_level() { pop(scope_lvl()); }
 
     protected:
         void unassign_vars(unsigned old_sz);
@@ -0,0 +1,368 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    inc_sat_solver.cpp
+
+Abstract:
+
+    Incremental solver based on the SAT solver.
+
+    Assertions are bit-blasted and converted into clauses lazily, when
+    check_sat is invoked. The bit-blaster and the mapping from atoms to
+    Boolean variables are preserved between calls. Thus, the SAT solver
+    keeps its learned clauses from one query to the next.
+
+    Backtracking points are implemented using "scope guards". The
+    assertions in a scope are guarded by a fresh Boolean constant g,
+    that is, a formula f is asserted as (or (not g) f), and g is
+    used as an extra assumption in check_sat. When the scope is popped,
+    the unit clause (not g) is asserted.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+    The solver returns unknown if the assertions contain atoms that
+    cannot be handled by the bit-blaster (e.g., arithmetic atoms).
+
+--*/
+#include"inc_sat_solver.h"
+#include"solver_na2as.h"
+#include"tactic.h"
+#include"goal2sat.h"
+#include"sat_solver.h"
+#include"th_rewriter.h"
+#include"bit_blaster_rewriter.h"
+#include"bit_blaster_model_converter.h"
+#include"filter_model_converter.h"
+#include"ast_smt2_pp.h"
+#include"model_v2_pp.h"
+
+class inc_sat_solver : public solver_na2as {
+    ast_manager &               m;
+    params_ref                  m_params;
+    sat::solver                 m_solver;
+    goal2sat                    m_goal2sat;
+    th_rewriter                 m_simp;
+    bit_blaster_rewriter        m_bb;
+    atom2bool_var               m_map;
+    // assertion stack, m_fmls[0 .. m_fmls_head) were already converted into clauses.
+    expr_ref_vector             m_fmls;
+    unsigned                    m_fmls_head;
+    unsigned_vector             m_fmls_lim;
+    expr_ref_vector             m_scope_guards;
+    // proxies for assumptions that are not literals.
+    obj_map<expr, expr*>        m_proxies;
+    expr_ref_vector             m_pinned;
+    ref<filter_model_converter> m_fmc;
+    // assumptions of the last check_sat call.
+    sat::literal_vector         m_asms;
+    u_map<expr*>                m_lit2asm;
+    expr_ref_vector             m_core;
+    model_ref                   m_model;
+    statistics                  m_stats;
+    std::string                 m_unknown;
+
+    static params_ref simp_params(params_ref const & p) {
+        params_ref r = p;
+        r.set_bool("elim_and", true);
+        r.set_bool("blast_distinct", true);
+        return r;
+    }
+
+public:
+    inc_sat_solver(ast_manager & _m, params_ref const & p):
+        solver_na2as(_m),
+        m(_m),
+        m_params(p),
+        m_solver(p, 0),
+        m_simp(_m, simp_params(p)),
+        m_bb(_m, p),
+        m_map(_m),
+        m_fmls(_m),
+        m_fmls_head(0),
+        m_scope_guards(_m),
+        m_pinned(_m),
+        m_core(_m),
+        m_unknown("no reason given") {
+        m_fmc = alloc(filter_model_converter, _m);
+    }
+
+    virtual ~inc_sat_solver() {}
+
+    virtual void updt_params(params_ref const & p) {
+        m_params = p;
+        m_solver.updt_params(p);
+        m_simp.updt_params(simp_params(p));
+        m_bb.updt_params(p);
+    }
+
+    virtual void collect_param_descrs(param_descrs & r) {
+        goal2sat::collect_param_descrs(r);
+        sat::solver::collect_param_descrs(r);
+    }
+
+    virtual void assert_expr(expr * t) {
+        TRACE("inc_sat", tout << mk_ismt2_pp(t, m) << "\n";);
+        m_fmls.push_back(t);
+    }
+
+    virtual void push_core() {
+        m_fmls_lim.push_back(m_fmls.size());
+        app * g = m.mk_fresh_const("scope", m.mk_bool_sort());
+        m_scope_guards.push_back(g);
+        m_fmc->insert(g->get_decl());
+    }
+
+    virtual void pop_core(unsigned n) {
+        SASSERT(n <= m_fmls_lim.size());
+        m_solver.pop_to_base_level();
+        while (n > 0) {
+            unsigned lim = m_fmls_lim.back();
+            m_fmls.shrink(lim);
+            if (m_fmls_head > lim)
+                m_fmls_head = lim;
+            // disable the clauses of the scope
+            expr * g = m_scope_guards.back();
+            sat::bool_var v = m_map.to_bool_var(g);
+            if (v != sat::null_bool_var) {
+                sat::literal l(v, true);
+                m_solver.mk_clause(1, &l);
+            }
+            m_scope_guards.pop_back();
+            m_fmls_lim.pop_back();
+            --n;
+        }
+    }
+
+    virtual lbool check_sat_core(unsigned num_assumptions, expr * const * assumptions) {
+        m_model = 0;
+        m_core.reset();
+        m_unknown = "no reason given";
+        lbool r = l_undef;
+        try {
+            internalize_formulas();
+            internalize_assumptions(num_assumptions, assumptions);
+            if (m_map.interpreted_atoms()) {
+                m_unknown = "formula contains interpreted atoms";
+            }
+            else {
+                IF_VERBOSE(TACTIC_VERBOSITY_LVL, m_solver.display_status(verbose_stream()););
+                r = m_solver.check(m_asms.size(), m_asms.c_ptr());
+            }
+        }
+        catch (sat::solver_exception & ex) {
+            m_unknown = ex.msg();
+        }
+        catch (tactic_exception & ex) {
+            m_unknown = ex.msg();
+        }
+        catch (rewriter_exception & ex) {
+            m_unknown = ex.msg();
+        }
+        if (r == l_false)
+            extract_core();
+        m_stats.reset();
+        m_solver.collect_statistics(m_stats);
+        set_status(r);
+        return r;
+    }
+
+    virtual void set_cancel(bool f) {
+        m_solver.set_cancel(f);
+        m_goal2sat.set_cancel(f);
+        m_simp.set_cancel(f);
+        m_bb.set_cancel(f);
+    }
+
+    virtual void collect_statistics(statistics & st) const {
+        st.copy(m_stats);
+    }
+
+    virtual void get_unsat_core(ptr_vector<expr> & r) {
+        r.append(m_core.size(), m_core.c_ptr());
+    }
+
+    virtual void get_model(model_ref & md) {
+        if (status() == l_true && !m_model)
+            extract_model();
+        md = m_model;
+    }
+
+    virtual proof * get_proof() {
+        return 0;
+    }
+
+    virtual std::string reason_unknown() const {
+        return m_unknown;
+    }
+
+    virtual void get_labels(svector<symbol> & r) {}
+
+    virtual void set_progress_callback(progress_callback * callback) {}
+
+    virtual unsigned get_num_assertions() const {
+        return m_fmls.size();
+    }
+
+    virtual expr * get_assertion(unsigned idx) const {
+        return m_fmls.get(idx);
+    }
+
+    virtual void display(std::ostream & out) const {
+        unsigned num = m_fmls.size();
+        out << "(solver";
+        for (unsigned i = 0; i < num; i++) {
+            out << "\n  " << mk_ismt2_pp(m_fmls.get(i), m, 2);
+        }
+        out << ")";
+    }
+
+private:
+
+    /**
+       \brief Bit-blast t, and store the result in g.
+       If guard is not null, then the result is guarded by it.
+    */
+    void preprocess(expr * t, expr * guard, goal & g) {
+        expr_ref  r(m), bb(m);
+        proof_ref pr(m);
+        m_simp(t, r);
+        m_bb(r, bb, pr);
+        m_simp(bb, r);
+        if (guard != 0)
+            r = m.mk_or(m.mk_not(guard), r);
+        g.assert_expr(r);
+    }
+
+    /**
+       \brief Convert the new assertions into clauses.
+    */
+    void internalize_formulas() {
+        if (m_fmls_head == m_fmls.size())
+            return;
+        m_solver.pop_to_base_level();
+        goal g(m, false, false, false);
+        unsigned sz  = m_fmls.size();
+        unsigned lvl = 0;
+        for (unsigned i = m_fmls_head; i < sz; i++) {
+            // m_fmls[i] belongs to the innermost scope lvl s.t. m_fmls_lim[lvl-1] <= i
+            while (lvl < m_fmls_lim.size() && m_fmls_lim[lvl] <= i)
+                lvl++;
+            expr * guard = lvl == 0 ? 0 : m_scope_guards.get(lvl - 1);
+            preprocess(m_fmls.get(i), guard, g);
+        }
+        m_simp.cleanup();
+        m_bb.cleanup();
+        TRACE("inc_sat", g.display(tout););
+        m_goal2sat(g, m_params, m_solver, m_map, true);
+        m_fmls_head = sz;
+    }
+
+    /**
+       \brief Return a literal for the Boolean formula e.
+       If e is not a literal, then a proxy for it is created.
+    */
+    sat::literal mk_literal(expr * e) {
+        bool sign = false;
+        expr * arg;
+        while (m.is_not(e, arg)) {
+            sign = !sign;
+            e = arg;
+        }
+        if (!is_uninterp_const(e)) {
+            expr * p = 0;
+            if (!m_proxies.find(e, p)) {
+                app * q = m.mk_fresh_const("proxy", m.mk_bool_sort());
+                m_pinned.push_back(e);
+                m_pinned.push_back(q);
+                m_proxies.insert(e, q);
+                m_fmc->insert(q->get_decl());
+                goal g(m, false, false, false);
+                preprocess(m.mk_iff(q, e), 0, g);
+                m_goal2sat(g, m_params, m_solver, m_map, true);
+                p = q;
+            }
+            e = p;
+        }
+        sat::bool_var v = m_map.to_bool_var(e);
+        if (v == sat::null_bool_var) {
+            v = m_solver.mk_var(true);
+            m_map.insert(e, v);
+        }
+        return sat::literal(v, sign);
+    }
+
+    void internalize_assumptions(unsigned num_assumptions, expr * const * assumptions) {
+        m_solver.pop_to_base_level();
+        m_asms.reset();
+        m_lit2asm.reset();
+        unsigned num_guards = m_scope_guards.size();
+        for (unsigned i = 0; i < num_guards; i++) {
+            m_asms.push_back(mk_literal(m_scope_guards.get(i)));
+        }
+        for (unsigned i = 0; i < num_assumptions; i++) {
+            sat::literal l = mk_literal(assumptions[i]);
+            m_asms.push_back(l);
+            m_lit2asm.insert(l.index(), assumptions[i]);
+        }
+    }
+
+    void extract_core() {
+        sat::literal_vector const & core = m_solver.get_core();
+        for (unsigned i = 0; i < core.size(); i++) {
+            expr * a;
+            // scope guards are not reported
+            if (m_lit2asm.find(core[i].index(), a))
+                m_core.push_back(a);
+        }
+        TRACE("inc_sat", tout << "core:"; for (unsigned i = 0; i < m_core.size(); i++) tout << " " << mk_ismt2_pp(m_core.get(i), m); tout << "\n";);
+    }
+
+    void extract_model() {
+        model_ref md = alloc(model, m);
+        sat::model const & ll_m = m_solver.get_model();
+        atom2bool_var::iterator it  = m_map.begin();
+        atom2bool_var::iterator end = m_map.end();
+        for (; it != end; ++it) {
+            expr * n = it->m_key;
+            if (!is_uninterp_const(n))
+                continue;
+            switch (sat::value_at(it->m_value, ll_m)) {
+            case l_true:
+                md->register_decl(to_app(n)->get_decl(), m.mk_true());
+                break;
+            case l_false:
+                md->register_decl(to_app(n)->get_decl(), m.mk_false());
+                break;
+            default:
+                break;
+            }
+        }
+        model_converter_ref mc = concat(m_fmc.get(), mk_bit_blaster_model_converter(m, m_bb.const2bits()));
+        (*mc)(md, 0);
+        TRACE("inc_sat", model_v2_pp(tout, *md););
+        m_model = md;
+    }
+};
+
+solver * mk_inc_sat_solver(ast_manager & m, params_ref const & p) {
+    return alloc(inc_sat_solver, m, p);
+}
+
+class inc_sat_solver_factory : public solver_factory {
+public:
+    virtual ~inc_sat_solver_factory() {}
+
+    virtual solver * operator()(ast_manager & m, params_ref const & p, bool proofs_enabled, bool models_enabled, bool unsat_core_enabled, symbol const & logic) {
+        return mk_inc_sat_solver(m, p);
+    }
+};
+
+solver_factory * mk_inc_sat_solver_factory() {
+    return alloc(inc_sat_solver_factory);
+}
@@ -0,0 +1,31 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    inc_sat_solver.h
+
+Abstract:
+
+    Incremental solver based on the SAT solver.
+    Bit-vector formulas are bit-blasted incrementally, and the
+    same sat::solver (and its learned clauses) is reused by all
+    check_sat calls. Assumptions are handled natively by the SAT solver.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#ifndef _INC_SAT_SOLVER_H_
+#define _INC_SAT_SOLVER_H_
+
+#include"solver.h"
+
+solver * mk_inc_sat_solver(ast_manager & m, params_ref const & p);
+
+solver_factory * mk_inc_sat_solver_factory();
+
+#endif
@@ -0,0 +1,245 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.cpp
+
+Abstract:
+
+    SAT solver clause vivification.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#include"sat_vivify.h"
+#include"sat_vivify_params.hpp"
+#include"sat_solver.h"
+#include"stopwatch.h"
+#include"trace.h"
+
+namespace sat {
+
+    vivify::vivify(solver & _s, params_ref const & p):
+        s(_s) {
+        updt_params(p);
+        reset_statistics();
+    }
+
+    struct vivify::report {
+        vivify &  m_vivify;
+        stopwatch m_watch;
+        unsigned  m_elim_literals;
+        unsigned  m_elim_clauses;
+        report(vivify & v):
+            m_vivify(v),
+            m_elim_literals(v.m_elim_literals),
+            m_elim_clauses(v.m_elim_clauses) {
+            m_watch.start();
+        }
+
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(SAT_VB_LVL,
+                       verbose_stream() << " (sat-vivify :elim-literals "
+                       << (m_vivify.m_elim_literals - m_elim_literals)
+                       << " :elim-clauses " << (m_vivify.m_elim_clauses - m_elim_clauses)
+                       << mem_stat()
+                       << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
+        }
+    };
+
+    void vivify::operator()(unsigned budget) {
+        if (!m_vivify)
+            return;
+        s.propagate(false); // must propagate, since it uses s.push()
+        if (s.m_inconsistent)
+            return;
+        CASSERT("vivify", s.check_invariant());
+        report rpt(*this);
+        svector<char> saved_phase(s.m_phase);
+        budget = std::min(budget, m_vivify_limit);
+        unsigned start = s.num_propagations();
+        // the learned clauses get at most half of the budget, the irredundant clauses the rest.
+        run(s.m_learned, true, m_passes[1], budget / 2);
+        if (!s.inconsistent())
+            run(s.m_clauses, false, m_passes[0], budget - std::min(budget, s.num_propagations() - start));
+        s.m_phase = saved_phase;
+        CASSERT("vivify", s.check_invariant());
+    }
+
+    /**
+       \brief Vivify the clauses that were not vivified since the last complete round,
+       and update the schedule of the pass based on the number of literals and clauses eliminated.
+    */
+    void vivify::run(clause_vector & clauses, bool learned, pass & p, unsigned budget) {
+        if (p.m_delay > 0) {
+            p.m_delay--;
+            return;
+        }
+        unsigned elim      = m_elim_literals + m_elim_clauses;
+        unsigned limit     = s.num_propagations() + budget;
+        unsigned processed = 0;
+        bool     complete  = true;
+        SASSERT(s.m_qhead == s.m_trail.size());
+        clause_vector::iterator it  = clauses.begin();
+        clause_vector::iterator it2 = it;
+        clause_vector::iterator end = clauses.end();
+        try {
+            for (; it != end; ++it) {
+                clause & c = *(*it);
+                if (s.inconsistent() || c.vivified() || c.frozen() || (learned && c.glue() > m_learned_glue)) {
+                    *it2 = *it;
+                    ++it2;
+                    continue;
+                }
+                if (!complete || s.num_propagations() >= limit) {
+                    complete = false;
+                    *it2 = *it;
+                    ++it2;
+                    continue;
+                }
+                s.checkpoint();
+                c.set_vivified(true);
+                processed++;
+                if (!process(c))
+                    continue; // clause was removed
+                *it2 = *it;
+                ++it2;
+            }
+            clauses.set_end(it2);
+        }
+        catch (solver_exception & ex) {
+            // put clauses in a consistent state...
+            for (; it != end; ++it, ++it2) {
+                *it2 = *it;
+            }
+            clauses.set_end(it2);
+            throw ex;
+        }
+        if (complete) {
+            // all clauses were vivified, the next round starts from scratch.
+            for (it = clauses.begin(), end = clauses.end(); it != end; ++it)
+                (*it)->set_vivified(false);
+        }
+        TRACE("sat_vivify", tout << "learned: " << learned << " eliminated: " << (m_elim_literals + m_elim_clauses - elim)
+              << " complete: " << complete << " budget: " << budget << "\n";);
+        if (processed == 0) {
+            // the budget was exhausted before the pass started.
+            return;
+        }
+        if (m_elim_literals + m_elim_clauses > elim) {
+            p.m_backoff = 1;
+        }
+        else {
+            // the pass did not pay off, run it less often.
+            p.m_delay   = p.m_backoff;
+            p.m_backoff = std::min(2 * p.m_backoff, 64u);
+        }
+    }
+
+    /**
+       \brief Vivify c. Return false if c was deleted.
+    */
+    bool vivify::process(clause & c) {
+        TRACE("sat_vivify_detail", tout << "processing: " << c << "\n";);
+        SASSERT(s.scope_lvl() == 0);
+        SASSERT(s.m_qhead == s.m_trail.size());
+        SASSERT(!s.inconsistent());
+        unsigned sz = c.size();
+        for (unsigned i = 0; i < sz; i++) {
+            if (s.value(c[i]) == l_true) {
+                s.dettach_clause(c);
+                s.del_clause(c);
+                m_elim_clauses++;
+                return false;
+            }
+        }
+        // clause must not be used for propagation
+        s.dettach_clause(c);
+        s.push();
+        unsigned j    = 0;
+        bool     done = false;
+        for (unsigned i = 0; i < sz && !done; i++) {
+            literal l = c[i];
+            switch (s.value(l)) {
+            case l_true:
+                // l is implied by the negation of c[0], ..., c[j-1]
+                std::swap(c[j], c[i]);
+                j++;
+                done = true;
+                break;
+            case l_false:
+                // ~l is implied, l can be removed.
+                break;
+            case l_undef:
+                std::swap(c[j], c[i]);
+                j++;
+                if (i + 1 < sz) {
+                    s.assign(~l, justification());
+                    s.propagate_core(false); // must not use propagate(), since check_missed_propagation may fail for c
+                    done = s.inconsistent();
+                }
+                break;
+            }
+        }
+        s.pop(1);
+        SASSERT(!s.inconsistent());
+        SASSERT(s.m_qhead == s.m_trail.size());
+        if (j == sz) {
+            // clause can't be reduced.
+            s.attach_clause(c);
+            return true;
+        }
+        TRACE("sat_vivify", tout << c << "\nnew_size: " << j << "\n";);
+        m_elim_literals += sz - j;
+        switch (j) {
+        case 0:
+            s.set_conflict(justification());
+            s.del_clause(c);
+            return false;
+        case 1:
+            s.assign(c[0], justification());
+            s.del_clause(c);
+            s.propagate_core(false);
+            return false;
+        case 2:
+            SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
+            s.mk_bin_clause(c[0], c[1], c.is_learned());
+            s.del_clause(c);
+            return false;
+        default:
+            s.shrink_clause(c, j);
+            if (c.is_learned() && c.glue() > j)
+                c.set_glue(j);
+            s.attach_clause(c);
+            return true;
+        }
+    }
+
+    void vivify::updt_params(params_ref const & _p) {
+        sat_vivify_params p(_p);
+        m_vivify       = p.vivify();
+        m_vivify_limit = p.vivify_limit();
+        m_learned_glue = p.vivify_learned_glue();
+    }
+
+    void vivify::collect_param_descrs(param_descrs & d) {
+        sat_vivify_params::collect_param_descrs(d);
+    }
+
+    void vivify::collect_statistics(statistics & st) const {
+        st.update("vivify literals", m_elim_literals);
+        st.update("vivify clauses", m_elim_clauses);
+    }
+
+    void vivify::reset_statistics() {
+        m_elim_literals = 0;
+        m_elim_clauses  = 0;
+    }
+
+};
@@ -0,0 +1,84 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.h
+
+Abstract:
+
+    SAT solver clause vivification.
+
+    A clause l_1 or ... or l_n is vivified by assigning ~l_1, ~l_2, ...
+    and propagating (without using the clause itself):
+    - a literal that becomes false is removed from the clause,
+    - if a literal l_i becomes true, the clause is subsumed by l_1 or ... or l_i,
+    - if a conflict is found after assigning ~l_i, the clause is subsumed by l_1 or ... or l_i.
+
+    Learned and irredundant clauses are vivified in two separate passes.
+    The work of a round is bounded by a number of propagations, and passes
+    that do not pay off are run less often.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Revision History:
+
+--*/
+#ifndef _SAT_VIVIFY_H_
+#define _SAT_VIVIFY_H_
+
+#include"sat_types.h"
+#include"statistics.h"
+#include"params.h"
+
+namespace sat {
+    class solver;
+
+    class vivify {
+        struct report;
+
+        /**
+           \brief Schedule of a vivification pass.
+        */
+        struct pass {
+            unsigned m_delay;   // number of rounds to skip before the pass is run again
+            unsigned m_backoff; // delay used the next time the pass does not pay off
+            pass():m_delay(0), m_backoff(1) {}
+        };
+
+        solver & s;
+        pass     m_passes[2]; // irredundant and learned clauses
+
+        // config
+        bool     m_vivify;
+        unsigned m_vivify_limit;
+        unsigned m_learned_glue;
+
+        // stats
+        unsigned m_elim_literals;
+        unsigned m_elim_clauses;
+
+        void run(clause_vector & clauses, bool learned, pass & p, unsigned budget);
+        bool process(clause & c);
+    public:
+        vivify(solver & s, params_ref const & p);
+
+        /**
+           \brief Vivify the learned and irredundant clauses, unless
+           the corresponding pass is delayed. The solver must be at the base level.
+           The number of propagations is bounded by budget and sat.vivify.limit.
+        */
+        void operator()(unsigned budget);
+
+        void updt_params(params_ref const & p);
+        static void collect_param_descrs(param_descrs & d);
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
+    };
+
+};
+
+#endif
@@ -0,0 +1,992 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    bv2sat.cpp
+
+Abstract:
+
+    Bit-blast bit-vector atoms directly into a SAT solver.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+    The circuits follow bit_blaster_tpl (ripple carry adders, array
+    multiplier, restoring divider, barrel shifters), but the gates are
+    sat::literals. Each gate is simplified with respect to constant and
+    complementary inputs, normalized (input order and signs) and looked up
+    in a structural-hashing table before a new variable and its clauses
+    are created.
+
+--*/
+#include"bv2sat.h"
+#include"bv_decl_plugin.h"
+#include"ast_smt2_pp.h"
+#include"cooperate.h"
+#include"tactic.h"
+#include"hash.h"
+#include"map.h"
+
+struct bv2sat::imp {
+    enum gate_kind {
+        GATE_AND,
+        GATE_XOR,
+        GATE_XOR3,
+        GATE_MAJ,
+        GATE_ITE
+    };
+
+    struct gate {
+        unsigned m_kind;
+        unsigned m_a;
+        unsigned m_b;
+        unsigned m_c;
+        gate():m_kind(0), m_a(0), m_b(0), m_c(0) {}
+        gate(gate_kind k, sat::literal a, sat::literal b, sat::literal c = sat::null_literal):
+            m_kind(k), m_a(a.index()), m_b(b.index()), m_c(c.index()) {}
+
+        struct hash_proc {
+            unsigned operator()(gate const & g) const { return mk_mix(g.m_a, g.m_b, combine_hash(g.m_c, g.m_kind)); }
+        };
+
+        struct eq_proc {
+            bool operator()(gate const & g1, gate const & g2) const {
+                return g1.m_kind == g2.m_kind && g1.m_a == g2.m_a && g1.m_b == g2.m_b && g1.m_c == g2.m_c;
+            }
+        };
+    };
+
+    typedef map<gate, sat::literal, gate::hash_proc, gate::eq_proc> gate_table;
+
+    struct stats {
+        unsigned m_num_gates;
+        unsigned m_num_gate_hits;
+        unsigned m_num_clauses;
+        unsigned m_num_atoms;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    ast_manager &               m;
+    bv_util                     m_util;
+    sat::solver &               m_solver;
+    atom2bool_var &             m_map;
+    sat::literal                m_true;
+    gate_table                  m_gates;
+    // bit-vector term -> offset of its bits (least significant first) in m_bits
+    obj_map<expr, unsigned>     m_term2bits;
+    sat::literal_vector         m_bits;
+    obj_map<expr, sat::literal> m_bool2lit;
+    app_ref_vector              m_consts;
+    ptr_vector<expr>            m_todo;
+    stats                       m_stats;
+    unsigned long long          m_max_memory;
+    volatile bool               m_cancel;
+
+    imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map):
+        m(_m),
+        m_util(_m),
+        m_solver(s),
+        m_map(map),
+        m_consts(_m),
+        m_cancel(false) {
+        updt_params(p);
+    }
+
+    void updt_params(params_ref const & p) {
+        m_max_memory = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
+    }
+
+    void checkpoint() {
+        cooperate("bv2sat");
+        if (m_cancel)
+            throw tactic_exception(TACTIC_CANCELED_MSG);
+        if (memory::get_allocation_size() > m_max_memory)
+            throw tactic_exception(TACTIC_MAX_MEMORY_MSG);
+    }
+
+    // -----------------------------------
+    //
+    // Gates
+    //
+    // -----------------------------------
+
+    void mk_clause(sat::literal l1) {
+        m_stats.m_num_clauses++;
+        m_solver.mk_clause(1, &l1);
+    }
+
+    void mk_clause(sat::literal l1, sat::literal l2) {
+        m_stats.m_num_clauses++;
+        m_solver.mk_clause(l1, l2);
+    }
+
+    void mk_clause(sat::literal l1, sat::literal l2, sat::literal l3) {
+        m_stats.m_num_clauses++;
+        m_solver.mk_clause(l1, l2, l3);
+    }
+
+    void mk_clause(sat::literal l1, sat::literal l2, sat::literal l3, sat::literal l4) {
+        m_stats.m_num_clauses++;
+        sat::literal lits[4] = { l1, l2, l3, l4 };
+        m_solver.mk_clause(4, lits);
+    }
+
+    sat::literal mk_true() {
+        if (m_true == sat::null_literal) {
+            m_true = sat::literal(m_solver.mk_var(), false);
+            mk_clause(m_true);
+        }
+        return m_true;
+    }
+
+    sat::literal mk_false() { return ~mk_true(); }
+
+    bool is_true(sat::literal l) const { return m_true != sat::null_literal && l == m_true; }
+
+    bool is_false(sat::literal l) const { return m_true != sat::null_literal && l == ~m_true; }
+
+    bool is_const(sat::literal l) const { return m_true != sat::null_literal && l.var() == m_true.var(); }
+
+    sat::literal mk_gate_var() {
+        m_stats.m_num_gates++;
+        return sat::literal(m_solver.mk_var(), false);
+    }
+
+    bool find_gate(gate const & g, sat::literal & r) {
+        if (m_gates.find(g, r)) {
+            m_stats.m_num_gate_hits++;
+            return true;
+        }
+        return false;
+    }
+
+    static void sort3(sat::literal & a, sat::literal & b, sat::literal & c) {
+        if (b < a) std::swap(a, b);
+        if (c < b) std::swap(b, c);
+        if (b < a) std::swap(a, b);
+    }
+
+    sat::literal mk_and(sat::literal a, sat::literal b) {
+        if (is_false(a) || is_false(b))
+            return mk_false();
+        if (is_true(a) || a == b)
+            return b;
+        if (is_true(b))
+            return a;
+        if (a == ~b)
+            return mk_false();
+        if (b < a)
+            std::swap(a, b);
+        gate g(GATE_AND, a, b);
+        sat::literal r;
+        if (find_gate(g, r))
+            return r;
+        r = mk_gate_var();
+        mk_clause(~r, a);
+        mk_clause(~r, b);
+        mk_clause(r, ~a, ~b);
+        m_gates.insert(g, r);
+        return r;
+    }
+
+    sat::literal mk_or(sat::literal a, sat::literal b) {
+        return ~mk_and(~a, ~b);
+    }
+
+    sat::literal mk_and(unsigned num, sat::literal const * ls) {
+        sat::literal_vector args;
+        for (unsigned i = 0; i < num; i++) {
+            if (is_false(ls[i]))
+                return mk_false();
+            if (!is_true(ls[i]))
+                args.push_back(ls[i]);
+        }
+        switch (args.size()) {
+        case 0: return mk_true();
+        case 1: return args[0];
+        case 2: return mk_and(args[0], args[1]);
+        default: break;
+        }
+        sat::literal r = mk_gate_var();
+        sat::literal_vector cls;
+        cls.push_back(r);
+        for (unsigned i = 0; i < args.size(); i++) {
+            mk_clause(~r, args[i]);
+            cls.push_back(~args[i]);
+        }
+        m_stats.m_num_clauses++;
+        m_solver.mk_clause(cls.size(), cls.c_ptr());
+        return r;
+    }
+
+    sat::literal mk_or(unsigned num, sat::literal const * ls) {
+        sat::literal_vector args;
+        for (unsigned i = 0; i < num; i++)
+            args.push_back(~ls[i]);
+        return ~mk_and(args.size(), args.c_ptr());
+    }
+
+    sat::literal mk_xor(sat::literal a, sat::literal b) {
+        if (is_false(a)) return b;
+        if (is_true(a))  return ~b;
+        if (is_false(b)) return a;
+        if (is_true(b))  return ~a;
+        if (a == b)      return mk_false();
+        if (a == ~b)     return mk_true();
+        bool sign = a.sign() != b.sign();
+        a = a.unsign();
+        b = b.unsign();
+        if (b < a)
+            std::swap(a, b);
+        gate g(GATE_XOR, a, b);
+        sat::literal r;
+        if (!find_gate(g, r)) {
+            r = mk_gate_var();
+            mk_clause(~r, a, b);
+            mk_clause(~r, ~a, ~b);
+            mk_clause(r, ~a, b);
+            mk_clause(r, a, ~b);
+            m_gates.insert(g, r);
+        }
+        return sign ? ~r : r;
+    }
+
+    sat::literal mk_iff(sat::literal a, sat::literal b) {
+        return ~mk_xor(a, b);
+    }
+
+    sat::literal mk_xor3(sat::literal a, sat::literal b, sat::literal c) {
+        if (is_const(a) || is_const(b) || is_const(c) ||
+            a.var() == b.var() || a.var() == c.var() || b.var() == c.var())
+            return mk_xor(mk_xor(a, b), c);
+        bool sign = a.sign() != b.sign();
+        sign = sign != c.sign();
+        a = a.unsign();
+        b = b.unsign();
+        c = c.unsign();
+        sort3(a, b, c);
+        gate g(GATE_XOR3, a, b, c);
+        sat::literal r;
+        if (!find_gate(g, r)) {
+            r = mk_gate_var();
+            mk_clause(~r, a, b, c);
+            mk_clause(~r, ~a, ~b, c);
+            mk_clause(~r, ~a, b, ~c);
+            mk_clause(~r, a, ~b, ~c);
+            mk_clause(r, ~a, b, c);
+            mk_clause(r, a, ~b, c);
+            mk_clause(r, a, b, ~c);
+            mk_clause(r, ~a, ~b, ~c);
+            m_gates.insert(g, r);
+        }
+        return sign ? ~r : r;
+    }
+
+    /**
+       \brief Majority (carry) of three literals.
+    */
+    sat::literal mk_maj(sat::literal a, sat::literal b, sat::literal c) {
+        if (is_false(a)) return mk_and(b, c);
+        if (is_true(a))  return mk_or(b, c);
+        if (is_false(b)) return mk_and(a, c);
+        if (is_true(b))  return mk_or(a, c);
+        if (is_false(c)) return mk_and(a, b);
+        if (is_true(c))  return mk_or(a, b);
+        if (a == b || a == c) return a;
+        if (b == c)      return b;
+        if (a == ~b)     return c;
+        if (a == ~c)     return b;
+        if (b == ~c)     return a;
+        sort3(a, b, c);
+        gate g(GATE_MAJ, a, b, c);
+        sat::literal r;
+        if (find_gate(g, r))
+            return r;
+        r = mk_gate_var();
+        mk_clause(~a, ~b, r);
+        mk_clause(~a, ~c, r);
+        mk_clause(~b, ~c, r);
+        mk_clause(a, b, ~r);
+        mk_clause(a, c, ~r);
+        mk_clause(b, c, ~r);
+        m_gates.insert(g, r);
+        return r;
+    }
+
+    sat::literal mk_ite(sat::literal c, sat::literal t, sat::literal e) {
+        if (is_true(c) || t == e) return t;
+        if (is_false(c)) return e;
+        if (c.sign()) {
+            c = ~c;
+            std::swap(t, e);
+        }
+        if (is_true(t))  return mk_or(c, e);
+        if (is_false(t)) return mk_and(~c, e);
+        if (is_true(e))  return mk_or(~c, t);
+        if (is_false(e)) return mk_and(c, t);
+        if (t == ~e)     return mk_iff(c, t);
+        if (c == t)      return mk_or(c, e);
+        if (c == ~t)     return mk_and(~c, e);
+        if (c == e)      return mk_and(c, t);
+        if (c == ~e)     return mk_or(~c, t);
+        gate g(GATE_ITE, c, t, e);
+        sat::literal r;
+        if (find_gate(g, r))
+            return r;
+        r = mk_gate_var();
+        mk_clause(~c, ~t, r);
+        mk_clause(~c, t, ~r);
+        mk_clause(c, ~e, r);
+        mk_clause(c, e, ~r);
+        // redundant clauses that improve propagation
+        mk_clause(~t, ~e, r);
+        mk_clause(t, e, ~r);
+        m_gates.insert(g, r);
+        return r;
+    }
+
+    // -----------------------------------
+    //
+    // Circuits
+    //
+    // -----------------------------------
+
+    bool is_numeral(unsigned sz, sat::literal const * bits, rational & r) const {
+        r.reset();
+        for (unsigned i = 0; i < sz; i++) {
+            if (is_true(bits[i]))
+                r += rational::power_of_two(i);
+            else if (!is_false(bits[i]))
+                return false;
+        }
+        return true;
+    }
+
+    bool is_minus_one(unsigned sz, sat::literal const * bits) const {
+        for (unsigned i = 0; i < sz; i++)
+            if (!is_true(bits[i]))
+                return false;
+        return true;
+    }
+
+    void num2bits(rational const & v, unsigned sz, sat::literal_vector & out) {
+        SASSERT(v.is_nonneg());
+        rational aux = v;
+        rational two(2);
+        for (unsigned i = 0; i < sz; i++) {
+            out.push_back((aux % two).is_zero() ? mk_false() : mk_true());
+            aux = div(aux, two);
+        }
+    }
+
+    void mk_neg(unsigned sz, sat::literal const * a, sat::literal_vector & out) {
+        sat::literal cin = mk_true();
+        for (unsigned i = 0; i < sz; i++) {
+            out.push_back(mk_xor(~a[i], cin));
+            if (i < sz - 1)
+                cin = mk_and(~a[i], cin);
+        }
+    }
+
+    void mk_adder(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out) {
+        sat::literal cin = mk_false();
+        for (unsigned i = 0; i < sz; i++) {
+            out.push_back(mk_xor3(a[i], b[i], cin));
+            if (i < sz - 1)
+                cin = mk_maj(a[i], b[i], cin);
+        }
+    }
+
+    void mk_subtracter(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out, sat::literal & cout) {
+        sat::literal cin = mk_true();
+        for (unsigned i = 0; i < sz; i++) {
+            out.push_back(mk_xor3(a[i], ~b[i], cin));
+            cin = mk_maj(a[i], ~b[i], cin);
+        }
+        cout = cin;
+    }
+
+    /**
+       \brief Shift-and-add array multiplier. A constant operand is moved
+       to \c b, so that rows of zero bits vanish by constant propagation.
+    */
+    void mk_multiplier(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out) {
+        rational n_a, n_b;
+        if (is_numeral(sz, a, n_a))
+            std::swap(a, b);
+        if (is_minus_one(sz, b)) {
+            mk_neg(sz, a, out);
+            return;
+        }
+        if (is_numeral(sz, a, n_a) && is_numeral(sz, b, n_b)) {
+            num2bits(mod(n_a * n_b, rational::power_of_two(sz)), sz, out);
+            return;
+        }
+        sat::literal_vector acc;
+        for (unsigned j = 0; j < sz; j++)
+            acc.push_back(mk_and(a[j], b[0]));
+        for (unsigned i = 1; i < sz; i++) {
+            checkpoint();
+            if (is_false(b[i]))
+                continue;
+            sat::literal cin = mk_false();
+            for (unsigned j = i; j < sz; j++) {
+                sat::literal pp = mk_and(a[j - i], b[i]);
+                sat::literal s  = mk_xor3(acc[j], pp, cin);
+                if (j < sz - 1)
+                    cin = mk_maj(acc[j], pp, cin);
+                acc[j] = s;
+            }
+        }
+        out.append(acc);
+    }
+
+    void mk_udiv_urem(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & q, sat::literal_vector & r) {
+        // r is the residual of each stage of the division.
+        sat::literal_vector & p = r;
+        sat::literal_vector t;
+        p.push_back(a[sz - 1]);
+        for (unsigned i = 1; i < sz; i++)
+            p.push_back(mk_false());
+        q.resize(sz, sat::null_literal);
+        for (unsigned i = 0; i < sz; i++) {
+            checkpoint();
+            sat::literal qi;
+            t.reset();
+            mk_subtracter(sz, p.c_ptr(), b, t, qi);
+            q[sz - i - 1] = qi;
+            if (i < sz - 1) {
+                for (unsigned j = sz - 1; j > 0; j--)
+                    p[j] = mk_ite(qi, t[j - 1], p[j - 1]);
+                p[0] = a[sz - i - 2];
+            }
+            else {
+                for (unsigned j = 0; j < sz; j++)
+                    p[j] = mk_ite(qi, t[j], p[j]);
+            }
+        }
+    }
+
+    void mk_multiplexer(sat::literal c, unsigned sz, sat::literal const * t, sat::literal const * e, sat::literal_vector & out) {
+        for (unsigned i = 0; i < sz; i++)
+            out.push_back(mk_ite(c, t[i], e[i]));
+    }
+
+    void mk_abs(unsigned sz, sat::literal const * a, sat::literal_vector & out) {
+        sat::literal_vector neg_a;
+        mk_neg(sz, a, neg_a);
+        mk_multiplexer(a[sz - 1], sz, neg_a.c_ptr(), a, out);
+    }
+
+    void mk_sdiv(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out) {
+        sat::literal_vector abs_a, abs_b, q, r, neg_q;
+        mk_abs(sz, a, abs_a);
+        mk_abs(sz, b, abs_b);
+        mk_udiv_urem(sz, abs_a.c_ptr(), abs_b.c_ptr(), q, r);
+        mk_neg(sz, q.c_ptr(), neg_q);
+        mk_multiplexer(mk_iff(a[sz - 1], b[sz - 1]), sz, q.c_ptr(), neg_q.c_ptr(), out);
+    }
+
+    void mk_srem(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out) {
+        sat::literal_vector abs_a, abs_b, q, r, neg_r;
+        mk_abs(sz, a, abs_a);
+        mk_abs(sz, b, abs_b);
+        mk_udiv_urem(sz, abs_a.c_ptr(), abs_b.c_ptr(), q, r);
+        mk_neg(sz, r.c_ptr(), neg_r);
+        mk_multiplexer(a[sz - 1], sz, neg_r.c_ptr(), r.c_ptr(), out);
+    }
+
+    /**
+       \brief Signed modulus, see bit_blaster_tpl::mk_smod for the semantics.
+    */
+    void mk_smod(unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out) {
+        sat::literal a_msb = a[sz - 1];
+        sat::literal b_msb = b[sz - 1];
+        sat::literal_vector abs_a, abs_b, q, u, neg_u, neg_u_add_b, u_add_b, ite1, ite2, body, zero;
+        mk_abs(sz, a, abs_a);
+        mk_abs(sz, b, abs_b);
+        mk_udiv_urem(sz, abs_a.c_ptr(), abs_b.c_ptr(), q, u);
+        mk_neg(sz, u.c_ptr(), neg_u);
+        mk_adder(sz, neg_u.c_ptr(), b, neg_u_add_b);
+        mk_adder(sz, u.c_ptr(), b, u_add_b);
+        num2bits(rational(0), sz, zero);
+        sat::literal u_eq_0 = mk_eq(sz, u.c_ptr(), zero.c_ptr());
+        mk_multiplexer(b_msb, sz, neg_u.c_ptr(), neg_u_add_b.c_ptr(), ite1);
+        mk_multiplexer(b_msb, sz, u_add_b.c_ptr(), u.c_ptr(), ite2);
+        mk_multiplexer(a_msb, sz, ite1.c_ptr(), ite2.c_ptr(), body);
+        mk_multiplexer(u_eq_0, sz, u.c_ptr(), body.c_ptr(), out);
+    }
+
+    sat::literal mk_eq(unsigned sz, sat::literal const * a, sat::literal const * b) {
+        sat::literal_vector eqs;
+        for (unsigned i = 0; i < sz; i++)
+            eqs.push_back(mk_iff(a[i], b[i]));
+        return mk_and(eqs.size(), eqs.c_ptr());
+    }
+
+    sat::literal mk_le(bool is_signed, unsigned sz, sat::literal const * a, sat::literal const * b) {
+        sat::literal out = mk_or(~a[0], b[0]);
+        unsigned n = is_signed ? sz - 1 : sz;
+        for (unsigned i = 1; i < n; i++)
+            out = mk_maj(~a[i], b[i], out);
+        if (is_signed)
+            out = mk_maj(~b[sz - 1], a[sz - 1], out);
+        return out;
+    }
+
+    /**
+       \brief Barrel shifter. fill is the literal shifted in, or null_literal
+       for the most significant bit of a (arithmetic shift right).
+    */
+    void mk_shift(bool left, sat::literal fill, unsigned sz, sat::literal const * a, sat::literal const * b, sat::literal_vector & out) {
+        bool arith = fill == sat::null_literal;
+        if (arith)
+            fill = a[sz - 1];
+        rational k;
+        if (is_numeral(sz, b, k)) {
+            unsigned n = k.is_unsigned() && k.get_unsigned() < sz ? k.get_unsigned() : sz;
+            for (unsigned j = 0; j < sz; j++) {
+                if (left)
+                    out.push_back(j < n ? fill : a[j - n]);
+                else
+                    out.push_back(j + n < sz ? a[j + n] : fill);
+            }
+            return;
+        }
+        out.append(sz, a);
+        sat::literal_vector new_out;
+        unsigned i = 0;
+        for (; i < sz; ++i) {
+            checkpoint();
+            unsigned shift_i = 1 << i;
+            if (shift_i >= sz)
+                break;
+            new_out.reset();
+            for (unsigned j = 0; j < sz; ++j) {
+                sat::literal a_j = fill;
+                if (left && shift_i <= j)
+                    a_j = out[j - shift_i];
+                else if (!left && shift_i + j < sz)
+                    a_j = out[j + shift_i];
+                new_out.push_back(mk_ite(b[i], a_j, out[j]));
+            }
+            out.swap(new_out);
+        }
+        sat::literal_vector large;
+        for (; i < sz; ++i)
+            large.push_back(b[i]);
+        sat::literal is_large = mk_or(large.size(), large.c_ptr());
+        for (unsigned j = 0; j < sz; ++j)
+            out[j] = mk_ite(is_large, fill, out[j]);
+    }
+
+    void mk_rotate_left(unsigned sz, sat::literal const * a, unsigned n, sat::literal_vector & out) {
+        n = n % sz;
+        for (unsigned i = sz - n; i < sz; i++)
+            out.push_back(a[i]);
+        for (unsigned i = 0; i < sz - n; i++)
+            out.push_back(a[i]);
+    }
+
+    // -----------------------------------
+    //
+    // Terms
+    //
+    // -----------------------------------
+
+    sat::literal const * get_bits(expr * t) const {
+        return m_bits.c_ptr() + m_term2bits.find(t);
+    }
+
+    sat::literal get_lit(expr * t) const {
+        return m_bool2lit.find(t);
+    }
+
+    bool is_blasted(expr * t) const {
+        return m.is_bool(t) ? m_bool2lit.contains(t) : m_term2bits.contains(t);
+    }
+
+    void blast_bitwise(app * t, unsigned sz, sat::literal_vector & out) {
+        unsigned num = t->get_num_args();
+        sat::literal_vector bit;
+        for (unsigned i = 0; i < sz; i++) {
+            bit.reset();
+            for (unsigned j = 0; j < num; j++)
+                bit.push_back(get_bits(t->get_arg(j))[i]);
+            switch (t->get_decl_kind()) {
+            case OP_BAND:
+                out.push_back(mk_and(bit.size(), bit.c_ptr()));
+                break;
+            case OP_BOR:
+                out.push_back(mk_or(bit.size(), bit.c_ptr()));
+                break;
+            case OP_BXOR: {
+                sat::literal r = bit[0];
+                for (unsigned j = 1; j < bit.size(); j++)
+                    r = mk_xor(r, bit[j]);
+                out.push_back(r);
+                break;
+            }
+            case OP_BNAND:
+                out.push_back(~mk_and(bit[0], bit[1]));
+                break;
+            case OP_BNOR:
+                out.push_back(~mk_or(bit[0], bit[1]));
+                break;
+            case OP_BXNOR:
+                out.push_back(mk_iff(bit[0], bit[1]));
+                break;
+            default:
+                UNREACHABLE();
+            }
+        }
+    }
+
+    void blast_bv(app * t, sat::literal_vector & out) {
+        unsigned sz = m_util.get_bv_size(t);
+        rational val;
+        unsigned bv_sz;
+        if (is_uninterp_const(t)) {
+            for (unsigned i = 0; i < sz; i++)
+                out.push_back(sat::literal(m_solver.mk_var(), false));
+            m_consts.push_back(t);
+            return;
+        }
+        if (m_util.is_numeral(t, val, bv_sz)) {
+            num2bits(val, sz, out);
+            return;
+        }
+        if (m.is_ite(t)) {
+            mk_multiplexer(get_lit(t->get_arg(0)), sz, get_bits(t->get_arg(1)), get_bits(t->get_arg(2)), out);
+            return;
+        }
+        SASSERT(t->get_family_id() == m_util.get_family_id());
+        unsigned num = t->get_num_args();
+        expr * a0 = num > 0 ? t->get_arg(0) : 0;
+        expr * a1 = num > 1 ? t->get_arg(1) : 0;
+        sat::literal_vector tmp1, tmp2;
+        switch (t->get_decl_kind()) {
+        case OP_BADD:
+        case OP_BMUL:
+            tmp1.append(sz, get_bits(a0));
+            for (unsigned i = 1; i < num; i++) {
+                tmp2.reset();
+                if (t->get_decl_kind() == OP_BADD)
+                    mk_adder(sz, tmp1.c_ptr(), get_bits(t->get_arg(i)), tmp2);
+                else
+                    mk_multiplier(sz, tmp1.c_ptr(), get_bits(t->get_arg(i)), tmp2);
+                tmp1.swap(tmp2);
+            }
+            out.append(tmp1);
+            break;
+        case OP_BSUB: {
+            sat::literal cout;
+            mk_subtracter(sz, get_bits(a0), get_bits(a1), out, cout);
+            break;
+        }
+        case OP_BNEG:
+            mk_neg(sz, get_bits(a0), out);
+            break;
+        case OP_BUDIV_I:
+            mk_udiv_urem(sz, get_bits(a0), get_bits(a1), out, tmp1);
+            break;
+        case OP_BUREM_I:
+            mk_udiv_urem(sz, get_bits(a0), get_bits(a1), tmp1, out);
+            break;
+        case OP_BSDIV_I:
+            mk_sdiv(sz, get_bits(a0), get_bits(a1), out);
+            break;
+        case OP_BSREM_I:
+            mk_srem(sz, get_bits(a0), get_bits(a1), out);
+            break;
+        case OP_BSMOD_I:
+            mk_smod(sz, get_bits(a0), get_bits(a1), out);
+            break;
+        case OP_BNOT: {
+            sat::literal const * bits = get_bits(a0);
+            for (unsigned i = 0; i < sz; i++)
+                out.push_back(~bits[i]);
+            break;
+        }
+        case OP_BAND:
+        case OP_BOR:
+        case OP_BXOR:
+        case OP_BNAND:
+        case OP_BNOR:
+        case OP_BXNOR:
+            blast_bitwise(t, sz, out);
+            break;
+        case OP_CONCAT:
+            for (unsigned i = num; i-- > 0; )
+                out.append(m_util.get_bv_size(t->get_arg(i)), get_bits(t->get_arg(i)));
+            break;
+        case OP_EXTRACT: {
+            unsigned low = m_util.get_extract_low(t);
+            out.append(sz, get_bits(a0) + low);
+            break;
+        }
+        case OP_ZERO_EXT:
+        case OP_SIGN_EXT: {
+            unsigned a_sz = m_util.get_bv_size(a0);
+            sat::literal const * bits = get_bits(a0);
+            out.append(a_sz, bits);
+            sat::literal high = t->get_decl_kind() == OP_ZERO_EXT ? mk_false() : bits[a_sz - 1];
+            for (unsigned i = a_sz; i < sz; i++)
+                out.push_back(high);
+            break;
+        }
+        case OP_REPEAT: {
+            unsigned a_sz = m_util.get_bv_size(a0);
+            for (unsigned i = 0; i < sz; i += a_sz)
+                out.append(a_sz, get_bits(a0));
+            break;
+        }
+        case OP_BREDAND:
+            out.push_back(mk_and(m_util.get_bv_size(a0), get_bits(a0)));
+            break;
+        case OP_BREDOR:
+            out.push_back(mk_or(m_util.get_bv_size(a0), get_bits(a0)));
+            break;
+        case OP_BCOMP:
+            out.push_back(mk_eq(m_util.get_bv_size(a0), get_bits(a0), get_bits(a1)));
+            break;
+        case OP_BSHL:
+            mk_shift(true, mk_false(), sz, get_bits(a0), get_bits(a1), out);
+            break;
+        case OP_BLSHR:
+            mk_shift(false, mk_false(), sz, get_bits(a0), get_bits(a1), out);
+            break;
+        case OP_BASHR:
+            mk_shift(false, sat::null_literal, sz, get_bits(a0), get_bits(a1), out);
+            break;
+        case OP_ROTATE_LEFT:
+            mk_rotate_left(sz, get_bits(a0), t->get_decl()->get_parameter(0).get_int(), out);
+            break;
+        case OP_ROTATE_RIGHT: {
+            unsigned n = t->get_decl()->get_parameter(0).get_int() % sz;
+            mk_rotate_left(sz, get_bits(a0), sz - n, out);
+            break;
+        }
+        default:
+            UNREACHABLE();
+        }
+        SASSERT(out.size() == sz);
+    }
+
+    sat::literal blast_bool(app * t) {
+        if (is_uninterp_const(t)) {
+            sat::bool_var v = m_map.to_bool_var(t);
+            if (v == sat::null_bool_var) {
+                v = m_solver.mk_var();
+                m_map.insert(t, v);
+            }
+            return sat::literal(v, false);
+        }
+        if (m.is_true(t))
+            return mk_true();
+        if (m.is_false(t))
+            return mk_false();
+        unsigned num = t->get_num_args();
+        sat::literal_vector args;
+        if (t->get_family_id() == m.get_basic_family_id()) {
+            if (m.is_eq(t) && !m.is_bool(t->get_arg(0))) {
+                expr * a = t->get_arg(0);
+                return mk_eq(m_util.get_bv_size(a), get_bits(a), get_bits(t->get_arg(1)));
+            }
+            for (unsigned i = 0; i < num; i++)
+                args.push_back(get_lit(t->get_arg(i)));
+            switch (t->get_decl_kind()) {
+            case OP_NOT:
+                return ~args[0];
+            case OP_AND:
+                return mk_and(args.size(), args.c_ptr());
+            case OP_OR:
+                return mk_or(args.size(), args.c_ptr());
+            case OP_IMPLIES:
+                return mk_or(~args[0], args[1]);
+            case OP_IFF:
+            case OP_EQ:
+                return mk_iff(args[0], args[1]);
+            case OP_XOR:
+                return mk_xor(args[0], args[1]);
+            case OP_ITE:
+                return mk_ite(args[0], args[1], args[2]);
+            default:
+                UNREACHABLE();
+                return sat::null_literal;
+            }
+        }
+        SASSERT(t->get_family_id() == m_util.get_family_id() && num == 2);
+        expr * a = t->get_arg(0);
+        expr * b = t->get_arg(1);
+        unsigned sz = m_util.get_bv_size(a);
+        switch (t->get_decl_kind()) {
+        case OP_ULEQ: return mk_le(false, sz, get_bits(a), get_bits(b));
+        case OP_SLEQ: return mk_le(true, sz, get_bits(a), get_bits(b));
+        case OP_UGEQ: return mk_le(false, sz, get_bits(b), get_bits(a));
+        case OP_SGEQ: return mk_le(true, sz, get_bits(b), get_bits(a));
+        case OP_ULT:  return ~mk_le(false, sz, get_bits(b), get_bits(a));
+        case OP_SLT:  return ~mk_le(true, sz, get_bits(b), get_bits(a));
+        case OP_UGT:  return ~mk_le(false, sz, get_bits(a), get_bits(b));
+        case OP_SGT:  return ~mk_le(true, sz, get_bits(a), get_bits(b));
+        default:
+            UNREACHABLE();
+            return sat::null_literal;
+        }
+    }
+
+    void blast(expr * root) {
+        sat::literal_vector out;
+        m_todo.push_back(root);
+        while (!m_todo.empty()) {
+            checkpoint();
+            expr * e = m_todo.back();
+            if (is_blasted(e)) {
+                m_todo.pop_back();
+                continue;
+            }
+            SASSERT(is_app(e));
+            app * t = to_app(e);
+            bool visited = true;
+            for (unsigned i = 0; i < t->get_num_args(); i++) {
+                expr * arg = t->get_arg(i);
+                if (!is_blasted(arg)) {
+                    m_todo.push_back(arg);
+                    visited = false;
+                }
+            }
+            if (!visited)
+                continue;
+            m_todo.pop_back();
+            if (m.is_bool(t)) {
+                m_bool2lit.insert(t, blast_bool(t));
+            }
+            else {
+                out.reset();
+                blast_bv(t, out);
+                m_term2bits.insert(t, m_bits.size());
+                m_bits.append(out);
+            }
+        }
+    }
+
+    void operator()() {
+        ptr_vector<expr> atoms;
+        atom2bool_var::iterator it  = m_map.begin();
+        atom2bool_var::iterator end = m_map.end();
+        for (; it != end; ++it) {
+            if (!is_uninterp_const(it->m_key))
+                atoms.push_back(it->m_key);
+        }
+        for (unsigned i = 0; i < atoms.size(); i++) {
+            expr * atom = atoms[i];
+            blast(atom);
+            sat::literal l = get_lit(atom);
+            sat::literal v(m_map.to_bool_var(atom), false);
+            TRACE("bv2sat", tout << mk_ismt2_pp(atom, m) << "\n" << v << " <=> " << l << "\n";);
+            mk_clause(~v, l);
+            mk_clause(v, ~l);
+            m_stats.m_num_atoms++;
+        }
+    }
+
+    void mk_model(sat::model const & ll_m, model & md) {
+        for (unsigned i = 0; i < m_consts.size(); i++) {
+            app * c = m_consts.get(i);
+            unsigned sz = m_util.get_bv_size(c);
+            sat::literal const * bits = get_bits(c);
+            rational val;
+            for (unsigned j = 0; j < sz; j++) {
+                if (sat::value_at(bits[j], ll_m) == l_true)
+                    val += rational::power_of_two(j);
+            }
+            md.register_decl(c->get_decl(), m_util.mk_numeral(val, sz));
+        }
+    }
+
+    void collect_statistics(statistics & st) const {
+        st.update("bv2sat atoms", m_stats.m_num_atoms);
+        st.update("bv2sat gates", m_stats.m_num_gates);
+        st.update("bv2sat gate hits", m_stats.m_num_gate_hits);
+        st.update("bv2sat clauses", m_stats.m_num_clauses);
+    }
+};
+
+bv2sat::bv2sat(ast_manager & m, params_ref const & p, sat::solver & s, atom2bool_var & map) {
+    m_imp = alloc(imp, m, p, s, map);
+}
+
+bv2sat::~bv2sat() {
+    dealloc(m_imp);
+}
+
+struct is_non_bv2sat_predicate {
+    struct found {};
+    ast_manager & m;
+    bv_util       u;
+
+    is_non_bv2sat_predicate(ast_manager & _m):m(_m), u(m) {}
+
+    void operator()(var *) { throw found(); }
+
+    void operator()(quantifier *) { throw found(); }
+
+    void operator()(app * n) {
+        if (!m.is_bool(n) && !u.is_bv(n))
+            throw found();
+        if (is_uninterp_const(n))
+            return;
+        family_id fid = n->get_family_id();
+        if (fid == m.get_basic_family_id()) {
+            switch (n->get_decl_kind()) {
+            case OP_TRUE: case OP_FALSE: case OP_NOT: case OP_AND: case OP_OR:
+            case OP_IMPLIES: case OP_IFF: case OP_EQ: case OP_XOR: case OP_ITE:
+                return;
+            default:
+                throw found();
+            }
+        }
+        if (fid != u.get_family_id())
+            throw found();
+        switch (n->get_decl_kind()) {
+        case OP_BV_NUM: case OP_BADD: case OP_BSUB: case OP_BNEG: case OP_BMUL:
+        case OP_BUDIV_I: case OP_BUREM_I: case OP_BSDIV_I: case OP_BSREM_I: case OP_BSMOD_I:
+        case OP_ULEQ: case OP_SLEQ: case OP_UGEQ: case OP_SGEQ:
+        case OP_ULT: case OP_SLT: case OP_UGT: case OP_SGT:
+        case OP_BAND: case OP_BOR: case OP_BNOT: case OP_BXOR:
+        case OP_BNAND: case OP_BNOR: case OP_BXNOR:
+        case OP_CONCAT: case OP_SIGN_EXT: case OP_ZERO_EXT: case OP_EXTRACT: case OP_REPEAT:
+        case OP_BREDOR: case OP_BREDAND: case OP_BCOMP:
+        case OP_BSHL: case OP_BLSHR: case OP_BASHR:
+        case OP_ROTATE_LEFT: case OP_ROTATE_RIGHT:
+            return;
+        default:
+            throw found();
+        }
+    }
+};
+
+bool bv2sat::is_supported(goal const & g) {
+    return !test<is_non_bv2sat_predicate>(g);
+}
+
+void bv2sat::operator()() {
+    (*m_imp)();
+}
+
+void bv2sat::mk_model(sat::model const & ll_m, model & md) const {
+    m_imp->mk_model(ll_m, md);
+}
+
+void bv2sat::collect_statistics(statistics & st) const {
+    m_imp->collect_statistics(st);
+}
+
+void bv2sat::set_cancel(bool f) {
+    m_imp->m_cancel = f;
+}
@@ -0,0 +1,72 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    bv2sat.h
+
+Abstract:
+
+    Bit-blast bit-vector atoms directly into a SAT solver.
+
+    goal2sat maps every bit-vector atom (=, bvule, bvsle, ...) to a
+    Boolean variable. bv2sat encodes these atoms as circuits over
+    sat::literal and adds the Tseitin clauses straight to the solver,
+    instead of building the circuits as Boolean expressions (bit_blaster)
+    and walking them again (goal2sat). Gates are hash-consed in a local
+    structural-hashing table, so no AST is created during blasting. The
+    only expressions created are the numerals of the model.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+    The supported fragment is the one left by the QF_BV preprocessing:
+    division and remainder must be the internal *_i versions, and
+    uninterpreted functions are not supported (see is_supported).
+
+--*/
+#ifndef _BV2SAT_H_
+#define _BV2SAT_H_
+
+#include"goal.h"
+#include"sat_solver.h"
+#include"model.h"
+#include"statistics.h"
+#include"atom2bool_var.h"
+
+class bv2sat {
+    struct imp;
+    imp *  m_imp;
+public:
+    bv2sat(ast_manager & m, params_ref const & p, sat::solver & s, atom2bool_var & map);
+    ~bv2sat();
+
+    /**
+       \brief Return true if every atom of \c g can be handled by goal2sat + bv2sat.
+    */
+    static bool is_supported(goal const & g);
+
+    /**
+       \brief Encode all interpreted atoms of the atom map (previously filled
+       by goal2sat) as circuits in the SAT solver, and constrain the Boolean
+       variable of each atom to be equivalent to its circuit output.
+
+       \warning throws a tactic_exception if it is interrupted (by set_cancel),
+       or memory consumption limit is reached (set with param :max-memory).
+    */
+    void operator()();
+
+    /**
+       \brief Store in \c md the values of the bit-vector constants of the goal.
+    */
+    void mk_model(sat::model const & ll_m, model & md) const;
+
+    void collect_statistics(statistics & st) const;
+
+    void set_cancel(bool f);
+};
+
+#endif
@@ -27,6 +27,8 @@ Notes:
 
 --*/
 #include"goal2sat.h"
+#include"sat_card_extension.h"
+#include"pb_decl_plugin.h"
 #include"ast_smt2_pp.h"
 #include"ref_util.h"
 #include"cooperate.h"
@@ -46,21 +48,27 @@ struct goal2sat::imp {
             m_t(t), m_root(r), m_sign(s), m_idx(idx) {}
     };
     ast_manager &               m;
+    pb_util                     m_pb;
     svector<frame>              m_frame_stack;
     svector<sat::literal>       m_result_stack;
     obj_map<app, sat::literal>  m_cache;
     obj_hashtable<expr>         m_interface_vars;
     sat::solver &               m_solver;
+    sat::card_extension *       m_card;
     atom2bool_var &             m_map;
     sat::bool_var               m_true;
     bool                        m_ite_extra;
+    bool                        m_default_external;
     unsigned long long          m_max_memory;
     volatile bool               m_cancel;
     
-    imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map):
+    imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map, bool default_external):
         m(_m),
+        m_pb(_m),
         m_solver(s),
-        m_map(map) {
+        m_card(0),
+        m_map(map),
+        m_default_external(default_external) {
         updt_params(p);
         m_cancel = false;
         m_true = sat::null_bool_var;
@@ -116,7 +124,7 @@ struct goal2sat::imp {
                 l = sat::literal(mk_true(), !sign);
             }
             else {
-                bool ext = !is_uninterp_const(t) || m_interface_vars.contains(t);
+                bool ext = m_default_external || !is_uninterp_const(t) || m_interface_vars.contains(t);
                 sat::bool_var v = m_solver.mk_var(ext);
                 m_map.insert(t, v);
                 l = sat::literal(v, sign);
@@ -155,6 +163,10 @@ struct goal2sat::imp {
         }
         if (process_cached(to_app(t), root, sign))
             return true;
+        if (m_pb.is_pb(t)) {
+            m_frame_stack.push_back(frame(to_app(t), root, sign, 0));
+            return false;
+        }
         if (to_app(t)->get_family_id() != m.get_basic_family_id()) {
             convert_atom(t, root, sign);
             return true;
@@ -295,7 +307,103 @@ struct goal2sat::imp {
         }
     }
 
+    sat::card_extension * get_card_extension() {
+        if (m_card == 0) {
+            sat::extension * ext = m_solver.get_extension();
+            if (ext == 0) {
+                m_card = alloc(sat::card_extension);
+                m_solver.set_extension(m_card);
+            }
+            else {
+                m_card = dynamic_cast<sat::card_extension*>(ext);
+                if (m_card == 0)
+                    throw tactic_exception("pseudo-Boolean constraints are not supported by the SAT solver extension");
+            }
+        }
+        return m_card;
+    }
+
+    static unsigned to_unsigned(uint64 n) {
+        if (n > UINT_MAX)
+            throw tactic_exception("pseudo-Boolean constraint is too big");
+        return static_cast<unsigned>(n);
+    }
+
+    /**
+       \brief Convert cardinality and pseudo-Boolean constraints.
+       They are normalized into the form w_1*l_1 + ... + w_n*l_n >= k, and
+       asserted in the cardinality extension of the SAT solver.
+       A constraint that is not at the root is reified using a fresh literal l,
+       that is, we assert l => C and ~l => ~C.
+    */
+    void convert_pb(app * t, bool root, bool sign) {
+        TRACE("goal2sat", tout << "convert_pb:\n" << mk_ismt2_pp(t, m) << "\n";);
+        unsigned num = t->get_num_args();
+        SASSERT(num <= m_result_stack.size());
+        sat::literal_vector lits;
+        unsigned_vector     weights;
+        uint64              sum = 0;
+        bool is_le = m_pb.is_at_most_k(t) || m_pb.is_le(t);
+        sat::literal * args = m_result_stack.end() - num;
+        for (unsigned i = 0; i < num; i++) {
+            // w*l <= k iff w*~l >= w - k
+            lits.push_back(is_le ? ~args[i] : args[i]);
+            weights.push_back(m_pb.get_coeff(t, i));
+            sum += weights.back();
+        }
+        m_result_stack.shrink(m_result_stack.size() - num);
+        uint64 k = m_pb.get_k(t);
+        if (is_le) {
+            if (sum < k) {
+                // trivially true
+                convert_atom(m.mk_true(), root, sign);
+                return;
+            }
+            k = sum - k;
+        }
+        sat::card_extension * card = get_card_extension();
+        if (root) {
+            if (!sign) {
+                card->add_at_least(to_unsigned(k), lits.size(), lits.c_ptr(), weights.c_ptr());
+            }
+            else if (k <= sum) {
+                // not (sum w_i*l_i >= k)  iff  sum w_i*~l_i >= sum - k + 1
+                for (unsigned i = 0; i < lits.size(); i++)
+                    lits[i].neg();
+                card->add_at_least(to_unsigned(sum - k + 1), lits.size(), lits.c_ptr(), weights.c_ptr());
+            }
+            return;
+        }
+        sat::bool_var v = m_solver.mk_var(true);
+        sat::literal  l(v, false);
+        m_cache.insert(t, l);
+        // l => C:  k*~l + sum w_i*l_i >= k
+        lits.push_back(~l);
+        weights.push_back(to_unsigned(k));
+        card->add_at_least(to_unsigned(k), lits.size(), lits.c_ptr(), weights.c_ptr());
+        if (k <= sum) {
+            // ~l => ~C:  (sum - k + 1)*l + sum w_i*~l_i >= sum - k + 1
+            unsigned k2 = to_unsigned(sum - k + 1);
+            for (unsigned i = 0; i + 1 < lits.size(); i++)
+                lits[i].neg();
+            lits.back()    = l;
+            weights.back() = k2;
+            card->add_at_least(k2, lits.size(), lits.c_ptr(), weights.c_ptr());
+        }
+        else {
+            // C is unsatisfiable
+            mk_clause(~l);
+        }
+        if (sign)
+            l.neg();
+        m_result_stack.push_back(l);
+    }
+
     void convert(app * t, bool root, bool sign) {
+        if (m_pb.is_pb(t)) {
+            convert_pb(t, root, sign);
+            return;
+        }
         SASSERT(t->get_family_id() == m.get_basic_family_id());
         switch (to_app(t)->get_decl_kind()) {
         case OP_OR:
@@ -439,8 +547,8 @@ struct goal2sat::scoped_set_imp {
     }
 };
 
-void goal2sat::operator()(goal const & g, params_ref const & p, sat::solver & t, atom2bool_var & m) {
-    imp proc(g.m(), p, t, m);
+void goal2sat::operator()(goal const & g, params_ref const & p, sat::solver & t, atom2bool_var & m, bool default_external) {
+    imp proc(g.m(), p, t, m, default_external);
     scoped_set_imp set(this, &proc);
     proc(g);
 }
@@ -637,6 +745,8 @@ struct sat2goal::imp {
             r.assert_expr(m.mk_false());
             return;
         }
+        if (s.get_extension() != 0)
+            throw tactic_exception("sat2goal does not support SAT solvers with extensions (e.g., pseudo-Boolean constraints)");
         init_lit2expr(s, map, mc, r.models_enabled());
         // collect units
         unsigned num_vars = s.num_vars();
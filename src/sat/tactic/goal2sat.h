@@ -51,11 +51,15 @@ public:
        
        \remark m doesn't need to be empty. the definitions there are 
        reused.
+
+       \remark if default_external is true, then all atoms are marked as external
+       variables in the SAT solver. This is needed when new formulas referring to
+       these atoms may be added later, since external variables are not eliminated.
     
        \warning conversion throws a tactic_exception, if it is interrupted (by set_cancel),
        an unsupported operator is found, or memory consumption limit is reached (set with param :max-memory).
     */
-    void operator()(goal const & g, params_ref const & p, sat::solver & t, atom2bool_var & m);
+    void operator()(goal const & g, params_ref const & p, sat::solver & t, atom2bool_var & m, bool default_external = false);
 
     void set_cancel(bool f);
 };
@@ -18,6 +18,8 @@ Notes:
 --*/
 #include"tactical.h"
 #include"goal2sat.h"
+#include"bv2sat.h"
+#include"sat_params.hpp"
 #include"sat_solver.h"
 #include"filter_model_converter.h"
 #include"ast_smt2_pp.h"
@@ -31,11 +33,14 @@ class sat_tactic : public tactic {
         sat2goal        m_sat2goal;
         sat::solver     m_solver;
         params_ref      m_params;
+        bv2sat *        m_bv2sat;
+        statistics      m_bv2sat_stats;
         
         imp(ast_manager & _m, params_ref const & p):
             m(_m),
             m_solver(p, 0),
-            m_params(p) {
+            m_params(p),
+            m_bv2sat(0) {
             SASSERT(!m.proofs_enabled());
         }
         
@@ -51,8 +56,23 @@ class sat_tactic : public tactic {
             TRACE("before_sat_solver", g->display(tout););
             g->elim_redundancies();
 
+            // bit-vector atoms are blasted directly into the solver when the whole goal is supported.
+            // The goal is kept until the answer is known, since the result cannot be translated back.
+            bool direct = sat_params(m_params).direct_bit_blast() && bv2sat::is_supported(*g);
+            goal_ref orig;
+            if (direct)
+                orig = alloc(goal, *g);
+
             atom2bool_var map(m);
             m_goal2sat(*g, m_params, m_solver, map);
+            scoped_ptr<bv2sat> blaster;
+            if (direct && map.interpreted_atoms()) {
+                blaster = alloc(bv2sat, m, m_params, m_solver, map);
+                m_bv2sat = blaster.get();
+                (*blaster)();
+                m_bv2sat = 0;
+                blaster->collect_statistics(m_bv2sat_stats);
+            }
             TRACE("sat_solver_unknown", tout << "interpreted_atoms: " << map.interpreted_atoms() << "\n";
                   atom2bool_var::iterator it  = map.begin();
                   atom2bool_var::iterator end = map.end();
@@ -71,7 +91,7 @@ class sat_tactic : public tactic {
             if (r == l_false) {
                 g->assert_expr(m.mk_false(), 0, 0);
             }
-            else if (r == l_true && !map.interpreted_atoms()) {
+            else if (r == l_true && (!map.interpreted_atoms() || blaster)) {
                 // register model
                 if (produce_models) {
                     model_ref md = alloc(model, m);
@@ -82,6 +102,8 @@ class sat_tactic : public tactic {
                     for (; it != end; ++it) {
                         expr * n   = it->m_key;
                         sat::bool_var v = it->m_value;
+                        if (!is_uninterp_const(n))
+                            continue;
                         TRACE("sat_tactic", tout << "extracting value of " << mk_ismt2_pp(n, m) << "\nvar: " << v << "\n";);
                         switch (sat::value_at(v, ll_m)) {
                         case l_true: 
@@ -94,10 +116,16 @@ class sat_tactic : public tactic {
                             break;
                         }
                     }
+                    if (blaster)
+                        blaster->mk_model(ll_m, *md);
                     TRACE("sat_tactic", model_v2_pp(tout, *md););
                     mc = model2model_converter(md.get());
                 }
             }
+            else if (direct) {
+                // the solver gave up, return the original goal.
+                g->copy_from(*orig);
+            }
             else {
                 // get simplified problem.
 #if 0
@@ -114,6 +142,8 @@ class sat_tactic : public tactic {
             m_goal2sat.set_cancel(f);
             m_sat2goal.set_cancel(f);
             m_solver.set_cancel(f);
+            if (m_bv2sat)
+                m_bv2sat->set_cancel(f);
         }
     };
     
@@ -173,6 +203,7 @@ public:
         try {
             proc(g, result, mc, pc, core);
             proc.m_solver.collect_statistics(m_stats);
+            m_stats.copy(proc.m_bv2sat_stats);
         }
         catch (sat::solver_exception & ex) {
             proc.m_solver.collect_statistics(m_stats);
@@ -216,3 +247,14 @@ tactic * mk_sat_preprocessor_tactic(ast_manager & m, params_ref const & p) {
     return t;
 }
 
+class is_bv2sat_probe : public probe {
+public:
+    virtual result operator()(goal const & g) {
+        return bv2sat::is_supported(g);
+    }
+};
+
+probe * mk_is_bv2sat_probe() {
+    return alloc(is_bv2sat_probe);
+}
+
@@ -22,14 +22,18 @@ Notes:
 #include"params.h"
 class ast_manager;
 class tactic;
+class probe;
 
 tactic * mk_sat_tactic(ast_manager & m, params_ref const & p = params_ref());
 
 tactic * mk_sat_preprocessor_tactic(ast_manager & m, params_ref const & p = params_ref());
 
+probe * mk_is_bv2sat_probe();
+
 /*
   ADD_TACTIC('sat', '(try to) solve goal using a SAT solver.', 'mk_sat_tactic(m, p)')
   ADD_TACTIC('sat-preprocess', 'Apply SAT solver preprocessing procedures (bounded resolution, Boolean constant propagation, 2-SAT, subsumption, subsumption resolution).', 'mk_sat_preprocessor_tactic(m, p)')
+  ADD_PROBE('is-bv2sat', 'true if the bit-vector atoms of the goal can be bit-blasted directly into the SAT solver (sat option direct_bit_blast).', 'mk_is_bv2sat_probe()')
 */
 
 #endif
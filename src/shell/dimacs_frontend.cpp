@@ -22,6 +22,7 @@ Revision History:
 #include"timeout.h"
 #include"dimacs.h"
 #include"sat_solver.h"
+#include"sat_params.hpp"
 
 extern bool          g_display_statistics;
 static sat::solver * g_solver = 0;
@@ -63,6 +64,29 @@ static void display_model(sat::solver const & s) {
     std::cout << "\n";
 }
 
+// store the cubes in the iCNF format: each cube is a line "a lit_1 ... lit_n 0".
+static lbool write_cubes(sat::solver & s, char const * file_name) {
+    vector<sat::literal_vector> cubes;
+    lbool r = s.cube(cubes);
+    if (r == l_false)
+        return r;
+    std::ofstream out(file_name);
+    if (out.bad() || out.fail()) {
+        std::cerr << "(error \"failed to open file '" << file_name << "'\")" << std::endl;
+        exit(ERR_OPEN_FILE);
+    }
+    for (unsigned i = 0; i < cubes.size(); i++) {
+        out << "a";
+        for (unsigned j = 0; j < cubes[i].size(); j++) {
+            sat::literal l = cubes[i][j];
+            out << " " << (l.sign() ? "-" : "") << l.var();
+        }
+        out << " 0\n";
+    }
+    IF_VERBOSE(1, verbose_stream() << "(cubes " << cubes.size() << ")\n";);
+    return r;
+}
+
 unsigned read_dimacs(char const * file_name) {
     g_start_time = clock();
     register_on_timeout_proc(on_timeout);
@@ -85,7 +109,12 @@ unsigned read_dimacs(char const * file_name) {
     }
     IF_VERBOSE(20, solver.display_status(verbose_stream()););
     
-    lbool r = solver.check();
+    sat_params sp(p);
+    lbool r;
+    if (sp.lookahead_cube_file().size() > 0)
+        r = write_cubes(solver, sp.lookahead_cube_file().bare_str());
+    else
+        r = solver.check();
     switch (r) {
     case l_true: 
         std::cout << "sat\n"; 
@@ -100,5 +100,177 @@ float cost_evaluator::operator()(expr * f, unsigned num_args, float const * args
     return eval(f);
 }
 
+unsigned cost_evaluator::emit(code & c, code::opcode op, unsigned arg, float val) {
+    code::instruction i;
+    i.m_op  = op;
+    i.m_arg = arg;
+    i.m_val = val;
+    c.m_instrs.push_back(i);
+    return c.m_instrs.size() - 1;
+}
+
+/**
+   \brief Emit the instructions for f. depth is the number of values on the stack
+   before the instructions are executed. Like eval, only the first two arguments
+   of arithmetic operators are considered, and the arguments of and, or, ite and
+   implies are evaluated on demand.
+*/
+void cost_evaluator::compile_core(expr * f, code & c, unsigned depth) {
+#define C(IDX, D) compile_core(to_app(f)->get_arg(IDX), c, D)
+#define PATCH(POS) c.m_instrs[POS].m_arg = c.m_instrs.size()
+    if (depth + 1 > c.m_stack_size)
+        c.m_stack_size = depth + 1;
+    if (is_app(f)) {
+        unsigned num_args;
+        family_id fid = to_app(f)->get_family_id();
+        if (fid == m_manager.get_basic_family_id()) {
+            switch (to_app(f)->get_decl_kind()) {
+            case OP_TRUE:     emit(c, code::PUSH_NUM, 0, 1.0f); return;
+            case OP_FALSE:    emit(c, code::PUSH_NUM, 0, 0.0f); return;
+            case OP_NOT:      C(0, depth); emit(c, code::NOT); return;
+            case OP_AND: 
+            case OP_OR: {
+                // and: the result is 0 as soon as an argument is 0.
+                // or:  the result is 1 as soon as an argument is not 0.
+                bool is_and = to_app(f)->get_decl_kind() == OP_AND;
+                unsigned_vector exits;
+                num_args = to_app(f)->get_num_args();
+                for (unsigned i = 0; i < num_args; i++) {
+                    C(i, depth);
+                    if (!is_and) 
+                        emit(c, code::NOT);
+                    exits.push_back(emit(c, code::JMP_FALSE));
+                }
+                emit(c, code::PUSH_NUM, 0, is_and ? 1.0f : 0.0f);
+                unsigned end = emit(c, code::JMP);
+                for (unsigned i = 0; i < exits.size(); i++)
+                    PATCH(exits[i]);
+                emit(c, code::PUSH_NUM, 0, is_and ? 0.0f : 1.0f);
+                PATCH(end);
+                return;
+            }
+            case OP_ITE: {
+                C(0, depth);
+                unsigned else_pos = emit(c, code::JMP_FALSE);
+                C(1, depth);
+                unsigned end = emit(c, code::JMP);
+                PATCH(else_pos);
+                C(2, depth);
+                PATCH(end);
+                return;
+            }
+            case OP_EQ:
+            case OP_IFF:      C(0, depth); C(1, depth + 1); emit(c, code::EQ); return;
+            case OP_XOR:      C(0, depth); C(1, depth + 1); emit(c, code::NEQ); return;
+            case OP_IMPLIES: {
+                C(0, depth);
+                unsigned true_pos = emit(c, code::JMP_FALSE);
+                C(1, depth);
+                emit(c, code::BOOL);
+                unsigned end = emit(c, code::JMP);
+                PATCH(true_pos);
+                emit(c, code::PUSH_NUM, 0, 1.0f);
+                PATCH(end);
+                return;
+            }
+            default:
+                ;
+            }
+        }
+        else if (fid == m_util.get_family_id()) {
+            switch (to_app(f)->get_decl_kind()) {
+            case OP_NUM: {
+                rational r = to_app(f)->get_decl()->get_parameter(0).get_rational();
+                emit(c, code::PUSH_NUM, 0, static_cast<float>(numerator(r).get_int64())/static_cast<float>(denominator(r).get_int64()));
+                return;
+            } 
+            case OP_LE:       C(0, depth); C(1, depth + 1); emit(c, code::LE); return;
+            case OP_GE:       C(0, depth); C(1, depth + 1); emit(c, code::GE); return;
+            case OP_LT:       C(0, depth); C(1, depth + 1); emit(c, code::LT); return;
+            case OP_GT:       C(0, depth); C(1, depth + 1); emit(c, code::GT); return;
+            case OP_ADD:      C(0, depth); C(1, depth + 1); emit(c, code::ADD); return;
+            case OP_SUB:      C(0, depth); C(1, depth + 1); emit(c, code::SUB); return;
+            case OP_UMINUS:   C(0, depth); emit(c, code::UMINUS); return;
+            case OP_MUL:      C(0, depth); C(1, depth + 1); emit(c, code::MUL); return;
+            case OP_DIV:      C(0, depth); C(1, depth + 1); emit(c, code::DIV); return;
+            default:
+                ;
+            }
+        }
+    }
+    else if (is_var(f)) {
+        emit(c, code::PUSH_VAR, to_var(f)->get_idx());
+        return;
+    }
+    emit(c, code::ERROR);
+}
+
+void cost_evaluator::compile(expr * f, code & c) {
+    c.reset();
+    compile_core(f, c, 0);
+}
+
+float cost_evaluator::operator()(code const & c, unsigned num_args, float const * args) {
+    SASSERT(!c.empty());
+    if (m_stack.size() < c.m_stack_size)
+        m_stack.resize(c.m_stack_size, 0.0f);
+    float * stack = m_stack.c_ptr();
+    unsigned sp   = 0; // number of values on the stack
+    code::instruction const * instrs = c.m_instrs.c_ptr();
+    unsigned sz   = c.m_instrs.size();
+    unsigned pc   = 0;
+#define TOP stack[sp-1]
+#define BINARY(EXPR) { float b = stack[--sp]; float a = TOP; TOP = (EXPR); break; }
+    while (pc < sz) {
+        code::instruction const & i = instrs[pc++];
+        switch (i.m_op) {
+        case code::PUSH_NUM: stack[sp++] = i.m_val; break;
+        case code::PUSH_VAR: 
+            if (i.m_arg < num_args) {
+                stack[sp++] = args[num_args - i.m_arg - 1];
+            }
+            else {
+                warning_msg("cost function evaluation error");
+                stack[sp++] = 1.0f;
+            }
+            break;
+        case code::NOT:      TOP = TOP == 0.0f ? 1.0f : 0.0f; break;
+        case code::BOOL:     TOP = TOP != 0.0f ? 1.0f : 0.0f; break;
+        case code::EQ:       BINARY(a == b ? 1.0f : 0.0f);
+        case code::NEQ:      BINARY(a != b ? 1.0f : 0.0f);
+        case code::LE:       BINARY(a <= b ? 1.0f : 0.0f);
+        case code::GE:       BINARY(a >= b ? 1.0f : 0.0f);
+        case code::LT:       BINARY(a <  b ? 1.0f : 0.0f);
+        case code::GT:       BINARY(a >  b ? 1.0f : 0.0f);
+        case code::ADD:      BINARY(a + b);
+        case code::SUB:      BINARY(a - b);
+        case code::MUL:      BINARY(a * b);
+        case code::DIV: {
+            float q = stack[--sp];
+            if (q == 0.0f) {
+                warning_msg("cost function division by zero");
+                TOP = 1.0f;
+            }
+            else {
+                TOP = TOP / q;
+            }
+            break;
+        }
+        case code::UMINUS:   TOP = - TOP; break;
+        case code::JMP:      pc = i.m_arg; break;
+        case code::JMP_FALSE: 
+            if (stack[--sp] == 0.0f)
+                pc = i.m_arg;
+            break;
+        case code::ERROR:
+            warning_msg("cost function evaluation error");
+            stack[sp++] = 1.0f;
+            break;
+        }
+    }
+    SASSERT(sp == 1);
+    return stack[0];
+}
+
 
 
@@ -23,11 +23,44 @@ Revision History:
 #include"arith_decl_plugin.h"
 
 class cost_evaluator {
+public:
+    /**
+       \brief Cost function compiled into instructions for a stack machine.
+       It avoids the traversal of the expression every time the function is evaluated.
+    */
+    class code {
+        friend class cost_evaluator;
+        enum opcode {
+            PUSH_NUM,     // push m_val
+            PUSH_VAR,     // push the value of (VAR m_arg)
+            NOT, BOOL, EQ, NEQ, LE, GE, LT, GT,
+            ADD, SUB, MUL, DIV, UMINUS,
+            JMP,          // jump to m_arg
+            JMP_FALSE,    // pop, and jump to m_arg if the value is 0
+            ERROR         // push 1.0 and report an evaluation error
+        };
+        struct instruction {
+            opcode   m_op;
+            unsigned m_arg;
+            float    m_val;
+        };
+        svector<instruction> m_instrs;
+        unsigned             m_stack_size;
+    public:
+        code():m_stack_size(0) {}
+        bool empty() const { return m_instrs.empty(); }
+        void reset() { m_instrs.reset(); m_stack_size = 0; }
+    };
+
+private:
     ast_manager &   m_manager;
     arith_util      m_util;
     unsigned        m_num_args;
     float const *   m_args;
+    svector<float>  m_stack;
     float eval(expr * f) const;
+    unsigned emit(code & c, code::opcode op, unsigned arg = 0, float val = 0.0f);
+    void compile_core(expr * f, code & c, unsigned depth);
 public:
     cost_evaluator(ast_manager & m);
     /**
@@ -37,6 +70,13 @@ public:
        (VAR (num_args - 1)) is stored in the first position of the array.
     */
     float operator()(expr * f, unsigned num_args, float const * args);
+
+    /**
+       \brief Compile f into c. Evaluating c produces the same result as evaluating f.
+    */
+    void compile(expr * f, code & c);
+
+    float operator()(code const & c, unsigned num_args, float const * args);
 };
 
 #endif /* _COST_EVALUATOR_H_ */
@@ -19,6 +19,7 @@ Revision History:
 #include"mam.h"
 #include"smt_context.h"
 #include"pool.h"
+#include"obj_pair_hashtable.h"
 #include"ast_pp.h"
 #include"ast_ll_pp.h"
 #include"trail.h"
@@ -599,11 +600,13 @@ namespace smt {
     class code_tree_manager {
         label_hasher &    m_lbl_hasher;
         mam_trail_stack & m_trail_stack;
-        region &          m_region;
+        region &          m_trail_region;
+        region            m_persistent_region; //!< instructions of code trees that survive backtracking.
+        region *          m_region;
 
         template<typename OP>
         OP * mk_instr(opcode op, unsigned size) {
-            void * mem = m_region.allocate(size);
+            void * mem = m_region->allocate(size);
             OP * r = new (mem) OP;
             r->m_opcode = op;
             r->m_next   = 0;
@@ -634,7 +637,22 @@ namespace smt {
         code_tree_manager(label_hasher & h, mam_trail_stack & s):
             m_lbl_hasher(h),
             m_trail_stack(s),
-            m_region(s.get_region()) {
+            m_trail_region(s.get_region()),
+            m_region(&m_trail_region) {
+        }
+
+        /**
+           \brief When persistent is true, new instructions are allocated in a region
+           that is not affected by pop_scope. It is used to create code trees that
+           are cached and reused after backtracking.
+        */
+        void set_persistent(bool persistent) {
+            m_region = persistent ? &m_persistent_region : &m_trail_region;
+        }
+
+        void reset_persistent() {
+            SASSERT(m_region == &m_trail_region);
+            m_persistent_region.reset();
         }
         
         code_tree * mk_code_tree(func_decl * lbl, unsigned short num_args, bool filter_candidates) {
@@ -643,8 +661,85 @@ namespace smt {
             return r;
         }
 
+        static unsigned get_instr_size(instruction const * instr) {
+            opcode op = instr->m_opcode;
+            if (op >= INIT1 && op <= INIT6)
+                return sizeof(instruction);
+            if (op >= BIND1 && op <= BINDN)
+                return sizeof(bind);
+            if (op >= YIELD1 && op <= YIELDN)
+                return sizeof(yield) + static_cast<yield const *>(instr)->m_num_bindings * sizeof(unsigned);
+            if (op >= GET_CGR1 && op <= GET_CGRN)
+                return sizeof(get_cgr) + static_cast<get_cgr const *>(instr)->m_num_args * sizeof(unsigned);
+            switch (op) {
+            case INITN:     return sizeof(initn);
+            case COMPARE:   return sizeof(compare);
+            case CHECK:     return sizeof(check);
+            case FILTER:
+            case CFILTER:
+            case PFILTER:   return sizeof(filter);
+            case CHOOSE:
+            case NOOP:      return sizeof(choose);
+            case CONTINUE:  return sizeof(cont) + static_cast<cont const *>(instr)->m_num_args * sizeof(enode*);
+            case GET_ENODE: return sizeof(get_enode_instr);
+            case IS_CGR:    return sizeof(is_cgr) + static_cast<is_cgr const *>(instr)->m_num_args * sizeof(unsigned);
+            default:
+                UNREACHABLE();
+                return 0;
+            }
+        }
+
+        /**
+           \brief Copy the instructions reachable from head to the region r.
+           The instructions must not contain enodes (see code_tree_map::is_cacheable).
+        */
+        static instruction * copy_instrs(region & r, instruction const * head) {
+            instruction *  result = 0;
+            instruction ** last   = &result;
+            for (; head != 0; head = head->m_next) {
+                SASSERT(head->m_opcode != CHECK && head->m_opcode != GET_ENODE);
+                unsigned sz         = get_instr_size(head);
+                instruction * instr = static_cast<instruction *>(r.allocate(sz));
+                memcpy(instr, head, sz);
+                if (head->m_opcode == CHOOSE || head->m_opcode == NOOP) {
+                    choose * c = static_cast<choose *>(instr);
+                    c->m_alt   = static_cast<choose *>(copy_instrs(r, c->m_alt));
+                }
+                else if (head->m_opcode == CONTINUE) {
+                    cont * c = static_cast<cont *>(instr);
+                    for (unsigned i = 0; i < c->m_num_args; i++) {
+                        SASSERT(GET_TAG(c->m_joints[i]) != GROUND_TERM_TAG);
+                        if (GET_TAG(c->m_joints[i]) == NESTED_VAR_TAG) {
+                            joint2 * j = new (r) joint2(*UNTAG(joint2 *, c->m_joints[i]));
+                            c->m_joints[i] = TAG(enode *, j, NESTED_VAR_TAG);
+                        }
+                    }
+                }
+                *last = instr;
+                last  = &(instr->m_next);
+            }
+            *last = 0;
+            return result;
+        }
+
+        /**
+           \brief Copy the code tree src, whose instructions are in any region, to the region r.
+           Label hashes only depend on the declaration ids, so h may be the label hasher of another context.
+        */
+        static code_tree * copy_code_tree(label_hasher & h, region & r, code_tree const & src) {
+            code_tree * t     = alloc(code_tree, h, src.m_root_lbl, src.m_num_args, src.m_filter_candidates != 0);
+            t->m_num_regs     = src.m_num_regs;
+            t->m_num_choices  = src.m_num_choices;
+            t->m_root         = copy_instrs(r, src.m_root);
+            return t;
+        }
+
+        code_tree * mk_code_tree_copy(code_tree const & src) {
+            return copy_code_tree(m_lbl_hasher, *m_region, src);
+        }
+
         joint2 * mk_joint2(func_decl * f, unsigned pos, unsigned reg) {
-            return new (m_region) joint2(f, pos, reg);
+            return new (*m_region) joint2(f, pos, reg);
         }
 
         compare * mk_compare(unsigned reg1, unsigned reg2) { 
@@ -2808,6 +2903,104 @@ namespace smt {
         }
     }
 
+    // ------------------------------------
+    // 
+    // Code tree templates shared by the contexts of an ast_manager
+    //
+    // ------------------------------------
+
+    /**
+       \brief Store of the code trees compiled for multi-patterns without ground subterms.
+       These trees do not contain enodes, and their label hashes only depend on the 
+       declaration ids. So, they do not depend on the context that compiled them, and 
+       a new context of the same ast_manager copies a template instead of compiling 
+       the multi-pattern again.
+
+       The store is registered as a plugin of the ast_manager, and it is deleted with it.
+       Contexts only copy templates, so the store can be flushed at any time.
+    */
+    class code_tree_templates : public decl_plugin {
+        label_hasher                            m_lbl_hasher;
+        region                                  m_region;
+        obj_pair_map<quantifier, app, unsigned> m_map;       // (qa, mp) -> position of the template for first_idx = 0
+        ptr_vector<code_tree>                   m_templates;
+        ptr_vector<ast>                         m_pinned;
+
+        void flush() {
+            std::for_each(m_templates.begin(), m_templates.end(), delete_proc<code_tree>());
+            m_templates.reset();
+            m_map.reset();
+            m_region.reset();
+            ptr_vector<ast>::iterator it  = m_pinned.begin();
+            ptr_vector<ast>::iterator end = m_pinned.end();
+            for (; it != end; ++it)
+                m_manager->dec_ref(*it);
+            m_pinned.reset();
+        }
+
+    public:
+        virtual ~code_tree_templates() {
+            SASSERT(m_pinned.empty());
+        }
+
+        virtual void finalize() {
+            flush();
+        }
+
+        virtual decl_plugin * mk_fresh() { 
+            return alloc(code_tree_templates); 
+        }
+
+        virtual sort * mk_sort(decl_kind k, unsigned num_parameters, parameter const * parameters) {
+            UNREACHABLE();
+            return 0;
+        }
+
+        virtual func_decl * mk_func_decl(decl_kind k, unsigned num_parameters, parameter const * parameters, 
+                                         unsigned arity, sort * const * domain, sort * range) {
+            UNREACHABLE();
+            return 0;
+        }
+
+        static code_tree_templates & get(ast_manager & m) {
+            symbol name("mam_code_trees");
+            if (!m.has_plugin(name))
+                m.register_plugin(name, alloc(code_tree_templates));
+            return *static_cast<code_tree_templates *>(m.get_plugin(m.get_family_id(name)));
+        }
+
+        code_tree const * find(quantifier * qa, app * mp, unsigned first_idx) const {
+            unsigned idx;
+            if (!m_map.find(qa, mp, idx))
+                return 0;
+            return m_templates[idx + first_idx];
+        }
+
+        /**
+           \brief Store a copy of the code tree t for (qa, mp, first_idx). 
+           The store is flushed when it would have more than max_templates trees.
+        */
+        void insert(quantifier * qa, app * mp, unsigned first_idx, code_tree const & t, unsigned max_templates) {
+            unsigned idx;
+            if (!m_map.find(qa, mp, idx)) {
+                if (m_templates.size() + mp->get_num_args() > max_templates) {
+                    if (mp->get_num_args() > max_templates)
+                        return;
+                    flush();
+                }
+                idx = m_templates.size();
+                m_templates.resize(idx + mp->get_num_args(), 0);
+                m_map.insert(qa, mp, idx);
+                m_manager->inc_ref(qa);
+                m_manager->inc_ref(mp);
+                m_pinned.push_back(qa);
+                m_pinned.push_back(mp);
+            }
+            SASSERT(m_templates[idx + first_idx] == 0);
+            m_templates[idx + first_idx] = code_tree_manager::copy_code_tree(m_lbl_hasher, m_region, t);
+        }
+    };
+
     // ------------------------------------
     // 
     // A mapping from func_label -> code tree.                
@@ -2816,8 +3009,24 @@ namespace smt {
     class code_tree_map {
         ast_manager &               m_ast_manager;
         compiler &                  m_compiler;
+        code_tree_manager &         m_ct_manager;
         ptr_vector<code_tree>       m_trees;       // mapping: func_label -> tree
         mam_trail_stack &           m_trail_stack;
+        // Code trees created for a (quantifier, multi-pattern, first_idx) triple are
+        // cached, and reused when the same multi-pattern is added again after 
+        // backtracking (e.g., quantifiers asserted between push/pop and check-sat calls).
+        // Trees missing from the cache are copied from the code_tree_templates of the 
+        // ast_manager, so fresh contexts of the same manager do not compile them again.
+        // m_cache maps (qa, mp) to the position of the tree for first_idx = 0 in m_cached_trees.
+        // The cache is flushed when it is full and none of its trees is in use.
+        obj_pair_map<quantifier, app, unsigned> m_cache;
+        ptr_vector<code_tree>       m_cached_trees;
+        expr_ref_vector             m_cache_pinned;
+        unsigned                    m_max_cached_trees;
+        unsigned                    m_num_cached_in_use; // number of cached trees in m_trees
+        unsigned                    m_num_cache_hits;
+        unsigned                    m_num_cache_flushes;
+        unsigned                    m_num_template_hits; // trees copied from the templates of the ast_manager
 #ifdef Z3DEBUG
         context *                   m_context;
 #endif
@@ -2825,19 +3034,117 @@ namespace smt {
         class mk_tree_trail : public mam_trail {
             ptr_vector<code_tree> & m_trees;
             unsigned                m_lbl_id;
+            unsigned *              m_num_cached_in_use; // 0 if the tree is not cached
         public:
-            mk_tree_trail(ptr_vector<code_tree> & t, unsigned id):m_trees(t), m_lbl_id(id) {}
+            mk_tree_trail(ptr_vector<code_tree> & t, unsigned id, unsigned * num_cached_in_use):
+                m_trees(t), m_lbl_id(id), m_num_cached_in_use(num_cached_in_use) {}
             virtual void undo(mam_impl & m) {
-                dealloc(m_trees[m_lbl_id]);
+                // All updates performed by insert were already undone. 
+                // So, a cached tree is back to its initial state, and it is owned by the cache.
+                if (m_num_cached_in_use == 0)
+                    dealloc(m_trees[m_lbl_id]);
+                else
+                    (*m_num_cached_in_use)--;
                 m_trees[m_lbl_id] = 0;
             }
         };
+
+        /**
+           \brief Return true if the code tree for mp can be cached. 
+           Ground subterms are compiled into instructions that contain enodes,
+           and these enodes are deleted during backtracking.
+        */
+        static bool is_cacheable(app * mp) {
+            ptr_buffer<expr> todo;
+            unsigned num_patterns = mp->get_num_args();
+            for (unsigned i = 0; i < num_patterns; i++) {
+                app * p = to_app(mp->get_arg(i));
+                todo.append(p->get_num_args(), p->get_args());
+            }
+            while (!todo.empty()) {
+                expr * e = todo.back();
+                todo.pop_back();
+                if (is_ground(e))
+                    return false;
+                if (is_app(e))
+                    todo.append(to_app(e)->get_num_args(), to_app(e)->get_args());
+            }
+            return true;
+        }
+
+        code_tree * mk_cached_tree(quantifier * qa, app * mp, unsigned first_idx) {
+            unsigned idx;
+            if (!m_cache.find(qa, mp, idx)) {
+                if (!is_cacheable(mp))
+                    return 0;
+                if (m_cached_trees.size() + mp->get_num_args() > m_max_cached_trees) {
+                    // the persistent region cannot release the instructions of a single tree.
+                    if (m_num_cached_in_use > 0 || mp->get_num_args() > m_max_cached_trees)
+                        return 0;
+                    reset_cache();
+                    m_num_cache_flushes++;
+                }
+                idx = m_cached_trees.size();
+                m_cached_trees.resize(idx + mp->get_num_args(), 0);
+                m_cache.insert(qa, mp, idx);
+                m_cache_pinned.push_back(qa);
+                m_cache_pinned.push_back(mp);
+            }
+            code_tree * r = m_cached_trees[idx + first_idx];
+            if (r == 0) {
+                // another context of the same manager may have compiled the tree already.
+                code_tree_templates & templates = code_tree_templates::get(m_ast_manager);
+                code_tree const * t             = templates.find(qa, mp, first_idx);
+                m_ct_manager.set_persistent(true);
+                if (t != 0) {
+                    r = m_ct_manager.mk_code_tree_copy(*t);
+                    m_num_template_hits++;
+                }
+                else {
+                    r = m_compiler.mk_tree(qa, mp, first_idx, false);
+                    templates.insert(qa, mp, first_idx, *r, m_max_cached_trees);
+                }
+                m_ct_manager.set_persistent(false);
+                DEBUG_CODE(r->set_context(m_context););
+                m_cached_trees[idx + first_idx] = r;
+            }
+            else {
+                m_num_cache_hits++;
+            }
+            TRACE("mam_cache", tout << "using cached tree for:\n" << mk_pp(mp, m_ast_manager) << "\nfirst_idx: " << first_idx << "\n";);
+            return r;
+        }
+
+        void reset_cache() {
+            ptr_vector<code_tree>::iterator it  = m_cached_trees.begin();
+            ptr_vector<code_tree>::iterator end = m_cached_trees.end();
+            for (; it != end; ++it) {
+                code_tree * t = *it;
+                if (t == 0)
+                    continue;
+                unsigned lbl_id = t->get_root_lbl()->get_decl_id();
+                if (lbl_id < m_trees.size() && m_trees[lbl_id] == t)
+                    m_trees[lbl_id] = 0;
+                dealloc(t);
+            }
+            m_cached_trees.reset();
+            m_cache.reset();
+            m_cache_pinned.reset();
+            m_ct_manager.reset_persistent();
+        }
         
     public:
-        code_tree_map(ast_manager & m, compiler & c, mam_trail_stack & s):
+        code_tree_map(ast_manager & m, compiler & c, code_tree_manager & ct, mam_trail_stack & s, unsigned max_cached_trees):
             m_ast_manager(m),
             m_compiler(c),
-            m_trail_stack(s) {
+            m_ct_manager(ct),
+            m_trail_stack(s),
+            m_cache_pinned(m),
+            m_max_cached_trees(max_cached_trees),
+            m_num_cached_in_use(0),
+            m_num_cache_hits(0),
+            m_num_cache_flushes(0),
+            m_num_template_hits(0) {
         }
 
 #ifdef Z3DEBUG
@@ -2845,6 +3152,7 @@ namespace smt {
 #endif
 
         ~code_tree_map() {
+            reset_cache();
             std::for_each(m_trees.begin(), m_trees.end(), delete_proc<code_tree>());
         }
 
@@ -2863,10 +3171,17 @@ namespace smt {
             unsigned lbl_id   = lbl->get_decl_id();
             m_trees.reserve(lbl_id+1, 0);
             if (m_trees[lbl_id] == 0) {
-                m_trees[lbl_id] = m_compiler.mk_tree(qa, mp, first_idx, false);
+                code_tree * tree = mk_cached_tree(qa, mp, first_idx);
+                bool cached      = tree != 0;
+                if (!cached) {
+                    tree = m_compiler.mk_tree(qa, mp, first_idx, false);
+                    DEBUG_CODE(tree->set_context(m_context););
+                }
+                m_trees[lbl_id] = tree;
                 SASSERT(m_trees[lbl_id]->expected_num_args() == p->get_num_args());
-                DEBUG_CODE(m_trees[lbl_id]->set_context(m_context););
-                m_trail_stack.push(mk_tree_trail(m_trees, lbl_id));
+                if (cached)
+                    m_num_cached_in_use++;
+                m_trail_stack.push(mk_tree_trail(m_trees, lbl_id, cached ? &m_num_cached_in_use : 0));
             }
             else {
                 code_tree * tree = m_trees[lbl_id];
@@ -2884,8 +3199,19 @@ namespace smt {
         }
 
         void reset() {
+            // Trees updated at the base level are not restored to their initial state.
+            // So, the cache is flushed.
+            reset_cache();
             std::for_each(m_trees.begin(), m_trees.end(), delete_proc<code_tree>());
             m_trees.reset();
+            m_num_cached_in_use = 0;
+        }
+
+        void collect_statistics(::statistics & st) const {
+            st.update("mam cached trees", m_cached_trees.size());
+            st.update("mam cache hits", m_num_cache_hits);
+            st.update("mam cache flushes", m_num_cache_flushes);
+            st.update("mam template hits", m_num_template_hits);
         }
 
         code_tree * get_code_tree_for(func_decl * lbl) const {
@@ -3783,7 +4109,7 @@ namespace smt {
             m_ct_manager(m_lbl_hasher, m_trail_stack),
             m_compiler(ctx, m_ct_manager, m_lbl_hasher, use_filters),
             m_interpreter(ctx, *this, use_filters),
-            m_trees(m_ast_manager, m_compiler, m_trail_stack),
+            m_trees(m_ast_manager, m_compiler, m_ct_manager, m_trail_stack, ctx.get_fparams().m_qi_max_cached_code_trees),
             m_region(m_trail_stack.get_region()),
             m_r1(0),
             m_r2(0) {
@@ -3837,6 +4163,10 @@ namespace smt {
             m_trail_stack.pop_scope(num_scopes);
         }
 
+        virtual void collect_statistics(::statistics & st) const {
+            m_trees.collect_statistics(st);
+        }
+
         virtual void reset() {
             m_trail_stack.reset();
             m_trees.reset();
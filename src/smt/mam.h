@@ -21,6 +21,7 @@ Revision History:
 
 #include"ast.h"
 #include"smt_types.h"
+#include"statistics.h"
 
 namespace smt {
     /**
@@ -55,6 +56,8 @@ namespace smt {
 
         virtual void reset() = 0;
 
+        virtual void collect_statistics(::statistics & st) const = 0;
+
         virtual void display(std::ostream& out) = 0;
         
         virtual void on_match(quantifier * q, app * pat, unsigned num_bindings, enode * const * bindings, unsigned max_generation, ptr_vector<enode> & used_enodes) = 0;
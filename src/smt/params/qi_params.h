@@ -36,6 +36,7 @@ struct qi_params {
     double             m_qi_lazy_threshold;
     unsigned           m_qi_max_eager_multipatterns;
     unsigned           m_qi_max_lazy_multipattern_matching;
+    unsigned           m_qi_max_cached_code_trees;
     bool               m_qi_profile;
     unsigned           m_qi_profile_freq;
     quick_checker_mode m_qi_quick_checker;
@@ -85,6 +86,7 @@ struct qi_params {
         m_qi_lazy_threshold(20.0), // reduced to give a chance to MBQI
         m_qi_max_eager_multipatterns(0),
         m_qi_max_lazy_multipattern_matching(2),
+        m_qi_max_cached_code_trees(1024),
         m_qi_profile(false),
         m_qi_profile_freq(UINT_MAX),
         m_qi_quick_checker(MC_NO),
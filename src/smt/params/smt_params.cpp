@@ -35,6 +35,12 @@ void smt_params::updt_local_params(params_ref const & _p) {
     m_delay_units_threshold = p.delay_units_threshold();
     m_preprocess = _p.get_bool("preprocess", true); // hidden parameter
     m_soft_timeout = p.soft_timeout();
+    m_lemma_gc_tiered = p.lemma_gc_tiered();
+    m_lemma_gc_core_glue = p.lemma_gc_core_glue();
+    m_lemma_gc_tier2_glue = p.lemma_gc_tier2_glue();
+    m_threads = p.threads();
+    m_threads_cube_depth = p.threads_cube_depth();
+    m_threads_cube_conflicts = p.threads_cube_conflicts();
     model_params mp(_p);
     m_model_compact = mp.compact();
     if (_p.get_bool("arith.greatest_error_pivot", false))
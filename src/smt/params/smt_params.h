@@ -151,6 +151,18 @@ struct smt_params : public preprocessor_params,
     unsigned          m_new_clause_relevancy; //!< Max. number of unassigned literals to be considered relevant.
     unsigned          m_old_clause_relevancy; //!< Max. number of unassigned literals to be considered relevant.
     double            m_inv_clause_decay;     //!< clause activity decay
+    bool              m_lemma_gc_tiered;      //!< partition lemmas in tiers based on their glue (LBD) when deleting lemmas.
+    unsigned          m_lemma_gc_core_glue;   //!< lemmas with glue <= m_lemma_gc_core_glue are never deleted.
+    unsigned          m_lemma_gc_tier2_glue;  //!< lemmas with glue <= m_lemma_gc_tier2_glue are kept while they are used in conflicts.
+
+    // -----------------------------------
+    //
+    // Parallel cube-and-conquer (smt::kernel)
+    //
+    // -----------------------------------
+    unsigned          m_threads;                //!< number of worker contexts, 1 disables the parallel mode.
+    unsigned          m_threads_cube_depth;     //!< number of case splits used to create the cubes, 0 - derived from m_threads.
+    unsigned          m_threads_cube_conflicts; //!< conflicts spent by the sequential search before the cubes are created.
     
     // -----------------------------------
     //
@@ -255,6 +267,12 @@ struct smt_params : public preprocessor_params,
         m_new_clause_relevancy(45), 
         m_old_clause_relevancy(6),
         m_inv_clause_decay(1),
+        m_lemma_gc_tiered(false),
+        m_lemma_gc_core_glue(2),
+        m_lemma_gc_tier2_glue(6),
+        m_threads(1),
+        m_threads_cube_depth(0),
+        m_threads_cube_conflicts(1000),
         m_smtlib_dump_lemmas(false),
         m_smtlib_logic("AUFLIA"),
         m_profile_res_sub(false),
@@ -31,9 +31,13 @@ void theory_arith_params::updt_params(params_ref const & _p) {
     m_arith_euclidean_solver = p.arith_euclidean_solver();
     m_arith_propagate_eqs = p.arith_propagate_eqs();
     m_arith_branch_cut_ratio = p.arith_branch_cut_ratio();
+    m_arith_branch_and_cut = p.arith_branch_and_cut();
+    m_arith_cuts_per_round = p.arith_cuts_per_round();
+    m_arith_cut_max_age = p.arith_cut_max_age();
     m_arith_int_eq_branching = p.arith_int_eq_branch();
     m_arith_ignore_int = p.arith_ignore_int();
     m_arith_bound_prop = static_cast<bound_prop_mode>(p.arith_propagation_mode());
+    m_arith_lazy_explanations = p.arith_lazy_explain();
 }
 
 
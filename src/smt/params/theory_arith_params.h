@@ -27,7 +27,8 @@ enum arith_solver_id {
     AS_DIFF_LOGIC,
     AS_ARITH,
     AS_DENSE_DIFF_LOGIC,
-    AS_UTVPI
+    AS_UTVPI,
+    AS_DUAL_SIMPLEX
 };
 
 enum bound_prop_mode {
@@ -54,6 +55,7 @@ struct theory_arith_params {
     bool                    m_arith_propagate_eqs;
     bound_prop_mode         m_arith_bound_prop; 
     bool                    m_arith_stronger_lemmas;
+    bool                    m_arith_lazy_explanations;
     bool                    m_arith_skip_rows_with_big_coeffs;
     unsigned                m_arith_max_lemma_size; 
     unsigned                m_arith_small_lemma_size;
@@ -70,6 +72,9 @@ struct theory_arith_params {
     bool                    m_arith_dump_lemmas;
     bool                    m_arith_eager_eq_axioms;
     unsigned                m_arith_branch_cut_ratio;
+    bool                    m_arith_branch_and_cut;
+    unsigned                m_arith_cuts_per_round;
+    unsigned                m_arith_cut_max_age;
     bool                    m_arith_int_eq_branching;
     bool                    m_arith_enum_const_mod;
 
@@ -113,6 +118,7 @@ struct theory_arith_params {
         m_arith_propagate_eqs(true),
         m_arith_bound_prop(BP_REFINE),
         m_arith_stronger_lemmas(true),
+        m_arith_lazy_explanations(false),
         m_arith_skip_rows_with_big_coeffs(true),
         m_arith_max_lemma_size(128),
         m_arith_small_lemma_size(16),
@@ -129,6 +135,9 @@ struct theory_arith_params {
         m_arith_dump_lemmas(false),
         m_arith_eager_eq_axioms(true),
         m_arith_branch_cut_ratio(2),
+        m_arith_branch_and_cut(false),
+        m_arith_cuts_per_round(4),
+        m_arith_cut_max_age(8),
         m_arith_int_eq_branching(false),
         m_arith_enum_const_mod(false),
         m_arith_gcd_test(true),
@@ -21,6 +21,7 @@ Revision History:
 
 void theory_bv_params::updt_params(params_ref const & _p) {
     smt_params_helper p(_p);
+    m_bv_mode = static_cast<bv_solver_id>(p.bv_solver());
     m_bv_reflect = p.bv_reflect();
     m_bv_enable_int2bv2int = p.bv_enable_int2bv(); 
 }
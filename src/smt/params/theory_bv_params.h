@@ -23,7 +23,8 @@ Revision History:
 
 enum bv_solver_id {
     BS_NO_BV,
-    BS_BLASTER
+    BS_BLASTER,
+    BS_LAZY_BLASTER
 };
 
 struct theory_bv_params {
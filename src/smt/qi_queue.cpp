@@ -62,6 +62,8 @@ namespace smt {
             warning_msg("invalid new_gen function '%s', switching to default one", m_params.m_qi_new_gen.c_str());
             VERIFY(m_parser.parse_string("cost", m_new_gen_function));
         }
+        m_evaluator.compile(m_cost_function, m_cost_code);
+        m_evaluator.compile(m_new_gen_function, m_new_gen_code);
         m_eager_cost_threshold = m_params.m_qi_eager_threshold;
     }
 
@@ -121,7 +123,7 @@ namespace smt {
     
     float qi_queue::get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
         quantifier_stat * stat = set_values(q, pat, generation, min_top_generation, max_top_generation, 0);
-        float r = m_evaluator(m_cost_function, m_vals.size(), m_vals.c_ptr());
+        float r = m_evaluator(m_cost_code, m_vals.size(), m_vals.c_ptr());
         stat->update_max_cost(r);
         return r;
     }
@@ -129,27 +131,44 @@ namespace smt {
     unsigned qi_queue::get_new_gen(quantifier * q, unsigned generation, float cost) {
         // max_top_generation and min_top_generation are not available for computing inc_gen
         set_values(q, 0, generation, 0, 0, cost);
-        float r = m_evaluator(m_new_gen_function, m_vals.size(), m_vals.c_ptr());
+        float r = m_evaluator(m_new_gen_code, m_vals.size(), m_vals.c_ptr());
         return static_cast<unsigned>(r);
     }
     
     void qi_queue::insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
-        quantifier * q         = static_cast<quantifier*>(f->get_data());
-        float cost             = get_cost(q, pat, generation, min_top_generation, max_top_generation);
-        TRACE("qi_queue_detail", 
-              tout << "new instance of " << q->get_qid() << ", weight " << q->get_weight()
-              << ", generation: " << generation << ", scope_level: " << m_context.get_scope_level() << ", cost: " << cost << "\n";
-              for (unsigned i = 0; i < f->get_num_args(); i++) {
-                  tout << "#" << f->get_arg(i)->get_owner_id() << " ";
-              }
-              tout << "\n";);
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
-        m_new_entries.push_back(entry(f, cost, generation));
+        // the cost is computed by instantiate(). The values used by the cost function
+        // do not change before that, since they are only updated by instantiations.
+        m_new_entries.push_back(new_entry(f, pat, generation, min_top_generation, max_top_generation));
+    }
+
+    /**
+       \brief Compute the cost of the new entries.
+    */
+    void qi_queue::score_new_entries() {
+        m_batch.reset();
+        svector<new_entry>::iterator it  = m_new_entries.begin();
+        svector<new_entry>::iterator end = m_new_entries.end();
+        for (; it != end; ++it) {
+            fingerprint * f = it->m_qb;
+            quantifier * q  = static_cast<quantifier*>(f->get_data());
+            float cost      = get_cost(q, it->m_pat, it->m_generation, it->m_min_top_generation, it->m_max_top_generation);
+            TRACE("qi_queue_detail", 
+                  tout << "new instance of " << q->get_qid() << ", weight " << q->get_weight()
+                  << ", generation: " << it->m_generation << ", scope_level: " << m_context.get_scope_level() << ", cost: " << cost << "\n";
+                  for (unsigned i = 0; i < f->get_num_args(); i++) {
+                      tout << "#" << f->get_arg(i)->get_owner_id() << " ";
+                  }
+                  tout << "\n";);
+            m_batch.push_back(entry(f, cost, it->m_generation));
+        }
+        m_new_entries.reset();
     }
 
     void qi_queue::instantiate() {
-        svector<entry>::iterator it               = m_new_entries.begin();
-        svector<entry>::iterator end              = m_new_entries.end();
+        score_new_entries();
+        svector<entry>::iterator it               = m_batch.begin();
+        svector<entry>::iterator end              = m_batch.end();
         unsigned                 since_last_check = 0;
         for (; it != end; ++it) {
             entry & curr       = *it;
@@ -178,7 +197,7 @@ namespace smt {
                 since_last_check = 0;
             }
         }
-        m_new_entries.reset();
+        m_batch.reset();
         TRACE("new_entries_bug", tout << "[qi:instatiate]\n";);
     }
 
@@ -50,6 +50,8 @@ namespace smt {
         expr_ref                      m_new_gen_function;
         cost_parser                   m_parser;
         cost_evaluator                m_evaluator;
+        cost_evaluator::code          m_cost_code;
+        cost_evaluator::code          m_new_gen_code;
         cached_var_subst              m_subst;
         svector<float>                m_vals;
         double                        m_eager_cost_threshold;
@@ -60,7 +62,18 @@ namespace smt {
             unsigned      m_instantiated:1;
             entry(fingerprint * f, float c, unsigned g):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false) {}
         };
-        svector<entry>                m_new_entries;
+        // candidate instances are scored in batches by instantiate()
+        struct new_entry {
+            fingerprint * m_qb;
+            app *         m_pat;
+            unsigned      m_generation;
+            unsigned      m_min_top_generation;
+            unsigned      m_max_top_generation;
+            new_entry(fingerprint * f, app * pat, unsigned g, unsigned min_top_g, unsigned max_top_g):
+                m_qb(f), m_pat(pat), m_generation(g), m_min_top_generation(min_top_g), m_max_top_generation(max_top_g) {}
+        };
+        svector<new_entry>            m_new_entries;
+        svector<entry>                m_batch;
         svector<entry>                m_delayed_entries;
         expr_ref_vector               m_instances;
         unsigned_vector               m_instantiated_trail;
@@ -75,6 +88,7 @@ namespace smt {
         quantifier_stat * set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost);
         float get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
         unsigned get_new_gen(quantifier * q, unsigned generation, float cost);
+        void score_new_entries();
         void instantiate(entry & ent);
         void get_min_max_costs(float & min, float & max) const;
         void display_instance_profile(fingerprint * f, quantifier * q, unsigned num_bindings, enode * const * bindings, unsigned proof_id, unsigned generation);
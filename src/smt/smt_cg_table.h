@@ -116,87 +116,85 @@ namespace smt {
        \brief Congruence table.
     */
     class cg_table {
-        struct cg_unary_hash {
-            unsigned operator()(enode * n) const {
+        /**
+           \brief Entries of the unary and binary congruence tables. The roots of the arguments
+           and the hash code are stored inline to avoid memory accesses to the enodes during lookups.
+           
+           Remark: the roots are computed when the entry is created, and they are still valid while
+           the entry is in the table, because the parents of an equivalence class are removed from 
+           the table before its root is updated (see context::merge).
+        */
+        struct cg_unary_entry {
+            enode *  m_n;
+            enode *  m_r1;
+            unsigned m_hash;
+            cg_unary_entry():m_n(0), m_r1(0), m_hash(0) {}
+            explicit cg_unary_entry(enode * n):
+                m_n(n), 
+                m_r1(n->get_arg(0)->get_root()), 
+                m_hash(m_r1->hash()) {
                 SASSERT(n->get_num_args() == 1);
-                return n->get_arg(0)->get_root()->hash();
+            }
+        };
+
+        struct cg_unary_hash {
+            unsigned operator()(cg_unary_entry const & e) const {
+                return e.m_hash;
             }
         };
 
         struct cg_unary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 1);
-                SASSERT(n2->get_num_args() == 1);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                return n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root();
+            bool operator()(cg_unary_entry const & e1, cg_unary_entry const & e2) const {
+                SASSERT(e1.m_n->get_decl() == e2.m_n->get_decl());
+                return e1.m_r1 == e2.m_r1;
             }
         };
 
-        typedef chashtable<enode *, cg_unary_hash, cg_unary_eq> unary_table;
-        
-        struct cg_binary_hash {
-            unsigned operator()(enode * n) const {
+        typedef chashtable<cg_unary_entry, cg_unary_hash, cg_unary_eq> unary_table;
+
+        struct cg_binary_entry {
+            enode *  m_n;
+            enode *  m_r1;
+            enode *  m_r2;
+            unsigned m_hash;
+            cg_binary_entry():m_n(0), m_r1(0), m_r2(0), m_hash(0) {}
+            cg_binary_entry(enode * n, bool comm):
+                m_n(n), 
+                m_r1(n->get_arg(0)->get_root()), 
+                m_r2(n->get_arg(1)->get_root()) {
                 SASSERT(n->get_num_args() == 2);
-                // too many collisions
-                // unsigned r = 17 + n->get_arg(0)->get_root()->hash();
-                // return r * 31 + n->get_arg(1)->get_root()->hash();
-                return combine_hash(n->get_arg(0)->get_root()->hash(), n->get_arg(1)->get_root()->hash());
+                unsigned h1 = m_r1->hash();
+                unsigned h2 = m_r2->hash();
+                if (comm && h1 > h2)
+                    std::swap(h1, h2);
+                m_hash = combine_hash(h1, h2);
             }
         };
 
-        struct cg_binary_eq {
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-#if 1
-                return 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-#else
-                bool r = 
-                    n1->get_arg(0)->get_root() == n2->get_arg(0)->get_root() &&
-                    n1->get_arg(1)->get_root() == n2->get_arg(1)->get_root();
-                static unsigned counter = 0;
-                static unsigned failed  = 0;
-                if (!r) 
-                    failed++;
-                counter++;
-                if (counter % 100000 == 0) 
-                    std::cerr << "[cg_eq] " << counter << " " << failed << "\n";
-                return r;
-#endif
+        struct cg_binary_hash {
+            unsigned operator()(cg_binary_entry const & e) const {
+                return e.m_hash;
             }
         };
 
-        typedef chashtable<enode*, cg_binary_hash, cg_binary_eq> binary_table;
-        
-        struct cg_comm_hash {
-            unsigned operator()(enode * n) const {
-                SASSERT(n->get_num_args() == 2);
-                unsigned h1 = n->get_arg(0)->get_root()->hash();
-                unsigned h2 = n->get_arg(1)->get_root()->hash();
-                if (h1 > h2)
-                    std::swap(h1, h2);
-                return hash_u((h1 << 16) | (h2 & 0xFFFF));
+        struct cg_binary_eq {
+            bool operator()(cg_binary_entry const & e1, cg_binary_entry const & e2) const {
+                SASSERT(e1.m_n->get_decl() == e2.m_n->get_decl());
+                return e1.m_r1 == e2.m_r1 && e1.m_r2 == e2.m_r2;
             }
         };
+
+        typedef chashtable<cg_binary_entry, cg_binary_hash, cg_binary_eq> binary_table;
         
         struct cg_comm_eq {
             bool & m_commutativity;
             cg_comm_eq(bool & c):m_commutativity(c) {}
-            bool operator()(enode * n1, enode * n2) const {
-                SASSERT(n1->get_num_args() == 2);
-                SASSERT(n2->get_num_args() == 2);
-                SASSERT(n1->get_decl() == n2->get_decl());
-                enode * c1_1 = n1->get_arg(0)->get_root();
-                enode * c1_2 = n1->get_arg(1)->get_root();
-                enode * c2_1 = n2->get_arg(0)->get_root();
-                enode * c2_2 = n2->get_arg(1)->get_root();
-                if (c1_1 == c2_1 && c1_2 == c2_2) {
+            bool operator()(cg_binary_entry const & e1, cg_binary_entry const & e2) const {
+                SASSERT(e1.m_n->get_decl() == e2.m_n->get_decl());
+                if (e1.m_r1 == e2.m_r1 && e1.m_r2 == e2.m_r2) {
                     return true;
                 }
-                if (c1_1 == c2_2 && c1_2 == c2_1) {
+                if (e1.m_r1 == e2.m_r2 && e1.m_r2 == e2.m_r1) {
                     m_commutativity = true;
                     return true;
                 }
@@ -204,7 +202,7 @@ namespace smt {
             }
         };
 
-        typedef chashtable<enode*, cg_comm_hash, cg_comm_eq> comm_table;
+        typedef chashtable<cg_binary_entry, cg_binary_hash, cg_comm_eq> comm_table;
 
         struct cg_hash {
             unsigned operator()(enode * n) const;
@@ -256,14 +254,14 @@ namespace smt {
             void * t = get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                n_prime = UNTAG(unary_table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(unary_table*, t)->insert_if_not_there(cg_unary_entry(n)).m_n;
                 return enode_bool_pair(n_prime, false);
             case BINARY:
-                n_prime = UNTAG(binary_table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(binary_table*, t)->insert_if_not_there(cg_binary_entry(n, false)).m_n;
                 return enode_bool_pair(n_prime, false);
             case BINARY_COMM:
                 m_commutativity = false;
-                n_prime = UNTAG(comm_table*, t)->insert_if_not_there(n);
+                n_prime = UNTAG(comm_table*, t)->insert_if_not_there(cg_binary_entry(n, true)).m_n;
                 return enode_bool_pair(n_prime, m_commutativity);
             default:
                 n_prime = UNTAG(table*, t)->insert_if_not_there(n);
@@ -276,13 +274,13 @@ namespace smt {
             void * t = get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                UNTAG(unary_table*, t)->erase(n);
+                UNTAG(unary_table*, t)->erase(cg_unary_entry(n));
                 break;
             case BINARY:
-                UNTAG(binary_table*, t)->erase(n);
+                UNTAG(binary_table*, t)->erase(cg_binary_entry(n, false));
                 break;
             case BINARY_COMM:
-                UNTAG(comm_table*, t)->erase(n);
+                UNTAG(comm_table*, t)->erase(cg_binary_entry(n, true));
                 break;
             default:
                 UNTAG(table*, t)->erase(n);
@@ -295,11 +293,11 @@ namespace smt {
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->contains(n);
+                return UNTAG(unary_table*, t)->contains(cg_unary_entry(n));
             case BINARY:
-                return UNTAG(binary_table*, t)->contains(n);
+                return UNTAG(binary_table*, t)->contains(cg_binary_entry(n, false));
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->contains(n);
+                return UNTAG(comm_table*, t)->contains(cg_binary_entry(n, true));
             default:
                 return UNTAG(table*, t)->contains(n);
             }
@@ -308,14 +306,16 @@ namespace smt {
         enode * find(enode * n) const {
             SASSERT(n->get_num_args() > 0);
             enode * r = 0;
+            cg_unary_entry  u;
+            cg_binary_entry b;
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) ? r : 0;
+                return UNTAG(unary_table*, t)->find(cg_unary_entry(n), u) ? u.m_n : 0;
             case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) ? r : 0;
+                return UNTAG(binary_table*, t)->find(cg_binary_entry(n, false), b) ? b.m_n : 0;
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) ? r : 0;
+                return UNTAG(comm_table*, t)->find(cg_binary_entry(n, true), b) ? b.m_n : 0;
             default:
                 return UNTAG(table*, t)->find(n, r) ? r : 0;
             }
@@ -323,15 +323,17 @@ namespace smt {
 
         bool contains_ptr(enode * n) const {
             enode * r;
+            cg_unary_entry  u;
+            cg_binary_entry b;
             SASSERT(n->get_num_args() > 0);
             void * t = const_cast<cg_table*>(this)->get_table(n); 
             switch (static_cast<table_kind>(GET_TAG(t))) {
             case UNARY:
-                return UNTAG(unary_table*, t)->find(n, r) && n == r;
+                return UNTAG(unary_table*, t)->find(cg_unary_entry(n), u) && n == u.m_n;
             case BINARY:
-                return UNTAG(binary_table*, t)->find(n, r) && n == r;
+                return UNTAG(binary_table*, t)->find(cg_binary_entry(n, false), b) && n == b.m_n;
             case BINARY_COMM:
-                return UNTAG(comm_table*, t)->find(n, r) && n == r;
+                return UNTAG(comm_table*, t)->find(cg_binary_entry(n, true), b) && n == b.m_n;
             default:
                 return UNTAG(table*, t)->find(n, r) && n == r;
             }
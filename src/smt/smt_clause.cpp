@@ -26,10 +26,12 @@ namespace smt {
        bool_var2expr_map is a mapping from bool_var -> expr, it is only used if save_atoms == true.
     */
     clause * clause::mk(ast_manager & m, unsigned num_lits, literal * lits, clause_kind k, justification * js, 
-                        clause_del_eh * del_eh, bool save_atoms, expr * const * bool_var2expr_map) {
+                        clause_del_eh * del_eh, bool save_atoms, expr * const * bool_var2expr_map, bool has_glue) {
         SASSERT(k == CLS_AUX || js == 0 || !js->in_region());
         SASSERT(num_lits >= 2);
-        unsigned sz                = get_obj_size(num_lits, k, save_atoms, del_eh != 0, js != 0);
+        SASSERT(num_lits < (1u << 24)); // m_capacity has 24 bits
+        has_glue                   = has_glue && k != CLS_AUX;
+        unsigned sz                = get_obj_size(num_lits, k, has_glue, save_atoms, del_eh != 0, js != 0);
         void * mem                 = m.get_allocator().allocate(sz);
         clause * cls               = new (mem) clause();
         cls->m_num_literals        = num_lits;
@@ -41,10 +43,13 @@ namespace smt {
         cls->m_has_del_eh          = del_eh != 0;
         cls->m_has_justification   = js != 0;
         cls->m_deleted             = false;
+        cls->m_has_glue            = has_glue;
         SASSERT(!m.proofs_enabled() || js != 0);
         memcpy(cls->m_lits, lits, sizeof(literal) * num_lits);
         if (cls->is_lemma())
             cls->set_activity(1);
+        if (has_glue)
+            cls->set_glue(num_lits);
         if (del_eh)
             *(const_cast<clause_del_eh **>(cls->get_del_eh_addr())) = del_eh;
         if (js)
@@ -85,7 +90,7 @@ namespace smt {
             SASSERT(m_reinit || get_atom(i) == 0);
             m.dec_ref(get_atom(i));
         }
-        m.get_allocator().deallocate(get_obj_size(m_capacity, get_kind(), m_has_atoms, m_has_del_eh, m_has_justification), this);
+        m.get_allocator().deallocate(get_obj_size(m_capacity, get_kind(), m_has_glue, m_has_atoms, m_has_del_eh, m_has_justification), this);
     }
 
     void clause::release_atoms(ast_manager & m) {
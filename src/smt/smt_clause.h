@@ -50,7 +50,8 @@ namespace smt {
        A clause has several optional fields, I store space for them only if they are actually used.
     */
     class clause {
-        unsigned m_num_literals;
+        unsigned m_num_literals:31;       //!< at most m_capacity
+        unsigned m_has_glue:1;            //!< true if the clause has memory space for storing its glue (only lemmas created when the tiered lemma gc is enabled).
         unsigned m_capacity:24;           //!< some of the clause literals can be simplified and removed, this field contains the original number of literals (used for GC).
         unsigned m_kind:2;                //!< kind
         unsigned m_reinit:1;              //!< true if the clause is in the reinit stack (only for learned clauses and aux_lemmas)
@@ -61,10 +62,12 @@ namespace smt {
         unsigned m_deleted:1;             //!< true if the clause is marked for deletion by was not deleted yet because it is referenced by some data-structure (e.g., m_lemmas)
         literal  m_lits[0];
 
-        static unsigned get_obj_size(unsigned num_lits, clause_kind k, bool has_atoms, bool has_del_eh, bool has_justification) {
+        static unsigned get_obj_size(unsigned num_lits, clause_kind k, bool has_glue, bool has_atoms, bool has_del_eh, bool has_justification) {
             unsigned r = sizeof(clause) + sizeof(literal) * num_lits;
             if (k != CLS_AUX)
                 r += sizeof(unsigned);
+            if (has_glue)
+                r += sizeof(unsigned);
             /* dvitek: Fix alignment issues on 64-bit platforms.  The
              * 'if' statement below probably isn't worthwhile since
              * I'm guessing the allocator is probably going to round
@@ -89,10 +92,20 @@ namespace smt {
             return reinterpret_cast<unsigned *>(m_lits + m_capacity);
         }
 
+        unsigned const * get_glue_addr() const {
+            return get_activity_addr() + 1;
+        }
+
+        unsigned * get_glue_addr() {
+            return get_activity_addr() + 1;
+        }
+
         clause_del_eh * const * get_del_eh_addr() const {
             unsigned const * addr = get_activity_addr();
             if (is_lemma())
                 addr ++;
+            if (m_has_glue)
+                addr ++;
             /* dvitek: It would be better to use uintptr_t than
              * size_t, but we need to wait until c++11 support is
              * really available.
@@ -150,7 +163,8 @@ namespace smt {
         
     public:
         static clause * mk(ast_manager & m, unsigned num_lits, literal * lits, clause_kind k, justification * js = 0, 
-                           clause_del_eh * del_eh = 0, bool save_atoms = false, expr * const * bool_var2expr_map = 0);
+                           clause_del_eh * del_eh = 0, bool save_atoms = false, expr * const * bool_var2expr_map = 0,
+                           bool has_glue = false);
         
         void deallocate(ast_manager & m);
         
@@ -210,6 +224,24 @@ namespace smt {
             *(get_activity_addr()) = act;
         }
 
+        /**
+           \brief Return the number of distinct decision levels in the clause when it was created (LBD).
+           It is only updated downwards when the clause is used during conflict resolution.
+        */
+        bool has_glue() const {
+            return m_has_glue;
+        }
+
+        unsigned get_glue() const {
+            SASSERT(has_glue());
+            return *(get_glue_addr());
+        }
+
+        void set_glue(unsigned glue) {
+            SASSERT(has_glue());
+            *(get_glue_addr()) = glue;
+        }
+
         clause_del_eh * get_del_eh() const {
             return m_has_del_eh ? *(get_del_eh_addr()) : 0;
         }
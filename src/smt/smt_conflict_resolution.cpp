@@ -491,8 +491,15 @@ namespace smt {
             switch (js.get_kind()) {
             case b_justification::CLAUSE: {
                 clause * cls = js.get_clause();
-                if (cls->is_lemma())
+                if (cls->is_lemma()) {
                     cls->inc_clause_activity();
+                    if (cls->has_glue() && cls->get_glue() > m_params.m_lemma_gc_core_glue) {
+                        // all literals of an antecedent are assigned, the glue can only get better.
+                        unsigned glue = m_ctx.get_num_diff_levels(cls->get_num_literals(), cls->begin_literals());
+                        if (glue < cls->get_glue())
+                            cls->set_glue(glue);
+                    }
+                }
                 unsigned num_lits = cls->get_num_literals();
                 unsigned i        = 0;
                 if (consequent != false_literal) {
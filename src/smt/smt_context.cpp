@@ -36,6 +36,7 @@ Revision History:
 #include"smt_model_finder.h"
 #include"model_pp.h"
 #include"ast_smt2_pp.h"
+#include"smt_parallel.h"
 
 namespace smt {
 
@@ -45,6 +46,7 @@ namespace smt {
         m_params(_p),
         m_setup(*this, p),
         m_cancel_flag(false),
+        m_par(0),
         m_asserted_formulas(m, p),
         m_qmanager(alloc(quantifier_manager, *this, p, _p)),
         m_model_generator(alloc(model_generator, m)),
@@ -60,6 +62,7 @@ namespace smt {
         m_cg_table(m),
         m_dyn_ack_manager(*this, p),
         m_is_diseq_tmp(0),
+        m_record_binaries(false),
         m_units_to_reassert(m_manager),
         m_qhead(0),
         m_simp_qhead(0),
@@ -82,7 +85,9 @@ namespace smt {
         m_generation(0),
         m_last_search_result(l_undef),
         m_last_search_failure(UNKNOWN),
-        m_searching(false) {
+        m_searching(false),
+        m_num_conflicts_since_lemma_gc(0),
+        m_lemma_gc_threshold(p.m_lemma_gc_initial) {
 
         SASSERT(m_scope_lvl == 0);
         SASSERT(m_base_lvl == 0);
@@ -1037,6 +1042,7 @@ namespace smt {
             m_manager.inc_ref(eq);
             m_is_diseq_tmp->m_func_decl_id = UINT_MAX;
             m_is_diseq_tmp->m_owner = eq;
+            m_is_diseq_tmp->m_hash  = eq->hash();
         }
         m_is_diseq_tmp->m_args[0] = n1;
         m_is_diseq_tmp->m_args[1] = n2;
@@ -2532,7 +2538,9 @@ namespace smt {
        \brief Delete low activity lemmas
     */
     inline void context::del_inactive_lemmas() {
-        if (m_fparams.m_lemma_gc_half)
+        if (m_fparams.m_lemma_gc_tiered)
+            del_inactive_lemmas3();
+        else if (m_fparams.m_lemma_gc_half)
             del_inactive_lemmas1();
         else
             del_inactive_lemmas2();
@@ -2648,6 +2656,118 @@ namespace smt {
         IF_VERBOSE(2, verbose_stream() << " :num-deleted-clauses " << num_del_cls << ")" << std::endl;);
     }
 
+    /**
+       \brief Glue based version of del_inactive_lemmas. The lemmas are partitioned in three tiers:
+
+       - core:  glue <= m_lemma_gc_core_glue, they are never deleted.
+       
+       - tier2: glue <= m_lemma_gc_tier2_glue, they are kept if they were used in a conflict since the 
+         last garbage collection, and are moved to the local tier otherwise.
+
+       - local: the less active half of the remaining lemmas is deleted.
+
+       The m_recent_lemmas_size most recent lemmas are not deleted.
+    */
+    void context::del_inactive_lemmas3() {
+        unsigned sz            = m_lemmas.size();
+        unsigned start_at      = m_base_lvl == 0 ? 0 : m_base_scopes[m_base_lvl - 1].m_lemmas_lim;
+        SASSERT(start_at <= sz);
+        if (start_at + m_fparams.m_recent_lemmas_size >= sz)
+            return;
+        IF_VERBOSE(2, verbose_stream() << "(smt.delete-inactive-lemmas"; verbose_stream().flush(););
+        unsigned end_at        = sz - m_fparams.m_recent_lemmas_size;
+        unsigned i             = start_at;
+        unsigned j             = i;
+        unsigned num_del_cls   = 0;
+        unsigned num_core      = 0;
+        unsigned num_tier2     = 0;
+        clause_vector local;
+        for (; i < end_at; i++) {
+            clause * cls = m_lemmas[i];
+            if (!can_delete(cls)) {
+                m_lemmas[j] = cls;
+                j++;
+                continue;
+            }
+            if (cls->deleted()) {
+                del_clause(cls);
+                num_del_cls++;
+                continue;
+            }
+            // lemmas created before the tiered gc was enabled have no glue.
+            unsigned glue = cls->has_glue() ? cls->get_glue() : UINT_MAX;
+            if (glue <= m_fparams.m_lemma_gc_core_glue) {
+                num_core++;
+                m_lemmas[j] = cls;
+                j++;
+            }
+            else if (glue <= m_fparams.m_lemma_gc_tier2_glue && cls->get_activity() > 0) {
+                // the activity is used to detect whether the lemma is used until the next garbage collection.
+                num_tier2++;
+                cls->set_activity(0);
+                m_lemmas[j] = cls;
+                j++;
+            }
+            else {
+                local.push_back(cls);
+            }
+        }
+        std::stable_sort(local.begin(), local.end(), clause_lt());
+        unsigned num_local  = local.size();
+        unsigned num_keep   = num_local / 2;
+        for (unsigned k = 0; k < num_local; k++) {
+            clause * cls = local[k];
+            if (k < num_keep) {
+                cls->set_activity(cls->get_activity() / 2);
+                m_lemmas[j] = cls;
+                j++;
+            }
+            else {
+                TRACE("del_inactive_lemmas", tout << "deleting: "; display_clause(tout, cls); tout << ", activity: " << 
+                      cls->get_activity() << ", glue: " << (cls->has_glue() ? cls->get_glue() : UINT_MAX) << "\n";);
+                del_clause(cls);
+                num_del_cls++;
+            }
+        }
+        // keep recent clauses
+        for (; i < sz; i++) {
+            clause * cls = m_lemmas[i];
+            if (cls->deleted() && can_delete(cls)) {
+                del_clause(cls);
+                num_del_cls++;
+            }
+            else {
+                m_lemmas[j] = cls;
+                j++;
+            }
+        }
+        m_lemmas.shrink(j);
+        IF_VERBOSE(2, verbose_stream() << " :num-deleted-clauses " << num_del_cls << " :core " << num_core << " :tier2 " << num_tier2 << ")" << std::endl;);
+    }
+
+    /**
+       \brief Return the number of distinct decision levels in the given literals.
+       Unassigned literals are considered to be in the same (next) level.
+    */
+    unsigned context::get_num_diff_levels(unsigned num_lits, literal const * lits) {
+        m_diff_levels.reserve(m_scope_lvl + 2, false);
+        unsigned r = 0;
+        for (unsigned i = 0; i < num_lits; i++) {
+            literal l    = lits[i];
+            unsigned lvl = get_assignment(l) == l_undef ? m_scope_lvl + 1 : get_assign_level(l);
+            if (!m_diff_levels[lvl]) {
+                m_diff_levels[lvl] = true;
+                r++;
+            }
+        }
+        for (unsigned i = 0; i < num_lits; i++) {
+            literal l    = lits[i];
+            unsigned lvl = get_assignment(l) == l_undef ? m_scope_lvl + 1 : get_assign_level(l);
+            m_diff_levels[lvl] = false;
+        }
+        return r;
+    }
+
     /**
        \brief Return true if "cls" has more than (or equal to) k unassigned literals.
     */
@@ -3090,12 +3210,15 @@ namespace smt {
         m_incomplete_theories.reset();
         m_num_conflicts                = 0;
         m_num_conflicts_since_restart  = 0;
-        m_num_conflicts_since_lemma_gc = 0;
+        if (!m_fparams.m_lemma_gc_tiered) {
+            // The tiered lemma garbage collection is amortized over all check-sat calls.
+            m_num_conflicts_since_lemma_gc = 0;
+            m_lemma_gc_threshold           = m_fparams.m_lemma_gc_initial;
+        }
         m_restart_threshold            = m_fparams.m_restart_initial;
         m_restart_outer_threshold      = m_fparams.m_restart_initial;
         m_agility                      = 0.0;
         m_luby_idx                     = 1;
-        m_lemma_gc_threshold           = m_fparams.m_lemma_gc_initial;
         m_last_search_failure          = OK;
         m_unsat_proof                  = 0;
         m_unsat_core                   .reset();
@@ -3990,6 +4113,8 @@ namespace smt {
     void context::set_cancel_flag(bool f) {
         m_cancel_flag = f;
         m_asserted_formulas.set_cancel_flag(f);
+        if (m_par)
+            m_par->set_cancel(f);
     }
 
 };
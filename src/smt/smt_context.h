@@ -63,9 +63,11 @@ Revision History:
 namespace smt {
 
     class model_generator;
+    class parallel;
 
     class context {
         friend class model_generator;
+        friend class parallel;
     public:
         statistics                  m_stats;
 
@@ -80,6 +82,7 @@ namespace smt {
         params_ref                  m_params;
         setup                       m_setup;
         volatile bool               m_cancel_flag;
+        parallel *                  m_par;         //!< workers of the parallel mode, cancelled together with this context.
         timer                       m_timer;
         asserted_formulas           m_asserted_formulas;
         scoped_ptr<quantifier_manager>   m_qmanager;
@@ -164,6 +167,9 @@ namespace smt {
         svector<double>             m_activity;    
         clause_vector               m_aux_clauses; 
         clause_vector               m_lemmas;
+        svector<bool>               m_diff_levels; //!< auxiliary field used to compute the glue of lemmas
+        bool                        m_record_binaries; //!< store learned binary clauses in m_learned_binaries (lemma sharing in parallel mode)
+        literal_vector              m_learned_binaries;
         vector<clause_vector>       m_clauses_to_reinit;
         expr_ref_vector             m_units_to_reassert;
         svector<char>               m_units_to_reassert_sign;
@@ -407,6 +413,8 @@ namespace smt {
         unsigned get_assign_level(literal l) const {
             return get_assign_level(l.var());
         }
+
+        unsigned get_num_diff_levels(unsigned num_lits, literal const * lits);
         
         /**
            \brief Return the scope level when v was internalized.
@@ -1028,6 +1036,8 @@ namespace smt {
 
         void del_inactive_lemmas2();
 
+        void del_inactive_lemmas3();
+
         bool more_than_k_unassigned_literals(clause * cls, unsigned k);
 
         void internalize_assertions();
@@ -380,6 +380,7 @@ namespace smt {
         st.update("max generation", m_stats.m_max_generation);
         st.update("minimized lits", m_stats.m_num_minimized_lits);
         st.update("num checks", m_stats.m_num_checks);
+        st.update("parallel cubes", m_stats.m_num_par_cubes);
 #if 0
         // missing?
         st.update("sat conflicts", m_stats.m_num_sat_conflicts);
@@ -30,6 +30,7 @@ namespace smt {
         SASSERT(m.is_bool(owner) || !merge_tf);
         enode * n             = new (mem) enode();
         n->m_owner            = owner;
+        n->m_hash             = owner->hash();
         n->m_root             = n;
         n->m_next             = n;
         n->m_cg               = 0;
@@ -424,6 +425,7 @@ namespace smt {
         memset(m_enode_data, 0, sz);
         enode * n = get_enode();
         n->m_owner         = m_app.get_app();
+        n->m_hash          = n->m_owner->hash();
         n->m_root          = n;
         n->m_next          = n;
         n->m_class_size    = 1;
@@ -72,9 +72,10 @@ namespace smt {
         enode *             m_root;     //!< Representative of the equivalence class
         enode *             m_next;     //!< Next element in the equivalence class.
         enode *             m_cg;       
+        // The fields accessed by merge and the congruence table (including m_hash and m_func_decl_id) 
+        // are stored in the first cache line. Fields that are rarely used are stored before m_args.
         unsigned            m_class_size;    //!< Size of the equivalence class if the enode is the root.
-        unsigned            m_generation; //!< Tracks how many quantifier instantiation rounds were needed to generate this enode.
-
+        unsigned            m_hash;          //!< Cached m_owner->hash(). It avoids a memory access to m_owner when the congruence table is used.
         unsigned            m_func_decl_id; //!< Id generated by the congruence table for fast indexing.
 
         unsigned            m_mark:1;        //!< Multi-purpose auxiliary mark. 
@@ -86,7 +87,6 @@ namespace smt {
         unsigned            m_bool:1;           //!< True if it is a boolean enode
         unsigned            m_merge_tf:1;       //!< True if the enode should be merged with true/false when the associated boolean variable is assigned.
         unsigned            m_cgc_enabled:1;    //!< True if congruence closure is enabled for this enode.
-        unsigned            m_iscope_lvl;       //!< When the enode was internalized
         /*
           The following property is valid for m_parents
           
@@ -105,9 +105,11 @@ namespace smt {
         enode_vector        m_parents;          //!< Parent enodes of the equivalence class.
         theory_var_list     m_th_var_list;      //!< List of theories that 'care' about this enode.
         trans_justification m_trans;            //!< A justification for the enode being equal to its root.
-        char                m_lbl_hash;         //!< It is different from -1, if enode is used in a pattern
         approx_set          m_lbls;
         approx_set          m_plbls;
+        unsigned            m_generation;       //!< Tracks how many quantifier instantiation rounds were needed to generate this enode.
+        unsigned            m_iscope_lvl;       //!< When the enode was internalized
+        char                m_lbl_hash;         //!< It is different from -1, if enode is used in a pattern
         enode *             m_args[0];          //!< Cached args
         
         friend class context;
@@ -189,7 +191,7 @@ namespace smt {
         }
 
         unsigned hash() const {
-            return m_owner->hash();
+            return m_hash;
         }
 
         enode * get_root() const { 
@@ -1303,6 +1303,10 @@ namespace smt {
             activity = 1;
         bool     lemma = k != CLS_AUX;
         m_stats.m_num_mk_lits += num_lits;
+        if (lemma && num_lits == 2 && m_record_binaries) {
+            m_learned_binaries.push_back(lits[0]);
+            m_learned_binaries.push_back(lits[1]);
+        }
         switch (num_lits) {
         case 0:
             if (j && !j->in_region())
@@ -1335,9 +1339,12 @@ namespace smt {
             bool save_atoms     = lemma && iscope_lvl > m_base_lvl;
             bool reinit         = save_atoms;
             SASSERT(!lemma || j == 0 || !j->in_region());
-            clause * cls = clause::mk(m_manager, num_lits, lits, k, j, del_eh, save_atoms, m_bool_var2expr.c_ptr());
+            // the glue is only stored when it is used, to save memory.
+            clause * cls = clause::mk(m_manager, num_lits, lits, k, j, del_eh, save_atoms, m_bool_var2expr.c_ptr(), m_fparams.m_lemma_gc_tiered);
             if (lemma) {
                 cls->set_activity(activity);
+                if (cls->has_glue())
+                    cls->set_glue(get_num_diff_levels(num_lits, lits));
                 if (k == CLS_LEARNED) {
                     int w2_idx  = select_learned_watch_lit(cls);
                     cls->swap_lits(1, w2_idx);
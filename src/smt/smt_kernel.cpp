@@ -18,6 +18,7 @@ Revision History:
 --*/
 #include"smt_kernel.h"
 #include"smt_context.h" 
+#include"smt_parallel.h"
 #include"ast_smt2_pp.h"
 #include"smt_params_helper.hpp"
 
@@ -84,6 +85,10 @@ namespace smt {
         }
 
         lbool setup_and_check() {
+            if (fparams().m_threads > 1) {
+                parallel p(m_kernel);
+                return p.setup_and_check();
+            }
             return m_kernel.setup_and_check();
         }
 
@@ -92,6 +97,10 @@ namespace smt {
         }
         
         lbool check(unsigned num_assumptions, expr * const * assumptions) {
+            if (fparams().m_threads > 1) {
+                parallel p(m_kernel);
+                return p(num_assumptions, assumptions);
+            }
             return m_kernel.check(num_assumptions, assumptions);
         }
         
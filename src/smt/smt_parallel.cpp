@@ -0,0 +1,504 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Parallel cube-and-conquer mode for smt::kernel.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_parallel.h"
+#include"smt_context.h"
+#include"ast_translation.h"
+#include"ast_lt.h"
+#include"model.h"
+#include"z3_exception.h"
+#include"z3_omp.h"
+
+namespace smt {
+
+    struct parallel::worker {
+        scoped_ptr<ast_manager> m_manager;
+        smt_params              m_params;
+        scoped_ptr<context>     m_ctx;
+        expr_ref_vector         m_atoms;         // translation of parallel::m_atoms
+        expr_ref_vector         m_assumptions;   // translation of the assumptions
+        obj_hashtable<expr>     m_assumption_set;
+        expr_ref_vector         m_proxies;       // m_proxies[j] is equivalent to the j-th cube atom
+        obj_hashtable<func_decl> m_proxy_decls;
+        unsigned_vector         m_var2atom;
+        unsigned                m_num_bool_vars; // number of Boolean variables when m_var2atom was updated
+        unsigned                m_units_head;
+        unsigned                m_pool_head;
+        key_set                 m_keys;          // lemmas already exported or imported
+        obj_hashtable<expr>     m_core;          // assumptions used to refute cubes
+
+        worker(ast_manager & m, smt_params const & p, params_ref const & ps, unsigned id):
+            m_manager(alloc(ast_manager, m, !m.proof_mode())),
+            m_params(p),
+            m_atoms(*m_manager),
+            m_assumptions(*m_manager),
+            m_proxies(*m_manager),
+            m_num_bool_vars(0),
+            m_units_head(0),
+            m_pool_head(0) {
+            m_params.m_threads     = 1;
+            m_params.m_random_seed = p.m_random_seed + id;
+            m_ctx = alloc(context, *m_manager, m_params, ps);
+        }
+
+        ast_manager & m() { return *m_manager; }
+    };
+
+    parallel::parallel(context & ctx):
+        m_ctx(ctx),
+        m_atoms(ctx.get_manager()),
+        m_cancel(false) {
+    }
+
+    parallel::~parallel() {
+        #pragma omp critical (smt_parallel)
+        {
+            if (m_ctx.m_par == this)
+                m_ctx.m_par = 0;
+        }
+        std::for_each(m_workers.begin(), m_workers.end(), delete_proc<worker>());
+    }
+
+    /**
+       \brief A lemma is a unit (l1 == l2) or a binary clause, and l1 and l2 are
+       literals over m_atoms: 2*atom + sign.
+    */
+    uint64 parallel::mk_key(unsigned l1, unsigned l2) {
+        if (l1 > l2)
+            std::swap(l1, l2);
+        return (static_cast<uint64>(l1) << 32) | static_cast<uint64>(l2);
+    }
+
+    bool parallel::use_par() const {
+#ifdef _NO_OMP_
+        return false;
+#else
+        // the workers only receive the asserted formulas: proofs and the macros found
+        // by the preprocessor cannot be transferred. Nested parallelism is not supported.
+        return
+            m_ctx.get_fparams().m_threads > 1 &&
+            !m_ctx.get_manager().proofs_enabled() &&
+            m_ctx.get_num_macros() == 0 &&
+            0 == omp_in_parallel();
+#endif
+    }
+
+    static void update_var2atom(context & ctx, expr_ref_vector const & atoms, unsigned_vector & var2atom) {
+        for (unsigned j = 0; j < atoms.size(); j++) {
+            expr * e = atoms.get(j);
+            if (ctx.b_internalized(e)) {
+                bool_var v = ctx.get_bool_var(e);
+                var2atom.reserve(v + 1, UINT_MAX);
+                var2atom[v] = j;
+            }
+        }
+    }
+
+    static unsigned lit2atom_lit(unsigned_vector const & var2atom, literal l) {
+        unsigned v = l.var();
+        if (v >= var2atom.size() || var2atom[v] == UINT_MAX)
+            return UINT_MAX;
+        return 2 * var2atom[v] + (l.sign() ? 1 : 0);
+    }
+
+    /**
+       \brief Collect the Boolean atoms of the asserted formulas that were internalized.
+       Atoms nested in quantifiers are ignored.
+    */
+    void parallel::init_atoms(unsigned num_assumptions, expr * const * assumptions) {
+        ast_manager & m = m_ctx.get_manager();
+        ast_mark         visited;
+        ptr_vector<expr> todo;
+        unsigned num = m_ctx.get_num_asserted_formulas();
+        for (unsigned i = 0; i < num; i++)
+            todo.push_back(m_ctx.get_asserted_formula(i));
+        for (unsigned i = 0; i < num_assumptions; i++)
+            todo.push_back(assumptions[i]);
+        while (!todo.empty()) {
+            expr * e = todo.back();
+            todo.pop_back();
+            if (!is_app(e) || visited.is_marked(e))
+                continue;
+            visited.mark(e, true);
+            if (m.is_bool(e) && !m.is_true(e) && !m.is_false(e) && m_ctx.b_internalized(e))
+                m_atoms.push_back(e);
+            todo.append(to_app(e)->get_num_args(), to_app(e)->get_args());
+        }
+    }
+
+    /**
+       \brief Select the most active atoms that are not assigned at the base level.
+       Activity is the measure used by the default case split queue.
+    */
+    void parallel::init_cube_atoms(unsigned num_assumptions, expr * const * assumptions) {
+        ast_manager & m  = m_ctx.get_manager();
+        smt_params & fp  = m_ctx.get_fparams();
+        obj_hashtable<expr> assumption_atoms;
+        for (unsigned i = 0; i < num_assumptions; i++) {
+            expr * a = assumptions[i];
+            m.is_not(a, a);
+            assumption_atoms.insert(a);
+        }
+        svector<std::pair<double, unsigned> > candidates;
+        for (unsigned j = 0; j < m_atoms.size(); j++) {
+            expr * e = m_atoms.get(j);
+            if (assumption_atoms.contains(e))
+                continue;
+            bool_var v = m_ctx.get_bool_var(e);
+            if (m_ctx.get_assignment(v) != l_undef && m_ctx.get_assign_level(v) <= m_ctx.get_base_level())
+                continue;
+            candidates.push_back(std::make_pair(-m_ctx.get_activity(v), j));
+        }
+        std::sort(candidates.begin(), candidates.end());
+        unsigned depth = fp.m_threads_cube_depth;
+        if (depth == 0)
+            depth = log2(fp.m_threads) + 2;
+        depth = std::min(depth, std::min(candidates.size(), 16u));
+        for (unsigned i = 0; i < depth; i++)
+            m_cube_atoms.push_back(candidates[i].second);
+    }
+
+    void parallel::init_workers(unsigned num_workers, unsigned num_assumptions, expr * const * assumptions) {
+        ast_manager & m = m_ctx.get_manager();
+        for (unsigned i = 0; i < num_workers; i++) {
+            worker * w = alloc(worker, m, m_ctx.get_fparams(), m_ctx.get_params(), i + 1);
+            m_workers.push_back(w);
+            ast_manager & wm = w->m();
+            context & wctx   = *(w->m_ctx);
+            ast_translation tr(m, wm);
+            wctx.set_logic(m_ctx.m_setup.get_logic());
+            wctx.m_record_binaries = true;
+            unsigned num = m_ctx.get_num_asserted_formulas();
+            for (unsigned j = 0; j < num; j++)
+                wctx.assert_expr(tr(m_ctx.get_asserted_formula(j)));
+            for (unsigned j = 0; j < m_atoms.size(); j++)
+                w->m_atoms.push_back(tr(m_atoms.get(j)));
+            for (unsigned j = 0; j < num_assumptions; j++) {
+                w->m_assumptions.push_back(tr(assumptions[j]));
+                w->m_assumption_set.insert(w->m_assumptions.back());
+            }
+            for (unsigned j = 0; j < m_cube_atoms.size(); j++) {
+                app * p = wm.mk_fresh_const("cube", wm.mk_bool_sort());
+                w->m_proxies.push_back(p);
+                w->m_proxy_decls.insert(p->get_decl());
+                wctx.assert_expr(wm.mk_eq(p, w->m_atoms.get(m_cube_atoms[j])));
+            }
+        }
+    }
+
+    /**
+       \brief Store in keys the literals assigned at the base level and the learned binary
+       clauses of ctx that only contain atoms in the domain of var2atom.
+    */
+    void parallel::collect_lemmas(context & ctx, unsigned_vector & var2atom, unsigned & units_head, svector<uint64> & keys) {
+        literal_vector const & trail = ctx.m_assigned_literals;
+        unsigned base_lvl = ctx.get_base_level();
+        unsigned i = std::min(units_head, trail.size());
+        for (; i < trail.size() && ctx.get_assign_level(trail[i]) <= base_lvl; i++) {
+            unsigned l = lit2atom_lit(var2atom, trail[i]);
+            if (l != UINT_MAX)
+                keys.push_back(mk_key(l, l));
+        }
+        units_head = i;
+        literal_vector & bins = ctx.m_learned_binaries;
+        for (unsigned j = 0; j + 1 < bins.size(); j += 2) {
+            unsigned l1 = lit2atom_lit(var2atom, bins[j]);
+            unsigned l2 = lit2atom_lit(var2atom, bins[j+1]);
+            if (l1 != UINT_MAX && l2 != UINT_MAX && l1 != (l2 ^ 1))
+                keys.push_back(mk_key(l1, l2));
+        }
+        bins.reset();
+    }
+
+    void parallel::export_lemmas(unsigned owner, svector<uint64> const & keys) {
+        if (keys.empty())
+            return;
+        #pragma omp critical (smt_parallel)
+        {
+            for (unsigned i = 0; i < keys.size(); i++) {
+                uint64 k = keys[i];
+                if (!m_pool_keys.contains(k)) {
+                    m_pool_keys.insert(k);
+                    m_pool.push_back(k);
+                    m_pool_owner.push_back(owner);
+                }
+            }
+        }
+    }
+
+    /**
+       \brief Assert the lemmas exported by the other workers since the last import.
+    */
+    void parallel::import_lemmas(unsigned owner) {
+        worker & w       = *(m_workers[owner]);
+        ast_manager & wm = w.m();
+        svector<uint64> keys;
+        #pragma omp critical (smt_parallel)
+        {
+            for (unsigned i = w.m_pool_head; i < m_pool.size(); i++) {
+                if (m_pool_owner[i] != owner)
+                    keys.push_back(m_pool[i]);
+            }
+            w.m_pool_head = m_pool.size();
+        }
+        for (unsigned i = 0; i < keys.size(); i++) {
+            uint64 k = keys[i];
+            if (w.m_keys.contains(k))
+                continue;
+            w.m_keys.insert(k);
+            unsigned l1 = static_cast<unsigned>(k >> 32);
+            unsigned l2 = static_cast<unsigned>(k & 0xFFFFFFFF);
+            expr_ref e1(w.m_atoms.get(l1 / 2), wm);
+            expr_ref e2(w.m_atoms.get(l2 / 2), wm);
+            if (l1 % 2 == 1)
+                e1 = wm.mk_not(e1);
+            if (l2 % 2 == 1)
+                e2 = wm.mk_not(e2);
+            if (l1 == l2)
+                w.m_ctx->assert_expr(e1);
+            else
+                w.m_ctx->assert_expr(wm.mk_or(e1, e2));
+        }
+    }
+
+    /**
+       \brief Solve the given cube using the context of the given worker.
+       Return l_false if the cube is refuted. The assumptions used to refute it are
+       stored in the core of the worker, and the context is inconsistent with the
+       assumptions (independently of the cube) if m_ctx.get_unsat_core() does not
+       contain cube literals.
+    */
+    lbool parallel::check_cube(unsigned owner, unsigned cube) {
+        worker & w       = *(m_workers[owner]);
+        ast_manager & wm = w.m();
+        context & wctx   = *(w.m_ctx);
+        expr_ref_vector asms(w.m_assumptions);
+        for (unsigned j = 0; j < w.m_proxies.size(); j++) {
+            expr * p = w.m_proxies.get(j);
+            asms.push_back((cube >> j) & 1 ? wm.mk_not(p) : p);
+        }
+        // the cancel flag of the worker is not reset: it may have been set by another worker.
+        lbool r = wctx.check(asms.size(), asms.c_ptr(), false);
+        if (r == l_false) {
+            for (unsigned i = 0; i < wctx.get_unsat_core_size(); i++) {
+                expr * a = wctx.get_unsat_core_expr(i);
+                if (w.m_assumption_set.contains(a))
+                    w.m_core.insert(a);
+            }
+        }
+        if (wctx.get_num_bool_vars() != w.m_num_bool_vars) {
+            update_var2atom(wctx, w.m_atoms, w.m_var2atom);
+            w.m_num_bool_vars = wctx.get_num_bool_vars();
+        }
+        svector<uint64> keys, new_keys;
+        collect_lemmas(wctx, w.m_var2atom, w.m_units_head, keys);
+        for (unsigned i = 0; i < keys.size(); i++) {
+            if (!w.m_keys.contains(keys[i])) {
+                w.m_keys.insert(keys[i]);
+                new_keys.push_back(keys[i]);
+            }
+        }
+        export_lemmas(owner, new_keys);
+        return r;
+    }
+
+    static bool depends_on_cube(context & ctx, obj_hashtable<expr> const & assumptions) {
+        for (unsigned i = 0; i < ctx.get_unsat_core_size(); i++) {
+            if (!assumptions.contains(ctx.get_unsat_core_expr(i)))
+                return true;
+        }
+        return false;
+    }
+
+    lbool parallel::run(bool setup, unsigned num_assumptions, expr * const * assumptions) {
+        smt_params & fp = m_ctx.get_fparams();
+        if (!use_par())
+            return setup ? m_ctx.setup_and_check() : m_ctx.check(num_assumptions, assumptions);
+
+        // bounded sequential search. It also ranks the atoms using their activity.
+        unsigned max_conflicts = fp.m_max_conflicts;
+        lbool r;
+        {
+            flet<unsigned> _max_conflicts(fp.m_max_conflicts, std::min(max_conflicts, fp.m_threads_cube_conflicts));
+            flet<bool>     _record(m_ctx.m_record_binaries, true);
+            r = setup ? m_ctx.setup_and_check() : m_ctx.check(num_assumptions, assumptions);
+        }
+        if (r != l_undef || m_ctx.m_last_search_failure != NUM_CONFLICTS || max_conflicts <= fp.m_threads_cube_conflicts || !use_par()) {
+            m_ctx.m_learned_binaries.reset();
+            return r;
+        }
+
+        init_atoms(num_assumptions, assumptions);
+        init_cube_atoms(num_assumptions, assumptions);
+        {
+            // lemmas learned by the sequential search are shared with all workers.
+            unsigned_vector var2atom;
+            unsigned units_head = 0;
+            svector<uint64> keys;
+            update_var2atom(m_ctx, m_atoms, var2atom);
+            collect_lemmas(m_ctx, var2atom, units_head, keys);
+            export_lemmas(UINT_MAX, keys);
+        }
+        unsigned num_cubes   = 1u << m_cube_atoms.size();
+        unsigned num_workers = std::min(fp.m_threads, num_cubes);
+        init_workers(num_workers, num_assumptions, assumptions);
+        IF_VERBOSE(1, verbose_stream() << "(smt.parallel :cubes " << num_cubes << " :workers " << num_workers
+                   << " :atoms " << m_atoms.size() << " :shared-lemmas " << m_pool.size() << ")\n";);
+
+        #pragma omp critical (smt_parallel)
+        {
+            m_ctx.m_par = this;
+            m_cancel    = m_ctx.get_cancel_flag();
+            for (unsigned i = 0; i < num_workers; i++)
+                m_workers[i]->m_ctx->set_cancel_flag(m_cancel);
+        }
+
+        unsigned    next_cube  = 0;
+        int         sat_id     = -1;
+        int         unsat_id   = -1;
+        bool        is_undef   = false;
+        failure     undef_reason = UNKNOWN;
+        bool        has_ex     = false;
+        std::string ex_msg;
+        #pragma omp parallel for num_threads(num_workers)
+        for (int i = 0; i < static_cast<int>(num_workers); i++) {
+            worker & w = *(m_workers[i]);
+            bool stop  = false;
+            try {
+                while (!stop) {
+                    unsigned idx = UINT_MAX;
+                    #pragma omp critical (smt_parallel)
+                    {
+                        if (sat_id == -1 && unsat_id == -1 && !has_ex && !m_cancel && next_cube < num_cubes)
+                            idx = next_cube++;
+                    }
+                    if (idx == UINT_MAX)
+                        break;
+                    import_lemmas(i);
+                    lbool cr = check_cube(i, idx);
+                    #pragma omp critical (smt_parallel)
+                    {
+                        if (cr == l_true && sat_id == -1 && unsat_id == -1) {
+                            sat_id = i;
+                            stop   = true;
+                        }
+                        else if (cr == l_false && !depends_on_cube(*(w.m_ctx), w.m_assumption_set) && sat_id == -1 && unsat_id == -1) {
+                            unsat_id = i;
+                            stop     = true;
+                        }
+                        else if (cr == l_undef && !is_undef) {
+                            is_undef     = true;
+                            undef_reason = w.m_ctx->get_last_search_failure();
+                        }
+                    }
+                }
+            }
+            catch (z3_exception & ex) {
+                // exceptions of canceled workers are ignored.
+                #pragma omp critical (smt_parallel)
+                {
+                    if (sat_id == -1 && unsat_id == -1 && !has_ex) {
+                        has_ex = true;
+                        ex_msg = ex.msg();
+                        stop   = true;
+                    }
+                }
+            }
+            if (stop) {
+                for (unsigned j = 0; j < num_workers; j++) {
+                    if (static_cast<unsigned>(i) != j)
+                        m_workers[j]->m_ctx->set_cancel_flag(true);
+                }
+            }
+        }
+
+        #pragma omp critical (smt_parallel)
+        {
+            m_ctx.m_par = 0;
+        }
+        m_ctx.m_stats.m_num_par_cubes += next_cube;
+        IF_VERBOSE(1, verbose_stream() << "(smt.parallel :solved-cubes " << next_cube << " :shared-lemmas " << m_pool.size() << ")\n";);
+
+        ast_manager & m = m_ctx.get_manager();
+        m_ctx.m_model = 0;
+        m_ctx.m_unsat_core.reset();
+        if (sat_id != -1) {
+            worker & w = *(m_workers[sat_id]);
+            model_ref md;
+            w.m_ctx->get_model(md);
+            if (md) {
+                // the proxies of the cube atoms are not part of the model.
+                ast_manager & wm = w.m();
+                model_ref new_md = alloc(model, wm);
+                new_md->copy_usort_interps(*md);
+                new_md->copy_func_interps(*md);
+                for (unsigned i = 0; i < md->get_num_constants(); i++) {
+                    func_decl * c = md->get_constant(i);
+                    if (!w.m_proxy_decls.contains(c))
+                        new_md->register_decl(c, md->get_const_interp(c));
+                }
+                ast_translation tr(wm, m, false);
+                m_ctx.m_model = new_md->translate(tr);
+            }
+            m_ctx.m_last_search_failure = OK;
+            return l_true;
+        }
+        if (unsat_id != -1 || (!has_ex && !is_undef && !m_cancel)) {
+            // all cubes were refuted, or a worker refuted the assumptions.
+            obj_hashtable<expr> core;
+            for (unsigned i = 0; i < num_workers; i++) {
+                worker & w = *(m_workers[i]);
+                if (unsat_id != -1 && static_cast<unsigned>(unsat_id) != i)
+                    continue;
+                ast_translation tr(w.m(), m, false);
+                if (unsat_id != -1) {
+                    for (unsigned j = 0; j < w.m_ctx->get_unsat_core_size(); j++)
+                        core.insert(tr(w.m_ctx->get_unsat_core_expr(j)));
+                }
+                else {
+                    obj_hashtable<expr>::iterator it  = w.m_core.begin();
+                    obj_hashtable<expr>::iterator end = w.m_core.end();
+                    for (; it != end; ++it)
+                        core.insert(tr(*it));
+                }
+            }
+            // the core is a subset of the assumptions.
+            for (unsigned i = 0; i < num_assumptions; i++) {
+                if (core.contains(assumptions[i]) && !m_ctx.m_unsat_core.contains(assumptions[i]))
+                    m_ctx.m_unsat_core.push_back(assumptions[i]);
+            }
+            std::sort(m_ctx.m_unsat_core.c_ptr(), m_ctx.m_unsat_core.c_ptr() + m_ctx.m_unsat_core.size(), ast_lt_proc());
+            m_ctx.m_last_search_failure = OK;
+            return l_false;
+        }
+        if (has_ex)
+            throw default_exception(ex_msg.c_str());
+        m_ctx.m_last_search_failure = m_cancel ? CANCELED : undef_reason;
+        return l_undef;
+    }
+
+    void parallel::set_cancel(bool f) {
+        #pragma omp critical (smt_parallel)
+        {
+            m_cancel = f;
+            for (unsigned i = 0; i < m_workers.size(); i++)
+                m_workers[i]->m_ctx->set_cancel_flag(f);
+        }
+    }
+
+};
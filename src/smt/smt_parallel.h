@@ -0,0 +1,90 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.h
+
+Abstract:
+
+    Parallel cube-and-conquer mode for smt::kernel.
+
+    The context first searches sequentially for a bounded number of
+    conflicts. If it does not finish, the most active unassigned atoms
+    of the input are used to split the search space into cubes. The
+    cubes are solved as assumptions by worker contexts running in
+    parallel, each of them with its own (translated) ast_manager.
+    The workers exchange learned unit and binary lemmas over the atoms
+    of the input between cubes.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+    The parallel mode is not used when proofs are enabled, or when
+    the preprocessor found macros, since the workers only receive
+    the asserted formulas.
+
+--*/
+#ifndef _SMT_PARALLEL_H_
+#define _SMT_PARALLEL_H_
+
+#include"ast.h"
+#include"lbool.h"
+#include"hashtable.h"
+
+namespace smt {
+
+    class context;
+
+    class parallel {
+        struct worker;
+        struct key_hash { unsigned operator()(uint64 k) const { return hash_ull(k); } };
+        typedef hashtable<uint64, key_hash, default_eq<uint64> > key_set;
+
+        context &              m_ctx;
+        expr_ref_vector        m_atoms;      // Boolean atoms of the asserted formulas, the vocabulary of the shared lemmas.
+        unsigned_vector        m_cube_atoms; // atoms used to create the cubes.
+        ptr_vector<worker>     m_workers;
+        // Shared lemmas. A lemma is encoded as a pair of literals over m_atoms (see mk_key).
+        svector<uint64>        m_pool;
+        unsigned_vector        m_pool_owner;
+        key_set                m_pool_keys;
+        volatile bool          m_cancel;
+
+        static uint64 mk_key(unsigned l1, unsigned l2);
+
+        bool use_par() const;
+        void init_atoms(unsigned num_assumptions, expr * const * assumptions);
+        void init_cube_atoms(unsigned num_assumptions, expr * const * assumptions);
+        void init_workers(unsigned num_workers, unsigned num_assumptions, expr * const * assumptions);
+        void collect_lemmas(context & ctx, unsigned_vector & var2atom, unsigned & units_head, svector<uint64> & keys);
+        void export_lemmas(unsigned owner, svector<uint64> const & keys);
+        void import_lemmas(unsigned owner);
+        lbool check_cube(unsigned owner, unsigned cube);
+        lbool run(bool setup, unsigned num_assumptions, expr * const * assumptions);
+
+    public:
+        parallel(context & ctx);
+
+        ~parallel();
+
+        /**
+           \brief Check the asserted formulas of the context under the given assumptions.
+           The model, the unsat core and the failure reason are stored in the context.
+        */
+        lbool operator()(unsigned num_assumptions, expr * const * assumptions) { return run(false, num_assumptions, assumptions); }
+
+        /**
+           \brief Parallel version of context::setup_and_check.
+        */
+        lbool setup_and_check() { return run(true, 0, 0); }
+
+        void set_cancel(bool f);
+    };
+
+};
+
+#endif
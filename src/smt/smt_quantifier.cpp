@@ -379,6 +379,7 @@ namespace smt {
 
     void quantifier_manager::collect_statistics(::statistics & st) const {
         m_imp->m_qi_queue.collect_statistics(st);
+        m_imp->m_plugin->collect_statistics(st);
     }
 
     void quantifier_manager::reset_statistics() {
@@ -557,6 +558,11 @@ namespace smt {
             }
         }
 
+        virtual void collect_statistics(::statistics & st) const {
+            m_mam->collect_statistics(st);
+            m_lazy_mam->collect_statistics(st);
+        }
+
         virtual void propagate() {
             m_mam->match();
             if (!m_context->relevancy() && use_ematching()) {
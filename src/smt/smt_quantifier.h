@@ -167,6 +167,8 @@ namespace smt {
         virtual void pop(unsigned num_scopes) = 0;
         
         virtual void set_cancel(bool f) = 0;
+
+        virtual void collect_statistics(::statistics & st) const {}
     };
 };
 
@@ -745,6 +745,7 @@ namespace smt {
             m_context.register_plugin(alloc(smt::theory_dummy, m_manager.mk_family_id("bv"), "no bit-vector"));
             break;
         case BS_BLASTER:
+        case BS_LAZY_BLASTER:
             m_context.register_plugin(alloc(smt::theory_bv, m_manager, m_params, m_params));
             break;
         }
@@ -21,6 +21,7 @@ Revision History:
 #define _THEORY_ARITH_H_
 
 #include"smt_theory.h"
+#include"smt_justification.h"
 #include"map.h"
 #include"heap.h"
 #include"nat_set.h"
@@ -36,16 +37,19 @@ Revision History:
 #include"grobner.h"
 #include"arith_simplifier_plugin.h"
 #include"arith_eq_solver.h"
+#include"dual_simplex.h"
 
 namespace smt {
     
     struct theory_arith_stats {
         unsigned m_conflicts, m_add_rows, m_pivots, m_diseq_cs, m_gomory_cuts, m_branches, m_gcd_tests;
         unsigned m_assert_lower, m_assert_upper, m_assert_diseq, m_core2th_eqs, m_core2th_diseqs;
-        unsigned m_th2core_eqs, m_th2core_diseqs, m_bound_props, m_offset_eqs, m_fixed_eqs, m_offline_eqs;
+        unsigned m_th2core_eqs, m_th2core_diseqs, m_bound_props, m_lazy_bound_props, m_offset_eqs, m_fixed_eqs, m_offline_eqs;
         unsigned m_max_min; 
         unsigned m_gb_simplify, m_gb_superpose, m_gb_compute_basis, m_gb_num_processed;
         unsigned m_nl_branching, m_nl_linear, m_nl_bounds, m_nl_cross_nested;
+        unsigned m_dual_simplex, m_dual_simplex_feasible, m_dual_simplex_conflicts;
+        unsigned m_pseudo_cost_branches, m_pooled_cuts, m_cut_lemmas, m_aged_cuts;
 
         void reset() { memset(this, 0, sizeof(theory_arith_stats)); }
         theory_arith_stats() { reset(); }
@@ -335,6 +339,27 @@ namespace smt {
 
             virtual void push_eq(enode_pair const& p, numeral const& coeff);
         };
+
+        /**
+           \brief Justification for a literal implied by bound propagation.
+           Only the bounds used to imply the literal are stored. Their literals and
+           equalities are collected when the justification is used in a conflict.
+           
+           \remark The bounds are not deleted before the implied literal is unassigned,
+           since they were asserted before the literal was implied.
+        */
+        class lazy_bound_justification : public justification {
+            theory_arith & m_th;
+            unsigned       m_num_bounds;
+            bound **       m_bounds;
+        public:
+            lazy_bound_justification(theory_arith & th, region & r, unsigned num_bounds, bound * const * bounds);
+            virtual void get_antecedents(conflict_resolution & cr);
+            virtual proof * mk_proof(conflict_resolution & cr) { UNREACHABLE(); return 0; } // not used when proofs are enabled
+            virtual theory_id get_from_theory() const { return m_th.get_id(); }
+            virtual char const * get_name() const { return "arith-lazy-bound"; }
+        };
+        friend class lazy_bound_justification;
    
         typedef int_hashtable<int_hash, default_eq<int> > literal_idx_set;
         typedef obj_pair_hashtable<enode, enode> eq_set;
@@ -418,6 +443,7 @@ namespace smt {
         var_heap                m_to_patch;         // heap containing all variables v s.t. m_value[v] does not satisfy bounds of v.
         nat_set                 m_left_basis;       // temporary: set of variables that already left the basis in make_feasible
         bool                    m_blands_rule;
+        dual_simplex            m_dual_simplex;     // floating point simplex used when m_arith_mode == AS_DUAL_SIMPLEX
 
         svector<unsigned>       m_update_trail_stack;    // temporary trail stack used to restore the last feasible assignment.
         nat_set                 m_in_update_trail_stack; // set of variables in m_update_trail_stack
@@ -452,6 +478,45 @@ namespace smt {
         literal_vector          m_tmp_literal_vector2;
         antecedents             m_tmp_antecedents;
         antecedents             m_tmp_antecedents2;
+        antecedents             m_lazy_antecedents;  // used by lazy_bound_justification
+        ptr_vector<bound>       m_tmp_bounds;
+
+        // branch and cut
+        struct pseudo_cost {
+            double   m_down;     // average decrease of the integer infeasibility per unit of rounding down.
+            double   m_up;       // average decrease of the integer infeasibility per unit of rounding up.
+            unsigned m_num_down;
+            unsigned m_num_up;
+            pseudo_cost():m_down(0), m_up(0), m_num_down(0), m_num_up(0) {}
+            void record(bool up, double gain) {
+                if (up) { m_num_up++; m_up += (gain - m_up) / m_num_up; }
+                else { m_num_down++; m_down += (gain - m_down) / m_num_down; }
+            }
+        };
+
+        /**
+           \brief Gomory cut (pol >= k) waiting in the cut pool. It is exported as the theory lemma
+           (or (not a_1) ... (not a_n) cut) where a_1 ... a_n are the antecedents of the cut.
+           The antecedents are stored as atoms because their Boolean variables may be deleted
+           during backtracking.
+        */
+        struct pooled_cut {
+            expr *            m_cut;
+            ptr_vector<expr>  m_atoms;
+            svector<bool>     m_signs;
+            vector<row_entry> m_pol;
+            numeral           m_k;
+            theory_var        m_max_var;
+            unsigned          m_age;
+            pooled_cut():m_cut(0), m_max_var(null_theory_var), m_age(0) {}
+        };
+
+        svector<pseudo_cost>    m_pseudo_costs;     // per var
+        pseudo_cost             m_avg_pseudo_cost;  // running average over all branchings, used for variables without history.
+        theory_var              m_last_branch_var;
+        numeral                 m_last_branch_value;
+        double                  m_last_branch_infeasibility;
+        ptr_vector<pooled_cut>  m_cut_pool;
 
         struct var_value_hash;
         friend struct var_value_hash;
@@ -494,8 +559,11 @@ namespace smt {
         unsigned max_lemma_size() const { return m_params.m_arith_max_lemma_size; }
         unsigned small_lemma_size() const { return m_params.m_arith_small_lemma_size; }
         bool relax_bounds() const { return m_params.m_arith_stronger_lemmas; }
+        bool lazy_explanations() const { return m_params.m_arith_lazy_explanations && !proofs_enabled() && !dump_lemmas(); }
         bool skip_big_coeffs() const { return m_params.m_arith_skip_rows_with_big_coeffs; }
         bool dump_lemmas() const { return m_params.m_arith_dump_lemmas; }
+        bool branch_and_cut() const { return m_params.m_arith_branch_and_cut; }
+        bool use_cut_pool() const { return branch_and_cut() && !proofs_enabled(); }
         bool process_atoms() const;
         unsigned get_num_conflicts() const { return m_num_conflicts; }
         var_kind get_var_kind(theory_var v) const { return m_data[v].kind(); }
@@ -716,6 +784,14 @@ namespace smt {
         theory_var select_smallest_var();
         bool make_feasible();
         void sign_row_conflict(theory_var x_i, bool is_below);
+        unsigned dual_simplex_threshold() const { return 16; }
+        unsigned dual_simplex_max_basis_changes() const { return 128; }
+        bool dual_simplex_make_feasible();
+        void dual_simplex_basis_changes(svector<unsigned> & rows, svector<theory_var> & vars) const;
+        inf_numeral const & dual_simplex_target(theory_var v) const;
+        bool dual_simplex_certify_feasible(svector<unsigned> const & rows, svector<theory_var> const & vars);
+        bool dual_simplex_certify_conflict(svector<unsigned> const & rows, svector<theory_var> const & vars);
+        void dual_simplex_transfer_basis();
 
         // -----------------------------------
         //
@@ -734,11 +810,11 @@ namespace smt {
         // -----------------------------------
         void mark_row_for_bound_prop(unsigned r1);
         void mark_rows_for_bound_prop(theory_var v);
-        void is_row_useful_for_bound_prop(row const & r, int & lower_idx, int & upper_idx) const;
-        void imply_bound_for_monomial(row const & r, int idx, bool lower);
-        void imply_bound_for_all_monomials(row const & r, bool lower);
+        void imply_bounds(row const & r);
+        void imply_bound_for_monomial(row const & r, int idx, bool lower, inf_numeral & k);
         void explain_bound(row const & r, int idx, bool lower, inf_numeral & delta, 
                            antecedents & antecedents);
+        void collect_bounds(row const & r, int idx, bool lower, ptr_vector<bound> & bounds);
         void mk_implied_bound(row const & r, unsigned idx, bool lower, theory_var v, bound_kind kind, inf_numeral const & k);
         void assign_bound_literal(literal l, row const & r, unsigned idx, bool lower, inf_numeral & delta, antecedents& antecedents);
         void propagate_bounds();
@@ -786,6 +862,18 @@ namespace smt {
         bool constrain_free_vars(row const & r);
         bool is_gomory_cut_target(row const & r);
         bool mk_gomory_cut(row const & r);
+        double int_infeasibility() const;
+        void update_pseudo_cost();
+        double pseudo_cost_score(theory_var v) const;
+        theory_var select_pseudo_cost_int_var();
+        bool is_small_cut(buffer<row_entry> const & pol) const;
+        pooled_cut * mk_pooled_cut(buffer<row_entry> const & pol, numeral const & k) const;
+        void add_cut_to_pool(pooled_cut * c, expr * cut, antecedents & ante);
+        void del_pooled_cut(pooled_cut * c);
+        void del_pooled_cuts(unsigned old_num_vars);
+        double cut_efficacy(pooled_cut const & c) const;
+        void export_cut(pooled_cut const & c);
+        bool mk_gomory_cuts();
         bool gcd_test(row const & r);
         bool ext_gcd_test(row const & r, numeral const & least_coeff, numeral const & lcm_den, numeral const & consts);
         bool gcd_test();
@@ -20,6 +20,7 @@ Revision History:
 #define _THEORY_ARITH_AUX_H_
 
 #include"theory_arith.h"
+#include"smt_conflict_resolution.h"
 
 namespace smt {
 
@@ -742,6 +743,27 @@ namespace smt {
         m_eq_coeffs.push_back(coeff);
     }
 
+    template<typename Ext>
+    theory_arith<Ext>::lazy_bound_justification::lazy_bound_justification(theory_arith & th, region & r, unsigned num_bounds, bound * const * bounds):
+        m_th(th),
+        m_num_bounds(num_bounds) {
+        m_bounds = new (r) bound*[num_bounds];
+        memcpy(m_bounds, bounds, sizeof(bound*) * num_bounds);
+    }
+
+    template<typename Ext>
+    void theory_arith<Ext>::lazy_bound_justification::get_antecedents(conflict_resolution & cr) {
+        antecedents & ante = m_th.m_lazy_antecedents;
+        ante.reset();
+        for (unsigned i = 0; i < m_num_bounds; i++)
+            m_bounds[i]->push_justification(ante, numeral::zero(), false);
+        mark_literals(cr, ante.lits().size(), ante.lits().c_ptr());
+        eq_vector::const_iterator it  = ante.eqs().begin();
+        eq_vector::const_iterator end = ante.eqs().end();
+        for (; it != end; ++it)
+            cr.mark_eq(it->first, it->second);
+    }
+
     /**
        \brief Copy the justification of b to new_bound. Only literals and equalities not in lits and eqs are copied.
        The justification of b is also copied to lits and eqs.
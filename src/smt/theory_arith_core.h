@@ -77,6 +77,7 @@ namespace smt {
         m_var_pos          .push_back(-1);
         m_bounds[0]        .push_back(0);
         m_bounds[1]        .push_back(0);
+        m_pseudo_costs     .push_back(pseudo_cost());
         if (r >= static_cast<int>(m_to_patch.get_bounds()))
             m_to_patch.set_bounds(r + 1);
         m_in_update_trail_stack.assure_domain(r);
@@ -1430,6 +1431,10 @@ namespace smt {
         m_nl_rounds              = 0;
         m_nl_gb_exhausted        = false;
         m_nl_strategy_idx        = 0;
+        m_pseudo_costs           .reset();
+        m_avg_pseudo_cost        = pseudo_cost();
+        m_last_branch_var        = null_theory_var;
+        del_pooled_cuts(0);
         theory::reset_eh();
     }
 
@@ -1513,6 +1518,8 @@ namespace smt {
         m_branch_cut_counter(0),
         m_eager_gcd(m_params.m_arith_eager_gcd),
         m_final_check_idx(0),
+        m_last_branch_var(null_theory_var),
+        m_last_branch_infeasibility(0),
         m_var_value_table(DEFAULT_HASHTABLE_INITIAL_CAPACITY, var_value_hash(*this), var_value_eq(*this)),
         m_liberal_final_check(true),
         m_changed_assignment(false),
@@ -1524,6 +1531,7 @@ namespace smt {
 
     template<typename Ext>
     theory_arith<Ext>::~theory_arith() {
+        del_pooled_cuts(0);
     }
 
     template<typename Ext>
@@ -2103,7 +2111,16 @@ namespace smt {
         m_left_basis.reset();
         m_blands_rule    = false;
         unsigned num_repeated = 0;
+        unsigned num_iterations = 0;
         while (!m_to_patch.empty()) {
+            if (m_params.m_arith_mode == AS_DUAL_SIMPLEX && num_iterations++ == dual_simplex_threshold()) {
+                if (!dual_simplex_make_feasible()) {
+                    TRACE("arith_make_feasible", tout << "make_feasible: dual simplex unsat\n"; display(tout););
+                    return false;
+                }
+                if (m_to_patch.empty())
+                    break;
+            }
             theory_var v = select_var_to_fix();
             if (v == null_theory_var) {
                 // all variables were satisfied...
@@ -2136,6 +2153,388 @@ namespace smt {
         return true;
     }
 
+    inline double to_double(rational const & n) { return n.get_double(); }
+
+    inline double to_double(inf_rational const & n) { return n.get_rational().get_double(); }
+
+    /**
+       \brief Solve the k x k system m x = b in place by Gauss-Jordan elimination, where m
+       is stored by rows. Return false if m is singular.
+    */
+    template<typename Numeral, typename Value>
+    bool dense_solve(unsigned k, vector<Numeral> & m, vector<Value> & b) {
+        for (unsigned c = 0; c < k; c++) {
+            unsigned p = c;
+            while (p < k && m[p * k + c].is_zero())
+                p++;
+            if (p == k)
+                return false;
+            if (p != c) {
+                for (unsigned j = c; j < k; j++)
+                    m[p * k + j].swap(m[c * k + j]);
+                b[p].swap(b[c]);
+            }
+            Numeral inv(1);
+            inv /= m[c * k + c];
+            for (unsigned j = c; j < k; j++)
+                m[c * k + j] *= inv;
+            b[c] *= inv;
+            for (unsigned i = 0; i < k; i++) {
+                if (i == c || m[i * k + c].is_zero())
+                    continue;
+                Numeral f = m[i * k + c];
+                for (unsigned j = c; j < k; j++)
+                    m[i * k + j].submul(f, m[c * k + j]);
+                b[i].submul(f, b[c]);
+            }
+        }
+        return true;
+    }
+
+    /**
+       \brief Use the floating point dual simplex (see dual_simplex.h) to find a basis 
+       and an assignment of the non-base variables that satisfies the bounds, or an
+       infeasible row. The pivoting is done in floating point only, and the result is
+       certified in exact arithmetic without pivoting the tableau:
+       dual_simplex_certify_feasible checks the assignment of the basis, and 
+       dual_simplex_certify_conflict checks the infeasible row and explains the conflict.
+       Return false if a conflict was found.
+
+       When the result cannot be certified (e.g., due to rounding errors and infinitesimals),
+       the basis is transferred to the tableau, and the exact pivoting loop in make_feasible
+       fixes the remaining violations.
+
+       The dual simplex works on the current tableau: the initial basis matrix is the
+       identity, and the rows are not updated when pivoting.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::dual_simplex_make_feasible() {
+        int num_vars = get_num_vars();
+        dual_simplex & ds = m_dual_simplex;
+        ds.reset(num_vars);
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (is_quasi_base(v))
+                return true;
+            if (lower(v))
+                ds.set_lower(v, to_double(lower(v)->get_value()));
+            if (upper(v))
+                ds.set_upper(v, to_double(upper(v)->get_value()));
+            ds.set_value(v, to_double(get_value(v)));
+        }
+        unsigned_vector vars;
+        svector<double> coeffs;
+        typename vector<row>::const_iterator it  = m_rows.begin();
+        typename vector<row>::const_iterator end = m_rows.end();
+        for (; it != end; ++it) {
+            theory_var s = it->get_base_var();
+            if (s == null_theory_var)
+                continue;
+            vars.reset();
+            coeffs.reset();
+            typename vector<row_entry>::const_iterator it2  = it->begin_entries();
+            typename vector<row_entry>::const_iterator end2 = it->end_entries();
+            for (; it2 != end2; ++it2) {
+                if (!it2->is_dead()) {
+                    vars.push_back(it2->m_var);
+                    coeffs.push_back(it2->m_coeff.get_double());
+                }
+            }
+            ds.add_row(s, vars.size(), vars.c_ptr(), coeffs.c_ptr());
+        }
+        m_stats.m_dual_simplex++;
+        lbool result = ds();
+        TRACE("dual_simplex", tout << "dual simplex: " << result << "\n";);
+        if (result == l_undef)
+            return true;
+
+        svector<unsigned>   changed_rows;
+        svector<theory_var> entering;
+        dual_simplex_basis_changes(changed_rows, entering);
+        if (changed_rows.size() <= dual_simplex_max_basis_changes()) {
+            if (result == l_true && dual_simplex_certify_feasible(changed_rows, entering)) {
+                m_stats.m_dual_simplex_feasible++;
+                return true;
+            }
+            if (result == l_false && dual_simplex_certify_conflict(changed_rows, entering)) {
+                m_stats.m_dual_simplex_conflicts++;
+                return false;
+            }
+        }
+        TRACE("dual_simplex", tout << "not certified, basis changes: " << changed_rows.size() << "\n";);
+        dual_simplex_transfer_basis();
+        return true;
+    }
+
+    /**
+       \brief Store in rows the rows whose base variable is not basic in the dual simplex,
+       and in vars the non-base variables that are basic in the dual simplex.
+       There are as many rows as variables.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::dual_simplex_basis_changes(svector<unsigned> & rows, svector<theory_var> & vars) const {
+        dual_simplex const & ds = m_dual_simplex;
+        for (unsigned r_id = 0; r_id < m_rows.size(); r_id++) {
+            theory_var s = m_rows[r_id].get_base_var();
+            if (s != null_theory_var && !ds.is_basic(s))
+                rows.push_back(r_id);
+        }
+        int num_vars = get_num_vars();
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (is_non_base(v) && ds.is_basic(v))
+                vars.push_back(v);
+        }
+        SASSERT(rows.size() == vars.size());
+    }
+
+    /**
+       \brief Return the value of a variable that is not basic in the dual simplex:
+       the bound selected by the dual simplex, or its current value.
+    */
+    template<typename Ext>
+    typename theory_arith<Ext>::inf_numeral const & theory_arith<Ext>::dual_simplex_target(theory_var v) const {
+        if (lower(v) && m_dual_simplex.at_lower(v))
+            return lower(v)->get_value();
+        if (upper(v) && m_dual_simplex.at_upper(v))
+            return upper(v)->get_value();
+        return m_value[v];
+    }
+
+    /**
+       \brief Certify the feasible basis of the dual simplex. The variables that are not
+       basic in the dual simplex get their target values. In the k rows whose base variable
+       left the basis, the only other unknowns are the k non-base variables that entered the
+       basis, so their exact values are the solution of a k x k system. The values of the 
+       base variables that stayed in the basis follow from their rows. If all these values
+       satisfy the bounds, the non-base variables are updated and true is returned.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::dual_simplex_certify_feasible(svector<unsigned> const & rows, svector<theory_var> const & vars) {
+        int num_vars = get_num_vars();
+        unsigned k   = rows.size();
+        svector<int> pos(num_vars, -1);
+        for (unsigned j = 0; j < k; j++)
+            pos[vars[j]] = j;
+        vector<numeral> m;
+        vector<inf_numeral> b;
+        m.resize(k * k, numeral());
+        b.resize(k, inf_numeral());
+        for (unsigned i = 0; i < k; i++) {
+            row const & r = m_rows[rows[i]];
+            typename vector<row_entry>::const_iterator it  = r.begin_entries();
+            typename vector<row_entry>::const_iterator end = r.end_entries();
+            for (; it != end; ++it) {
+                if (it->is_dead())
+                    continue;
+                if (pos[it->m_var] >= 0)
+                    m[i * k + pos[it->m_var]] = it->m_coeff;
+                else
+                    b[i].submul(it->m_coeff, dual_simplex_target(it->m_var));
+            }
+        }
+        if (!dense_solve(k, m, b))
+            return false;
+
+        vector<inf_numeral> new_values;
+        new_values.resize(num_vars, inf_numeral());
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (!is_non_base(v))
+                continue;
+            new_values[v] = pos[v] >= 0 ? b[pos[v]] : dual_simplex_target(v);
+            if ((lower(v) && new_values[v] < lower(v)->get_value()) || (upper(v) && new_values[v] > upper(v)->get_value()))
+                return false;
+        }
+        typename vector<row>::const_iterator it  = m_rows.begin();
+        typename vector<row>::const_iterator end = m_rows.end();
+        for (; it != end; ++it) {
+            theory_var s = it->get_base_var();
+            if (s == null_theory_var)
+                continue;
+            inf_numeral & val = new_values[s];
+            typename vector<row_entry>::const_iterator it2  = it->begin_entries();
+            typename vector<row_entry>::const_iterator end2 = it->end_entries();
+            for (; it2 != end2; ++it2) {
+                if (!it2->is_dead() && it2->m_var != s)
+                    val.submul(it2->m_coeff, new_values[it2->m_var]);
+            }
+            if ((lower(s) && val < lower(s)->get_value()) || (upper(s) && val > upper(s)->get_value()))
+                return false;
+        }
+
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (is_non_base(v) && new_values[v] != m_value[v])
+                set_value(v, new_values[v]);
+        }
+        m_to_patch.reset();
+        TRACE("dual_simplex", tout << "certified feasible basis, basis changes: " << k << "\n"; display(tout););
+        CASSERT("arith", valid_row_assignment());
+        CASSERT("arith", satisfy_bounds());
+        return true;
+    }
+
+    /**
+       \brief Certify the infeasible row of the dual simplex. Let x_i be the infeasible
+       basic variable. The row of x_i in the dual simplex is the combination
+       sum_r y_r * row_r of the rows of the tableau where the coefficient of x_i is 1 and 
+       the coefficients of the other basic variables of the dual simplex are 0. 
+       The multipliers of the rows whose base variable stayed in the basis are 0 (except 
+       for the row of x_i), so the other multipliers are the solution of a k x k system.
+       If the bounds of the variables in the combination imply a bound of x_i that
+       contradicts its violated bound, these bounds explain the conflict.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::dual_simplex_certify_conflict(svector<unsigned> const & rows, svector<theory_var> const & vars) {
+        dual_simplex const & ds = m_dual_simplex;
+        theory_var x_i = ds.get_infeasible_var();
+        bool is_below  = lower(x_i) != 0 && ds.get_value(x_i) < to_double(lower(x_i)->get_value());
+        bound * b_i    = is_below ? lower(x_i) : upper(x_i);
+        if (b_i == 0)
+            return false;
+        int num_vars = get_num_vars();
+        unsigned k   = rows.size();
+        svector<int> pos(num_vars, -1);
+        for (unsigned j = 0; j < k; j++)
+            pos[vars[j]] = j;
+        // the transposed system: sum_r y_r * a_rj = 0 for every variable x_j that entered the basis.
+        vector<numeral> m;
+        vector<numeral> y;
+        m.resize(k * k, numeral());
+        y.resize(k, numeral());
+        for (unsigned i = 0; i < k; i++) {
+            row const & r = m_rows[rows[i]];
+            typename vector<row_entry>::const_iterator it  = r.begin_entries();
+            typename vector<row_entry>::const_iterator end = r.end_entries();
+            for (; it != end; ++it) {
+                if (!it->is_dead() && pos[it->m_var] >= 0)
+                    m[pos[it->m_var] * k + i] = it->m_coeff;
+            }
+        }
+        bool stayed = pos[x_i] < 0;
+        if (stayed) {
+            // x_i is the base variable of its row, with coefficient 1.
+            SASSERT(is_base(x_i));
+            row const & r = m_rows[get_var_row(x_i)];
+            typename vector<row_entry>::const_iterator it  = r.begin_entries();
+            typename vector<row_entry>::const_iterator end = r.end_entries();
+            for (; it != end; ++it) {
+                if (!it->is_dead() && pos[it->m_var] >= 0)
+                    y[pos[it->m_var]] -= it->m_coeff;
+            }
+        }
+        else {
+            y[pos[x_i]] = numeral(1);
+        }
+        if (!dense_solve(k, m, y))
+            return false;
+
+        vector<numeral> coeffs;
+        coeffs.resize(num_vars, numeral());
+        svector<theory_var> touched;
+        for (unsigned i = 0; i <= k; i++) {
+            if (i == k && !stayed)
+                break;
+            numeral const & y_r = i < k ? y[i] : numeral::one();
+            if (y_r.is_zero())
+                continue;
+            row const & r = m_rows[i < k ? rows[i] : get_var_row(x_i)];
+            typename vector<row_entry>::const_iterator it  = r.begin_entries();
+            typename vector<row_entry>::const_iterator end = r.end_entries();
+            for (; it != end; ++it) {
+                if (it->is_dead())
+                    continue;
+                if (coeffs[it->m_var].is_zero())
+                    touched.push_back(it->m_var);
+                coeffs[it->m_var].addmul(y_r, it->m_coeff);
+            }
+        }
+        SASSERT(coeffs[x_i].is_one());
+
+        // x_i = - sum_j coeffs[j] * x_j
+        inf_numeral implied;
+        antecedents& ante = get_antecedents();
+        for (unsigned i = 0; i < touched.size(); i++) {
+            theory_var x_j        = touched[i];
+            numeral const & coeff = coeffs[x_j];
+            if (x_j == x_i || coeff.is_zero())
+                continue;
+            SASSERT(!ds.is_basic(x_j));
+            bound * b = get_bound(x_j, is_below ? coeff.is_neg() : coeff.is_pos());
+            if (b == 0)
+                return false;
+            implied.submul(coeff, b->get_value());
+            b->push_justification(ante, coeff, proofs_enabled());
+        }
+        if (is_below ? implied >= b_i->get_value() : implied <= b_i->get_value())
+            return false;
+        b_i->push_justification(ante, numeral(1), proofs_enabled());
+        if (ante.lits().empty() && ante.eqs().empty())
+            return false;
+        TRACE("dual_simplex", tout << "certified conflict for v" << x_i << " is_below: " << is_below << ", implied bound: " << implied << "\n";);
+        set_conflict(ante.lits().size(), ante.lits().c_ptr(), 
+                     ante.eqs().size(), ante.eqs().c_ptr(), ante, is_int(x_i), "farkas");
+        return true;
+    }
+
+    /**
+       \brief Pivot the tableau to the basis found by the dual simplex, and move the
+       non-base variables to the bounds selected by the dual simplex.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::dual_simplex_transfer_basis() {
+        int num_vars = get_num_vars();
+        dual_simplex & ds = m_dual_simplex;
+
+        // move the tableau to the basis found by the dual simplex.
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (!ds.is_basic(v) || !is_non_base(v))
+                continue;
+            column & c = m_columns[v];
+            theory_var x_i = null_theory_var;
+            numeral a_ij;
+            typename svector<col_entry>::const_iterator it  = c.begin_entries();
+            typename svector<col_entry>::const_iterator end = c.end_entries();
+            for (; it != end; ++it) {
+                if (!it->is_dead()) {
+                    row & r      = m_rows[it->m_row_id];
+                    theory_var s = r.get_base_var();
+                    if (s != null_theory_var && !ds.is_basic(s)) {
+                        x_i  = s;
+                        a_ij = r[it->m_row_idx].m_coeff;
+                        break;
+                    }
+                }
+            }
+            if (x_i != null_theory_var)
+                pivot<true>(x_i, v, a_ij, m_eager_gcd);
+        }
+
+        // move the non-base variables to their bounds.
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (!is_non_base(v))
+                continue;
+            bound * l = lower(v);
+            bound * u = upper(v);
+            if (l && (ds.at_lower(v) || get_value(v) < l->get_value())) {
+                if (get_value(v) != l->get_value())
+                    set_value(v, l->get_value());
+            }
+            else if (u && (ds.at_upper(v) || get_value(v) > u->get_value())) {
+                if (get_value(v) != u->get_value())
+                    set_value(v, u->get_value());
+            }
+        }
+
+        // base variables that left the basis are not patched.
+        m_to_patch.reset();
+        for (theory_var v = 0; v < num_vars; v++) {
+            if (is_base(v) && (below_lower(v) || above_upper(v)))
+                m_to_patch.insert(v);
+        }
+        TRACE("dual_simplex", display(tout););
+        CASSERT("arith", wf_rows());
+        CASSERT("arith", wf_columns());
+        CASSERT("arith", valid_row_assignment());
+    }
+
     /**
        \brief A row is in a sign inconsistency when it is implying a
        lower (upper) bound on x_i, which is above (below) its known
@@ -2394,158 +2793,114 @@ namespace smt {
        Then row implies a upper bound for every monomial in the row.
        Proof: similar to the previous claim.
 
-       The result is stored in lower_idx and upper_idx
-       - lower_idx >= 0  : row can imply a lower bound for the monomial at 'lower_idx'
-       - lower_idx == -1 : row can imply a lower bound for every monomial in the row.
-       - lower_idx == -2 : row cannot be used to imply a lower bound.
- 
-       - upper_idx >= 0  : row can imply a upper bound for the monomial at 'upper_idx'
-       - upper_idx == -1 : row can imply a upper bound for every monomial in the row.
-       - upper_idx == -2 : row cannot be used to imply a upper bound.
+       The row is traversed once to accumulate
+       
+       lower_sum = (Sum_{a_i < 0} -a_i * lower(x_i)) + (Sum_{a_j > 0} -a_j * upper(x_j))
+       upper_sum = (Sum_{a_i > 0} -a_i * lower(x_i)) + (Sum_{a_j < 0} -a_j * upper(x_j))
+
+       over the monomials that have the required bound, and to count the monomials that do not.
+       If no bound is missing, then the bound of a monomial is the sum minus the contribution of the monomial.
+       If exactly one bound is missing, then the sum is a bound for the monomial without bound.
+       The monomial bounds are then used to produce bounds for the monomial variables.
     */
     template<typename Ext>
-    void theory_arith<Ext>::is_row_useful_for_bound_prop(row const & r, int & lower_idx, int & upper_idx) const {
-        lower_idx = -1;
-        upper_idx = -1; 
+    void theory_arith<Ext>::imply_bounds(row const & r) {
+        inf_numeral lower_sum, upper_sum;
+        int lower_idx = -1; // position of the last monomial without a bound in lower_sum
+        int upper_idx = -1; 
+        unsigned num_lower_missing = 0, num_upper_missing = 0;
         typename vector<row_entry>::const_iterator it  = r.begin_entries();
         typename vector<row_entry>::const_iterator end = r.end_entries();
         for (int i = 0; it != end; ++it, ++i) {
-            if (!it->is_dead()) {
-#define UPDATE_IDX(IDX) IDX = IDX == -1 ? i : -2
-                if (skip_big_coeffs() && it->m_coeff.is_big()) {
-                    TRACE("is_row_useful", tout << "skipping row that contains big number...\n"; display_row_info(tout, r););
-                    lower_idx = -2;
-                    upper_idx = -2;
-                    return;
+            if (it->is_dead())
+                continue;
+            if (skip_big_coeffs() && it->m_coeff.is_big()) {
+                TRACE("is_row_useful", tout << "skipping row that contains big number...\n"; display_row_info(tout, r););
+                return;
+            }
+            bool is_pos = it->m_coeff.is_pos();
+            if (num_lower_missing < 2) {
+                bound * b = get_bound(it->m_var, is_pos);
+                if (b == 0) {
+                    num_lower_missing++;
+                    lower_idx = i;
                 }
-                bool is_pos = it->m_coeff.is_pos();
-                if (lower(it->m_var) == 0) {
-                    if (is_pos) {
-                        UPDATE_IDX(upper_idx);
-                    }
-                    else {
-                        UPDATE_IDX(lower_idx);
-                    }
+                else {
+                    // lower_sum -= it->m_coeff * b->get_value();
+                    lower_sum.submul(it->m_coeff, b->get_value());
                 }
-                if (upper(it->m_var) == 0) {
-                    if (is_pos) {
-                        UPDATE_IDX(lower_idx);
-                    }
-                    else {
-                        UPDATE_IDX(upper_idx);
-                    }
+            }
+            if (num_upper_missing < 2) {
+                bound * b = get_bound(it->m_var, !is_pos);
+                if (b == 0) {
+                    num_upper_missing++;
+                    upper_idx = i;
+                }
+                else {
+                    // upper_sum -= it->m_coeff * b->get_value();
+                    upper_sum.submul(it->m_coeff, b->get_value());
                 }
-                if (lower_idx == -2 && upper_idx == -2)
-                    return;
             }
+            if (num_lower_missing >= 2 && num_upper_missing >= 2)
+                return;
         }
-    }
 
-    /**
-       \brief Imply a lower/upper bound for the monomial stored at position idx.
-       Then this bound is used to produce a bound for the monomial variable.
-    */
-    template<typename Ext>
-    void theory_arith<Ext>::imply_bound_for_monomial(row const & r, int idx, bool is_lower) {
-        row_entry const & entry = r[idx];
-        if (m_unassigned_atoms[entry.m_var] > 0) {
-            inf_numeral implied_k;
-            typename vector<row_entry>::const_iterator it  = r.begin_entries();
-            typename vector<row_entry>::const_iterator end = r.end_entries();
-            for (int idx2 = 0; it != end; ++it, ++idx2) {
-                if (!it->is_dead() && idx != idx2) {
-                    bound * b  = get_bound(it->m_var, is_lower ? it->m_coeff.is_pos() : it->m_coeff.is_neg());
-                    SASSERT(b);
-                    // implied_k -= it->m_coeff * b->get_value();
-                    implied_k.submul(it->m_coeff, b->get_value());
-                }
-            }
-            implied_k /= entry.m_coeff;
-            if (entry.m_coeff.is_pos() == is_lower) {
-                // implied_k is a lower bound for entry.m_var
-                bound * curr = lower(entry.m_var);
-                if (curr == 0 || implied_k > curr->get_value()) {
-                    TRACE("arith_imply_bound", 
-                          tout << "implying lower bound for v" << entry.m_var << " " << implied_k << " using row:\n";
-                          display_row_info(tout, r);
-                          display_var(tout, entry.m_var););
-                    mk_implied_bound(r, idx, is_lower, entry.m_var, B_LOWER, implied_k);
+        inf_numeral implied_k;
+        it = r.begin_entries();
+        for (int idx = 0; it != end; ++it, ++idx) {
+            if (it->is_dead() || m_unassigned_atoms[it->m_var] == 0)
+                continue;
+            if (num_lower_missing == 0 || (num_lower_missing == 1 && lower_idx == idx)) {
+                implied_k = lower_sum;
+                if (num_lower_missing == 0) {
+                    // implied_k += it->m_coeff * b;
+                    implied_k.addmul(it->m_coeff, get_bound(it->m_var, it->m_coeff.is_pos())->get_value());
                 }
+                imply_bound_for_monomial(r, idx, true, implied_k);
             }
-            else {
-                // implied_k is an upper bound for it->m_var 
-                bound * curr = upper(entry.m_var);
-                if (curr == 0 || implied_k < curr->get_value()) {
-                    TRACE("arith_imply_bound", 
-                          tout << "implying upper bound for v" << entry.m_var << " " << implied_k << " using row:\n";
-                          display_row_info(tout, r);
-                          display_var(tout, entry.m_var););
-                    mk_implied_bound(r, idx, is_lower, entry.m_var, B_UPPER, implied_k);
+            if (num_upper_missing == 0 || (num_upper_missing == 1 && upper_idx == idx)) {
+                implied_k = upper_sum;
+                if (num_upper_missing == 0) {
+                    // implied_k += it->m_coeff * b;
+                    implied_k.addmul(it->m_coeff, get_bound(it->m_var, it->m_coeff.is_neg())->get_value());
                 }
+                imply_bound_for_monomial(r, idx, false, implied_k);
             }
-        } 
+        }
     }
 
     /**
-       \brief Auxiliary method. See is_row_useful_for_bound_prop 
-
-       If is_lower = true (false), then imply a lower (upper) bound for all
-       monomials in the row. The monomial bounds are used to compute bounds
-       for the monomial variables.
+       \brief Given a lower (upper) bound implied_k for the monomial stored at position idx,
+       imply a bound for the monomial variable if it improves the current one.
+       implied_k is divided by the coefficient of the monomial.
     */
     template<typename Ext>
-    void theory_arith<Ext>::imply_bound_for_all_monomials(row const & r, bool is_lower) {
-        // Traverse the row once and compute 
-        // bb = (Sum_{a_i < 0} -a_i*lower(x_i)) + (Sum_{a_j > 0} -a_j * upper(x_j))  If is_lower = true
-        // bb = (Sum_{a_i > 0} -a_i*lower(x_i)) + (Sum_{a_j < 0} -a_j * upper(x_j))  If is_lower = false
-        inf_numeral bb;
-        typename vector<row_entry>::const_iterator it  = r.begin_entries();
-        typename vector<row_entry>::const_iterator end = r.end_entries();
-        for (; it != end; ++it) {
-            if (!it->is_dead()) {
-                inf_numeral const & b = get_bound(it->m_var, is_lower ? it->m_coeff.is_pos() : it->m_coeff.is_neg())->get_value();
-                // bb -= it->m_coeff * b;
-                bb.submul(it->m_coeff, b);
+    void theory_arith<Ext>::imply_bound_for_monomial(row const & r, int idx, bool is_lower, inf_numeral & implied_k) {
+        row_entry const & entry = r[idx];
+        implied_k /= entry.m_coeff;
+        TRACE("arith_imply_bound", 
+              display_var(tout, entry.m_var);
+              tout << "implied bound: " << (entry.m_coeff.is_pos() == is_lower ? ">=" : "<=") << implied_k << "\n";);
+        if (entry.m_coeff.is_pos() == is_lower) {
+            // implied_k is a lower bound for entry.m_var
+            bound * curr = lower(entry.m_var);
+            if (curr == 0 || implied_k > curr->get_value()) {
+                TRACE("arith_imply_bound", 
+                      tout << "implying lower bound for v" << entry.m_var << " " << implied_k << " using row:\n";
+                      display_row_info(tout, r);
+                      display_var(tout, entry.m_var););
+                mk_implied_bound(r, idx, is_lower, entry.m_var, B_LOWER, implied_k);
             }
         }
-        
-        inf_numeral implied_k;
-        it = r.begin_entries();
-        for (int idx = 0; it != end; ++it, ++idx) {
-            if (!it->is_dead() && m_unassigned_atoms[it->m_var] > 0) {
-                inf_numeral const & b = get_bound(it->m_var, is_lower ? it->m_coeff.is_pos() : it->m_coeff.is_neg())->get_value();
-                implied_k  = bb;
-                // implied_k += it->m_coeff * b;
-                implied_k.addmul(it->m_coeff, b);
-                // implied_k is a bound for the monomial in position it
-                implied_k /= it->m_coeff;
+        else {
+            // implied_k is an upper bound for entry.m_var 
+            bound * curr = upper(entry.m_var);
+            if (curr == 0 || implied_k < curr->get_value()) {
                 TRACE("arith_imply_bound", 
-                      display_var(tout, it->m_var);
-                      tout << "implied bound: " << (it->m_coeff.is_pos() ? ">=" : "<=") << implied_k << "\n";);
-                if (it->m_coeff.is_pos() == is_lower) {
-                    // implied_k is a lower bound for it->m_var
-                    bound * curr = lower(it->m_var);
-                    if (curr == 0 || implied_k > curr->get_value()) {
-                        // improved lower bound
-                        TRACE("arith_imply_bound",
-                              tout << "implying lower bound for v" << it->m_var << " " << implied_k << " using row:\n";
-                              display_row_info(tout, r);
-                              display_var(tout, it->m_var););
-                        mk_implied_bound(r, idx, is_lower, it->m_var, B_LOWER, implied_k);
-                    }
-                }
-                else {
-                    // implied_k is an upper bound for it->m_var 
-                    bound * curr = upper(it->m_var);
-                    if (curr == 0 || implied_k < curr->get_value()) {
-                        // improved upper bound
-                        TRACE("arith_imply_bound",
-                              tout << "implying upper bound for v" << it->m_var << " " << implied_k << " using row:\n";
-                              display_row_info(tout, r);
-                              display_var(tout, it->m_var););
-                        mk_implied_bound(r, idx, is_lower, it->m_var, B_UPPER, implied_k);
-                    }
-                }
+                      tout << "implying upper bound for v" << entry.m_var << " " << implied_k << " using row:\n";
+                      display_row_info(tout, r);
+                      display_var(tout, entry.m_var););
+                mk_implied_bound(r, idx, is_lower, entry.m_var, B_UPPER, implied_k);
             }
         }
     }
@@ -2669,6 +3024,25 @@ namespace smt {
         }
     }
 
+    /**
+       \brief Store in bounds the bounds used by explain_bound (without relaxation) to justify 
+       the lower/upper bound of the monomial at position idx.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::collect_bounds(row const & r, int idx, bool is_lower, ptr_vector<bound> & bounds) {
+        bounds.reset();
+        typename vector<row_entry>::const_iterator it  = r.begin_entries();
+        typename vector<row_entry>::const_iterator end = r.end_entries();
+        for (int idx2 = 0; it != end; ++it, ++idx2) {
+            if (!it->is_dead() && idx != idx2) {
+                bound * b  = get_bound(it->m_var, is_lower ? it->m_coeff.is_pos() : it->m_coeff.is_neg());
+                SASSERT(b);
+                if (b->has_justification())
+                    bounds.push_back(b);
+            }
+        }
+    }
+
     template<typename Ext>
     void theory_arith<Ext>::mk_implied_bound(row const & r, unsigned idx, bool is_lower, theory_var v, bound_kind kind, inf_numeral const & k) {
         atoms & as                       = m_var_occs[v];
@@ -2746,6 +3120,17 @@ namespace smt {
     void theory_arith<Ext>::assign_bound_literal(literal l, row const & r, unsigned idx, bool is_lower, inf_numeral & delta, antecedents& ante) {
         m_stats.m_bound_props++;
         context & ctx = get_context();
+        if (lazy_explanations()) {
+            // explanations that would be added as small lemmas are still computed eagerly.
+            ptr_vector<bound> & bounds = m_tmp_bounds;
+            collect_bounds(r, idx, is_lower, bounds);
+            if (bounds.size() >= small_lemma_size()) {
+                m_stats.m_lazy_bound_props++;
+                TRACE("propagate_bounds", tout << "lazy explanation of "; ctx.display_detailed_literal(tout, l); tout << "\n";);
+                ctx.assign(l, ctx.mk_justification(lazy_bound_justification(*this, ctx.get_region(), bounds.size(), bounds.c_ptr())));
+                return;
+            }
+        }
         explain_bound(r, idx, is_lower, delta, ante);
         if (dump_lemmas()) {
             char const * logic = is_int(r.get_base_var()) ? "QF_LIA" : "QF_LRA";
@@ -2805,23 +3190,7 @@ namespace smt {
             row & r = m_rows[*it];
             if (r.get_base_var() != null_theory_var) {
                 if (r.size() < max_lemma_size()) { // Ignore big rows.
-                    int lower_idx;
-                    int upper_idx;
-                    is_row_useful_for_bound_prop(r, lower_idx, upper_idx);
-                    
-                    if (lower_idx >= 0) {
-                        imply_bound_for_monomial(r, lower_idx, true);
-                    }
-                    else if (lower_idx == -1) {
-                        imply_bound_for_all_monomials(r, true);
-                    }
-                    
-                    if (upper_idx >= 0) {
-                        imply_bound_for_monomial(r, upper_idx, false);
-                    }
-                    else if (upper_idx == -1) {
-                        imply_bound_for_all_monomials(r, false);
-                    }
+                    imply_bounds(r);
                     
                     // sneaking cheap eq detection in this loop 
                     propagate_cheap_eq(*it);
@@ -3252,6 +3621,10 @@ namespace smt {
             m_var_pos         .shrink(old_num_vars);
             m_bounds[0]       .shrink(old_num_vars);
             m_bounds[1]       .shrink(old_num_vars);
+            m_pseudo_costs    .shrink(old_num_vars);
+            if (m_last_branch_var >= static_cast<int>(old_num_vars))
+                m_last_branch_var = null_theory_var;
+            del_pooled_cuts(old_num_vars);
             SASSERT(check_vector_sizes());
         }
     }
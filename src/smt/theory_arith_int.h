@@ -19,6 +19,7 @@ Revision History:
 #ifndef _THEORY_ARITH_INT_H_
 #define _THEORY_ARITH_INT_H_
 
+#include<math.h>
 #include"ast_ll_pp.h"
 #include"arith_simplifier_plugin.h"
 #include"well_sorted.h"
@@ -202,6 +203,11 @@ namespace smt {
         numeral k     = ceil(get_value(v));
         rational _k   = k.to_rational();
         expr * bound  = m_util.mk_ge(get_enode(v)->get_owner(), m_util.mk_numeral(_k, true));
+        if (branch_and_cut()) {
+            m_last_branch_var           = v;
+            m_last_branch_value         = get_value(v).get_rational();
+            m_last_branch_infeasibility = int_infeasibility();
+        }
         TRACE("arith_branching", tout << mk_bounded_pp(bound, get_manager()) << "\n";);
         context & ctx = get_context();
         ctx.internalize(bound, true);
@@ -470,6 +476,7 @@ namespace smt {
 
     /**
        \brief Create a gomory cut for the given row.
+       When the cut pool is used, the cut is added to the pool instead of being asserted.
     */
     template<typename Ext>
     bool theory_arith<Ext>::mk_gomory_cut(row const & r) {
@@ -492,8 +499,6 @@ namespace smt {
         
         antecedents& ante = get_antecedents();
 
-        m_stats.m_gomory_cuts++;
-
         // gomory will be   pol >= k
         numeral k(1);
         buffer<row_entry> pol;
@@ -595,10 +600,12 @@ namespace smt {
         if (pol.empty()) {
             SASSERT(k.is_pos());
             // conflict 0 >= k where k is positive
+            m_stats.m_gomory_cuts++;
             set_conflict(ante.lits().size(), ante.lits().c_ptr(), ante.eqs().size(), ante.eqs().c_ptr(), ante, true, "gomory_cut");
             return true;
         }
-        else if (pol.size() == 1) {
+        numeral k0 = k; // k is normalized below
+        if (pol.size() == 1) {
             theory_var v = pol[0].m_var;
             k /= pol[0].m_coeff;
             bool is_lower = pol[0].m_coeff.is_pos();
@@ -638,6 +645,15 @@ namespace smt {
             mk_polynomial_ge(pol.size(), pol.c_ptr(), k.to_rational(), bound);            
         }
         TRACE("gomory_cut", tout << "new cut:\n" << mk_pp(bound, get_manager()) << "\n";);
+        if (use_cut_pool()) {
+            // cuts depending on equalities cannot be stored as clauses, and cuts with
+            // big coefficients produce even bigger cuts when they are reused. They are discarded.
+            if (!ante.eqs().empty() || !is_small_cut(pol))
+                return false;
+            add_cut_to_pool(mk_pooled_cut(pol, pol.size() == 1 ? k0 : k), bound, ante);
+            return true;
+        }
+        m_stats.m_gomory_cuts++;
         literal l     = null_literal;
         context & ctx = get_context();
         ctx.internalize(bound, true);
@@ -650,6 +666,308 @@ namespace smt {
                            ante.eqs().size(), ante.eqs().c_ptr(), l)));
         return true;
     }
+
+    /**
+       \brief Return the sum of the distances of the integer variables to their nearest integers.
+       This is the measure used to compute pseudo-costs.
+    */
+    template<typename Ext>
+    double theory_arith<Ext>::int_infeasibility() const {
+        double r = 0;
+        int num  = get_num_vars();
+        for (theory_var v = 0; v < num; v++) {
+            if (is_int(v) && !get_value(v).is_int()) {
+                numeral val = get_value(v).get_rational();
+                double f    = (val - floor(val)).to_rational().get_double();
+                r += std::min(f, 1.0 - f);
+            }
+        }
+        return r;
+    }
+
+    /**
+       \brief Update the pseudo-cost of the variable of the last branching.
+       The case split is decided by the core, so the direction of the branch is
+       recovered from the current value of the variable.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::update_pseudo_cost() {
+        theory_var v = m_last_branch_var;
+        if (v == null_theory_var)
+            return;
+        m_last_branch_var = null_theory_var;
+        numeral const & old_val = m_last_branch_value;
+        numeral val = get_value(v).get_rational();
+        double gain = std::max(0.0, m_last_branch_infeasibility - int_infeasibility());
+        bool up;
+        double f;
+        if (val >= ceil(old_val)) {
+            up = true;
+            f  = (ceil(old_val) - old_val).to_rational().get_double();
+        }
+        else if (val <= floor(old_val)) {
+            up = false;
+            f  = (old_val - floor(old_val)).to_rational().get_double();
+        }
+        else {
+            return;
+        }
+        m_pseudo_costs[v].record(up, gain / f);
+        m_avg_pseudo_cost.record(up, gain / f);
+    }
+
+    /**
+       \brief Return the product of the expected decrease of the integer infeasibility
+       in both branches on v. Variables without history use the average pseudo-costs.
+    */
+    template<typename Ext>
+    double theory_arith<Ext>::pseudo_cost_score(theory_var v) const {
+        pseudo_cost const & pc = m_pseudo_costs[v];
+        double down = pc.m_num_down > 0 ? pc.m_down : (m_avg_pseudo_cost.m_num_down > 0 ? m_avg_pseudo_cost.m_down : 1.0);
+        double up   = pc.m_num_up > 0 ? pc.m_up : (m_avg_pseudo_cost.m_num_up > 0 ? m_avg_pseudo_cost.m_up : 1.0);
+        numeral val = get_value(v).get_rational();
+        double f    = (val - floor(val)).to_rational().get_double();
+        double eps  = 1e-6;
+        return std::max(down * f, eps) * std::max(up * (1.0 - f), eps);
+    }
+
+    /**
+       \brief Select the integer base variable that is not assigned to an integer value.
+       As in find_bounded_infeasible_int_base_var, variables with the tightest bounds are
+       preferred, and the pseudo-cost score selects among them. Remaining ties are broken randomly.
+    */
+    template<typename Ext>
+    theory_var theory_arith<Ext>::select_pseudo_cost_int_var() {
+        theory_var r = null_theory_var;
+        numeral range;
+        numeral new_range;
+        numeral small_range_thresold(1024);
+        bool bounded = false;
+        double best  = 0;
+        unsigned n   = 0;
+        typename vector<row>::const_iterator it  = m_rows.begin();
+        typename vector<row>::const_iterator end = m_rows.end();
+        for (; it != end; ++it) {
+            theory_var v = it->get_base_var();
+            if (v == null_theory_var || !is_base(v) || !is_int(v) || get_value(v).is_int())
+                continue;
+            bool new_bounded = false;
+            if (is_bounded(v)) {
+                new_range  = upper_bound(v).get_rational();
+                new_range -= lower_bound(v).get_rational();
+                new_bounded = new_range <= small_range_thresold;
+            }
+            if (r != null_theory_var && ((bounded && !new_bounded) || (bounded && new_bounded && new_range > range)))
+                continue;
+            double score = pseudo_cost_score(v);
+            if (r == null_theory_var || (new_bounded && !bounded) || (new_bounded && new_range < range) || score > best) {
+                r       = v;
+                best    = score;
+                bounded = new_bounded;
+                range   = new_range;
+                n       = 1;
+            }
+            else if (score == best) {
+                n++;
+                if (m_random() % n == 0)
+                    r = v;
+            }
+        }
+        if (r == null_theory_var) 
+            return find_infeasible_int_base_var();
+        m_stats.m_pseudo_cost_branches++;
+        return r;
+    }
+
+    template<typename Ext>
+    bool theory_arith<Ext>::is_small_cut(buffer<row_entry> const & pol) const {
+        numeral max_coeff(1024);
+        typename buffer<row_entry>::const_iterator it  = pol.begin();
+        typename buffer<row_entry>::const_iterator end = pol.end();
+        for (; it != end; ++it) {
+            if (abs(numerator(it->m_coeff)) > max_coeff || denominator(it->m_coeff) > max_coeff)
+                return false;
+        }
+        return true;
+    }
+
+    template<typename Ext>
+    typename theory_arith<Ext>::pooled_cut * theory_arith<Ext>::mk_pooled_cut(buffer<row_entry> const & pol, numeral const & k) const {
+        pooled_cut * c = alloc(pooled_cut);
+        for (unsigned i = 0; i < pol.size(); i++) {
+            c->m_pol.push_back(pol[i]);
+            c->m_max_var = std::max(c->m_max_var, pol[i].m_var);
+        }
+        c->m_k = k;
+        return c;
+    }
+
+    /**
+       \brief Insert a new cut in the cut pool. If the pool already contains the cut,
+       then the pooled copy is rejuvenated instead.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::add_cut_to_pool(pooled_cut * c, expr * cut, antecedents & ante) {
+        typename ptr_vector<pooled_cut>::iterator it  = m_cut_pool.begin();
+        typename ptr_vector<pooled_cut>::iterator end = m_cut_pool.end();
+        for (; it != end; ++it) {
+            if ((*it)->m_cut == cut) {
+                (*it)->m_age = 0;
+                dealloc(c);
+                return;
+            }
+        }
+        ast_manager & m = get_manager();
+        context & ctx   = get_context();
+        c->m_cut = cut;
+        m.inc_ref(cut);
+        literal_vector::const_iterator it2  = ante.lits().begin();
+        literal_vector::const_iterator end2 = ante.lits().end();
+        for (; it2 != end2; ++it2) {
+            expr * atom = ctx.bool_var2expr(it2->var());
+            m.inc_ref(atom);
+            c->m_atoms.push_back(atom);
+            c->m_signs.push_back(it2->sign());
+        }
+        m_cut_pool.push_back(c);
+        m_stats.m_pooled_cuts++;
+    }
+
+    template<typename Ext>
+    void theory_arith<Ext>::del_pooled_cut(pooled_cut * c) {
+        ast_manager & m = get_manager();
+        m.dec_ref(c->m_cut);
+        ptr_vector<expr>::iterator it  = c->m_atoms.begin();
+        ptr_vector<expr>::iterator end = c->m_atoms.end();
+        for (; it != end; ++it)
+            m.dec_ref(*it);
+        dealloc(c);
+    }
+
+    /**
+       \brief Remove the pooled cuts that contain variables greater than or equal to old_num_vars.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::del_pooled_cuts(unsigned old_num_vars) {
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_cut_pool.size(); i++) {
+            pooled_cut * c = m_cut_pool[i];
+            if (c->m_max_var >= static_cast<int>(old_num_vars))
+                del_pooled_cut(c);
+            else
+                m_cut_pool[j++] = c;
+        }
+        m_cut_pool.shrink(j);
+    }
+
+    /**
+       \brief Return the violation of the cut by the current assignment divided by the
+       euclidean norm of the cut, or 0 if the current assignment satisfies the cut.
+    */
+    template<typename Ext>
+    double theory_arith<Ext>::cut_efficacy(pooled_cut const & c) const {
+        numeral val;
+        double norm = 0;
+        typename vector<row_entry>::const_iterator it  = c.m_pol.begin();
+        typename vector<row_entry>::const_iterator end = c.m_pol.end();
+        for (; it != end; ++it) {
+            val += it->m_coeff * get_value(it->m_var).get_rational();
+            double a = it->m_coeff.to_rational().get_double();
+            norm += a * a;
+        }
+        if (val >= c.m_k)
+            return 0;
+        return (c.m_k - val).to_rational().get_double() / sqrt(norm);
+    }
+
+    /**
+       \brief Assert the theory lemma (or (not a_1) ... (not a_n) cut) for the given pooled cut.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::export_cut(pooled_cut const & c) {
+        context & ctx = get_context();
+        literal_vector & lits = m_tmp_literal_vector2;
+        lits.reset();
+        ctx.internalize(c.m_cut, true);
+        literal l = ctx.get_literal(c.m_cut);
+        ctx.mark_as_relevant(l);
+        lits.push_back(l);
+        for (unsigned i = 0; i < c.m_atoms.size(); i++) {
+            expr * atom = c.m_atoms[i];
+            ctx.internalize(atom, true);
+            ctx.mark_as_relevant(atom);
+            lits.push_back(~literal(ctx.get_bool_var(atom), c.m_signs[i]));
+        }
+        TRACE("gomory_cut", tout << "exporting cut:\n"; ctx.display_literals_verbose(tout, lits.size(), lits.c_ptr()); tout << "\n";);
+        m_stats.m_gomory_cuts++;
+        m_stats.m_cut_lemmas++;
+        ctx.mk_clause(lits.size(), lits.c_ptr(), 0, CLS_AUX_LEMMA, 0);
+    }
+
+    /**
+       \brief Cutting plane round of the branch and cut strategy. Gomory cuts for the rows of
+       integer base variables that are not assigned to integer values are added to the cut pool,
+       and the most violated cuts of the pool are exported as theory lemmas. The remaining cuts
+       age, and they are removed from the pool after m_arith_cut_max_age rounds.
+       Return false if no cut was exported.
+    */
+    template<typename Ext>
+    bool theory_arith<Ext>::mk_gomory_cuts() {
+        context & ctx           = get_context();
+        unsigned max_cuts       = m_params.m_arith_cuts_per_round;
+        unsigned num_rows       = m_rows.size();
+        unsigned num_candidates = 0;
+        unsigned start          = num_rows == 0 ? 0 : m_random() % num_rows;
+        for (unsigned i = 0; i < num_rows && num_candidates < 4 * max_cuts; i++) {
+            row const & r = m_rows[(start + i) % num_rows];
+            theory_var v  = r.get_base_var();
+            if (v == null_theory_var || !is_base(v) || !is_int(v) || get_value(v).is_int())
+                continue;
+            if (mk_gomory_cut(r)) {
+                num_candidates++;
+                if (ctx.inconsistent())
+                    return true;
+            }
+        }
+
+        svector<double> efficacy;
+        typename ptr_vector<pooled_cut>::const_iterator it  = m_cut_pool.begin();
+        typename ptr_vector<pooled_cut>::const_iterator end = m_cut_pool.end();
+        for (; it != end; ++it)
+            efficacy.push_back(cut_efficacy(**it));
+
+        unsigned num_exported = 0;
+        while (num_exported < max_cuts && !ctx.inconsistent()) {
+            unsigned best = UINT_MAX;
+            for (unsigned i = 0; i < efficacy.size(); i++) {
+                if (efficacy[i] > 0 && (best == UINT_MAX || efficacy[i] > efficacy[best]))
+                    best = i;
+            }
+            if (best == UINT_MAX)
+                break;
+            export_cut(*m_cut_pool[best]);
+            efficacy[best] = -1;
+            num_exported++;
+        }
+
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_cut_pool.size(); i++) {
+            pooled_cut * c = m_cut_pool[i];
+            if (efficacy[i] < 0) {
+                del_pooled_cut(c);
+            }
+            else if (++c->m_age > m_params.m_arith_cut_max_age) {
+                m_stats.m_aged_cuts++;
+                del_pooled_cut(c);
+            }
+            else {
+                m_cut_pool[j++] = c;
+            }
+        }
+        m_cut_pool.shrink(j);
+        TRACE("gomory_cut", tout << "candidates: " << num_candidates << ", exported: " << num_exported << ", pool: " << m_cut_pool.size() << "\n";);
+        return num_exported > 0 || ctx.inconsistent();
+    }
     
     /**
        \brief Return false if the row failed the GCD test, that is, a conflict was detected.
@@ -1260,6 +1578,8 @@ namespace smt {
     template<typename Ext>
     final_check_status theory_arith<Ext>::check_int_feasibility() {
         TRACE("arith_int_detail", get_context().display(tout););
+        if (branch_and_cut())
+            update_pseudo_cost();
         if (!has_infeasible_int_var()) {
             TRACE("arith_int_incomp", tout << "FC_DONE 1...\n"; display(tout););
             return FC_DONE;
@@ -1385,20 +1705,32 @@ namespace smt {
                 failed();
                 return FC_CONTINUE;
             }
-            theory_var int_var = find_infeasible_int_base_var();
-            if (int_var != null_theory_var) {
-                TRACE("arith_int", tout << "v" << int_var << " does not have an integer assignment: " << get_value(int_var) << "\n";);
-                SASSERT(is_base(int_var));
-                row const & r = m_rows[get_var_row(int_var)];
-                mk_gomory_cut(r);
-                return FC_CONTINUE;
+            if (use_cut_pool()) {
+                if (mk_gomory_cuts())
+                    return FC_CONTINUE;
+                // no violated cut was found, fall back to branching.
+                theory_var int_var = select_pseudo_cost_int_var();
+                if (int_var != null_theory_var) {
+                    branch_infeasible_int_var(int_var);
+                    return FC_CONTINUE;
+                }
+            }
+            else {
+                theory_var int_var = find_infeasible_int_base_var();
+                if (int_var != null_theory_var) {
+                    TRACE("arith_int", tout << "v" << int_var << " does not have an integer assignment: " << get_value(int_var) << "\n";);
+                    SASSERT(is_base(int_var));
+                    row const & r = m_rows[get_var_row(int_var)];
+                    mk_gomory_cut(r);
+                    return FC_CONTINUE;
+                }
             }
         }
         else {
             if (m_params.m_arith_int_eq_branching && branch_infeasible_int_equality()) {
                 return FC_CONTINUE;
             }
-            theory_var int_var = find_infeasible_int_base_var();
+            theory_var int_var = branch_and_cut() ? select_pseudo_cost_int_var() : find_infeasible_int_base_var();
             if (int_var != null_theory_var) {
                 TRACE("arith_int", tout << "v" << int_var << " does not have and integer assignment: " << get_value(int_var) << "\n";);
                 // apply branching 
@@ -34,6 +34,7 @@ namespace smt {
         SASSERT(m_var_pos.size() == m_data.size());
         SASSERT(m_bounds[0].size() == m_data.size());
         SASSERT(m_bounds[1].size() == m_data.size());
+        SASSERT(m_pseudo_costs.size() == m_data.size());
         return true;
     }
 
@@ -29,15 +29,26 @@ namespace smt {
         st.update("arith conflicts", m_stats.m_conflicts);
         st.update("add rows", m_stats.m_add_rows);
         st.update("pivots", m_stats.m_pivots);
+        if (m_stats.m_dual_simplex > 0) {
+            st.update("dual simplex calls", m_stats.m_dual_simplex);
+            st.update("dual simplex certified feasible", m_stats.m_dual_simplex_feasible);
+            st.update("dual simplex certified conflicts", m_stats.m_dual_simplex_conflicts);
+            m_dual_simplex.collect_statistics(st);
+        }
         st.update("assert lower", m_stats.m_assert_lower);
         st.update("assert upper", m_stats.m_assert_upper);
         st.update("assert diseq", m_stats.m_assert_diseq);
         st.update("bound prop", m_stats.m_bound_props);
+        st.update("lazy bound prop", m_stats.m_lazy_bound_props);
         st.update("fixed eqs", m_stats.m_fixed_eqs);
         st.update("offset eqs", m_stats.m_offset_eqs);
         st.update("gcd tests", m_stats.m_gcd_tests);
         st.update("ineq splits", m_stats.m_branches);
         st.update("gomory cuts", m_stats.m_gomory_cuts);
+        st.update("pseudo cost branches", m_stats.m_pseudo_cost_branches);
+        st.update("pooled cuts", m_stats.m_pooled_cuts);
+        st.update("cut lemmas", m_stats.m_cut_lemmas);
+        st.update("aged cuts", m_stats.m_aged_cuts);
         st.update("max-min", m_stats.m_max_min);
         st.update("grobner", m_stats.m_gb_compute_basis);
         st.update("pseudo nonlinear", m_stats.m_nl_linear);
@@ -753,6 +753,177 @@ namespace smt {
     MK_AC_BINARY(internalize_xnor,     mk_xnor);
     MK_BINARY(internalize_comp,     mk_comp);
 
+    class add_lazy_term_trail : public trail<theory_bv> {
+    public:
+        virtual void undo(theory_bv & th) {
+            th.m_lazy_terms.pop_back();
+        }
+    };
+
+    class blast_lazy_term_trail : public trail<theory_bv> {
+        unsigned m_idx;
+    public:
+        blast_lazy_term_trail(unsigned idx):m_idx(idx) {}
+        virtual void undo(theory_bv & th) {
+            th.m_lazy_terms[m_idx].m_blasted = false;
+        }
+    };
+
+    /**
+       \brief Internalize a multiplication, unsigned division or remainder without
+       creating its circuit. See blast_lazy_term.
+    */
+    void theory_bv::internalize_lazy(app * n) {
+        SASSERT(!get_context().e_internalized(n));
+        process_args(n);
+        enode * e = mk_enode(n);
+        // make sure the arguments have bits, as it happens when the circuit is created.
+        for (unsigned i = 0; i < n->get_num_args(); i++) 
+            get_arg_var(e, i);
+        mk_bits(e->get_th_var(get_id()));
+        m_lazy_terms.push_back(lazy_term(e));
+        m_trail_stack.push(add_lazy_term_trail());
+    }
+
+    void theory_bv::mk_lazy_circuit(enode * e, expr_ref_vector & bits) {
+        ast_manager & m = get_manager();
+        app * n         = e->get_owner();
+        expr_ref_vector arg1_bits(m), arg2_bits(m);
+        switch (n->get_decl_kind()) {
+        case OP_BMUL: {
+            unsigned i = n->get_num_args();
+            --i;
+            get_arg_bits(e, i, bits);
+            while (i > 0) {
+                --i;
+                arg1_bits.reset();
+                get_arg_bits(e, i, arg1_bits);
+                arg2_bits.reset();
+                m_bb.mk_multiplier(arg1_bits.size(), arg1_bits.c_ptr(), bits.c_ptr(), arg2_bits);
+                bits.swap(arg2_bits);
+            }
+            break;
+        }
+        case OP_BUDIV_I:
+            get_arg_bits(e, 0, arg1_bits);
+            get_arg_bits(e, 1, arg2_bits);
+            m_bb.mk_udiv(arg1_bits.size(), arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits);
+            break;
+        case OP_BUREM_I:
+            get_arg_bits(e, 0, arg1_bits);
+            get_arg_bits(e, 1, arg2_bits);
+            m_bb.mk_urem(arg1_bits.size(), arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits);
+            break;
+        default:
+            UNREACHABLE();
+        }
+    }
+
+    /**
+       \brief Store in result the value of the bits of v. Return false if some bit is not assigned.
+    */
+    bool theory_bv::get_bits_value(theory_var v, numeral & result) const {
+        context & ctx               = get_context();
+        literal_vector const & bits = m_bits[v];
+        result.reset();
+        for (unsigned i = 0; i < bits.size(); i++) {
+            lbool val = ctx.get_assignment(bits[i]);
+            if (val == l_undef)
+                return false;
+            if (val == l_true)
+                result += rational::power_of_two(i);
+        }
+        return true;
+    }
+
+    /**
+       \brief Return true if the values assigned to the bits of the lazy term e and its arguments
+       satisfy the semantics of its operator. 
+       Division by zero is not checked, the term is blasted in this case.
+    */
+    bool theory_bv::is_lazy_term_consistent(enode * e) {
+        app * n = e->get_owner();
+        theory_var v = e->get_th_var(get_id());
+        numeral r, expected, arg;
+        if (!get_bits_value(v, r))
+            return false;
+        unsigned num_args = n->get_num_args();
+        for (unsigned i = 0; i < num_args; i++) {
+            if (!get_bits_value(get_arg_var(e, i), arg))
+                return false;
+            if (i == 0) {
+                expected = arg;
+                continue;
+            }
+            switch (n->get_decl_kind()) {
+            case OP_BMUL: 
+                expected *= arg; 
+                break;
+            case OP_BUDIV_I: 
+                if (arg.is_zero()) return false;
+                expected = div(expected, arg); 
+                break;
+            case OP_BUREM_I: 
+                if (arg.is_zero()) return false;
+                expected = mod(expected, arg); 
+                break;
+            default:
+                UNREACHABLE();
+            }
+        }
+        expected = mod(expected, rational::power_of_two(get_bv_size(e)));
+        return r == expected;
+    }
+
+    /**
+       \brief Assert that the bits of the lazy term at position idx are equal to
+       the bits of its circuit.
+    */
+    void theory_bv::blast_lazy_term(unsigned idx) {
+        context & ctx   = get_context();
+        ast_manager & m = get_manager();
+        enode * e       = m_lazy_terms[idx].m_enode;
+        theory_var v    = e->get_th_var(get_id());
+        expr_ref_vector bits(m);
+        mk_lazy_circuit(e, bits);
+        SASSERT(bits.size() == m_bits[v].size());
+        TRACE("bv", tout << "blasting: " << mk_bounded_pp(e->get_owner(), m) << "\n";);
+        for (unsigned i = 0; i < bits.size(); i++) {
+            expr_ref s_bit(m);
+            simplify_bit(bits.get(i), s_bit);
+            ctx.internalize(s_bit, true);
+            literal l = ctx.get_literal(s_bit);
+            literal b = m_bits[v][i];
+            ctx.mark_as_relevant(l);
+            ctx.mark_as_relevant(b);
+            ctx.mk_th_axiom(get_id(), ~l,  b);
+            ctx.mk_th_axiom(get_id(),  l, ~b);
+        }
+        m_lazy_terms[idx].m_blasted = true;
+        m_lazy_terms[idx].m_reblast = true;
+        m_trail_stack.push(blast_lazy_term_trail(idx));
+        m_stats.m_num_lazy_blast++;
+    }
+
+    /**
+       \brief Blast the relevant lazy terms that are not satisfied by the current assignment.
+       Return true if a term was blasted.
+    */
+    bool theory_bv::check_lazy_terms() {
+        context & ctx = get_context();
+        bool blasted  = false;
+        for (unsigned i = 0; i < m_lazy_terms.size(); i++) {
+            lazy_term const & t = m_lazy_terms[i];
+            if (t.m_blasted || (ctx.relevancy() && !ctx.is_relevant(t.m_enode)))
+                continue;
+            if (!is_lazy_term_consistent(t.m_enode)) {
+                blast_lazy_term(i);
+                blasted = true;
+            }
+        }
+        return blasted;
+    }
+
 #define MK_PARAMETRIC_UNARY(NAME, BLAST_OP)                                     \
     void theory_bv::NAME(app * n) {                                             \
         SASSERT(!get_context().e_internalized(n));                              \
@@ -813,11 +984,11 @@ namespace smt {
         switch (term->get_decl_kind()) {
         case OP_BV_NUM:         internalize_num(term); return true;
         case OP_BADD:           internalize_add(term); return true;
-        case OP_BMUL:           internalize_mul(term); return true;
+        case OP_BMUL:           if (lazy_blast()) internalize_lazy(term); else internalize_mul(term); return true;
         case OP_BSDIV_I:        internalize_sdiv(term); return true;
-        case OP_BUDIV_I:        internalize_udiv(term); return true;
+        case OP_BUDIV_I:        if (lazy_blast()) internalize_lazy(term); else internalize_udiv(term); return true;
         case OP_BSREM_I:        internalize_srem(term); return true;
-        case OP_BUREM_I:        internalize_urem(term); return true;
+        case OP_BUREM_I:        if (lazy_blast()) internalize_lazy(term); else internalize_urem(term); return true;
         case OP_BSMOD_I:        internalize_smod(term); return true;
         case OP_BAND:           internalize_and(term); return true;
         case OP_BOR:            internalize_or(term); return true;
@@ -1268,8 +1439,23 @@ namespace smt {
         theory::pop_scope_eh(num_scopes);
     }
 
+    /**
+       \brief The circuits created by final_check_eh are lost when the context backtracks.
+       Terms that were already blasted are blasted again at the search level, where
+       their circuits survive.
+    */
+    void theory_bv::restart_eh() {
+        for (unsigned i = 0; i < m_lazy_terms.size(); i++) {
+            if (m_lazy_terms[i].m_reblast && !m_lazy_terms[i].m_blasted)
+                blast_lazy_term(i);
+        }
+    }
+
     final_check_status theory_bv::final_check_eh() {
         SASSERT(check_invariant());
+        if (lazy_blast() && check_lazy_terms()) {
+            return FC_CONTINUE;
+        }
         if (m_approximates_large_bvs) {
             return FC_GIVEUP;
         }
@@ -1280,6 +1466,7 @@ namespace smt {
         pop_scope_eh(m_trail_stack.get_num_scopes());
         m_bool_var2atom.reset();
         m_fixed_var_table.reset();
+        m_lazy_terms.reset();
         theory::reset_eh();
     }
 
@@ -1580,6 +1767,7 @@ namespace smt {
         st.update("bv dynamic diseqs", m_stats.m_num_diseq_dynamic);
         st.update("bv bit2core", m_stats.m_num_bit2core);
         st.update("bv->core eq", m_stats.m_num_th2core_eq);
+        st.update("bv lazy blast", m_stats.m_num_lazy_blast);
     }
 
 #ifdef Z3DEBUG
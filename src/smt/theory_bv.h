@@ -34,6 +34,7 @@ namespace smt {
     
     struct theory_bv_stats {
         unsigned   m_num_diseq_static, m_num_diseq_dynamic, m_num_bit2core, m_num_th2core_eq, m_num_conflicts;
+        unsigned   m_num_lazy_blast;
         void reset() { memset(this, 0, sizeof(theory_bv_stats)); }
         theory_bv_stats() { reset(); }
     };
@@ -130,6 +131,21 @@ namespace smt {
         svector<var_pos>         m_prop_queue;
         bool                     m_approximates_large_bvs;
 
+        /**
+           \brief In the lazy blasting mode (BS_LAZY_BLASTER), the bits of multiplications,
+           unsigned divisions and remainders are fresh atoms. The circuit relating them to 
+           the bits of the arguments is only created when the candidate model violates the
+           semantics of the operator. There is no word-level propagation on the unblasted
+           terms, they are only checked against complete assignments (check_lazy_terms).
+        */
+        struct lazy_term {
+            enode * m_enode;
+            bool    m_blasted;
+            bool    m_reblast; // the term was blasted before, its circuit is recreated on restarts.
+            lazy_term(enode * n = 0):m_enode(n), m_blasted(false), m_reblast(false) {}
+        };
+        svector<lazy_term>       m_lazy_terms;
+
         theory_var find(theory_var v) const { return m_find.find(v); }
         theory_var next(theory_var v) const { return m_find.next(v); }
         bool is_root(theory_var v) const { return m_find.is_root(v); }
@@ -203,6 +219,16 @@ namespace smt {
         void internalize_smul_no_overflow(app *n);
         void internalize_smul_no_underflow(app *n);
 
+        bool lazy_blast() const { return m_params.m_bv_mode == BS_LAZY_BLASTER; }
+        friend class add_lazy_term_trail;
+        friend class blast_lazy_term_trail;
+        void internalize_lazy(app * n);
+        void mk_lazy_circuit(enode * e, expr_ref_vector & bits);
+        bool get_bits_value(theory_var v, numeral & result) const;
+        bool is_lazy_term_consistent(enode * e);
+        void blast_lazy_term(unsigned idx);
+        bool check_lazy_terms();
+
         bool approximate_term(app* n);
 
         template<bool Signed>
@@ -234,6 +260,7 @@ namespace smt {
         virtual void relevant_eh(app * n);
         virtual void push_scope_eh();
         virtual void pop_scope_eh(unsigned num_scopes);
+        virtual void restart_eh();
         virtual final_check_status final_check_eh();
         virtual void reset_eh();
         svector<theory_var>   m_merge_aux[2]; //!< auxiliary vector used in merge_zero_one_bits
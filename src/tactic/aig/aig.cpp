@@ -20,6 +20,7 @@ Notes:
 #include"goal.h"
 #include"ast_smt2_pp.h"
 #include"cooperate.h"
+#include"sat_solver.h"
 
 #define USE_TWO_LEVEL_RULES
 #define FIRST_NODE_ID (UINT_MAX/2)
@@ -1302,6 +1303,822 @@ struct aig_manager::imp {
         }
     };
 
+    /**
+       \brief Nodes of the AIG rooted at a literal, in topological order.
+       The constant node is always the first one. The children of the i-th node
+       are stored as (index << 1) | sign in m_fanins[2*i] and m_fanins[2*i+1].
+    */
+    struct topo_nodes {
+        ptr_vector<aig>   m_nodes;
+        unsigned_vector   m_fanins;
+        u_map<unsigned>   m_id2idx;
+
+        unsigned get_idx(aig * n) const {
+            unsigned r = 0;
+            VERIFY(m_id2idx.find(n->m_id, r));
+            return r;
+        }
+
+        unsigned to_code(aig_lit const & l) const { return (get_idx(l.ptr()) << 1) | (l.is_inverted() ? 1 : 0); }
+
+        unsigned fanin(unsigned i, unsigned k) const { return m_fanins[2*i + k]; }
+
+        unsigned size() const { return m_nodes.size(); }
+
+        void push(aig * n) {
+            n->m_mark = true;
+            m_id2idx.insert(n->m_id, m_nodes.size());
+            m_nodes.push_back(n);
+        }
+
+        void operator()(imp & m, aig_lit const & root) {
+            push(m.m_true.ptr());
+            ptr_vector<aig> todo;
+            todo.push_back(root.ptr());
+            while (!todo.empty()) {
+                aig * n = todo.back();
+                if (n->m_mark) {
+                    todo.pop_back();
+                    continue;
+                }
+                if (!is_var(n)) {
+                    aig * l = left(n).ptr();
+                    aig * r = right(n).ptr();
+                    if (!l->m_mark || !r->m_mark) {
+                        if (!l->m_mark) todo.push_back(l);
+                        if (!r->m_mark) todo.push_back(r);
+                        continue;
+                    }
+                }
+                todo.pop_back();
+                push(n);
+            }
+            unmark(m_nodes.size(), m_nodes.c_ptr());
+            m_fanins.resize(2 * m_nodes.size(), 0);
+            for (unsigned i = 0; i < m_nodes.size(); i++) {
+                aig * n = m_nodes[i];
+                if (!is_var(n)) {
+                    m_fanins[2*i]   = to_code(left(n));
+                    m_fanins[2*i+1] = to_code(right(n));
+                }
+            }
+        }
+    };
+
+    /**
+       \brief Functional reduction (FRAIG sweeping).
+
+       The nodes are simulated on 64-bit words of random input patterns.
+       Nodes with the same simulation signature, modulo complementation, are
+       candidates for merging, and each candidate pair is proved equivalent by an
+       incremental SAT solver under a conflict budget. A counterexample produced
+       by the solver becomes a new simulation pattern that separates the pair.
+       The AIG is rebuilt bottom-up, replacing each proved node by its representative.
+    */
+    struct fraig_proc {
+        struct sig_hash {
+            fraig_proc * m_owner;
+            sig_hash(fraig_proc * o = 0):m_owner(o) {}
+            unsigned operator()(unsigned i) const { return m_owner->get_sig_hash(i); }
+        };
+
+        struct sig_eq {
+            fraig_proc * m_owner;
+            sig_eq(fraig_proc * o = 0):m_owner(o) {}
+            bool operator()(unsigned i, unsigned j) const { return m_owner->same_sig(i, j, 0, RAND_WORDS); }
+        };
+
+        typedef hashtable<unsigned, sig_hash, sig_eq> sig_table;
+
+        enum {
+            RAND_WORDS = 4,   // words of random patterns, they determine the classes of candidates
+            MAX_WORDS  = 16   // maximal number of words (random and counterexample patterns)
+        };
+
+        imp &                  m;
+        topo_nodes             m_topo;
+        unsigned               m_num_words;
+        unsigned               m_ce_word;    // word receiving the counterexamples
+        unsigned               m_ce_bit;     // next free bit of m_ce_word
+        svector<uint64>        m_sim;        // word-major: m_sim[w * m_topo.size() + i]
+        svector<aig_lit>       m_new;
+        sig_table              m_table;      // first representative of each class
+        unsigned_vector        m_next_rep;   // next representative in the same class
+        sat::solver            m_solver;
+        svector<sat::bool_var> m_vars;       // nodes are encoded in the solver on demand
+        unsigned_vector        m_todo;
+        random_gen             m_rand;
+        unsigned               m_num_merged;
+        unsigned               m_num_refuted;
+        unsigned               m_num_undef;
+
+        static params_ref mk_solver_params(unsigned max_conflicts) {
+            // The queries are many small incremental calls: keep them cheap.
+            params_ref p;
+            p.set_uint("max_conflicts", max_conflicts);
+            p.set_bool("scc", false);
+            p.set_bool("elim_blocked_clauses", false);
+            p.set_bool("resolution", false);
+            p.set_bool("subsumption", false);
+            p.set_bool("probing", false);
+            p.set_bool("asymm_branch", false);
+            return p;
+        }
+
+        fraig_proc(imp & _m, unsigned max_conflicts):
+            m(_m),
+            m_num_words(0),
+            m_ce_word(UINT_MAX),
+            m_ce_bit(0),
+            m_table(DEFAULT_HASHTABLE_INITIAL_CAPACITY, sig_hash(this), sig_eq(this)),
+            m_solver(mk_solver_params(max_conflicts), 0),
+            m_num_merged(0),
+            m_num_refuted(0),
+            m_num_undef(0) {
+        }
+
+        ~fraig_proc() {
+            release();
+        }
+
+        void release() {
+            for (unsigned i = 0; i < m_new.size(); i++) {
+                if (!m_new[i].is_null())
+                    m.dec_ref(m_new[i]);
+            }
+            m_new.reset();
+        }
+
+        uint64 sim(unsigned i, unsigned w) const { return m_sim[w * m_topo.size() + i]; }
+
+        bool phase(unsigned i) const { return (m_sim[i] & 1) != 0; }
+
+        uint64 norm_sim(unsigned i, unsigned w) const { return phase(i) ? ~sim(i, w) : sim(i, w); }
+
+        unsigned get_sig_hash(unsigned i) const {
+            unsigned h = 0;
+            for (unsigned w = 0; w < RAND_WORDS; w++) {
+                uint64 v = norm_sim(i, w);
+                h = combine_hash(h, hash_u_u(static_cast<unsigned>(v), static_cast<unsigned>(v >> 32)));
+            }
+            return h;
+        }
+
+        bool same_sig(unsigned i, unsigned j, unsigned begin, unsigned end) const {
+            for (unsigned w = begin; w < end; w++) {
+                if (norm_sim(i, w) != norm_sim(j, w))
+                    return false;
+            }
+            return true;
+        }
+
+        uint64 rand64() {
+            uint64 r = 0;
+            for (unsigned k = 0; k < 5; k++)
+                r = (r << 15) ^ static_cast<uint64>(m_rand());
+            return r;
+        }
+
+        void simulate(unsigned w) {
+            unsigned sz = m_topo.size();
+            uint64 * s  = m_sim.c_ptr() + w * sz;
+            s[0] = ~static_cast<uint64>(0);
+            for (unsigned i = 1; i < sz; i++) {
+                if (is_var(m_topo.m_nodes[i]))
+                    continue;
+                unsigned a = m_topo.fanin(i, 0);
+                unsigned b = m_topo.fanin(i, 1);
+                uint64 va  = (a & 1) ? ~s[a >> 1] : s[a >> 1];
+                uint64 vb  = (b & 1) ? ~s[b >> 1] : s[b >> 1];
+                s[i] = va & vb;
+            }
+        }
+
+        void add_word() {
+            unsigned sz = m_topo.size();
+            m_sim.resize((m_num_words + 1) * sz, 0);
+            for (unsigned i = 1; i < sz; i++) {
+                if (is_var(m_topo.m_nodes[i]))
+                    m_sim[m_num_words * sz + i] = rand64();
+            }
+            simulate(m_num_words);
+            m_num_words++;
+        }
+
+        void add_counterexample() {
+            if (m_ce_word == UINT_MAX || m_ce_bit == 64) {
+                if (m_num_words < MAX_WORDS) {
+                    add_word();
+                    m_ce_word = m_num_words - 1;
+                }
+                m_ce_bit = 0;
+            }
+            unsigned sz = m_topo.size();
+            uint64 bit  = static_cast<uint64>(1) << m_ce_bit;
+            sat::model const & md = m_solver.get_model();
+            for (unsigned i = 1; i < sz; i++) {
+                // inputs that are not encoded in the solver keep their random value.
+                if (!is_var(m_topo.m_nodes[i]) || m_vars[i] == sat::null_bool_var)
+                    continue;
+                uint64 & v = m_sim[m_ce_word * sz + i];
+                if (md[m_vars[i]] == l_true)
+                    v |= bit;
+                else
+                    v &= ~bit;
+            }
+            m_ce_bit++;
+            simulate(m_ce_word);
+        }
+
+        sat::literal to_lit(unsigned code) const { return sat::literal(m_vars[code >> 1], (code & 1) != 0); }
+
+        /**
+           \brief Encode the cone of node i in the solver. Only inputs are decision variables.
+        */
+        void encode(unsigned i) {
+            m_todo.push_back(i);
+            while (!m_todo.empty()) {
+                unsigned j = m_todo.back();
+                if (m_vars[j] != sat::null_bool_var) {
+                    m_todo.pop_back();
+                    continue;
+                }
+                aig * n = m_topo.m_nodes[j];
+                if (!is_var(n)) {
+                    unsigned a = m_topo.fanin(j, 0) >> 1;
+                    unsigned b = m_topo.fanin(j, 1) >> 1;
+                    if (m_vars[a] == sat::null_bool_var || m_vars[b] == sat::null_bool_var) {
+                        m_todo.push_back(a);
+                        m_todo.push_back(b);
+                        continue;
+                    }
+                }
+                m_todo.pop_back();
+                m_vars[j] = m_solver.mk_var(true, is_var(n) && j != 0);
+                sat::literal o(m_vars[j], false);
+                if (j == 0) {
+                    m_solver.mk_clause(1, &o);
+                }
+                else if (!is_var(n)) {
+                    sat::literal a = to_lit(m_topo.fanin(j, 0));
+                    sat::literal b = to_lit(m_topo.fanin(j, 1));
+                    m_solver.mk_clause(~o, a);
+                    m_solver.mk_clause(~o, b);
+                    m_solver.mk_clause(o, ~a, ~b);
+                }
+            }
+        }
+
+        /**
+           \brief Return l_true if node i is equivalent to node j (to its complement if neg is true),
+           l_false if the solver found a counterexample, and l_undef if the conflict budget was exhausted.
+        */
+        lbool prove(unsigned i, unsigned j, bool neg) {
+            encode(i);
+            encode(j);
+            sat::literal li(m_vars[i], false);
+            sat::literal lj(m_vars[j], neg);
+            sat::literal asms[2];
+            for (unsigned k = 0; k < 2; k++) {
+                asms[0] = k == 0 ? li : ~li;
+                asms[1] = k == 0 ? ~lj : lj;
+                switch (m_solver.check(2, asms)) {
+                case l_true:  return l_false;
+                case l_undef: return l_undef;
+                default: break;
+                }
+            }
+            m_solver.mk_clause(~li, lj);
+            m_solver.mk_clause(li, ~lj);
+            return l_true;
+        }
+
+        aig_lit get_new(unsigned code) const {
+            aig_lit r = m_new[code >> 1];
+            if (code & 1)
+                r.invert();
+            return r;
+        }
+
+        void set_new(unsigned i, aig_lit const & r) {
+            m.inc_ref(r);
+            m_new[i] = r;
+        }
+
+        void add_rep(unsigned i) {
+            unsigned j = 0;
+            if (!m_table.find(i, j)) {
+                m_table.insert(i);
+                return;
+            }
+            while (m_next_rep[j] != UINT_MAX)
+                j = m_next_rep[j];
+            m_next_rep[j] = i;
+        }
+
+        void process(unsigned i) {
+            unsigned j  = 0;
+            bool is_rep = true;
+            if (m_table.find(i, j)) {
+                for (; j != UINT_MAX; j = m_next_rep[j]) {
+                    if (!same_sig(i, j, RAND_WORDS, m_num_words))
+                        continue;
+                    bool neg = phase(i) != phase(j);
+                    lbool r  = prove(i, j, neg);
+                    if (r == l_true) {
+                        aig_lit n = m_new[j];
+                        if (neg)
+                            n.invert();
+                        set_new(i, n);
+                        m_num_merged++;
+                        return;
+                    }
+                    if (r == l_undef) {
+                        m_num_undef++;
+                        is_rep = false;
+                        break;
+                    }
+                    m_num_refuted++;
+                    add_counterexample();
+                }
+            }
+            if (is_rep)
+                add_rep(i);
+            set_new(i, m.mk_and(get_new(m_topo.fanin(i, 0)), get_new(m_topo.fanin(i, 1))));
+        }
+
+        aig_lit operator()(aig_lit p) {
+            m_topo(m, p);
+            unsigned sz = m_topo.size();
+            for (unsigned w = 0; w < RAND_WORDS; w++)
+                add_word();
+            m_new.resize(sz, aig_lit::null);
+            m_next_rep.resize(sz, UINT_MAX);
+            m_vars.resize(sz, sat::null_bool_var);
+            for (unsigned i = 0; i < sz; i++) {
+                aig * n = m_topo.m_nodes[i];
+                if (is_var(n)) {
+                    set_new(i, aig_lit(n));
+                    add_rep(i);
+                }
+                else {
+                    m.checkpoint();
+                    process(i);
+                }
+            }
+            IF_VERBOSE(10, verbose_stream() << "(aig-fraig :nodes " << sz << " :merged " << m_num_merged 
+                       << " :refuted " << m_num_refuted << " :undef " << m_num_undef << ")\n";);
+            aig_lit r = get_new(m_topo.to_code(p));
+            m.inc_ref(r);
+            release();
+            m.dec_ref_result(r);
+            return r;
+        }
+    };
+
+    /**
+       \brief DAG-aware cut rewriting.
+
+       Enumerates 4-feasible cuts with their truth tables, and replaces a node by
+       a small implementation of the function of one of its cuts (constant, literal,
+       two-input gate, two-level AND, XOR, ITE) when the nodes it adds to the new
+       graph are fewer than the nodes it frees in the fanout-free cone of the node.
+       The nodes of the new graph are marked as they are created.
+    */
+    struct cut_rewrite_proc {
+        enum {
+            MAX_LEAVES = 4,
+            MAX_CUTS   = 6    // cuts per node, including the trivial one
+        };
+
+        struct cut {
+            unsigned m_size;
+            unsigned m_leaves[MAX_LEAVES]; // sorted node indices
+            unsigned m_tt;                 // truth table over the leaves, the k-th leaf is var_tt(k)
+        };
+
+        imp &              m;
+        topo_nodes         m_topo;
+        svector<cut>       m_cuts;       // m_cuts[i * MAX_CUTS + k]
+        unsigned_vector    m_num_cuts;
+        unsigned_vector    m_refs;       // reference counters before rewriting
+        svector<aig_lit>   m_new;
+        ptr_vector<aig>    m_marked;     // nodes of the new graph
+        ptr_vector<aig>    m_visited;
+        unsigned_vector    m_todo;
+        unsigned           m_num_rewrites;
+
+        cut_rewrite_proc(imp & _m):m(_m), m_num_rewrites(0) {}
+
+        ~cut_rewrite_proc() {
+            release();
+        }
+
+        void release() {
+            unmark(m_marked.size(), m_marked.c_ptr());
+            m_marked.reset();
+            for (unsigned i = 0; i < m_new.size(); i++) {
+                if (!m_new[i].is_null())
+                    m.dec_ref(m_new[i]);
+            }
+            m_new.reset();
+        }
+
+        void mark_new(aig_lit const & l) {
+            m_visited.push_back(l.ptr());
+            while (!m_visited.empty()) {
+                aig * n = m_visited.back();
+                m_visited.pop_back();
+                if (n->m_mark)
+                    continue;
+                n->m_mark = true;
+                m_marked.push_back(n);
+                if (!is_var(n)) {
+                    m_visited.push_back(left(n).ptr());
+                    m_visited.push_back(right(n).ptr());
+                }
+            }
+        }
+
+        /**
+           \brief Number of nodes of the cone of l that are not in the new graph.
+        */
+        unsigned num_added(aig_lit const & l) {
+            unsigned r     = 0;
+            unsigned qhead = m_marked.size();
+            m_visited.push_back(l.ptr());
+            while (!m_visited.empty()) {
+                aig * n = m_visited.back();
+                m_visited.pop_back();
+                if (n->m_mark)
+                    continue;
+                n->m_mark = true;
+                m_marked.push_back(n);
+                r++;
+                if (!is_var(n)) {
+                    m_visited.push_back(left(n).ptr());
+                    m_visited.push_back(right(n).ptr());
+                }
+            }
+            unmark(m_marked.size() - qhead, m_marked.c_ptr() + qhead);
+            m_marked.shrink(qhead);
+            return r;
+        }
+
+        static unsigned var_tt(unsigned k) {
+            static const unsigned tts[MAX_LEAVES] = { 0xAAAA, 0xCCCC, 0xF0F0, 0xFF00 };
+            return tts[k];
+        }
+
+        static unsigned neg_tt(unsigned tt, bool s) { return s ? (~tt & 0xFFFF) : tt; }
+
+        static aig_lit neg_lit(aig_lit l, bool s) {
+            if (s)
+                l.invert();
+            return l;
+        }
+
+        // (a xor s0) and (b xor s1), complemented if s2, where s = s0 + 2*s1 + 4*s2
+        static unsigned and_tt(unsigned a, unsigned b, unsigned s) {
+            return neg_tt(neg_tt(a, (s & 1) != 0) & neg_tt(b, (s & 2) != 0), (s & 4) != 0);
+        }
+
+        aig_lit mk_and_lit(aig_lit a, aig_lit b, unsigned s) {
+            m.inc_ref(a);
+            m.inc_ref(b);
+            aig_lit r = neg_lit(m.mk_and(neg_lit(a, (s & 1) != 0), neg_lit(b, (s & 2) != 0)), (s & 4) != 0);
+            m.inc_ref(r);
+            m.dec_ref(a);
+            m.dec_ref(b);
+            m.dec_ref_result(r);
+            return r;
+        }
+
+        /**
+           \brief Restate the truth table tt over the leaves of c as a truth table over the leaves of d.
+           The leaves of c must be a subset of the leaves of d.
+        */
+        static unsigned expand(unsigned tt, cut const & c, cut const & d) {
+            unsigned pos[MAX_LEAVES];
+            for (unsigned k = 0, l = 0; k < c.m_size; k++) {
+                while (d.m_leaves[l] != c.m_leaves[k])
+                    l++;
+                pos[k] = l;
+            }
+            unsigned r = 0;
+            for (unsigned mt = 0; mt < 16; mt++) {
+                unsigned cmt = 0;
+                for (unsigned k = 0; k < c.m_size; k++) {
+                    if (mt & (1u << pos[k]))
+                        cmt |= 1u << k;
+                }
+                if (tt & (1u << cmt))
+                    r |= 1u << mt;
+            }
+            return r;
+        }
+
+        static bool merge(cut const & a, cut const & b, cut & r) {
+            unsigned i = 0, j = 0;
+            r.m_size = 0;
+            while (i < a.m_size || j < b.m_size) {
+                unsigned v;
+                if (j == b.m_size || (i < a.m_size && a.m_leaves[i] < b.m_leaves[j]))
+                    v = a.m_leaves[i++];
+                else if (i == a.m_size || b.m_leaves[j] < a.m_leaves[i])
+                    v = b.m_leaves[j++];
+                else {
+                    v = a.m_leaves[i];
+                    i++; j++;
+                }
+                if (r.m_size == MAX_LEAVES)
+                    return false;
+                r.m_leaves[r.m_size++] = v;
+            }
+            return true;
+        }
+
+        static bool depends_on(unsigned tt, unsigned k) {
+            unsigned p = var_tt(k);
+            return ((tt & p) >> (1u << k)) != (tt & ~p & 0xFFFF);
+        }
+
+        /**
+           \brief Remove the leaves the truth table of c does not depend on.
+        */
+        static void minimize(cut & c) {
+            unsigned k = 0;
+            while (k < c.m_size) {
+                if (depends_on(c.m_tt, k)) {
+                    k++;
+                    continue;
+                }
+                unsigned low = (1u << k) - 1;
+                unsigned tt  = 0;
+                for (unsigned mt = 0; mt < 16; mt++) {
+                    unsigned old_mt = ((mt & low) | ((mt & ~low) << 1)) & 0xF;
+                    if (c.m_tt & (1u << old_mt))
+                        tt |= 1u << mt;
+                }
+                c.m_tt = tt;
+                for (unsigned l = k + 1; l < c.m_size; l++)
+                    c.m_leaves[l-1] = c.m_leaves[l];
+                c.m_size--;
+            }
+        }
+
+        static bool same_leaves(cut const & a, cut const & b) {
+            if (a.m_size != b.m_size)
+                return false;
+            for (unsigned k = 0; k < a.m_size; k++) {
+                if (a.m_leaves[k] != b.m_leaves[k])
+                    return false;
+            }
+            return true;
+        }
+
+        void add_cut(cut * cs, unsigned & num, cut const & c) {
+            unsigned worst = 0;
+            for (unsigned k = 0; k < num; k++) {
+                if (same_leaves(cs[k], c))
+                    return;
+                if (cs[k].m_size > cs[worst].m_size)
+                    worst = k;
+            }
+            if (num < MAX_CUTS - 1)
+                cs[num++] = c;
+            else if (cs[worst].m_size > c.m_size)
+                cs[worst] = c;
+        }
+
+        void compute_cuts(unsigned i) {
+            cut * cs      = m_cuts.c_ptr() + i * MAX_CUTS;
+            unsigned num  = 0;
+            if (!is_var(m_topo.m_nodes[i])) {
+                unsigned a = m_topo.fanin(i, 0);
+                unsigned b = m_topo.fanin(i, 1);
+                cut const * as = m_cuts.c_ptr() + (a >> 1) * MAX_CUTS;
+                cut const * bs = m_cuts.c_ptr() + (b >> 1) * MAX_CUTS;
+                for (unsigned k1 = 0; k1 < m_num_cuts[a >> 1]; k1++) {
+                    for (unsigned k2 = 0; k2 < m_num_cuts[b >> 1]; k2++) {
+                        cut c;
+                        if (!merge(as[k1], bs[k2], c))
+                            continue;
+                        unsigned ta = neg_tt(expand(as[k1].m_tt, as[k1], c), (a & 1) != 0);
+                        unsigned tb = neg_tt(expand(bs[k2].m_tt, bs[k2], c), (b & 1) != 0);
+                        c.m_tt = ta & tb;
+                        minimize(c);
+                        add_cut(cs, num, c);
+                    }
+                }
+            }
+            cut & t = cs[num++];
+            t.m_size      = 1;
+            t.m_leaves[0] = i;
+            t.m_tt        = var_tt(0);
+            m_num_cuts[i] = num;
+        }
+
+        static bool is_leaf(cut const & c, unsigned j) {
+            for (unsigned k = 0; k < c.m_size; k++) {
+                if (c.m_leaves[k] == j)
+                    return true;
+            }
+            return false;
+        }
+
+        /**
+           \brief Number of nodes below i in the fanout-free cone of i that is bounded by the leaves of c.
+           Nodes that were rewritten are not counted, since they are not in the new graph.
+        */
+        unsigned mffc_size(unsigned i, cut const & c) {
+            unsigned r = 0;
+            m_todo.reset();
+            m_todo.push_back(i);
+            while (!m_todo.empty()) {
+                unsigned j = m_todo.back();
+                m_todo.pop_back();
+                if (j != i)
+                    r++;
+                for (unsigned k = 0; k < 2; k++) {
+                    unsigned ch = m_topo.fanin(j, k) >> 1;
+                    if (is_var(m_topo.m_nodes[ch]) || m_refs[ch] != 1 || is_leaf(c, ch) || m_new[ch] != aig_lit(m_topo.m_nodes[ch]))
+                        continue;
+                    m_todo.push_back(ch);
+                }
+            }
+            return r;
+        }
+
+        bool match2(unsigned tt, aig_lit const * ls, aig_lit & r) {
+            unsigned v0 = var_tt(0), v1 = var_tt(1);
+            for (unsigned s = 0; s < 8; s++) {
+                if (and_tt(v0, v1, s) == tt) {
+                    r = mk_and_lit(ls[0], ls[1], s);
+                    return true;
+                }
+            }
+            if ((v0 ^ v1) == tt) {
+                r = m.mk_xor(ls[0], ls[1]);
+                return true;
+            }
+            if (neg_tt(v0 ^ v1, true) == tt) {
+                r = m.mk_iff(ls[0], ls[1]);
+                return true;
+            }
+            return false;
+        }
+
+        bool match3(unsigned tt, aig_lit const * ls, aig_lit & r) {
+            // ((x and y) and z) with polarities
+            for (unsigned z = 0; z < 3; z++) {
+                unsigned x = (z + 1) % 3, y = (z + 2) % 3;
+                for (unsigned s1 = 0; s1 < 8; s1++) {
+                    unsigned h = and_tt(var_tt(x), var_tt(y), s1);
+                    for (unsigned s2 = 0; s2 < 8; s2++) {
+                        if (and_tt(h, var_tt(z), s2) == tt) {
+                            r = mk_and_lit(mk_and_lit(ls[x], ls[y], s1), ls[z], s2);
+                            return true;
+                        }
+                    }
+                }
+            }
+            // ite(c, t, e) with polarities
+            for (unsigned c = 0; c < 3; c++) {
+                unsigned t = (c + 1) % 3, e = (c + 2) % 3;
+                for (unsigned s = 0; s < 8; s++) {
+                    unsigned vc = neg_tt(var_tt(c), (s & 4) != 0);
+                    unsigned vt = neg_tt(var_tt(t), (s & 1) != 0);
+                    unsigned ve = neg_tt(var_tt(e), (s & 2) != 0);
+                    if (((vc & vt) | (neg_tt(vc, true) & ve)) == tt) {
+                        r = m.mk_ite(neg_lit(ls[c], (s & 4) != 0), neg_lit(ls[t], (s & 1) != 0), neg_lit(ls[e], (s & 2) != 0));
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        bool match4(unsigned tt, aig_lit const * ls, aig_lit & r) {
+            // ((a and b) and (c and d)) with polarities
+            static const unsigned pairs[3][4] = { { 0, 1, 2, 3 }, { 0, 2, 1, 3 }, { 0, 3, 1, 2 } };
+            for (unsigned p = 0; p < 3; p++) {
+                unsigned const * q = pairs[p];
+                for (unsigned s1 = 0; s1 < 8; s1++) {
+                    unsigned h1 = and_tt(var_tt(q[0]), var_tt(q[1]), s1);
+                    for (unsigned s2 = 0; s2 < 8; s2++) {
+                        unsigned h2 = and_tt(var_tt(q[2]), var_tt(q[3]), s2);
+                        for (unsigned s = 0; s < 8; s += 4) {
+                            if (and_tt(h1, h2, s) == tt) {
+                                aig_lit l1 = mk_and_lit(ls[q[0]], ls[q[1]], s1);
+                                m.inc_ref(l1);
+                                aig_lit l2 = mk_and_lit(ls[q[2]], ls[q[3]], s2);
+                                r = mk_and_lit(l1, l2, s);
+                                m.inc_ref(r);
+                                m.dec_ref(l1);
+                                m.dec_ref_result(r);
+                                return true;
+                            }
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+
+        /**
+           \brief Store in r an implementation of the function of c over the new leaves.
+        */
+        bool build(cut const & c, aig_lit & r) {
+            aig_lit ls[MAX_LEAVES];
+            for (unsigned k = 0; k < c.m_size; k++)
+                ls[k] = m_new[c.m_leaves[k]];
+            switch (c.m_size) {
+            case 0:
+                r = c.m_tt == 0 ? m.m_false : m.m_true;
+                return true;
+            case 1:
+                r = neg_lit(ls[0], c.m_tt != var_tt(0));
+                return true;
+            case 2:
+                return match2(c.m_tt, ls, r);
+            case 3:
+                return match3(c.m_tt, ls, r);
+            default:
+                return match4(c.m_tt, ls, r);
+            }
+        }
+
+        aig_lit get_new(unsigned code) const {
+            aig_lit r = m_new[code >> 1];
+            if (code & 1)
+                r.invert();
+            return r;
+        }
+
+        void process(unsigned i) {
+            aig_lit s = m.mk_and(get_new(m_topo.fanin(i, 0)), get_new(m_topo.fanin(i, 1)));
+            m.inc_ref(s);
+            aig_lit best = s;
+            m.inc_ref(best);
+            int cost_s    = static_cast<int>(num_added(s));
+            int best_gain = 0;
+            cut const * cs = m_cuts.c_ptr() + i * MAX_CUTS;
+            for (unsigned k = 0; k < m_num_cuts[i]; k++) {
+                cut const & c = cs[k];
+                if (c.m_size == 1 && c.m_leaves[0] == i)
+                    continue;
+                aig_lit r;
+                if (!build(c, r))
+                    continue;
+                m.inc_ref(r);
+                int gain = cost_s + static_cast<int>(mffc_size(i, c)) - static_cast<int>(num_added(r));
+                if (r != s && gain > best_gain) {
+                    m.dec_ref(best);
+                    best      = r;
+                    best_gain = gain;
+                }
+                else {
+                    m.dec_ref(r);
+                }
+            }
+            if (best != s)
+                m_num_rewrites++;
+            m_new[i] = best;
+            mark_new(best);
+            m.dec_ref(s);
+        }
+
+        aig_lit operator()(aig_lit p) {
+            m_topo(m, p);
+            unsigned sz = m_topo.size();
+            for (unsigned i = 0; i < sz; i++)
+                m_refs.push_back(m_topo.m_nodes[i]->m_ref_count);
+            m_cuts.resize(sz * MAX_CUTS);
+            m_num_cuts.resize(sz, 0);
+            m_new.resize(sz, aig_lit::null);
+            for (unsigned i = 0; i < sz; i++) {
+                aig * n = m_topo.m_nodes[i];
+                compute_cuts(i);
+                if (is_var(n)) {
+                    m.inc_ref(n);
+                    m_new[i] = aig_lit(n);
+                    mark_new(m_new[i]);
+                }
+                else {
+                    m.checkpoint();
+                    process(i);
+                }
+            }
+            IF_VERBOSE(10, verbose_stream() << "(aig-cut-rewrite :nodes " << sz << " :rewrites " << m_num_rewrites << ")\n";);
+            aig_lit r = get_new(m_topo.to_code(p));
+            m.inc_ref(r);
+            release();
+            m.dec_ref_result(r);
+            return r;
+        }
+    };
+
 public:
     imp(ast_manager & m, unsigned long long max_memory, bool default_gate_encoding):
         m_var_id_gen(0),
@@ -1551,6 +2368,16 @@ public:
         return p(l);
     }
 
+    aig_lit fraig(aig_lit l, unsigned max_conflicts) {
+        fraig_proc p(*this, max_conflicts);
+        return p(l);
+    }
+
+    aig_lit cut_rewrite(aig_lit l) {
+        cut_rewrite_proc p(*this);
+        return p(l);
+    }
+
     void display_ref(std::ostream & out, aig * r) const {
         if (is_var(r)) 
             out << "#" << r->m_id;
@@ -1732,6 +2559,14 @@ void aig_manager::max_sharing(aig_ref & r) {
     r = aig_ref(*this, m_imp->max_sharing(aig_lit(r)));
 }
 
+void aig_manager::fraig(aig_ref & r, unsigned max_conflicts) {
+    r = aig_ref(*this, m_imp->fraig(aig_lit(r), max_conflicts));
+}
+
+void aig_manager::cut_rewrite(aig_ref & r) {
+    r = aig_ref(*this, m_imp->cut_rewrite(aig_lit(r)));
+}
+
 void aig_manager::to_formula(aig_ref const & r, goal & g) {
     SASSERT(!g.proofs_enabled());
     SASSERT(!g.unsat_core_enabled());
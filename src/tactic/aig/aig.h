@@ -68,6 +68,11 @@ public:
     aig_ref mk_iff(aig_ref const & r1, aig_ref const & r2);
     aig_ref mk_ite(aig_ref const & r1, aig_ref const & r2, aig_ref const & r3);
     void max_sharing(aig_ref & r);
+    // Merge the functionally equivalent nodes of r (random simulation + SAT sweeping).
+    // Each equivalence is proved using at most max_conflicts conflicts.
+    void fraig(aig_ref & r, unsigned max_conflicts = 100);
+    // Replace nodes by smaller implementations of the functions of their 4-input cuts.
+    void cut_rewrite(aig_ref & r);
     void to_formula(aig_ref const & r, expr_ref & result);
     void to_formula(aig_ref const & r, goal & result);
     void display(std::ostream & out, aig_ref const & r) const;
@@ -25,6 +25,9 @@ class aig_tactic : public tactic {
     unsigned long long m_max_memory;
     bool               m_aig_gate_encoding;
     bool               m_aig_per_assertion;
+    bool               m_aig_fraig;
+    unsigned           m_aig_fraig_max_conflicts;
+    bool               m_aig_cut_rewrite;
     aig_manager *      m_aig_manager;
 
     struct mk_aig_manager {
@@ -58,6 +61,9 @@ public:
         t->m_max_memory = m_max_memory;
         t->m_aig_gate_encoding = m_aig_gate_encoding;
         t->m_aig_per_assertion = m_aig_per_assertion;
+        t->m_aig_fraig = m_aig_fraig;
+        t->m_aig_fraig_max_conflicts = m_aig_fraig_max_conflicts;
+        t->m_aig_cut_rewrite = m_aig_cut_rewrite;
         return t;
     }
 
@@ -65,11 +71,25 @@ public:
         m_max_memory        = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
         m_aig_gate_encoding = p.get_bool("aig_default_gate_encoding", true);
         m_aig_per_assertion = p.get_bool("aig_per_assertion", true); 
+        m_aig_fraig         = p.get_bool("aig_fraig", false);
+        m_aig_fraig_max_conflicts = p.get_uint("aig_fraig_max_conflicts", 100);
+        m_aig_cut_rewrite   = p.get_bool("aig_cut_rewrite", false);
     }
 
     virtual void collect_param_descrs(param_descrs & r) { 
         insert_max_memory(r);
         r.insert("aig_per_assertion", CPK_BOOL, "(default: true) process one assertion at a time.");
+        r.insert("aig_fraig", CPK_BOOL, "(default: false) merge functionally equivalent nodes using simulation and SAT sweeping.");
+        r.insert("aig_fraig_max_conflicts", CPK_UINT, "(default: 100) maximum number of conflicts for proving each equivalence in FRAIG sweeping.");
+        r.insert("aig_cut_rewrite", CPK_BOOL, "(default: false) rewrite nodes using the functions of their 4-input cuts.");
+    }
+
+    void simplify(aig_ref & r) {
+        if (m_aig_fraig)
+            m_aig_manager->fraig(r, m_aig_fraig_max_conflicts);
+        if (m_aig_cut_rewrite)
+            m_aig_manager->cut_rewrite(r);
+        m_aig_manager->max_sharing(r);
     }
 
     void operator()(goal_ref const & g) {
@@ -81,7 +101,7 @@ public:
             unsigned size = g->size();
             for (unsigned i = 0; i < size; i++) {
                 aig_ref r = m_aig_manager->mk_aig(g->form(i));
-                m_aig_manager->max_sharing(r);
+                simplify(r);
                 expr_ref new_f(g->m());
                 m_aig_manager->to_formula(r, new_f);
                 g->update(i, new_f, 0, g->dep(i));
@@ -91,7 +111,7 @@ public:
             fail_if_unsat_core_generation("aig", g);
             aig_ref r = m_aig_manager->mk_aig(*(g.get()));
             g->reset(); // save memory
-            m_aig_manager->max_sharing(r);
+            simplify(r);
             m_aig_manager->to_formula(r, *(g.get()));
         }
         SASSERT(g->is_well_sorted());
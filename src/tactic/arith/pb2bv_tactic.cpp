@@ -23,6 +23,7 @@ Notes:
 #include"rewriter_def.h"
 #include"ref_util.h"
 #include"arith_decl_plugin.h"
+#include"pb_decl_plugin.h"
 #include"trace.h"
 #include"ast_smt2_pp.h"
 #include"expr_substitution.h"
@@ -111,6 +112,7 @@ private:
         bool_rewriter              m_b_rw;
         arith_util                 m_arith_util;
         bv_util                    m_bv_util;
+        pb_util                    m_pb_util;
         expr_dependency_ref_vector m_new_deps;
         
         bool                       m_produce_models;
@@ -118,6 +120,7 @@ private:
         
         unsigned                   m_all_clauses_limit;
         unsigned                   m_cardinality_limit;
+        bool                       m_native;
         unsigned long long         m_max_memory;
         // m_const2bit should be a map, since we want constant time access to it, and avoid quadratic behavior.
         // It is ok to use a vector at the model converter because we don't need to search that vector.
@@ -359,6 +362,30 @@ private:
             return true;
         }
 
+        /**
+           \brief Create a native cardinality/pseudo-Boolean atom for m_p >= m_c.
+           Return false if the coefficients do not fit in machine integers.
+        */
+        bool mk_native_pbc(polynomial const & m_p, numeral const & m_c, bool is_card, expr_ref & r) {
+            if (!m_c.is_unsigned())
+                return false;
+            ptr_buffer<expr> args;
+            unsigned_vector  coeffs;
+            for (unsigned i = 0; i < m_p.size(); i++) {
+                monomial const & mo = m_p[i];
+                if (!mo.m_a.is_unsigned())
+                    return false;
+                args.push_back(mon_lit2lit(mo));
+                coeffs.push_back(mo.m_a.get_unsigned());
+            }
+            if (is_card)
+                r = m_pb_util.mk_at_least_k(args.size(), args.c_ptr(), m_c.get_unsigned());
+            else
+                r = m_pb_util.mk_ge(args.size(), coeffs.c_ptr(), args.c_ptr(), m_c.get_unsigned());
+            TRACE("pb2bv_native", tout << mk_ismt2_pp(r, m) << "\n";);
+            return true;
+        }
+
         void bitblast_pbc(polynomial & m_p, numeral const & m_c, expr_ref & r) {
             bool is_card = is_cardinality(m_p, m_c);
         
@@ -384,6 +411,9 @@ private:
                 m_b_rw.mk_and(args.size(), args.c_ptr(), r);
                 return;
             }
+
+            if (m_native && mk_native_pbc(m_p, m_c, is_card, r))
+                return;
         
             if (m_p.size() <= m_all_clauses_limit) {
                 pb2bv_all_clauses proc(*this);
@@ -850,6 +880,7 @@ private:
             m_b_rw(m, p),
             m_arith_util(m),
             m_bv_util(m),
+            m_pb_util(m),
             m_new_deps(m),            
             m_temporary_ints(m),
             m_used_dependencies(m),
@@ -871,12 +902,14 @@ private:
             m_max_memory   = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
             m_all_clauses_limit = p.get_uint("pb2bv_all_clauses_limit", 8);
             m_cardinality_limit = p.get_uint("pb2bv_cardinality_limit", UINT_MAX);
+            m_native            = p.get_bool("pb2bv_native", false);
         }
 
         void collect_param_descrs(param_descrs & r) {
             insert_max_memory(r);
             r.insert("pb2bv_all_clauses_limit", CPK_UINT, "(default: 8) maximum number of literals for using equivalent CNF encoding of PB constraint.");
             r.insert("pb2bv_cardinality_limit", CPK_UINT, "(default: inf) limit for using arc-consistent cardinality constraint encoding.");
+            r.insert("pb2bv_native", CPK_BOOL, "(default: false) keep pseudo-Boolean constraints as cardinality/pb atoms instead of encoding them, the resultant goal must be processed by the sat tactic.");
         }
         
         void set_cancel(bool f) {
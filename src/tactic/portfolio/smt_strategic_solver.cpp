@@ -36,6 +36,8 @@ Notes:
 #include"qffpa_tactic.h"
 #include"horn_tactic.h"
 #include"smt_solver.h"
+#include"inc_sat_solver.h"
+#include"sat_params.hpp"
 
 tactic * mk_tactic_for_logic(ast_manager & m, params_ref const & p, symbol const & logic) {
     if (logic=="QF_UF")
@@ -101,8 +103,13 @@ public:
         else
             l = logic;
         tactic * t = mk_tactic_for_logic(m, p, l);
+        solver * inc_s;
+        if (l == "QF_BV" && !proofs_enabled && sat_params(p).incremental())
+            inc_s = mk_inc_sat_solver(m, p);
+        else
+            inc_s = mk_smt_solver(m, p, l);
         return mk_combined_solver(mk_tactic2solver(m, t, p, proofs_enabled, models_enabled, unsat_core_enabled, l),
-                                  mk_smt_solver(m, p, l),
+                                  inc_s,
                                   p);
     }
 };
@@ -34,21 +34,28 @@ Notes:
 #include"propagate_values_tactic.h"
 #include"sls_tactic.h"
 #include"nnf_tactic.h"
+#include"ast_translation.h"
+#include"scoped_ptr_vector.h"
+#include"scoped_numeral_vector.h"
+#include"z3_omp.h"
 
 #include"sls_params.hpp"
 #include"sls_evaluator.h"
 #include"sls_tracker.h"
+#include"sls_word_evaluator.h"
 
 class sls_tactic : public tactic {
     class stats {
     public:
         unsigned        m_restarts;
+        unsigned        m_reseeds;
         stopwatch       m_stopwatch;    
         unsigned        m_full_evals;
         unsigned        m_incr_evals;
         unsigned        m_moves, m_flips, m_incs, m_decs, m_invs;
         stats() :
             m_restarts(0),
+            m_reseeds(0),
             m_full_evals(0),
             m_incr_evals(0),
             m_moves(0),
@@ -64,8 +71,35 @@ class sls_tactic : public tactic {
             m_stopwatch.reset();
             m_stopwatch.start();
         }
+        void add(stats const & s) {
+            m_restarts   += s.m_restarts;
+            m_reseeds    += s.m_reseeds;
+            m_full_evals += s.m_full_evals;
+            m_incr_evals += s.m_incr_evals;
+            m_moves      += s.m_moves;
+            m_flips      += s.m_flips;
+            m_incs       += s.m_incs;
+            m_decs       += s.m_decs;
+            m_invs       += s.m_invs;
+        }
     };    
 
+    /**
+       \brief State shared by the walkers of the parallel mode. The best assignment
+       is indexed like the constants of the walkers, which are collected in the
+       same order since the walkers run on translations of the same goal.
+       The values belong to the manager of the shared state, and they are only
+       accessed in the critical section sls_shared. So, no numeral created by
+       one walker is updated or deleted by another one.
+    */
+    struct shared_state {
+        volatile bool       m_cancel;
+        double              m_best_score;
+        unsynch_mpz_manager m_mpz_manager;
+        scoped_mpz_vector   m_best_values;
+        shared_state(): m_cancel(false), m_best_score(0.0), m_best_values(m_mpz_manager) {}
+    };
+
     struct imp {       
         ast_manager   & m_manager;
         stats         & m_stats;
@@ -77,9 +111,17 @@ class sls_tactic : public tactic {
         bv_util         m_bv_util;
         sls_tracker     m_tracker;
         sls_evaluator   m_evaluator;
+        sls_word_evaluator m_word_evaluator;
 
         unsigned        m_max_restarts;
         unsigned        m_plateau_limit;
+        bool            m_word_eval;
+        bool            m_use_words; // the goal is evaluated by m_word_evaluator
+        unsigned        m_threads;
+        unsigned        m_random_seed;
+        params_ref      m_params;
+        shared_state *  m_shared;     // not 0 when this walker runs in parallel with others
+        double          m_best_score; // best local maximum of this walker
 
         typedef enum { MV_FLIP = 0, MV_INC, MV_DEC, MV_INV } move_type;        
 
@@ -93,7 +135,11 @@ class sls_tactic : public tactic {
             m_cancel(false),
             m_bv_util(m),
             m_tracker(m, m_bv_util, m_mpz_manager, m_powers),
-            m_evaluator(m, m_bv_util, m_tracker, m_mpz_manager, m_powers) 
+            m_evaluator(m, m_bv_util, m_tracker, m_mpz_manager, m_powers),
+            m_word_evaluator(m, m_bv_util),
+            m_use_words(false),
+            m_shared(0),
+            m_best_score(0.0)
         {
             updt_params(p);
         }
@@ -106,7 +152,14 @@ class sls_tactic : public tactic {
 
         ast_manager & m() const { return m_manager; }
 
-        void set_cancel(bool f) { m_cancel = f; }
+        void set_cancel(bool f) { 
+            m_cancel = f; 
+            #pragma omp critical (sls_shared)
+            {
+                if (f && m_shared)
+                    m_shared->m_cancel = true;
+            }
+        }
         void cancel() { set_cancel(true); }
         void reset_cancel() { set_cancel(false); }
 
@@ -116,14 +169,19 @@ class sls_tactic : public tactic {
 
         void updt_params(params_ref const & _p) {
             sls_params p(_p);
+            m_params = _p;
             m_produce_models = _p.get_bool("model", false);
             m_max_restarts = p.restarts();            
-            m_tracker.set_random_seed(p.random_seed());
+            m_random_seed = p.random_seed();
+            m_tracker.set_random_seed(m_random_seed);
+            m_word_evaluator.set_random_seed(m_random_seed);
             m_plateau_limit = p.plateau_limit();
+            m_word_eval = p.word_eval();
+            m_threads = p.threads();
         }
 
         void checkpoint() { 
-            if (m_cancel)
+            if (m_cancel || (m_shared && m_shared->m_cancel))
                 throw tactic_exception(TACTIC_CANCELED_MSG);
             cooperate("sls");
         }
@@ -147,41 +205,130 @@ class sls_tactic : public tactic {
             return res;
         }
 
+        double get_score(goal_ref const & g, unsigned i) {
+            return m_use_words ? m_word_evaluator.get_score(i) : m_tracker.get_score(g->form(i));
+        }
+
+        bool is_true(goal_ref const & g, unsigned i) {
+            return m_use_words ? m_word_evaluator.is_true(i) : m_mpz_manager.is_one(m_tracker.get_value(g->form(i)));
+        }
+
+        ptr_vector<func_decl> & get_unsat_constants(goal_ref const & g) {
+            return m_use_words ? m_word_evaluator.get_unsat_constants() : m_tracker.get_unsat_constants(g);
+        }
+
+        ptr_vector<func_decl> const & get_constants() {
+            return m_use_words ? m_word_evaluator.get_constants() : m_tracker.get_constants();
+        }
+
+        /**
+           \brief Record that the current assignment has the given score, and
+           publish it to the other walkers if it is the best one so far.
+        */
+        void publish(double score) {
+            if (score <= m_best_score)
+                return;
+            m_best_score = score;
+            if (!m_shared)
+                return;
+            #pragma omp critical (sls_shared)
+            {
+                if (score > m_shared->m_best_score) {
+                    ptr_vector<func_decl> const & cs = get_constants();
+                    unsynch_mpz_manager & sm = m_shared->m_mpz_manager;
+                    scoped_mpz v(sm);
+                    m_shared->m_best_score = score;
+                    m_shared->m_best_values.reset();
+                    for (unsigned i = 0; i < cs.size(); i++) {
+                        if (m_use_words)
+                            sm.set(v, m_word_evaluator.get_value(cs[i]));
+                        else
+                            sm.set(v, m_tracker.get_value(cs[i]));
+                        m_shared->m_best_values.push_back(v);
+                    }
+                }
+            }
+        }
+
+        /**
+           \brief Replace the current assignment by the best published one, if
+           it is better than the best assignment of this walker.
+        */
+        bool reseed() {
+            if (!m_shared)
+                return false;
+            bool found = false;
+            #pragma omp critical (sls_shared)
+            {
+                ptr_vector<func_decl> const & cs = get_constants();
+                if (m_shared->m_best_score > m_best_score && m_shared->m_best_values.size() == cs.size()) {
+                    mpz v;
+                    for (unsigned i = 0; i < cs.size(); i++) {
+                        mpz const & s = m_shared->m_best_values[i];
+                        if (m_use_words)
+                            m_word_evaluator.set_value(cs[i], m_shared->m_mpz_manager.get_uint64(s));
+                        else {
+                            m_mpz_manager.set(v, s);
+                            m_tracker.set_value(cs[i], v);
+                        }
+                    }
+                    m_mpz_manager.del(v);
+                    m_best_score = m_shared->m_best_score;
+                    m_stats.m_reseeds++;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        void randomize() {
+            if (m_use_words)
+                m_word_evaluator.randomize();
+            else
+                m_tracker.randomize();
+        }
+
         double top_score(goal_ref const & g) {
             #if 0
-            double min = m_tracker.get_score(g->form(0));
+            double min = get_score(g, 0);
             unsigned sz = g->size();
             for (unsigned i = 1; i < sz; i++) {
-                double q = m_tracker.get_score(g->form(i));
+                double q = get_score(g, i);
                 if (q < min) min = q;
             }
             TRACE("sls_top", tout << "Score distribution:"; 
                                 for (unsigned i = 0; i < sz; i++)
-                                    tout << " " << m_tracker.get_score(g->form(i));
+                                    tout << " " << get_score(g, i);
                                 tout << " MIN: " << min << std::endl; );
             return min;
             #else
             double top_sum = 0.0;
             unsigned sz = g->size();
             for (unsigned i = 0; i < sz; i++) {
-                top_sum += m_tracker.get_score(g->form(i));
+                top_sum += get_score(g, i);
             }
             TRACE("sls_top", tout << "Score distribution:"; 
                                     for (unsigned i = 0; i < sz; i++)
-                                        tout << " " << m_tracker.get_score(g->form(i));
+                                        tout << " " << get_score(g, i);
                                     tout << " AVG: " << top_sum / (double) sz << std::endl; );
             return top_sum / (double) sz;
             #endif
         }
 
         double rescore(goal_ref const & g) {
-            m_evaluator.update_all();
+            if (m_use_words)
+                m_word_evaluator.update_all();
+            else
+                m_evaluator.update_all();
             m_stats.m_full_evals++;
             return top_score(g);
         }
 
         double incremental_score(goal_ref const & g, func_decl * fd, const mpz & new_value) {
-            m_evaluator.update(fd, new_value);
+            if (m_use_words)
+                m_word_evaluator.update(fd, m_mpz_manager.get_uint64(new_value));
+            else
+                m_evaluator.update(fd, new_value);
             m_stats.m_incr_evals++;
             return top_score(g);
         }
@@ -303,8 +450,66 @@ class sls_tactic : public tactic {
             m_mpz_manager.del(new_value);
         }
 
+        double find_best_move_words(ptr_vector<func_decl> & to_evaluate, double score, 
+                                    unsigned & best_const, mpz & best_value, unsigned & new_bit, move_type & move) {
+            // candidate values of a constant: the 64 flips, +1 or -1, and the inversion.
+            uint64 values[66];
+            move_type moves[66];
+            double scores[66];
+            double new_score = score;
+
+            for (unsigned i = 0; i < to_evaluate.size() && new_score < 1.0; i++) {
+                func_decl * fd = to_evaluate[i];
+                unsigned bv_sz = m_word_evaluator.get_width(fd);
+                uint64 old_value = m_word_evaluator.get_value(fd);
+                uint64 mask = sls_word_evaluator::mask(bv_sz);
+                unsigned n = 0;
+
+                for (unsigned j = 0; j < bv_sz; j++) {
+                    values[n] = old_value ^ (1ull << j);
+                    moves[n++] = MV_FLIP;
+                }
+                if (m_bv_util.is_bv_sort(fd->get_range()) && bv_sz > 1) {
+                    if ((old_value & 1) != 0) {
+                        values[n] = (old_value + 1) & mask;
+                        moves[n++] = MV_INC;
+                    }
+                    else {
+                        values[n] = (old_value - 1) & mask;
+                        moves[n++] = MV_DEC;
+                    }
+                    values[n] = ~old_value & mask;
+                    moves[n++] = MV_INV;
+                }
+
+                // all candidates are scored in batches, the assignment is not modified.
+                m_word_evaluator.what_if(fd, n, values, scores);
+                m_stats.m_incr_evals += n;
+
+                // same order and tie breaking as the mpz moves below: the flips stop at a
+                // perfect score, +1, -1 and the inversion are always tried.
+                for (unsigned j = 0; j < n; j++) {
+                    if (moves[j] == MV_FLIP && new_score >= 1.0)
+                        continue;
+                    if (scores[j] >= new_score) {
+                        new_score = scores[j];
+                        best_const = i;
+                        m_mpz_manager.set(best_value, values[j]);
+                        move = moves[j];
+                        if (move == MV_FLIP)
+                            new_bit = j;
+                    }
+                }
+            }
+
+            return new_score;
+        }
+
         double find_best_move(goal_ref const & g, ptr_vector<func_decl> & to_evaluate, double score, 
                               unsigned & best_const, mpz & best_value, unsigned & new_bit, move_type & move) {
+            if (m_use_words)
+                return find_best_move_words(to_evaluate, score, best_const, best_value, new_bit, move);
+
             mpz old_value, temp;
             unsigned bv_sz;
             double new_score = score;
@@ -367,7 +572,7 @@ class sls_tactic : public tactic {
             TRACE("sls", tout << "Starting search, initial score   = " << std::setprecision(32) << score << std::endl;
                          tout << "Score distribution:"; 
                          for (unsigned i = 0; i < g->size(); i++)
-                             tout << " " << std::setprecision(3) << m_tracker.get_score(g->form(i));
+                             tout << " " << std::setprecision(3) << get_score(g, i);
                          tout << " TOP: " << score << std::endl; ); 
         
             unsigned plateau_cnt = 0;
@@ -380,7 +585,7 @@ class sls_tactic : public tactic {
                     old_score = score;
                     new_const = (unsigned)-1;
                         
-                    ptr_vector<func_decl> & to_evaluate = m_tracker.get_unsat_constants(g);
+                    ptr_vector<func_decl> & to_evaluate = get_unsat_constants(g);
 
                     TRACE("sls_constants", tout << "Evaluating these constants: " << std::endl;
                                             for (unsigned i = 0 ; i < to_evaluate.size(); i++)
@@ -391,7 +596,7 @@ class sls_tactic : public tactic {
                     if (new_const == static_cast<unsigned>(-1)) {
                         TRACE("sls", tout << "Local maximum reached; unsatisfied constraints: " << std::endl; 
                                         for (unsigned i = 0; i < g->size(); i++) {
-                                            if (!m_mpz_manager.is_one(m_tracker.get_value(g->form(i))))
+                                            if (!is_true(g, i))
                                                 tout << mk_ismt2_pp(g->form(i), m_manager) << std::endl;
                                         });
 
@@ -399,7 +604,7 @@ class sls_tactic : public tactic {
                                         tout << "Scores: " << std::endl;
                                         for (unsigned i = 0; i < g->size(); i++)
                                             tout << mk_ismt2_pp(g->form(i), m_manager) << " ---> " << 
-                                            m_tracker.get_score(g->form(i)) << std::endl; );
+                                            get_score(g, i) << std::endl; );
                         score = old_score;
                     }
                     else {
@@ -435,7 +640,7 @@ class sls_tactic : public tactic {
 
                         TRACE("sls", tout << "Score distribution:"; 
                                         for (unsigned i = 0; i < g->size(); i++)
-                                            tout << " " << std::setprecision(3) << m_tracker.get_score(g->form(i));
+                                            tout << " " << std::setprecision(3) << get_score(g, i);
                                         tout << " TOP: " << score << std::endl; );                        
                     }
 
@@ -443,7 +648,7 @@ class sls_tactic : public tactic {
                         // score could theoretically be imprecise.
                         bool all_true = true;
                         for (unsigned i = 0; i < g->size() && all_true; i++)
-                            if (!m_mpz_manager.is_one(m_tracker.get_value(g->form(i))))
+                            if (!is_true(g, i))
                                 all_true=false;
                         if (all_true) {
                             res = l_true; // sat
@@ -454,13 +659,19 @@ class sls_tactic : public tactic {
                 }
                 while (score > old_score && res == l_undef);                
 
+                // the climb stopped: at a local maximum, or on a plateau.
+                publish(score);
+
                 if (score != old_score)
                     plateau_cnt = 0;
                 else {
                     plateau_cnt++;
                     if (plateau_cnt < m_plateau_limit) {
                         TRACE("sls", tout << "In a plateau (" << plateau_cnt << "/" << m_plateau_limit << "); randomizing locally." << std::endl; );
-                        m_evaluator.randomize_local(g);
+                        if (m_use_words)
+                            m_word_evaluator.randomize_local();
+                        else
+                            m_evaluator.randomize_local(g);
                         //mk_random_move(g);
                         score = top_score(g);
                     }
@@ -473,13 +684,11 @@ class sls_tactic : public tactic {
             return res;
         }    
 
-        void operator()(goal_ref const & g, model_converter_ref & mc) {
-            if (g->inconsistent()) {
-                mc = 0;
-                return;
-            }
-
-            m_tracker.initialize(g);
+        lbool run(goal_ref const & g) {
+            m_use_words = m_word_eval && m_word_evaluator.initialize(g);
+            if (!m_use_words)
+                m_tracker.initialize(g);
+            m_best_score = 0.0;
             lbool res = l_undef;
         
             do {
@@ -487,16 +696,142 @@ class sls_tactic : public tactic {
                 if ((m_stats.m_restarts % 100) == 0)                        
                     report_tactic_progress("Searching... restarts left:", m_max_restarts - m_stats.m_restarts);
                 
+                double best_score = m_best_score;
                 res = search(g);
 
-                if (res == l_undef)
-                    m_tracker.randomize();
+                if (res == l_undef) {
+                    // a walker that did not improve its best assignment restarts
+                    // from the best one of the other walkers.
+                    if (m_best_score > best_score || !reseed())
+                        randomize();
+                }
             }
             while (res != l_true && m_stats.m_restarts++ < m_max_restarts);
+
+            return res;
+        }
+
+        model_ref get_model() {
+            return m_use_words ? m_word_evaluator.get_model() : m_tracker.get_model();
+        }
+
+        bool use_par() const {
+#ifdef _NO_OMP_
+            return false;
+#else
+            // nested parallelism is not supported.
+            return m_threads > 1 && 0 == omp_in_parallel();
+#endif
+        }
+
+        /**
+           \brief Run m_threads walkers: this one, and copies on translations of \c g
+           using different random seeds and plateau limits. The walkers share their
+           best assignment, and the first one to find a model cancels the others.
+        */
+        lbool par_run(goal_ref const & g, model_ref & mdl) {
+            int num_threads = static_cast<int>(m_threads);
+            shared_state shared;
+            scoped_ptr_vector<ast_manager> managers;
+            goal_ref_vector                goals;
+            scoped_ptr_vector<stats>       walker_stats;
+            scoped_ptr_vector<imp>         walkers;
+            for (int i = 1; i < num_threads; i++) {
+                ast_manager * new_m = alloc(ast_manager, m_manager, !m_manager.proof_mode());
+                managers.push_back(new_m);
+                ast_translation translator(m_manager, *new_m);
+                goals.push_back(g->translate(translator));
+                params_ref ps(m_params);
+                ps.set_uint("threads", 1);
+                ps.set_uint("random_seed", m_random_seed + i);
+                ps.set_uint("plateau_limit", m_plateau_limit * (1 + i % 4));
+                stats * st = alloc(stats);
+                walker_stats.push_back(st);
+                imp * w = alloc(imp, *new_m, ps, *st);
+                w->m_shared = &shared;
+                walkers.push_back(w);
+            }
+            #pragma omp critical (sls_shared)
+            {
+                shared.m_cancel = m_cancel;
+                m_shared = &shared;
+            }
+
+            int         finished_id = -1;
+            bool        has_ex      = false;
+            std::string ex_msg;
+            #pragma omp parallel for num_threads(num_threads)
+            for (int i = 0; i < num_threads; i++) {
+                try {
+                    lbool r = i == 0 ? run(g) : walkers[i-1]->run(goals.get(i-1));
+                    if (r == l_true) {
+                        #pragma omp critical (sls_shared)
+                        {
+                            if (finished_id == -1)
+                                finished_id = i;
+                            shared.m_cancel = true;
+                        }
+                    }
+                }
+                catch (z3_exception & ex) {
+                    // exceptions of canceled walkers are ignored.
+                    #pragma omp critical (sls_shared)
+                    {
+                        if (!shared.m_cancel) {
+                            has_ex = true;
+                            ex_msg = ex.msg();
+                            shared.m_cancel = true;
+                        }
+                    }
+                }
+            }
+            #pragma omp critical (sls_shared)
+            {
+                m_shared = 0;
+            }
+
+            for (unsigned i = 0; i < walker_stats.size(); i++)
+                m_stats.add(*walker_stats[i]);
+
+            if (finished_id == -1) {
+                if (has_ex)
+                    throw tactic_exception(ex_msg.c_str());
+                checkpoint();
+                return l_undef;
+            }
+            IF_VERBOSE(10, verbose_stream() << "(sls.par :winner " << finished_id << ")\n";);
+            if (m_produce_models) {
+                model_ref md = finished_id == 0 ? get_model() : walkers[finished_id-1]->get_model();
+                if (finished_id == 0)
+                    mdl = md;
+                else {
+                    ast_translation translator(*(managers[finished_id-1]), m_manager, false);
+                    mdl = md->translate(translator);
+                }
+            }
+            return l_true;
+        }
+
+        void operator()(goal_ref const & g, model_converter_ref & mc) {
+            if (g->inconsistent()) {
+                mc = 0;
+                return;
+            }
+
+            model_ref mdl;
+            lbool res = l_undef;
+            if (use_par())
+                res = par_run(g, mdl);
+            else {
+                res = run(g);
+                if (res == l_true && m_produce_models) {
+                    model_ref md = get_model();
+                    mdl = md;
+                }
+            }
         
             if (res == l_true) {                
                 if (m_produce_models) {
-                    model_ref mdl = m_tracker.get_model();
                     mc = model2model_converter(mdl.get());
                     TRACE("sls_model", mc->display(tout); );
                 }
@@ -568,6 +903,7 @@ public:
     virtual void collect_statistics(statistics & st) const {
         double seconds = m_stats.m_stopwatch.get_current_seconds();            
         st.update("sls restarts", m_stats.m_restarts);
+        st.update("sls reseeds", m_stats.m_reseeds);
         st.update("sls full evals", m_stats.m_full_evals);
         st.update("sls incr evals", m_stats.m_incr_evals);
         st.update("sls incr evals/sec", m_stats.m_incr_evals/ seconds);
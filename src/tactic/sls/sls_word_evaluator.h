@@ -0,0 +1,862 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sls_word_evaluator.h
+
+Abstract:
+
+    Evaluation and scoring of the SLS uplink graph on machine words.
+
+    When all bit-vectors of the goal have at most 64 bits, the values
+    are kept as uint64 instead of mpz, and no bignum is allocated during
+    the search. The nodes are numbered in topological order (arguments
+    before parents), so an update re-evaluates the cone of the modified
+    constant by increasing node index. Every node has NUM_LANES value
+    slots: one pass over a cone evaluates and scores up to NUM_LANES
+    candidate values of the constant. The per-lane loops run over small
+    fixed size arrays, and the compiler vectorizes the bitwise ones.
+
+    The scores are the ones of sls_tracker::score_bool.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+    initialize fails on operators that are not listed in get_op, and
+    on bit-vectors wider than 64 bits. The tactic then uses sls_tracker
+    and sls_evaluator.
+
+--*/
+#ifndef _SLS_WORD_EVALUATOR_H_
+#define _SLS_WORD_EVALUATOR_H_
+
+#include<algorithm>
+#include<cmath>
+#include"goal.h"
+#include"model.h"
+#include"bv_decl_plugin.h"
+
+class sls_word_evaluator {
+public:
+    enum { NUM_LANES = 8 };
+
+private:
+    enum op_kind {
+        W_LEAF, W_AND, W_OR, W_NOT, W_XOR, W_EQ, W_DISTINCT, W_ITE,
+        W_CONCAT, W_EXTRACT, W_ADD, W_SUB, W_MUL, W_NEG,
+        W_UDIV, W_UREM, W_SDIV, W_SREM, W_SMOD,
+        W_BAND, W_BOR, W_BXOR, W_BNAND, W_BNOR, W_BNOT,
+        W_ULEQ, W_ULT, W_UGEQ, W_UGT, W_SLEQ, W_SLT, W_SGEQ, W_SGT,
+        W_BIT2BOOL, W_SHL, W_LSHR, W_ASHR, W_SIGN_EXT, W_ZERO_EXT,
+        W_UNSUPPORTED
+    };
+
+    struct node {
+        op_kind   m_op;
+        bool      m_bool;      // Boolean nodes are scored, bit-vector nodes are not
+        unsigned  m_width;     // 1 for Booleans
+        unsigned  m_param;     // low bit of extract, bit of bit2bool, index of a constant
+        unsigned  m_args;      // first argument in m_args
+        unsigned  m_num_args;
+        unsigned  m_ups;       // first parent in m_ups
+        unsigned  m_num_ups;
+    };
+
+    ast_manager &                m_manager;
+    bv_util &                    m_bv_util;
+    random_gen                   m_rng;
+    svector<node>                m_nodes;
+    unsigned_vector              m_args;
+    unsigned_vector              m_ups;
+    obj_map<expr, unsigned>      m_expr2node;
+    unsigned_vector              m_roots;       // node of every formula of the goal
+    vector<unsigned_vector>      m_root_consts; // constants occurring in every formula
+    ptr_vector<func_decl>        m_constants;
+    unsigned_vector              m_const2node;
+    obj_map<func_decl, unsigned> m_decl2const;
+    ptr_vector<func_decl>        m_temp_constants;
+    unsigned_vector              m_const_mark;
+    unsigned                     m_const_stamp;
+
+    svector<uint64>              m_values;      // current assignment
+    svector<double>              m_scores;
+    svector<uint64>              m_lanes;       // NUM_LANES values per node, valid in m_cone
+    svector<double>              m_lane_scores;
+    unsigned_vector              m_cone;        // nodes evaluated by a pass, in topological order
+    unsigned_vector              m_cone_mark;
+    unsigned                     m_cone_stamp;
+    unsigned                     m_cone_root;   // constant node of m_cone, UINT_MAX if none
+
+public:
+    sls_word_evaluator(ast_manager & m, bv_util & bvu):
+        m_manager(m),
+        m_bv_util(bvu),
+        m_const_stamp(0),
+        m_cone_stamp(0),
+        m_cone_root(UINT_MAX) {
+    }
+
+    static uint64 mask(unsigned w) { return w >= 64 ? ~0ull : (1ull << w) - 1; }
+
+    void set_random_seed(unsigned s) { m_rng.set_seed(s); }
+
+private:
+    static int64 to_signed(uint64 v, unsigned w) {
+        if (w < 64 && ((v >> (w - 1)) & 1) != 0)
+            v |= ~mask(w);
+        return static_cast<int64>(v);
+    }
+
+    static unsigned popcount(uint64 v) {
+        v = v - ((v >> 1) & 0x5555555555555555ull);
+        v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+        v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return static_cast<unsigned>((v * 0x0101010101010101ull) >> 56);
+    }
+
+    // division by zero follows hi_div0, as in sls_evaluator.
+    static uint64 sdiv(uint64 x, uint64 y, unsigned w) {
+        int64 a = to_signed(x, w), b = to_signed(y, w);
+        if (b == 0)
+            return a < 0 ? 1 : mask(w);
+        if (b == -1) // a / -1 overflows for the smallest 64-bit a
+            return (0 - x) & mask(w);
+        return static_cast<uint64>(a / b) & mask(w);
+    }
+
+    static uint64 srem(uint64 x, uint64 y, unsigned w) {
+        int64 a = to_signed(x, w), b = to_signed(y, w);
+        if (b == 0)
+            return x;
+        if (b == -1)
+            return 0;
+        return static_cast<uint64>(a % b) & mask(w);
+    }
+
+    static uint64 smod(uint64 x, uint64 y, unsigned w) {
+        int64 a = to_signed(x, w), b = to_signed(y, w);
+        if (b == 0)
+            return x;
+        uint64 abs_a = a < 0 ? 0 - static_cast<uint64>(a) : static_cast<uint64>(a);
+        uint64 abs_b = b < 0 ? 0 - static_cast<uint64>(b) : static_cast<uint64>(b);
+        uint64 u = abs_a % abs_b;
+        if (u == 0 || (a >= 0 && b >= 0))
+            return u;
+        if (a < 0 && b >= 0)
+            return (y - u) & mask(w);
+        if (a >= 0 && b < 0)
+            return (u + y) & mask(w);
+        return (0 - u) & mask(w);
+    }
+
+    op_kind get_op(app * n, unsigned & param) const {
+        param = 0;
+        if (n->get_num_args() == 0)
+            return W_LEAF;
+        family_id fid = n->get_family_id();
+        if (fid == m_manager.get_basic_family_id()) {
+            switch (n->get_decl_kind()) {
+            case OP_AND:      return W_AND;
+            case OP_OR:       return W_OR;
+            case OP_NOT:      return W_NOT;
+            case OP_XOR:      return W_XOR;
+            case OP_EQ:
+            case OP_IFF:      return n->get_num_args() == 2 ? W_EQ : W_UNSUPPORTED;
+            case OP_DISTINCT: return W_DISTINCT;
+            case OP_ITE:      return W_ITE;
+            default:          return W_UNSUPPORTED;
+            }
+        }
+        if (fid != m_bv_util.get_family_id())
+            return W_UNSUPPORTED;
+        switch (n->get_decl_kind()) {
+        case OP_CONCAT:    return W_CONCAT;
+        case OP_EXTRACT:
+            param = m_bv_util.get_extract_low(n);
+            return W_EXTRACT;
+        case OP_BADD:      return W_ADD;
+        case OP_BSUB:      return W_SUB;
+        case OP_BMUL:      return W_MUL;
+        case OP_BNEG:      return W_NEG;
+        case OP_BUDIV:
+        case OP_BUDIV_I:   return W_UDIV;
+        case OP_BUREM:
+        case OP_BUREM_I:   return W_UREM;
+        case OP_BSDIV:
+        case OP_BSDIV_I:   return W_SDIV;
+        case OP_BSREM:
+        case OP_BSREM_I:   return W_SREM;
+        case OP_BSMOD:
+        case OP_BSMOD_I:   return W_SMOD;
+        case OP_BAND:      return W_BAND;
+        case OP_BOR:       return W_BOR;
+        case OP_BXOR:      return W_BXOR;
+        case OP_BNAND:     return W_BNAND;
+        case OP_BNOR:      return W_BNOR;
+        case OP_BNOT:      return W_BNOT;
+        case OP_ULEQ:      return W_ULEQ;
+        case OP_ULT:       return W_ULT;
+        case OP_UGEQ:      return W_UGEQ;
+        case OP_UGT:       return W_UGT;
+        case OP_SLEQ:      return W_SLEQ;
+        case OP_SLT:       return W_SLT;
+        case OP_SGEQ:      return W_SGEQ;
+        case OP_SGT:       return W_SGT;
+        case OP_BIT2BOOL:
+            param = n->get_decl()->get_parameter(0).get_int();
+            return W_BIT2BOOL;
+        case OP_BSHL:      return W_SHL;
+        case OP_BLSHR:     return W_LSHR;
+        case OP_BASHR:     return W_ASHR;
+        case OP_SIGN_EXT:  return W_SIGN_EXT;
+        case OP_ZERO_EXT:  return W_ZERO_EXT;
+        default:           return W_UNSUPPORTED;
+        }
+    }
+
+    bool mk_node(app * a) {
+        sort * s = m_manager.get_sort(a);
+        node n;
+        n.m_bool = m_manager.is_bool(s);
+        if (n.m_bool)
+            n.m_width = 1;
+        else if (m_bv_util.is_bv_sort(s) && m_bv_util.get_bv_size(s) <= 64)
+            n.m_width = m_bv_util.get_bv_size(s);
+        else
+            return false;
+        n.m_op = get_op(a, n.m_param);
+        if (n.m_op == W_UNSUPPORTED)
+            return false;
+        unsigned id = m_nodes.size();
+        uint64 v = 0;
+        if (n.m_op == W_LEAF) {
+            rational q;
+            unsigned bv_sz;
+            n.m_param = UINT_MAX;
+            if (is_uninterp_const(a)) {
+                n.m_param = m_constants.size();
+                m_decl2const.insert(a->get_decl(), m_constants.size());
+                m_constants.push_back(a->get_decl());
+                m_const2node.push_back(id);
+            }
+            else if (m_manager.is_true(a))
+                v = 1;
+            else if (m_manager.is_false(a))
+                v = 0;
+            else if (m_bv_util.is_numeral(a, q, bv_sz))
+                v = q.get_uint64();
+            else
+                return false;
+        }
+        n.m_args = m_args.size();
+        n.m_num_args = a->get_num_args();
+        for (unsigned i = 0; i < n.m_num_args; i++)
+            m_args.push_back(m_expr2node.find(a->get_arg(i)));
+        n.m_ups = 0;
+        n.m_num_ups = 0;
+        m_expr2node.insert(a, id);
+        m_nodes.push_back(n);
+        m_values.push_back(v);
+        return true;
+    }
+
+    void mk_uplinks() {
+        unsigned sz = m_nodes.size();
+        for (unsigned i = 0; i < m_args.size(); i++)
+            m_nodes[m_args[i]].m_num_ups++;
+        unsigned pos = 0;
+        for (unsigned i = 0; i < sz; i++) {
+            m_nodes[i].m_ups = pos;
+            pos += m_nodes[i].m_num_ups;
+            m_nodes[i].m_num_ups = 0;
+        }
+        m_ups.resize(pos, 0);
+        for (unsigned i = 0; i < sz; i++) {
+            node const & n = m_nodes[i];
+            for (unsigned j = 0; j < n.m_num_args; j++) {
+                node & c = m_nodes[m_args[n.m_args + j]];
+                m_ups[c.m_ups + c.m_num_ups++] = i;
+            }
+        }
+    }
+
+    // the constants of a formula are listed from left to right, as in sls_tracker.
+    void mk_root_consts() {
+        unsigned_vector todo;
+        for (unsigned i = 0; i < m_roots.size(); i++) {
+            next_cone_stamp();
+            m_root_consts.push_back(unsigned_vector());
+            unsigned_vector & consts = m_root_consts.back();
+            todo.push_back(m_roots[i]);
+            while (!todo.empty()) {
+                unsigned c = todo.back();
+                todo.pop_back();
+                if (in_cone(c))
+                    continue;
+                m_cone_mark[c] = m_cone_stamp;
+                node const & n = m_nodes[c];
+                if (n.m_op == W_LEAF && n.m_param != UINT_MAX)
+                    consts.push_back(n.m_param);
+                for (unsigned j = n.m_num_args; j-- > 0; )
+                    todo.push_back(m_args[n.m_args + j]);
+            }
+        }
+        m_cone_root = UINT_MAX;
+    }
+
+    void next_cone_stamp() {
+        if (++m_cone_stamp == 0) {
+            m_cone_mark.fill(0);
+            m_cone_stamp = 1;
+        }
+    }
+
+    bool in_cone(unsigned i) const { return m_cone_mark[i] == m_cone_stamp; }
+
+    uint64 get_lane(unsigned i, unsigned l) const {
+        return in_cone(i) ? m_lanes[i * NUM_LANES + l] : m_values[i];
+    }
+
+    double get_lane_score(unsigned i, unsigned l) const {
+        return in_cone(i) ? m_lane_scores[i * NUM_LANES + l] : m_scores[i];
+    }
+
+    void get_arg(unsigned i, unsigned num_lanes, uint64 * out) const {
+        if (in_cone(i)) {
+            uint64 const * v = m_lanes.c_ptr() + i * NUM_LANES;
+            for (unsigned l = 0; l < num_lanes; l++)
+                out[l] = v[l];
+        }
+        else {
+            uint64 v = m_values[i];
+            for (unsigned l = 0; l < num_lanes; l++)
+                out[l] = v;
+        }
+    }
+
+    void eval(unsigned i, unsigned nl) {
+        node const & n = m_nodes[i];
+        unsigned const * args = m_args.c_ptr() + n.m_args;
+        unsigned na = n.m_num_args;
+        uint64 * r = m_lanes.c_ptr() + i * NUM_LANES;
+        uint64 x[NUM_LANES], y[NUM_LANES];
+        uint64 m = mask(n.m_width);
+        unsigned w = na > 0 ? m_nodes[args[0]].m_width : 0;
+        unsigned l;
+
+        switch (n.m_op) {
+        case W_AND:
+        case W_BAND:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] &= x[l];
+            }
+            break;
+        case W_OR:
+        case W_BOR:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] |= x[l];
+            }
+            break;
+        case W_XOR:
+        case W_BXOR:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] ^= x[l];
+            }
+            break;
+        case W_BNAND:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] = ~(r[l] & x[l]) & m;
+            }
+            break;
+        case W_BNOR:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] = ~(r[l] | x[l]) & m;
+            }
+            break;
+        case W_NOT:
+        case W_BNOT:
+            get_arg(args[0], nl, x);
+            for (l = 0; l < nl; l++) r[l] = ~x[l] & m;
+            break;
+        case W_EQ:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = x[l] == y[l];
+            break;
+        case W_DISTINCT:
+            for (l = 0; l < nl; l++) r[l] = 1;
+            for (unsigned j = 0; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (unsigned k = j + 1; k < na; k++) {
+                    get_arg(args[k], nl, y);
+                    for (l = 0; l < nl; l++) r[l] &= x[l] != y[l];
+                }
+            }
+            break;
+        case W_ITE:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            get_arg(args[2], nl, r);
+            for (l = 0; l < nl; l++) r[l] = x[l] != 0 ? y[l] : r[l];
+            break;
+        case W_CONCAT:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                unsigned wj = m_nodes[args[j]].m_width;
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] = (r[l] << wj) | x[l];
+            }
+            break;
+        case W_EXTRACT:
+            get_arg(args[0], nl, x);
+            for (l = 0; l < nl; l++) r[l] = (x[l] >> n.m_param) & m;
+            break;
+        case W_ADD:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] = (r[l] + x[l]) & m;
+            }
+            break;
+        case W_SUB:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = (x[l] - y[l]) & m;
+            break;
+        case W_MUL:
+            get_arg(args[0], nl, r);
+            for (unsigned j = 1; j < na; j++) {
+                get_arg(args[j], nl, x);
+                for (l = 0; l < nl; l++) r[l] = (r[l] * x[l]) & m;
+            }
+            break;
+        case W_NEG:
+            get_arg(args[0], nl, x);
+            for (l = 0; l < nl; l++) r[l] = (0 - x[l]) & m;
+            break;
+        case W_UDIV:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = y[l] == 0 ? m : x[l] / y[l];
+            break;
+        case W_UREM:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = y[l] == 0 ? x[l] : x[l] % y[l];
+            break;
+        case W_SDIV:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = sdiv(x[l], y[l], w);
+            break;
+        case W_SREM:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = srem(x[l], y[l], w);
+            break;
+        case W_SMOD:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = smod(x[l], y[l], w);
+            break;
+        case W_ULEQ:
+        case W_ULT:
+        case W_UGEQ:
+        case W_UGT:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            switch (n.m_op) {
+            case W_ULEQ: for (l = 0; l < nl; l++) r[l] = x[l] <= y[l]; break;
+            case W_ULT:  for (l = 0; l < nl; l++) r[l] = x[l] < y[l];  break;
+            case W_UGEQ: for (l = 0; l < nl; l++) r[l] = x[l] >= y[l]; break;
+            default:     for (l = 0; l < nl; l++) r[l] = x[l] > y[l];  break;
+            }
+            break;
+        case W_SLEQ:
+        case W_SLT:
+        case W_SGEQ:
+        case W_SGT:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) {
+                int64 a = to_signed(x[l], w), b = to_signed(y[l], w);
+                r[l] = n.m_op == W_SLEQ ? a <= b : n.m_op == W_SLT ? a < b : n.m_op == W_SGEQ ? a >= b : a > b;
+            }
+            break;
+        case W_BIT2BOOL:
+            get_arg(args[0], nl, x);
+            for (l = 0; l < nl; l++) r[l] = (x[l] >> n.m_param) & 1;
+            break;
+        case W_SHL:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = y[l] >= w ? 0 : (x[l] << y[l]) & m;
+            break;
+        case W_LSHR:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) r[l] = y[l] >= w ? 0 : x[l] >> y[l];
+            break;
+        case W_ASHR:
+            get_arg(args[0], nl, x);
+            get_arg(args[1], nl, y);
+            for (l = 0; l < nl; l++) {
+                bool neg = ((x[l] >> (w - 1)) & 1) != 0;
+                if (y[l] >= w)
+                    r[l] = neg ? m : 0;
+                else
+                    r[l] = (x[l] >> y[l]) | (neg ? m & ~(m >> y[l]) : 0);
+            }
+            break;
+        case W_SIGN_EXT:
+            get_arg(args[0], nl, x);
+            for (l = 0; l < nl; l++) r[l] = static_cast<uint64>(to_signed(x[l], w)) & m;
+            break;
+        case W_ZERO_EXT:
+            get_arg(args[0], nl, r);
+            break;
+        default:
+            UNREACHABLE();
+        }
+    }
+
+    double score_bool(unsigned i, unsigned l, bool negated) const {
+        node const & n = m_nodes[i];
+        unsigned const * args = m_args.c_ptr() + n.m_args;
+        switch (n.m_op) {
+        case W_AND: {
+            if (negated)
+                break;
+            double min = 1.0;
+            for (unsigned j = 0; j < n.m_num_args; j++) {
+                double cur = get_lane_score(args[j], l);
+                if (cur < min) min = cur;
+            }
+            return min;
+        }
+        case W_OR: {
+            if (negated)
+                break;
+            double max = 0.0;
+            for (unsigned j = 0; j < n.m_num_args; j++) {
+                double cur = get_lane_score(args[j], l);
+                if (cur > max) max = cur;
+            }
+            return max;
+        }
+        case W_ITE:
+            if (negated)
+                break;
+            return get_lane_score(get_lane(args[0], l) != 0 ? args[1] : args[2], l);
+        case W_EQ: {
+            uint64 x = get_lane(args[0], l), y = get_lane(args[1], l);
+            if (negated)
+                return x == y ? 0.0 : 1.0;
+            node const & a = m_nodes[args[0]];
+            if (a.m_bool)
+                return x == y ? 1.0 : 0.0;
+            return 1.0 - (popcount(x ^ y) / (double) a.m_width);
+        }
+        case W_ULEQ:
+        case W_SLEQ: {
+            unsigned w = m_nodes[args[0]].m_width;
+            uint64 x = get_lane(args[0], l), y = get_lane(args[1], l);
+            bool le = n.m_op == W_ULEQ ? x <= y : to_signed(x, w) <= to_signed(y, w);
+            // the differences below are non-negative and fit in w bits.
+            if (negated) {
+                if (!le)
+                    return 1.0;
+                uint64 diff = (y - x) & mask(w);
+                if (diff == ~0ull) // diff + 1 == 2^64
+                    return 0.0;
+                double dbl = std::ldexp(static_cast<double>(diff + 1), -static_cast<int>(w));
+                return dbl > 1.0 ? 0.0 : 1.0 - dbl;
+            }
+            if (le)
+                return 1.0;
+            double dbl = std::ldexp(static_cast<double>((x - y) & mask(w)), -static_cast<int>(w));
+            return dbl > 1.0 ? 1.0 : dbl;
+        }
+        case W_NOT: {
+            op_kind c = m_nodes[args[0]].m_op;
+            if (negated || c == W_AND || c == W_OR) // Precondition: Assertion set is in NNF.
+                break;
+            return score_bool(args[0], l, true);
+        }
+        case W_DISTINCT: {
+            unsigned pairs = 0, distinct_pairs = 0;
+            for (unsigned j = 0; j < n.m_num_args; j++) {
+                for (unsigned k = j + 1; k < n.m_num_args; k++) {
+                    pairs++;
+                    if (get_lane(args[j], l) != get_lane(args[k], l))
+                        distinct_pairs++;
+                }
+            }
+            double res = distinct_pairs / (double) pairs;
+            return negated ? 1.0 - res : res;
+        }
+        default:
+            break;
+        }
+        // Constants and the remaining atoms are scored by their value.
+        bool v = get_lane(i, l) != 0;
+        return v != negated ? 1.0 : 0.0;
+    }
+
+    void eval_cone(unsigned num_lanes) {
+        for (unsigned k = 0; k < m_cone.size(); k++) {
+            unsigned i = m_cone[k];
+            node const & n = m_nodes[i];
+            if (n.m_op != W_LEAF)
+                eval(i, num_lanes);
+            if (n.m_bool) {
+                double * s = m_lane_scores.c_ptr() + i * NUM_LANES;
+                for (unsigned l = 0; l < num_lanes; l++)
+                    s[l] = score_bool(i, l, false);
+            }
+        }
+    }
+
+    void commit() {
+        for (unsigned k = 0; k < m_cone.size(); k++) {
+            unsigned i = m_cone[k];
+            m_values[i] = m_lanes[i * NUM_LANES];
+            if (m_nodes[i].m_bool)
+                m_scores[i] = m_lane_scores[i * NUM_LANES];
+        }
+    }
+
+    void mk_cone(unsigned c) {
+        if (m_cone_root == c)
+            return;
+        next_cone_stamp();
+        m_cone.reset();
+        m_cone.push_back(c);
+        m_cone_mark[c] = m_cone_stamp;
+        for (unsigned k = 0; k < m_cone.size(); k++) {
+            node const & n = m_nodes[m_cone[k]];
+            for (unsigned j = 0; j < n.m_num_ups; j++) {
+                unsigned p = m_ups[n.m_ups + j];
+                if (!in_cone(p)) {
+                    m_cone_mark[p] = m_cone_stamp;
+                    m_cone.push_back(p);
+                }
+            }
+        }
+        // node indices are a topological order.
+        std::sort(m_cone.begin(), m_cone.end());
+        m_cone_root = c;
+    }
+
+    unsigned get_const_node(func_decl * fd) const {
+        SASSERT(m_decl2const.contains(fd));
+        return m_const2node[m_decl2const.find(fd)];
+    }
+
+    uint64 get_random_value(unsigned w) {
+        uint64 r = 0;
+        for (unsigned i = 0; i < w; i += 15)
+            r = (r << 15) | m_rng();
+        return r & mask(w);
+    }
+
+    void reset() {
+        m_nodes.reset();
+        m_args.reset();
+        m_ups.reset();
+        m_expr2node.reset();
+        m_roots.reset();
+        m_root_consts.reset();
+        m_constants.reset();
+        m_const2node.reset();
+        m_decl2const.reset();
+        m_values.reset();
+        m_cone.reset();
+        m_cone_root = UINT_MAX;
+    }
+
+public:
+    /**
+       \brief Build the node graph of \c g. Return false if \c g contains
+       an unsupported operator or a bit-vector wider than 64 bits.
+    */
+    bool initialize(goal_ref const & g) {
+        reset();
+        ptr_vector<expr> todo;
+        unsigned sz = g->size();
+        for (unsigned i = 0; i < sz; i++) {
+            expr * f = g->form(i);
+            todo.push_back(f);
+            while (!todo.empty()) {
+                expr * e = todo.back();
+                if (m_expr2node.contains(e)) {
+                    todo.pop_back();
+                    continue;
+                }
+                if (!is_app(e))
+                    return false;
+                app * a = to_app(e);
+                bool visited = true;
+                for (unsigned j = a->get_num_args(); j-- > 0; ) {
+                    if (!m_expr2node.contains(a->get_arg(j))) {
+                        todo.push_back(a->get_arg(j));
+                        visited = false;
+                    }
+                }
+                if (!visited)
+                    continue;
+                todo.pop_back();
+                if (!mk_node(a))
+                    return false;
+            }
+            m_roots.push_back(m_expr2node.find(f));
+        }
+        unsigned n = m_nodes.size();
+        m_scores.reset();
+        m_scores.resize(n, 0.0);
+        m_lanes.reset();
+        m_lanes.resize(n * NUM_LANES, 0);
+        m_lane_scores.reset();
+        m_lane_scores.resize(n * NUM_LANES, 0.0);
+        m_cone_mark.reset();
+        m_cone_mark.resize(n, 0);
+        m_cone_stamp = 0;
+        m_const_mark.reset();
+        m_const_mark.resize(m_constants.size(), 0);
+        m_const_stamp = 0;
+        mk_uplinks();
+        mk_root_consts();
+        return true;
+    }
+
+    unsigned get_width(func_decl * fd) const { return m_nodes[get_const_node(fd)].m_width; }
+
+    uint64 get_value(func_decl * fd) const { return m_values[get_const_node(fd)]; }
+
+    /**
+       \brief Assign \c value to \c fd without evaluating the goal; the scores
+       are valid again after update_all.
+    */
+    void set_value(func_decl * fd, uint64 value) { m_values[get_const_node(fd)] = value & mask(get_width(fd)); }
+
+    ptr_vector<func_decl> const & get_constants() const { return m_constants; }
+
+    bool is_true(unsigned form_idx) const { return m_values[m_roots[form_idx]] == 1; }
+
+    double get_score(unsigned form_idx) const { return m_scores[m_roots[form_idx]]; }
+
+    void update_all() {
+        next_cone_stamp();
+        m_cone.reset();
+        for (unsigned i = 0; i < m_nodes.size(); i++) {
+            m_cone.push_back(i);
+            m_cone_mark[i] = m_cone_stamp;
+            if (m_nodes[i].m_op == W_LEAF)
+                m_lanes[i * NUM_LANES] = m_values[i];
+        }
+        m_cone_root = UINT_MAX;
+        eval_cone(1);
+        commit();
+    }
+
+    void update(func_decl * fd, uint64 value) {
+        unsigned c = get_const_node(fd);
+        mk_cone(c);
+        m_lanes[c * NUM_LANES] = value;
+        eval_cone(1);
+        commit();
+    }
+
+    /**
+       \brief Store in \c scores[i] the top score (average of the formula
+       scores) the goal would have if \c fd were \c values[i].
+       The current assignment is not modified.
+    */
+    void what_if(func_decl * fd, unsigned n, uint64 const * values, double * scores) {
+        unsigned c = get_const_node(fd);
+        mk_cone(c);
+        uint64 * lanes = m_lanes.c_ptr() + c * NUM_LANES;
+        unsigned num_roots = m_roots.size();
+        for (unsigned b = 0; b < n; b += NUM_LANES) {
+            unsigned nl = std::min(n - b, static_cast<unsigned>(NUM_LANES));
+            for (unsigned l = 0; l < nl; l++)
+                lanes[l] = values[b + l];
+            eval_cone(nl);
+            for (unsigned l = 0; l < nl; l++) {
+                double top_sum = 0.0;
+                for (unsigned i = 0; i < num_roots; i++)
+                    top_sum += get_lane_score(m_roots[i], l);
+                scores[b + l] = top_sum / (double) num_roots;
+            }
+        }
+    }
+
+    ptr_vector<func_decl> & get_unsat_constants() {
+        if (m_roots.size() == 1)
+            return m_constants;
+        m_temp_constants.reset();
+        if (++m_const_stamp == 0) {
+            m_const_mark.fill(0);
+            m_const_stamp = 1;
+        }
+        for (unsigned i = 0; i < m_roots.size(); i++) {
+            if (is_true(i))
+                continue;
+            unsigned_vector const & consts = m_root_consts[i];
+            for (unsigned j = 0; j < consts.size(); j++) {
+                unsigned k = consts[j];
+                if (m_const_mark[k] != m_const_stamp) {
+                    m_const_mark[k] = m_const_stamp;
+                    m_temp_constants.push_back(m_constants[k]);
+                }
+            }
+        }
+        return m_temp_constants;
+    }
+
+    void randomize() {
+        for (unsigned k = 0; k < m_constants.size(); k++) {
+            unsigned c = m_const2node[k];
+            m_values[c] = get_random_value(m_nodes[c].m_width);
+        }
+    }
+
+    void randomize_local() {
+        ptr_vector<func_decl> & unsat_constants = get_unsat_constants();
+        if (unsat_constants.empty())
+            return;
+        func_decl * fd = unsat_constants[m_rng(unsat_constants.size())];
+        update(fd, get_random_value(get_width(fd)));
+    }
+
+    model_ref get_model() {
+        model_ref res = alloc(model, m_manager);
+        for (unsigned k = 0; k < m_constants.size(); k++) {
+            func_decl * fd = m_constants[k];
+            uint64 v = m_values[m_const2node[k]];
+            expr_ref val(m_manager);
+            if (m_manager.is_bool(fd->get_range()))
+                val = v != 0 ? m_manager.mk_true() : m_manager.mk_false();
+            else
+                val = m_bv_util.mk_numeral(rational(v, rational::ui64()), fd->get_range());
+            res->register_decl(fd, val);
+        }
+        return res;
+    }
+};
+
+#endif
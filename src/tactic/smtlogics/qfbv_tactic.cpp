@@ -28,6 +28,7 @@ Notes:
 #include"bv_size_reduction_tactic.h"
 #include"aig_tactic.h"
 #include"sat_tactic.h"
+#include"sat_params.hpp"
 
 #define MEMLIMIT 300
 
@@ -92,6 +93,27 @@ tactic * mk_qfbv_tactic(ast_manager & m, params_ref const & p) {
                                      mk_smt_tactic()),
                             mk_sat_tactic(m));
 #endif    
+
+    tactic * blast_st = and_then(mk_bit_blaster_tactic(m),
+                                 when(mk_lt(mk_memory_probe(), mk_const_probe(MEMLIMIT)),
+                                      and_then(using_params(and_then(mk_simplify_tactic(m),
+                                                                     mk_solve_eqs_tactic(m)),
+                                                            local_ctx_p),
+                                               if_no_proofs(cond(mk_produce_unsat_cores_probe(),
+                                                                 mk_aig_tactic(),
+                                                                 using_params(mk_aig_tactic(),
+                                                                              big_aig_p))))),
+                                 new_sat);
+
+    if (sat_params(p).direct_bit_blast()) {
+        // skip the Boolean circuit (and its AIG simplification), and let the SAT tactic blast the atoms.
+        params_ref direct_p;
+        direct_p.set_bool("direct_bit_blast", true);
+        blast_st = cond(mk_and(mk_is_bv2sat_probe(),
+                               mk_not(mk_or(mk_produce_proofs_probe(), mk_produce_unsat_cores_probe()))),
+                        using_params(mk_sat_tactic(m), direct_p),
+                        blast_st);
+    }
     
     tactic * st = using_params(and_then(preamble_st,
                                         // If the user sets HI_DIV0=false, then the formula may contain uninterpreted function
@@ -100,16 +122,7 @@ tactic * mk_qfbv_tactic(ast_manager & m, params_ref const & p) {
                                              cond(mk_is_qfbv_eq_probe(),
                                                   and_then(mk_bv1_blaster_tactic(m),
                                                            using_params(mk_smt_tactic(), solver_p)),
-                                                  and_then(mk_bit_blaster_tactic(m),
-                                                           when(mk_lt(mk_memory_probe(), mk_const_probe(MEMLIMIT)),
-                                                                and_then(using_params(and_then(mk_simplify_tactic(m),
-                                                                                               mk_solve_eqs_tactic(m)),
-                                                                                      local_ctx_p),
-                                                                         if_no_proofs(cond(mk_produce_unsat_cores_probe(),
-                                                                                           mk_aig_tactic(),
-                                                                                           using_params(mk_aig_tactic(),
-                                                                                                        big_aig_p))))),
-                                                           new_sat)),
+                                                  blast_st),
                                              mk_smt_tactic())),
                                main_p);
 
@@ -99,6 +99,7 @@ private:
     friend class nary_tactical;
     friend class binary_tactical;
     friend class unary_tactical;
+    friend class par_and_then_scheduler;
 
     virtual void set_cancel(bool f) {}
 
@@ -644,279 +644,656 @@ tactic * par(tactic * t1, tactic * t2, tactic * t3, tactic * t4) {
     return par(4, ts);
 }
 
-class par_and_then_tactical : public and_then_tactical {
+/**
+   \brief Exception raised by a tactic executed in a parallel region.
+   It is stored and raised again once the region is left.
+*/
+struct par_exception {
+    bool               m_raised;
+    par_exception_kind m_kind;
+    std::string        m_msg;
+    unsigned           m_error_code;
+
+    par_exception():m_raised(false), m_kind(DEFAULT_EX), m_error_code(0) {}
+
+    void set(par_exception_kind k, char const * msg, unsigned error_code) {
+        m_raised     = true;
+        m_kind       = k;
+        m_msg        = msg;
+        m_error_code = error_code;
+    }
+
+    void raise() const {
+        switch (m_kind) {
+        case ERROR_EX: throw z3_error(m_error_code);
+        case TACTIC_EX: throw tactic_exception(m_msg.c_str());
+        default:
+            throw default_exception(m_msg.c_str());
+        }
+    }
+};
+
+/**
+   \brief Work-stealing scheduler for the subgoals of par_and_then_tactical.
+
+   A split creates a group of jobs, one per subgoal. A job applies a translation
+   of the second tactic to a translation of its subgoal in a fresh ast_manager,
+   and is pushed to the deque of the thread that created it. Threads pop jobs
+   from the back of their own deque, and steal jobs from the front of the other
+   deques. A thread waiting for the jobs of its group executes other jobs in the
+   meantime, so a job that splits again (nested par_and_then) adds its subgoals to
+   the same scheduler instead of solving them sequentially.
+
+   At most m_max_managers translated managers are alive. When none is available,
+   the thread that split solves the next subgoal itself, in its own manager.
+
+   A thread executes jobs of other groups only while it is nested in fewer than
+   max_help_depth() jobs, beyond that it only executes the jobs of the group it
+   waits for. Threads without a job back off, see backoff().
+*/
+class par_and_then_scheduler {
 public:
-    par_and_then_tactical(tactic * t1, tactic * t2):and_then_tactical(t1, t2) {}
-    virtual ~par_and_then_tactical() {}
+    struct group;
+
+    struct job {
+        scoped_ptr<ast_manager> m_owned;   // manager of the job, 0 if it runs in the manager of its group
+        ast_manager &           m_manager;
+        group &                 m_group;
+        unsigned                m_idx;     // index of the subgoal in the group
+        tactic_ref              m_tactic;
+        goal_ref                m_goal;
+        goal_ref_buffer         m_result;
+        model_converter_ref     m_mc;
+        proof_converter_ref     m_pc;
+        expr_dependency_ref     m_core;
+        par_exception           m_ex;
+        bool                    m_done;
+
+        job(ast_manager & m, bool owned, group & g, unsigned idx):
+            m_owned(owned ? &m : 0),
+            m_manager(m),
+            m_group(g),
+            m_idx(idx),
+            m_core(m),
+            m_done(false) {
+        }
+    };
 
-    virtual void operator()(goal_ref const & in, 
-                            goal_ref_buffer & result, 
-                            model_converter_ref & mc, 
-                            proof_converter_ref & pc, 
-                            expr_dependency_ref & core) {
-        bool use_seq;
-#ifdef _NO_OMP_
-        use_seq = true;
-#else
-        use_seq = 0 != omp_in_parallel();
-#endif
-        if (use_seq) {
-            // execute tasks sequentially
-            and_then_tactical::operator()(in, result, mc, pc, core);
-            return;
+    /**
+       \brief Jobs created by one split. The first job that finds a model or
+       raises an exception decides the outcome of the group, and cancels the
+       other jobs.
+    */
+    struct group {
+        omp_lock_t      m_lock;
+        ptr_vector<job> m_jobs;   // jobs that were not collected yet
+        volatile bool   m_cancel;
+        job *           m_winner;
+        job *           m_failed;
+
+        group():m_cancel(false), m_winner(0), m_failed(0) { omp_init_lock(&m_lock); }
+        ~group() { omp_destroy_lock(&m_lock); }
+
+        void add(job * j) {
+            omp_set_lock(&m_lock);
+            m_jobs.push_back(j);
+            omp_unset_lock(&m_lock);
         }
 
-        bool models_enabled = in->models_enabled();
-        bool proofs_enabled = in->proofs_enabled();
-        bool cores_enabled  = in->unsat_core_enabled();
+        /**
+           \brief Cancel the jobs of the group. Like tactic::set_cancel, it must be
+           invoked in the critical section tactic_cancel.
+        */
+        void cancel() {
+            omp_set_lock(&m_lock);
+            cancel_jobs(*this);
+            omp_unset_lock(&m_lock);
+        }
 
-        ast_manager & m = in->m();                                                                          
-        goal_ref_buffer      r1;
-        model_converter_ref mc1;                                                                           
-        proof_converter_ref pc1;                                                                           
-        expr_dependency_ref core1(m);                                                                      
-        result.reset();                                                                                     
-        mc   = 0;                                                                                
-        pc   = 0;        
-        core = 0;
-        m_t1->operator()(in, r1, mc1, pc1, core1);                                                            
-        SASSERT(!is_decided(r1) || (!pc1 && !core1)); // the pc and core of decided goals is 0
-        unsigned r1_size = r1.size();                                                                       
-        SASSERT(r1_size > 0);                                                                               
-        checkpoint();                                                                                       
-        if (r1_size == 1) {                                                                                 
-            // Only one subgoal created... no need for parallelism
-            if (r1[0]->is_decided()) {
-                result.push_back(r1[0]);                                                                    
-                if (models_enabled) mc = mc1;                                                                                 
-                SASSERT(!pc); SASSERT(!core);
-                return;                                                                                     
-            }                                                                                               
-            goal_ref r1_0 = r1[0];                                                                          
-            m_t2->operator()(r1_0, result, mc, pc, core);                                              
-            if (models_enabled) mc = concat(mc1.get(), mc.get());                                                               
-            if (proofs_enabled) pc = concat(pc1.get(), pc.get());                                                               
-            if (cores_enabled) core = m.mk_join(core1.get(), core);                                                            
-        }                                                                                     
-        else {                                                                                              
-            if (cores_enabled) core = core1;                                                                                   
+        /**
+           \brief Move the finished jobs to \c done.
+        */
+        void collect(ptr_vector<job> & done) {
+            omp_set_lock(&m_lock);
+            unsigned j = 0;
+            for (unsigned i = 0; i < m_jobs.size(); i++) {
+                if (m_jobs[i]->m_done)
+                    done.push_back(m_jobs[i]);
+                else
+                    m_jobs[j++] = m_jobs[i];
+            }
+            m_jobs.shrink(j);
+            omp_unset_lock(&m_lock);
+        }
+    };
+
+private:
+    struct deque {
+        omp_lock_t      m_lock;
+        ptr_vector<job> m_jobs;
+        unsigned        m_head;   // the jobs before m_head were stolen
+        volatile unsigned m_size; // number of jobs, read without the lock to skip empty deques
+        deque():m_head(0), m_size(0) { omp_init_lock(&m_lock); }
+        ~deque() { omp_destroy_lock(&m_lock); }
+    };
+
+    unsigned                 m_num_threads;
+    scoped_ptr_vector<deque> m_deques;
+    omp_lock_t               m_lock;
+    unsigned                 m_num_managers;
+    unsigned                 m_max_managers;
+    svector<unsigned>        m_depth;   // number of nested jobs executed by each thread
+    volatile bool            m_stop;
+
+    unsigned max_help_depth() const { return 8; }
+
+    job * take(deque & d, unsigned i) {
+        job * j = d.m_jobs[i];
+        for (; i + 1 < d.m_jobs.size(); i++)
+            d.m_jobs[i] = d.m_jobs[i + 1];
+        d.m_jobs.pop_back();
+        return j;
+    }
 
-            scoped_ptr_vector<ast_manager> managers;
-            tactic_ref_vector              ts2;
-            goal_ref_vector                g_copies;
+public:
+    par_and_then_scheduler(unsigned num_threads):
+        m_num_threads(num_threads),
+        m_num_managers(0),
+        m_max_managers(4 * num_threads),
+        m_depth(num_threads, 0u),
+        m_stop(false) {
+        omp_init_lock(&m_lock);
+        for (unsigned i = 0; i < num_threads; i++)
+            m_deques.push_back(alloc(deque));
+    }
 
-            ast_manager & m = in->m();
+    ~par_and_then_scheduler() {
+        omp_destroy_lock(&m_lock);
+    }
 
-            for (unsigned i = 0; i < r1_size; i++) {
-                ast_manager * new_m = alloc(ast_manager, m, !m.proof_mode());
-                managers.push_back(new_m);
-                ast_translation translator(m, *new_m);
-                g_copies.push_back(r1[i]->translate(translator));
-                ts2.push_back(m_t2->translate(*new_m));
-            }
+    unsigned num_threads() const { return m_num_threads; }
 
-            proof_converter_ref_buffer             pc_buffer;                                                           
-            model_converter_ref_buffer             mc_buffer;                                                           
-            scoped_ptr_vector<expr_dependency_ref> core_buffer;
-            scoped_ptr_vector<goal_ref_buffer>     goals_vect;
+    static void cancel_jobs(group & g) {
+        g.m_cancel = true;
+        for (unsigned i = 0; i < g.m_jobs.size(); i++)
+            g.m_jobs[i]->m_tactic->set_cancel(true);
+    }
 
-            pc_buffer.resize(r1_size);
-            mc_buffer.resize(r1_size);
-            core_buffer.resize(r1_size);
-            goals_vect.resize(r1_size);
+    bool reserve_manager() {
+        bool r = false;
+        omp_set_lock(&m_lock);
+        if (m_num_managers < m_max_managers) {
+            m_num_managers++;
+            r = true;
+        }
+        omp_unset_lock(&m_lock);
+        return r;
+    }
 
-            bool found_solution = false;
-            bool failed         = false;
-            par_exception_kind ex_kind = DEFAULT_EX;
-            unsigned error_code = 0;
-            std::string  ex_msg;
+    void release_manager() {
+        omp_set_lock(&m_lock);
+        SASSERT(m_num_managers > 0);
+        m_num_managers--;
+        omp_unset_lock(&m_lock);
+    }
 
-            #pragma omp parallel for
-            for (int i = 0; i < static_cast<int>(r1_size); i++) {                                                        
-                ast_manager & new_m = *(managers[i]);
-                goal_ref new_g = g_copies[i];
+    void push(unsigned tid, job * j) {
+        deque & d = *(m_deques[tid]);
+        omp_set_lock(&d.m_lock);
+        d.m_jobs.push_back(j);
+        d.m_size = d.m_jobs.size() - d.m_head;
+        omp_unset_lock(&d.m_lock);
+    }
 
-                goal_ref_buffer r2;
-                model_converter_ref mc2;                                                                   
-                proof_converter_ref pc2;                                                                   
-                expr_dependency_ref core2(new_m);                                                              
-                
-                bool curr_failed = false;
+    /**
+       \brief Return the last job of the deque of \c tid, or else the first
+       job of another deque, or 0 if there is no job.
+    */
+    job * pop(unsigned tid) {
+        for (unsigned k = 0; k < m_num_threads; k++) {
+            deque & d = *(m_deques[(tid + k) % m_num_threads]);
+            if (d.m_size == 0)
+                continue;
+            job * j = 0;
+            omp_set_lock(&d.m_lock);
+            if (d.m_head < d.m_jobs.size()) {
+                if (k == 0) {
+                    j = d.m_jobs.back();
+                    d.m_jobs.pop_back();
+                }
+                else {
+                    j = d.m_jobs[d.m_head++];
+                }
+                if (d.m_head == d.m_jobs.size()) {
+                    d.m_jobs.reset();
+                    d.m_head = 0;
+                }
+                d.m_size = d.m_jobs.size() - d.m_head;
+            }
+            omp_unset_lock(&d.m_lock);
+            if (j)
+                return j;
+        }
+        return 0;
+    }
 
-                try {
-                    ts2[i]->operator()(new_g, r2, mc2, pc2, core2);                                              
+    /**
+       \brief Return a job of the group \c g that was not started yet, or 0 if there is none.
+    */
+    job * pop(group & g) {
+        for (unsigned k = 0; k < m_num_threads; k++) {
+            deque & d = *(m_deques[k]);
+            if (d.m_size == 0)
+                continue;
+            job * j = 0;
+            omp_set_lock(&d.m_lock);
+            for (unsigned i = d.m_head; i < d.m_jobs.size(); i++) {
+                if (&(d.m_jobs[i]->m_group) == &g) {
+                    j = take(d, i);
+                    break;
                 }
-                catch (tactic_exception & ex) {
-                    #pragma omp critical (par_and_then_tactical)
+            }
+            d.m_size = d.m_jobs.size() - d.m_head;
+            omp_unset_lock(&d.m_lock);
+            if (j)
+                return j;
+        }
+        return 0;
+    }
+
+    static void run(job & j) {
+        if (!j.m_group.m_cancel) {
+            try {
+                (*j.m_tactic)(j.m_goal, j.m_result, j.m_mc, j.m_pc, j.m_core);
+            }
+            catch (tactic_exception & ex) {
+                j.m_ex.set(TACTIC_EX, ex.msg(), 0);
+            }
+            catch (z3_error & err) {
+                j.m_ex.set(ERROR_EX, "", err.error_code());
+            }
+            catch (z3_exception & z3_ex) {
+                j.m_ex.set(DEFAULT_EX, z3_ex.msg(), 0);
+            }
+        }
+        group & g = j.m_group;
+        #pragma omp critical (tactic_cancel)
+        {
+            omp_set_lock(&g.m_lock);
+            if (!g.m_cancel && (j.m_ex.m_raised || is_decided_sat(j.m_result))) {
+                if (j.m_ex.m_raised)
+                    g.m_failed = &j;
+                else
+                    g.m_winner = &j;
+                cancel_jobs(g);
+            }
+            j.m_done = true;
+            omp_unset_lock(&g.m_lock);
+        }
+    }
+
+    /**
+       \brief Execute one job of the scheduler, from the thread \c tid waiting
+       for the group \c g (0 if it waits for no group). Return false if there is none.
+    */
+    bool help(unsigned tid, group * g) {
+        job * j = m_depth[tid] < max_help_depth() || g == 0 ? pop(tid) : pop(*g);
+        if (j == 0)
+            return false;
+        m_depth[tid]++;
+        run(*j);
+        m_depth[tid]--;
+        return true;
+    }
+
+    /**
+       \brief Wait after \c num_idle consecutive rounds without a job: spin first,
+       then yield the processor, then sleep.
+    */
+    static void backoff(unsigned num_idle) {
+        if (num_idle < 16)
+            return;
+        z3_sleep(num_idle < 64 ? 0 : 1);
+    }
+
+    /**
+       \brief Execute jobs until stop is invoked.
+    */
+    void work(unsigned tid) {
+        unsigned num_idle = 0;
+        while (!m_stop) {
+            if (help(tid, 0))
+                num_idle = 0;
+            else
+                backoff(num_idle++);
+        }
+    }
+
+    void stop() { m_stop = true; }
+};
+
+// scheduler of the parallel region the current thread is working for.
+static par_and_then_scheduler * g_par_and_then_scheduler = 0;
+#pragma omp threadprivate(g_par_and_then_scheduler)
+
+class par_and_then_tactical : public and_then_tactical {
+    omp_lock_t                      m_lock;
+    par_and_then_scheduler::group * m_group; // group of subgoals being solved, protected by m_lock
+
+    typedef par_and_then_scheduler::job job;
+
+    /**
+       \brief Store in the buffers of the subgoal of \c j the result of \c j.
+    */
+    void store(job & j, ast_manager & m, scoped_ptr_vector<goal_ref_buffer> & goals_vect,
+               model_converter_ref_buffer & mc_buffer, proof_converter_ref_buffer & pc_buffer,
+               expr_dependency_ref & core, bool proofs_enabled, bool cores_enabled) {
+        ast_translation translator(j.m_manager, m, false);
+        expr_dependency_translation td(translator);
+        unsigned i = j.m_idx;
+        if (is_decided(j.m_result)) {
+            SASSERT(is_decided_unsat(j.m_result));
+            // the proof and unsat core of a decided_unsat goal are stored in the node itself.
+            goal * r = j.m_result[0];
+            if (proofs_enabled) {
+                proof * pr = j.m_owned ? translator(r->pr(0)) : r->pr(0);
+                pc_buffer.set(i, proof2proof_converter(m, pr));
+            }
+            if (cores_enabled && r->dep(0) != 0)
+                core = m.mk_join(core.get(), j.m_owned ? td(r->dep(0)) : r->dep(0));
+            return;
+        }
+        goal_ref_buffer * new_r2 = alloc(goal_ref_buffer);
+        goals_vect.set(i, new_r2);
+        for (unsigned k = 0; k < j.m_result.size(); k++)
+            new_r2->push_back(j.m_owned ? j.m_result[k]->translate(translator) : j.m_result[k]);
+        if (j.m_mc)
+            mc_buffer.set(i, j.m_owned ? j.m_mc->translate(translator) : j.m_mc.get());
+        if (j.m_pc)
+            pc_buffer.set(i, j.m_owned ? j.m_pc->translate(translator) : j.m_pc.get());
+        if (cores_enabled && j.m_core != 0)
+            core = m.mk_join(core.get(), j.m_owned ? td(j.m_core) : j.m_core.get());
+    }
+
+    /**
+       \brief Apply m_t2 to the subgoals \c r1 produced by m_t1 on \c in, using
+       the scheduler \c s from the thread \c tid.
+    */
+    void split(par_and_then_scheduler & s, unsigned tid, goal_ref const & in, goal_ref_buffer & r1,
+               model_converter_ref & mc1, proof_converter_ref & pc1, expr_dependency_ref & core1,
+               goal_ref_buffer & result, model_converter_ref & mc, proof_converter_ref & pc, expr_dependency_ref & core) {
+        bool models_enabled = in->models_enabled();
+        bool proofs_enabled = in->proofs_enabled();
+        bool cores_enabled  = in->unsat_core_enabled();
+        ast_manager & m = in->m();
+        unsigned r1_size = r1.size();
+
+        if (cores_enabled) core = core1;
+
+        par_and_then_scheduler::group      grp;
+        proof_converter_ref_buffer         pc_buffer;
+        model_converter_ref_buffer         mc_buffer;
+        scoped_ptr_vector<goal_ref_buffer> goals_vect;
+        pc_buffer.resize(r1_size);
+        mc_buffer.resize(r1_size);
+        goals_vect.resize(r1_size);
+
+        bool          found_solution = false;
+        par_exception ex;
+
+        omp_set_lock(&m_lock);
+        m_group = &grp;
+        omp_unset_lock(&m_lock);
+
+        // the jobs refer to grp, so this loop is left only when all created jobs are done.
+        unsigned num_jobs = 0;
+        unsigned num_done = 0;
+        unsigned num_idle = 0;
+        ptr_vector<job> done;
+        while (num_done < num_jobs || (num_jobs < r1_size && !grp.m_cancel)) {
+            try {
+                if (m_cancel) {
+                    #pragma omp critical (tactic_cancel)
                     {
-                        if (!failed && !found_solution) {
-                            curr_failed = true;
-                            failed      = true;
-                            ex_kind     = TACTIC_EX;
-                            ex_msg      = ex.msg();
-                        }
+                        grp.cancel();
                     }
                 }
-                catch (z3_error & err) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
-                        if (!failed && !found_solution) {
-                            curr_failed = true;
-                            failed      = true;
-                            ex_kind     = ERROR_EX;
-                            error_code  = err.error_code();
-                        }
-                    }                    
+                while (num_jobs < r1_size && !grp.m_cancel && s.reserve_manager()) {
+                    // the job owns its manager, and it is owned by this loop until it is added to grp.
+                    scoped_ptr<job> j;
+                    try {
+                        scoped_ptr<ast_manager> new_m(alloc(ast_manager, m, !m.proof_mode()));
+                        j = alloc(job, *new_m, true, grp, num_jobs);
+                        new_m.detach();
+                        ast_translation translator(m, j->m_manager);
+                        j->m_goal   = r1[num_jobs]->translate(translator);
+                        j->m_tactic = m_t2->translate(j->m_manager);
+                    }
+                    catch (z3_exception &) {
+                        // j and its manager are deleted on the way out.
+                        s.release_manager();
+                        throw;
+                    }
+                    num_jobs++;
+                    job * new_j = j.detach();
+                    grp.add(new_j);
+                    s.push(tid, new_j);
                 }
-                catch (z3_exception & z3_ex) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
-                        if (!failed && !found_solution) {
-                            curr_failed = true;
-                            failed      = true;
-                            ex_kind     = DEFAULT_EX;
-                            ex_msg      = z3_ex.msg();
+
+                done.reset();
+                grp.collect(done);
+                for (unsigned k = 0; k < done.size(); k++) {
+                    job * j = done[k];
+                    if (j == grp.m_winner) {
+                        found_solution = true;
+                        ast_translation translator(j->m_manager, m, false);
+                        SASSERT(j->m_result.size() == 1);
+                        result.push_back(j->m_owned ? j->m_result[0]->translate(translator) : j->m_result[0]);
+                        if (models_enabled) {
+                            // the model converter of the job contains the actual model
+                            model_converter_ref mc2 = j->m_owned && j->m_mc ? j->m_mc->translate(translator) : j->m_mc.get();
+                            model_ref md;
+                            md = alloc(model, m);
+                            apply(mc2, md, 0);
+                            apply(mc1, md, j->m_idx);
+                            mc = model2model_converter(md.get());
                         }
                     }
+                    else if (j == grp.m_failed) {
+                        ex = j->m_ex;
+                    }
+                    else if (!grp.m_cancel) {
+                        store(*j, m, goals_vect, mc_buffer, pc_buffer, core, proofs_enabled, cores_enabled);
+                    }
+                    bool owned = j->m_owned;
+                    dealloc(j);
+                    if (owned)
+                        s.release_manager();
+                    num_done++;
                 }
 
-                if (curr_failed) {
-                    for (unsigned j = 0; j < r1_size; j++) {
-                        if (static_cast<unsigned>(i) != j)
-                            ts2.get(j)->cancel();
-                    }
+                if (s.help(tid, &grp)) {
+                    num_idle = 0;
                 }
-                else {
-                    if (is_decided(r2)) {
-                        SASSERT(r2.size() == 1);
-                        if (is_decided_sat(r2)) {                                                          
-                            // found solution... 
-                            bool first = false;
-                            #pragma omp critical (par_and_then_tactical)
-                            {
-                                if (!found_solution) {
-                                    failed         = false;
-                                    found_solution = true;
-                                    first          = true;
-                                }
-                            }
-                            if (first) {
-                                for (unsigned j = 0; j < r1_size; j++) {
-                                    if (static_cast<unsigned>(i) != j)
-                                        ts2.get(j)->cancel();
-                                }
-                                ast_translation translator(new_m, m, false);
-                                SASSERT(r2.size() == 1);
-                                result.push_back(r2[0]->translate(translator));
-                                if (models_enabled) {
-                                    // mc2 contains the actual model                                                    
-                                    mc2  = mc2 ? mc2->translate(translator) : 0;
-                                    model_ref md;     
-                                    md = alloc(model, m);
-                                    apply(mc2, md, 0);
-                                    apply(mc1, md, i);
-                                    mc   = model2model_converter(md.get());                                             
-                                }
-                                SASSERT(!pc); SASSERT(!core);
-                            }       
-                        }                                                     
-                        else {                                                                                  
-                            SASSERT(is_decided_unsat(r2));                                                 
-                            // the proof and unsat core of a decided_unsat goal are stored in the node itself.
-                            // pc2 and core2 must be 0.
-                            SASSERT(!pc2);
-                            SASSERT(!core2);
-                            
-                            if (models_enabled) mc_buffer.set(i, 0);
-                            if (proofs_enabled) {
-                                proof * pr = r2[0]->pr(0);
-                                pc_buffer.push_back(proof2proof_converter(m, pr));
-                            }
-                            if (cores_enabled && r2[0]->dep(0) != 0) {
-                                expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
-                                *new_dep = r2[0]->dep(0);
-                                core_buffer.set(i, new_dep);
-                            }
-                        }                                                                 
-                    }                                                                                       
-                    else {                                                                                      
-                        goal_ref_buffer * new_r2 = alloc(goal_ref_buffer);
-                        goals_vect.set(i, new_r2);
-                        new_r2->append(r2.size(), r2.c_ptr());
-                        mc_buffer.set(i, mc2.get());
-                        pc_buffer.set(i, pc2.get());
-                        if (cores_enabled && core2 != 0) {
-                            expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
-                            *new_dep = core2;
-                            core_buffer.set(i, new_dep);
-                        }
-                    }                                                                                           
+                else if (num_jobs < r1_size && !grp.m_cancel) {
+                    // no manager is available, and there is no other job to execute.
+                    job * j = alloc(job, m, false, grp, num_jobs);
+                    j->m_goal   = r1[num_jobs];
+                    j->m_tactic = m_t2->translate(m);
+                    num_jobs++;
+                    grp.add(j);
+                    par_and_then_scheduler::run(*j);
+                    num_idle = 0;
+                }
+                else if (num_done < num_jobs && done.empty()) {
+                    // the remaining jobs of the group are executed by other threads.
+                    par_and_then_scheduler::backoff(num_idle++);
                 }
             }
-            
-            if (failed) {
-                switch (ex_kind) {
-                case ERROR_EX: throw z3_error(error_code);
-                case TACTIC_EX: throw tactic_exception(ex_msg.c_str());
-                default:
-                    throw default_exception(ex_msg.c_str());
+            catch (z3_exception & z3_ex) {
+                // raised while creating a job, e.g., memory limit.
+                if (!ex.m_raised && !found_solution)
+                    ex.set(DEFAULT_EX, z3_ex.msg(), 0);
+                #pragma omp critical (tactic_cancel)
+                {
+                    grp.cancel();
                 }
             }
+        }
 
-            if (found_solution)
-                return;
+        omp_set_lock(&m_lock);
+        m_group = 0;
+        omp_unset_lock(&m_lock);
+
+        if (found_solution) {
+            SASSERT(!pc);
+            pc   = 0;
+            core = 0;
+            return;
+        }
+        if (ex.m_raised)
+            ex.raise();
+        if (grp.m_cancel)
+            throw tactic_exception(TACTIC_CANCELED_MSG);
+
+        sbuffer<unsigned> sz_buffer;
+        for (unsigned i = 0; i < r1_size; i++) {
+            goal_ref_buffer * r = goals_vect[i];
+            if (r != 0) {
+                result.append(r->size(), r->c_ptr());
+                sz_buffer.push_back(r->size());
+            }
+            else {
+                sz_buffer.push_back(0);
+            }
+        }
 
+        if (result.empty()) {
+            // all subgoals were shown to be unsat.
+            // create an decided_unsat goal with the proof
+            in->reset_all();
+            proof_ref pr(m);
+            if (proofs_enabled)
+                apply(m, pc1, pc_buffer, pr);
+            SASSERT(cores_enabled || core == 0);
+            in->assert_expr(m.mk_false(), pr, core);
             core = 0;
-            sbuffer<unsigned> sz_buffer;                                                           
-            for (unsigned i = 0; i < r1_size; i++) {
-                ast_translation translator(*(managers[i]), m, false);
-                goal_ref_buffer * r = goals_vect[i];
-                if (r != 0) {
-                    for (unsigned k = 0; k < r->size(); k++) {
-                        result.push_back((*r)[k]->translate(translator));
+            result.push_back(in.get());
+            SASSERT(!mc); SASSERT(!pc); SASSERT(!core);
+        }
+        else {
+            if (models_enabled) mc = concat(mc1.get(), mc_buffer.size(), mc_buffer.c_ptr(), sz_buffer.c_ptr());
+            if (proofs_enabled) pc = concat(pc1.get(), pc_buffer.size(), pc_buffer.c_ptr(), sz_buffer.c_ptr());
+            SASSERT(cores_enabled || core == 0);
+        }
+    }
+
+public:
+    par_and_then_tactical(tactic * t1, tactic * t2):and_then_tactical(t1, t2), m_group(0) { omp_init_lock(&m_lock); }
+    virtual ~par_and_then_tactical() { omp_destroy_lock(&m_lock); }
+
+    virtual void operator()(goal_ref const & in,
+                            goal_ref_buffer & result,
+                            model_converter_ref & mc,
+                            proof_converter_ref & pc,
+                            expr_dependency_ref & core) {
+        bool use_seq;
+#ifdef _NO_OMP_
+        use_seq = true;
+#else
+        // a job of a par_and_then scheduler splits in the same scheduler,
+        // other parallel regions execute the tasks sequentially.
+        use_seq = g_par_and_then_scheduler == 0 && 0 != omp_in_parallel();
+#endif
+        if (use_seq) {
+            // execute tasks sequentially
+            and_then_tactical::operator()(in, result, mc, pc, core);
+            return;
+        }
+
+        bool models_enabled = in->models_enabled();
+        bool proofs_enabled = in->proofs_enabled();
+        bool cores_enabled  = in->unsat_core_enabled();
+
+        ast_manager & m = in->m();
+        goal_ref_buffer      r1;
+        model_converter_ref mc1;
+        proof_converter_ref pc1;
+        expr_dependency_ref core1(m);
+        result.reset();
+        mc   = 0;
+        pc   = 0;
+        core = 0;
+        m_t1->operator()(in, r1, mc1, pc1, core1);
+        SASSERT(!is_decided(r1) || (!pc1 && !core1)); // the pc and core of decided goals is 0
+        unsigned r1_size = r1.size();
+        SASSERT(r1_size > 0);
+        checkpoint();
+        if (r1_size == 1) {
+            // Only one subgoal created... no need for parallelism
+            if (r1[0]->is_decided()) {
+                result.push_back(r1[0]);
+                if (models_enabled) mc = mc1;
+                SASSERT(!pc); SASSERT(!core);
+                return;
+            }
+            goal_ref r1_0 = r1[0];
+            m_t2->operator()(r1_0, result, mc, pc, core);
+            if (models_enabled) mc = concat(mc1.get(), mc.get());
+            if (proofs_enabled) pc = concat(pc1.get(), pc.get());
+            if (cores_enabled) core = m.mk_join(core1.get(), core);
+        }
+        else if (g_par_and_then_scheduler != 0) {
+            split(*g_par_and_then_scheduler, omp_get_thread_num(), in, r1, mc1, pc1, core1, result, mc, pc, core);
+        }
+        else {
+            par_and_then_scheduler s(omp_get_max_threads());
+            par_exception ex;
+            #pragma omp parallel num_threads(s.num_threads())
+            {
+                unsigned tid = omp_get_thread_num();
+                g_par_and_then_scheduler = &s;
+                if (tid == 0) {
+                    try {
+                        split(s, tid, in, r1, mc1, pc1, core1, result, mc, pc, core);
+                    }
+                    catch (tactic_exception & ex1) {
+                        ex.set(TACTIC_EX, ex1.msg(), 0);
+                    }
+                    catch (z3_error & err) {
+                        ex.set(ERROR_EX, "", err.error_code());
                     }
-                    sz_buffer.push_back(r->size());
+                    catch (z3_exception & z3_ex) {
+                        ex.set(DEFAULT_EX, z3_ex.msg(), 0);
+                    }
+                    s.stop();
                 }
                 else {
-                    sz_buffer.push_back(0);
-                }
-                if (mc_buffer[i] != 0)
-                    mc_buffer.set(i, mc_buffer[i]->translate(translator));
-                if (pc_buffer[i] != 0)
-                    pc_buffer.set(i, pc_buffer[i]->translate(translator));
-                expr_dependency_translation td(translator);
-                if (core_buffer[i] != 0) {
-                    expr_dependency_ref curr_core(m);
-                    curr_core = td(*(core_buffer[i]));
-                    core = m.mk_join(curr_core, core);
+                    s.work(tid);
                 }
+                g_par_and_then_scheduler = 0;
             }
-
-            if (result.empty()) {
-                // all subgoals were shown to be unsat.                                                     
-                // create an decided_unsat goal with the proof
-                in->reset_all();
-                proof_ref pr(m);
-                if (proofs_enabled)
-                    apply(m, pc1, pc_buffer, pr);
-                SASSERT(cores_enabled || core == 0);
-                in->assert_expr(m.mk_false(), pr, core);
-                core = 0;
-                result.push_back(in.get());
-                SASSERT(!mc); SASSERT(!pc); SASSERT(!core);
-            }
-            else {
-                if (models_enabled) mc = concat(mc1.get(), mc_buffer.size(), mc_buffer.c_ptr(), sz_buffer.c_ptr());                 
-                if (proofs_enabled) pc = concat(pc1.get(), pc_buffer.size(), pc_buffer.c_ptr(), sz_buffer.c_ptr()); 
-                SASSERT(cores_enabled || core == 0);
-            }
+            if (ex.m_raised)
+                ex.raise();
         }
     }
 
     virtual tactic * translate(ast_manager & m) {
-        return translate_core<and_then_tactical>(m);
+        return translate_core<par_and_then_tactical>(m);
     }
 
+protected:
+    virtual void set_cancel(bool f) {
+        and_then_tactical::set_cancel(f);
+        if (f) {
+            // the lock of each tactical is distinct, since canceling a group
+            // cancels the nested par_and_then tacticals of its jobs.
+            omp_set_lock(&m_lock);
+            if (m_group)
+                m_group->cancel();
+            omp_unset_lock(&m_lock);
+        }
+    }
 };
 
 // Similar to and_then combinator, but t2 is applied in parallel to all subgoals produced by t1
@@ -0,0 +1,100 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    aig_fraig.cpp
+
+Abstract:
+
+    Test FRAIG sweeping and cut rewriting of AIGs on miters of adders.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"aig.h"
+#include"reg_decl_plugins.h"
+#include"model.h"
+#include"model_evaluator.h"
+#include"util.h"
+
+static void mk_adders(ast_manager & m, unsigned sz, bool bug, expr_ref_vector & xs, expr_ref_vector & ys, expr_ref & miter) {
+    for (unsigned i = 0; i < sz; i++) {
+        xs.push_back(m.mk_fresh_const("x", m.mk_bool_sort()));
+        ys.push_back(m.mk_fresh_const("y", m.mk_bool_sort()));
+    }
+    expr_ref c1(m.mk_false(), m), c2(m.mk_false(), m);
+    expr_ref_vector diffs(m);
+    for (unsigned i = 0; i < sz; i++) {
+        expr * x = xs.get(i);
+        expr * y = ys.get(i);
+        // ripple carry: s = (x xor y) xor c, c' = (x and y) or (c and (x xor y))
+        expr_ref xy(m.mk_xor(x, y), m);
+        expr_ref s1(m.mk_xor(xy, c1), m);
+        c1 = m.mk_or(m.mk_and(x, y), m.mk_and(c1, xy));
+        // majority carry: s = x xor (y xor c), c' = (x and y) or (x and c) or (y and c)
+        expr_ref s2(m.mk_xor(x, m.mk_xor(y, c2)), m);
+        if (bug && i == sz / 2)
+            s2 = m.mk_xor(x, c2);
+        expr * args[3] = { m.mk_and(x, y), m.mk_and(x, c2), m.mk_and(y, c2) };
+        c2 = m.mk_or(3, args);
+        diffs.push_back(m.mk_xor(s1, s2));
+    }
+    diffs.push_back(m.mk_xor(c1, c2));
+    miter = m.mk_or(diffs.size(), diffs.c_ptr());
+}
+
+static void tst_fraig_adders(bool bug) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector xs(m), ys(m);
+    expr_ref miter(m);
+    mk_adders(m, 16, bug, xs, ys, miter);
+    aig_manager mng(m);
+    aig_ref r = mng.mk_aig(miter);
+    unsigned num_before = mng.get_num_aigs();
+    mng.fraig(r);
+    expr_ref res(m);
+    mng.to_formula(r, res);
+    std::cout << "fraig: " << num_before << " --> " << mng.get_num_aigs() << " nodes\n";
+    VERIFY(bug == !m.is_false(res));
+}
+
+static void tst_cut_rewrite_adders() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector xs(m), ys(m);
+    expr_ref miter(m);
+    mk_adders(m, 8, true, xs, ys, miter);
+    aig_manager mng(m);
+    aig_ref r = mng.mk_aig(miter);
+    unsigned num_before = mng.get_num_aigs();
+    mng.cut_rewrite(r);
+    mng.max_sharing(r);
+    expr_ref res(m);
+    mng.to_formula(r, res);
+    std::cout << "cut rewrite: " << num_before << " --> " << mng.get_num_aigs() << " nodes\n";
+    random_gen rand(0);
+    for (unsigned k = 0; k < 200; k++) {
+        model_ref md = alloc(model, m);
+        for (unsigned i = 0; i < xs.size(); i++) {
+            md->register_decl(to_app(xs.get(i))->get_decl(), rand(2) == 0 ? m.mk_true() : m.mk_false());
+            md->register_decl(to_app(ys.get(i))->get_decl(), rand(2) == 0 ? m.mk_true() : m.mk_false());
+        }
+        model_evaluator ev(*md.get());
+        expr_ref v1(m), v2(m);
+        ev(miter, v1);
+        ev(res, v2);
+        VERIFY(v1 == v2);
+    }
+}
+
+void tst_aig_fraig() {
+    tst_fraig_adders(false);
+    tst_fraig_adders(true);
+    tst_cut_rewrite_adders();
+}
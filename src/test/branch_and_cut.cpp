@@ -0,0 +1,151 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    branch_and_cut.cpp
+
+Abstract:
+
+    Compare the branch and cut strategy for linear integer arithmetic
+    (arith.branch_and_cut=true) with the legacy branch/cut scheduling
+    on random bounded integer problems, and check that pseudo-cost
+    branches are taken and pooled cuts are exported only when it is enabled.
+    branch_and_cut_bench reports the search nodes, cuts and time of both
+    strategies on larger problems.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"arith_decl_plugin.h"
+#include"stopwatch.h"
+#include"random_formulas.h"
+
+/**
+   \brief Random problem over integers in [0, ub] with equalities and inequalities of 3 to 6
+   terms. The constraints are satisfied by a random solution, except for the first
+   equality when seed is a multiple of 3.
+*/
+static void mk_bounded_int(ast_manager & m, unsigned seed, unsigned num_vars, unsigned num_eqs, unsigned num_ineqs,
+                           expr_ref_vector & fmls) {
+    arith_util a(m);
+    random_gen r(seed);
+    unsigned ub = 5 + r(16);
+    expr_ref_vector xs(m);
+    svector<int> sol;
+    for (unsigned i = 0; i < num_vars; i++) {
+        xs.push_back(m.mk_fresh_const("x", a.mk_int()));
+        sol.push_back(r(ub + 1));
+        fmls.push_back(a.mk_ge(xs.get(i), a.mk_numeral(rational(0), true)));
+        fmls.push_back(a.mk_le(xs.get(i), a.mk_numeral(rational(ub), true)));
+    }
+    // constraints are satisfied by sol, except for the first equality of every third problem.
+    for (unsigned i = 0; i < num_eqs + num_ineqs; i++) {
+        expr_ref_vector ts(m);
+        int val = 0;
+        unsigned sz = 3 + r(4);
+        for (unsigned j = 0; j < sz; j++) {
+            unsigned x = r(num_vars);
+            int c = static_cast<int>(r(18)) - 9;
+            if (c == 0)
+                c = 1;
+            val += c * sol[x];
+            ts.push_back(a.mk_mul(a.mk_numeral(rational(c), true), xs.get(x)));
+        }
+        expr * lhs = a.mk_add(ts.size(), ts.c_ptr());
+        if (i < num_eqs) {
+            if (i == 0 && seed % 3 == 0)
+                val++;
+            fmls.push_back(m.mk_eq(lhs, a.mk_numeral(rational(val), true)));
+        }
+        else {
+            fmls.push_back(a.mk_le(lhs, a.mk_numeral(rational(val + static_cast<int>(r(4))), true)));
+        }
+    }
+}
+
+static void tst_bounded_int(unsigned seed, unsigned num_vars, unsigned num_eqs, unsigned num_ineqs,
+                            unsigned pseudo_cost_branches[2], unsigned cut_lemmas[2]) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    expr_ref_vector fmls(m);
+    mk_bounded_int(m, seed, num_vars, num_eqs, num_ineqs, fmls);
+    lbool res[2];
+    for (unsigned k = 0; k < 2; k++) {
+        smt_params p;
+        p.m_arith_branch_and_cut = k == 1;
+        smt::kernel ker(m, p);
+        for (unsigned i = 0; i < fmls.size(); i++)
+            ker.assert_expr(fmls.get(i));
+        res[k] = ker.check();
+        if (res[k] == l_true) {
+            model_ref md;
+            ker.get_model(md);
+            check_model(*md.get(), fmls);
+        }
+        pseudo_cost_branches[k] += get_stat(ker, "pseudo cost branches");
+        cut_lemmas[k]           += get_stat(ker, "cut lemmas");
+    }
+    VERIFY(res[0] == res[1]);
+}
+
+void tst_branch_and_cut() {
+    unsigned pseudo_cost_branches[2] = { 0, 0 };
+    unsigned cut_lemmas[2]           = { 0, 0 };
+    for (unsigned seed = 0; seed < 10; seed++)
+        tst_bounded_int(seed, 8 + seed / 4, 3, 6 + seed / 4, pseudo_cost_branches, cut_lemmas);
+    // the legacy scheduling neither uses pseudo-costs nor the cut pool.
+    VERIFY(pseudo_cost_branches[0] == 0 && cut_lemmas[0] == 0);
+    VERIFY(pseudo_cost_branches[1] > 0 && cut_lemmas[1] > 0);
+}
+
+/**
+   \brief Compare the branch and cut strategy with the legacy scheduling on larger bounded
+   problems. For each strategy, report the search nodes (branches on integer variables and
+   decisions), the cuts and the time of the check.
+*/
+void tst_branch_and_cut_bench() {
+    unsigned num_problems = 12;
+    unsigned branches[2]  = { 0, 0 };
+    unsigned decisions[2] = { 0, 0 };
+    unsigned cuts[2]      = { 0, 0 };
+    double   total[2]     = { 0, 0 };
+    for (unsigned seed = 0; seed < num_problems; seed++) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        expr_ref_vector fmls(m);
+        mk_bounded_int(m, seed, 14, 5, 9, fmls);
+        lbool res[2];
+        for (unsigned k = 0; k < 2; k++) {
+            smt_params p;
+            p.m_arith_branch_and_cut = k == 1;
+            smt::kernel ker(m, p);
+            for (unsigned i = 0; i < fmls.size(); i++)
+                ker.assert_expr(fmls.get(i));
+            stopwatch sw;
+            sw.start();
+            res[k] = ker.check();
+            sw.stop();
+            unsigned b = get_stat(ker, "ineq splits");
+            unsigned d = get_stat(ker, "decisions");
+            unsigned c = get_stat(ker, "gomory cuts") + get_stat(ker, "cut lemmas");
+            std::cout << "seed " << seed << (k == 0 ? " legacy:" : " branch and cut:") << " " << res[k]
+                      << ", branches " << b << ", decisions " << d << ", cuts " << c << ", " << sw.get_seconds() << "s\n";
+            branches[k]  += b;
+            decisions[k] += d;
+            cuts[k]      += c;
+            total[k]     += sw.get_seconds();
+        }
+        VERIFY(res[0] == res[1]);
+    }
+    for (unsigned k = 0; k < 2; k++)
+        std::cout << (k == 0 ? "legacy:" : "branch and cut:") << " branches " << branches[k] << ", decisions " << decisions[k]
+                  << ", cuts " << cuts[k] << ", " << total[k] << "s\n";
+}
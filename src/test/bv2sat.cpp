@@ -0,0 +1,220 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    bv2sat.cpp
+
+Abstract:
+
+    Compare the direct bit-blaster of the SAT tactic (sat.direct_bit_blast=true)
+    with bit-blasting through Boolean expressions on random bit-vector formulas.
+    bv2sat_bench compares the time of the qfbv tactic with and without
+    sat.direct_bit_blast on 64-bit multiplication benchmarks.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"tactical.h"
+#include"sat_tactic.h"
+#include"bit_blaster_tactic.h"
+#include"simplify_tactic.h"
+#include"bv_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"th_rewriter.h"
+#include"qfbv_tactic.h"
+#include"stopwatch.h"
+#include"random_formulas.h"
+
+static lbool check(tactic * t, ast_manager & m, expr_ref_vector const & fmls, bool direct) {
+    tactic_ref tac = t;
+    params_ref p;
+    p.set_bool("direct_bit_blast", direct);
+    tac->updt_params(p);
+    goal_ref g = alloc(goal, m, true, false);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        g->assert_expr(fmls[i]);
+    model_ref md;
+    proof_ref pr(m);
+    expr_dependency_ref core(m);
+    std::string reason;
+    lbool r = check_sat(*tac, g, md, pr, core, reason);
+    if (r == l_true)
+        check_model(*md.get(), fmls);
+    return r;
+}
+
+static void tst_random_bv(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_bv_gen gen(m, seed, 8);
+    expr_ref_vector fmls(m);
+    for (unsigned i = 0; i < 3; i++) {
+        expr * a = gen.mk_atom(3);
+        fmls.push_back(i % 2 == 0 ? a : m.mk_or(a, gen.mk_atom(2)));
+    }
+    lbool r1 = check(mk_sat_tactic(m), m, fmls, true);
+    params_ref simp_p;
+    simp_p.set_bool("elim_and", true);
+    lbool r2 = check(and_then(using_params(mk_simplify_tactic(m), simp_p), mk_bit_blaster_tactic(m), mk_sat_tactic(m)), m, fmls, false);
+    VERIFY(r1 != l_undef);
+    VERIFY(r1 == r2);
+}
+
+static lbool check_both(ast_manager & m, expr_ref_vector const & fmls) {
+    lbool r1 = check(mk_sat_tactic(m), m, fmls, true);
+    lbool r2 = check(and_then(mk_bit_blaster_tactic(m), mk_sat_tactic(m)), m, fmls, false);
+    VERIFY(r1 == r2);
+    return r1;
+}
+
+/**
+   \brief The division circuits agree with the hardware interpretation of the
+   rewriter when the divisor is zero.
+*/
+static void tst_div_by_zero(decl_kind k) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util u(m);
+    unsigned sz = 6;
+    expr_ref x(m.mk_const(symbol("x"), u.mk_sort(sz)), m);
+    expr_ref y(m.mk_const(symbol("y"), u.mk_sort(sz)), m);
+    expr_ref zero(u.mk_numeral(rational(0), sz), m);
+    expr_ref t(m.mk_app(u.get_fid(), k, x, y), m);
+    expr_ref hw(m.mk_app(u.get_fid(), k, x, zero), m);
+    th_rewriter rw(m);
+    rw(hw);
+    expr_ref_vector fmls(m);
+    fmls.push_back(m.mk_eq(y, zero));
+    fmls.push_back(m.mk_not(m.mk_eq(t, hw)));
+    VERIFY(check_both(m, fmls) == l_false);
+}
+
+void tst_bv2sat() {
+    tst_div_by_zero(OP_BUDIV_I);
+    tst_div_by_zero(OP_BUREM_I);
+    tst_div_by_zero(OP_BSDIV_I);
+    tst_div_by_zero(OP_BSREM_I);
+    tst_div_by_zero(OP_BSMOD_I);
+    for (unsigned seed = 0; seed < 40; seed++)
+        tst_random_bv(seed);
+}
+
+static uint64 random64(random_gen & r) {
+    uint64 v = 0;
+    for (unsigned i = 0; i < 4; i++)
+        v = (v << 16) | static_cast<uint64>(r(1 << 16));
+    return v;
+}
+
+static bool is_prime(uint64 n) {
+    for (uint64 d = 3; d * d <= n; d += 2)
+        if (n % d == 0)
+            return false;
+    return true;
+}
+
+/**
+   \brief x * y = p * q where p and q are primes of 14 to 17 bits, and 1 < x, y < 2^20.
+*/
+static void mk_factoring(ast_manager & m, unsigned seed, expr_ref_vector & fmls) {
+    bv_util u(m);
+    random_gen r(seed);
+    unsigned bits = 14 + seed % 4;
+    uint64 pq[2];
+    for (unsigned i = 0; i < 2; i++) {
+        do {
+            pq[i] = ((static_cast<uint64>(1) << (bits - 1)) + r(1 << (bits - 1))) | 1;
+        }
+        while (!is_prime(pq[i]));
+    }
+    expr_ref x(m.mk_const(symbol("x"), u.mk_sort(64)), m);
+    expr_ref y(m.mk_const(symbol("y"), u.mk_sort(64)), m);
+    expr_ref one(u.mk_numeral(rational(1), 64), m);
+    expr_ref bound(u.mk_numeral(rational(1 << 20), 64), m);
+    fmls.push_back(m.mk_eq(u.mk_bv_mul(x, y), u.mk_numeral(rational(pq[0] * pq[1], rational::ui64()), 64)));
+    fmls.push_back(m.mk_not(u.mk_ule(bound, x)));
+    fmls.push_back(m.mk_not(u.mk_ule(bound, y)));
+    fmls.push_back(m.mk_not(u.mk_ule(x, one)));
+    fmls.push_back(m.mk_not(u.mk_ule(y, one)));
+}
+
+/**
+   \brief a_0 * a_1 + a_2 * a_3 ... = v, where v is the value of the chain for random a_i,
+   and every a_i is above its random value shifted right by 8 bits.
+*/
+static void mk_chain(ast_manager & m, unsigned seed, expr_ref_vector & fmls) {
+    bv_util u(m);
+    random_gen r(seed);
+    unsigned n = 6 + seed % 5;
+    expr_ref acc(m);
+    uint64 v = 0;
+    for (unsigned i = 0; i < n; i++) {
+        expr_ref a(m.mk_const(symbol(i), u.mk_sort(64)), m);
+        uint64 val = random64(r);
+        if (i == 0) {
+            acc = a;
+            v   = val;
+        }
+        else if (i % 2 == 1) {
+            acc = u.mk_bv_mul(acc, a);
+            v  *= val;
+        }
+        else {
+            acc = u.mk_bv_add(acc, a);
+            v  += val;
+        }
+        fmls.push_back(m.mk_not(u.mk_ule(a, u.mk_numeral(rational(val >> 8, rational::ui64()), 64))));
+    }
+    fmls.push_back(m.mk_eq(acc, u.mk_numeral(rational(v, rational::ui64()), 64)));
+}
+
+static double bench(ast_manager & m, expr_ref_vector const & fmls, bool direct, lbool & r) {
+    params_ref p;
+    p.set_bool("direct_bit_blast", direct);
+    tactic_ref tac = mk_qfbv_tactic(m, p);
+    goal_ref g = alloc(goal, m, true, false);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        g->assert_expr(fmls[i]);
+    model_ref md;
+    proof_ref pr(m);
+    expr_dependency_ref core(m);
+    std::string reason;
+    stopwatch sw;
+    sw.start();
+    r = check_sat(*tac, g, md, pr, core, reason);
+    sw.stop();
+    if (r == l_true)
+        check_model(*md.get(), fmls);
+    return sw.get_seconds();
+}
+
+/**
+   \brief Time the qfbv tactic with and without sat.direct_bit_blast on 6 factoring
+   problems and 6 multiplication/addition chains. All of them are satisfiable.
+*/
+void tst_bv2sat_bench() {
+    double total[2] = { 0, 0 };
+    for (unsigned k = 0; k < 12; k++) {
+        ast_manager m;
+        reg_decl_plugins(m);
+        expr_ref_vector fmls(m);
+        if (k < 6)
+            mk_factoring(m, k, fmls);
+        else
+            mk_chain(m, k - 6, fmls);
+        lbool r[2];
+        double t[2];
+        for (unsigned i = 0; i < 2; i++) {
+            t[i] = bench(m, fmls, i == 1, r[i]);
+            total[i] += t[i];
+        }
+        std::cout << (k < 6 ? "factoring " : "chain ") << k % 6 << ": default " << t[0] << "s, direct " << t[1] << "s\n";
+        VERIFY(r[0] == l_true && r[1] == l_true);
+    }
+    std::cout << "total: default " << total[0] << "s, direct " << total[1] << "s\n";
+}
@@ -0,0 +1,90 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    bv_lazy_blast.cpp
+
+Abstract:
+
+    Compare the lazy bit-blasting of multiplication, unsigned division and
+    remainder (smt.bv.solver=2) with eager bit-blasting on random bit-vector
+    formulas.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"random_formulas.h"
+
+static lbool check(ast_manager & m, expr_ref_vector const & fmls, bv_solver_id mode, unsigned & num_lazy_blast) {
+    smt_params p;
+    p.m_bv_mode = mode;
+    smt::kernel ker(m, p);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        ker.assert_expr(fmls.get(i));
+    lbool r = ker.check();
+    if (r == l_true) {
+        model_ref md;
+        ker.get_model(md);
+        check_model(*md.get(), fmls);
+    }
+    num_lazy_blast += get_stat(ker, "bv lazy blast");
+    return r;
+}
+
+static void check_both(ast_manager & m, expr_ref_vector const & fmls, unsigned & num_lazy_blast) {
+    unsigned num_eager_blast = 0;
+    lbool r1 = check(m, fmls, BS_BLASTER, num_eager_blast);
+    lbool r2 = check(m, fmls, BS_LAZY_BLASTER, num_lazy_blast);
+    VERIFY(r1 != l_undef);
+    VERIFY(r1 == r2);
+    VERIFY(num_eager_blast == 0);
+}
+
+static void tst_random_bv(unsigned seed, unsigned sz, unsigned & num_lazy_blast) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_bv_gen gen(m, seed, sz);
+    expr_ref_vector fmls(m);
+    for (unsigned i = 0; i < 4; i++)
+        fmls.push_back(gen.mk_formula(3));
+    check_both(m, fmls, num_lazy_blast);
+}
+
+/**
+   \brief The model of the unblasted terms is refuted only by their circuits.
+*/
+static void tst_circuits(unsigned & num_lazy_blast) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    unsigned sz = 8;
+    expr_ref x(m.mk_const(symbol("x"), bv.mk_sort(sz)), m);
+    expr_ref y(m.mk_const(symbol("y"), bv.mk_sort(sz)), m);
+    expr_ref four(bv.mk_numeral(rational(4), sz), m);
+    expr_ref_vector fmls(m);
+    // no square is 3 modulo 4.
+    fmls.push_back(m.mk_eq(bv.mk_bv_urem(bv.mk_bv_mul(x, x), four), bv.mk_numeral(rational(3), sz)));
+    check_both(m, fmls, num_lazy_blast);
+    fmls.reset();
+    fmls.push_back(m.mk_eq(bv.mk_bv_mul(x, y), bv.mk_numeral(rational(143), sz)));
+    fmls.push_back(m.mk_not(m.mk_eq(x, bv.mk_numeral(rational(1), sz))));
+    fmls.push_back(m.mk_not(m.mk_eq(y, bv.mk_numeral(rational(1), sz))));
+    fmls.push_back(bv.mk_ule(x, y));
+    check_both(m, fmls, num_lazy_blast);
+}
+
+void tst_bv_lazy_blast() {
+    unsigned num_lazy_blast = 0;
+    tst_circuits(num_lazy_blast);
+    VERIFY(num_lazy_blast > 0);
+    for (unsigned seed = 0; seed < 60; seed++)
+        tst_random_bv(seed, seed % 2 == 0 ? 8 : 12, num_lazy_blast);
+}
@@ -0,0 +1,80 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    cost_evaluator.cpp
+
+Abstract:
+
+    Check that the compiled cost functions used by qi_queue produce the
+    same values as the interpreted ones on random inputs.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"cost_parser.h"
+#include"cost_evaluator.h"
+#include"reg_decl_plugins.h"
+#include"warning.h"
+#include"util.h"
+
+static char const * g_cost_functions[] = {
+    "(+ weight generation)",
+    "cost",
+    "(+ x (* y x) x)",
+    "(+ x (* 10 y) 2)",
+    "(- x y)",
+    "(- (* 3 x))",
+    "(/ x y)",
+    "(/ (+ x 1) (- y z))",
+    "(ite (and (> x 3) (<= y 4)) 2 10)",
+    "(ite (or (> x 3) (<= y 4)) 2 10)",
+    "(ite (implies (< x y) (>= z 2)) (+ x 1) (/ z 0))",
+    "(ite (xor (= x y) (not (< z 1))) weight (* weight 2))",
+    "(ite (iff (> x 1) (> y 1)) (ite (= z 0) 1 (/ 1 z)) cost)",
+    "(ite (and true (or false (> x 0) (> (/ y 0) 1))) (+ x y z) 0)",
+    "(* (ite (> generation 3) 5 1) (+ weight generation (/ cost 2)))",
+};
+
+static void tst_cost_function(char const * str, random_gen & r) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    cost_parser p(m);
+    p.add_var("x");
+    p.add_var("y");
+    p.add_var("z");
+    p.add_var("weight");
+    p.add_var("generation");
+    p.add_var("cost");
+    unsigned num_vars = 6;
+    expr_ref f(m);
+    VERIFY(p.parse_string(str, f));
+    cost_evaluator eval(m);
+    cost_evaluator::code c;
+    eval.compile(f, c);
+    VERIFY(!c.empty());
+    float vals[6];
+    for (unsigned i = 0; i < 200; i++) {
+        for (unsigned j = 0; j < num_vars; j++) {
+            // small values, so that the comparisons and divisions by zero are exercised.
+            vals[j] = r(4) == 0 ? static_cast<float>(r(1000)) / 8.0f : static_cast<float>(static_cast<int>(r(7)) - 3);
+        }
+        float v1 = eval(f, num_vars, vals);
+        float v2 = eval(c, num_vars, vals);
+        VERIFY(v1 == v2 || (v1 != v1 && v2 != v2));
+    }
+}
+
+void tst_cost_evaluator() {
+    // division by zero is reported with a warning
+    enable_warning_messages(false);
+    random_gen r(0);
+    for (unsigned i = 0; i < sizeof(g_cost_functions)/sizeof(char const *); i++)
+        tst_cost_function(g_cost_functions[i], r);
+    enable_warning_messages(true);
+}
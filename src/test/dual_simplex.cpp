@@ -0,0 +1,266 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    dual_simplex.cpp
+
+Abstract:
+
+    Test the sparse LU factorization, the floating point dual simplex,
+    and the theory_arith mode that uses them (arith.solver=5).
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include<math.h>
+#include<algorithm>
+#include"dual_simplex.h"
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"arith_decl_plugin.h"
+#include"random_formulas.h"
+
+typedef sparse_lu::entries entries;
+
+static void mk_random_matrix(random_gen & r, unsigned n, unsigned density, vector<entries> & cols) {
+    cols.reset();
+    cols.resize(n);
+    for (unsigned j = 0; j < n; j++) {
+        // a non-zero diagonal keeps the matrix non-singular most of the time
+        cols[j].push_back(sparse_lu::entry(j, static_cast<double>(r(9)) + 1.0));
+        for (unsigned i = 0; i < n; i++) {
+            if (i != j && r(100) < density)
+                cols[j].push_back(sparse_lu::entry(i, static_cast<double>(r(11)) - 5.0));
+        }
+    }
+}
+
+static double residual(vector<entries> const & cols, svector<double> const & x, svector<double> const & b) {
+    svector<double> y(b.size(), 0.0);
+    for (unsigned j = 0; j < cols.size(); j++)
+        for (unsigned k = 0; k < cols[j].size(); k++)
+            y[cols[j][k].m_idx] += cols[j][k].m_val * x[j];
+    double r = 0.0;
+    for (unsigned i = 0; i < b.size(); i++)
+        r = std::max(r, fabs(y[i] - b[i]));
+    return r;
+}
+
+static double residual_t(vector<entries> const & cols, svector<double> const & y, svector<double> const & c) {
+    double r = 0.0;
+    for (unsigned j = 0; j < cols.size(); j++) {
+        double s = 0.0;
+        for (unsigned k = 0; k < cols[j].size(); k++)
+            s += cols[j][k].m_val * y[cols[j][k].m_idx];
+        r = std::max(r, fabs(s - c[j]));
+    }
+    return r;
+}
+
+static double max_abs(svector<double> const & x) {
+    double r = 0.0;
+    for (unsigned i = 0; i < x.size(); i++)
+        r = std::max(r, fabs(x[i]));
+    return r;
+}
+
+// the residuals are relative to the size of the solution, since random updates
+// can make the matrix ill-conditioned.
+static void check_solves(random_gen & r, sparse_lu & lu, vector<entries> const & cols) {
+    unsigned n = cols.size();
+    svector<double> b, x;
+    for (unsigned i = 0; i < n; i++)
+        b.push_back(static_cast<double>(r(21)) - 10.0);
+    x.append(b);
+    lu.ftran(x);
+    VERIFY(residual(cols, x, b) < 1e-6 * (1.0 + max_abs(x)));
+    x.reset();
+    x.append(b);
+    lu.btran(x);
+    VERIFY(residual_t(cols, x, b) < 1e-6 * (1.0 + max_abs(x)));
+}
+
+static void tst_sparse_lu(unsigned seed, unsigned n, unsigned density) {
+    random_gen r(seed);
+    vector<entries> cols;
+    mk_random_matrix(r, n, density, cols);
+    sparse_lu lu;
+    if (!lu.factor(n, cols))
+        return;
+    check_solves(r, lu, cols);
+    // replace columns using Forrest-Tomlin updates
+    unsigned num_updates = 0;
+    for (unsigned k = 0; k < 3 * n; k++) {
+        unsigned j = r(n);
+        entries col;
+        svector<double> spike(n, 0.0);
+        for (unsigned i = 0; i < n; i++) {
+            if (i == j || r(100) < density) {
+                double v = static_cast<double>(r(11)) - 5.0;
+                if (i == j && v == 0.0)
+                    v = 1.0;
+                col.push_back(sparse_lu::entry(i, v));
+                spike[i] = v;
+            }
+        }
+        lu.ftran(spike, true);
+        if (fabs(spike[j]) < 1e-3)
+            continue; // the new matrix would be (almost) singular
+        cols[j] = col;
+        num_updates++;
+        // refactor periodically and when the update is unstable, as done by dual_simplex
+        if (!lu.update(j) || lu.num_updates() >= 64)
+            VERIFY(lu.factor(n, cols));
+        check_solves(r, lu, cols);
+    }
+    std::cout << "n: " << n << " updates: " << num_updates << " nonzeros: " << lu.num_nonzeros() << "\n";
+}
+
+/**
+   \brief Create sparse rows s_i = sum_j a_ij x_j (as s_i - sum_j a_ij x_j = 0) with a
+   known solution, and bounds around that solution.
+*/
+static void tst_dual_simplex(unsigned seed, unsigned num_rows, unsigned num_cols, bool feasible) {
+    random_gen r(seed);
+    dual_simplex ds;
+    unsigned num_vars = num_rows + num_cols;
+    ds.reset(num_vars);
+    svector<double> sol;
+    for (unsigned j = 0; j < num_cols; j++)
+        sol.push_back(static_cast<double>(r(21)) - 10.0);
+    vector<unsigned_vector> rows;
+    vector<svector<double> > coeffs;
+    for (unsigned i = 0; i < num_rows; i++) {
+        unsigned_vector vars;
+        svector<double> cs;
+        double s = 0.0;
+        vars.push_back(num_cols + i);
+        cs.push_back(1.0);
+        for (unsigned k = 0; k < 4; k++) {
+            unsigned j = r(num_cols);
+            double a   = static_cast<double>(r(7)) - 3.0;
+            if (a == 0.0 || vars.contains(j))
+                continue;
+            vars.push_back(j);
+            cs.push_back(-a);
+            s += a * sol[j];
+        }
+        sol.push_back(s);
+        ds.add_row(num_cols + i, vars.size(), vars.c_ptr(), cs.c_ptr());
+        rows.push_back(vars);
+        coeffs.push_back(cs);
+    }
+    for (unsigned v = 0; v < num_vars; v++) {
+        switch (r(4)) {
+        case 0: ds.set_lower(v, sol[v] - r(3)); break;
+        case 1: ds.set_upper(v, sol[v] + r(3)); break;
+        case 2: ds.set_lower(v, sol[v] - r(3)); ds.set_upper(v, sol[v] + r(3)); break;
+        default: break;
+        }
+    }
+    if (!feasible) {
+        // the bounds of the variables in the first row make it infeasible
+        for (unsigned k = 0; k < rows[0].size(); k++) {
+            unsigned v = rows[0][k];
+            double c   = coeffs[0][k];
+            if (k == 0) {
+                ds.set_lower(v, 1.0);
+            }
+            else {
+                ds.set_lower(v, c > 0 ? 0.0 : -1.0);
+                ds.set_upper(v, 0.0);
+            }
+        }
+    }
+    lbool res = ds();
+    statistics st;
+    ds.collect_statistics(st);
+    std::cout << "rows: " << num_rows << " cols: " << num_cols << " result: " << res << "\n";
+    st.display(std::cout);
+    if (feasible) {
+        VERIFY(res == l_true);
+        for (unsigned i = 0; i < rows.size(); i++) {
+            double s = 0.0;
+            for (unsigned k = 0; k < rows[i].size(); k++)
+                s += coeffs[i][k] * ds.get_value(rows[i][k]);
+            VERIFY(fabs(s) < 1e-6);
+        }
+    }
+    else {
+        VERIFY(res == l_false);
+    }
+}
+
+/**
+   \brief Compare the simplex based arithmetic solver with and without the dual simplex
+   on random systems of linear inequalities over the reals.
+*/
+static void tst_theory_arith(unsigned seed, unsigned num_vars, unsigned num_ineqs, unsigned & num_feasible, unsigned & num_conflicts) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    random_gen r(seed);
+    expr_ref_vector xs(m), fmls(m);
+    for (unsigned i = 0; i < num_vars; i++)
+        xs.push_back(m.mk_fresh_const("x", a.mk_real()));
+    for (unsigned i = 0; i < num_ineqs; i++) {
+        expr_ref_vector ts(m);
+        for (unsigned j = 0; j < num_vars; j++) {
+            if (r(3) == 0)
+                ts.push_back(a.mk_mul(a.mk_numeral(rational(static_cast<int>(r(9)) - 4), false), xs.get(j)));
+        }
+        if (ts.empty())
+            continue;
+        expr * lhs = a.mk_add(ts.size(), ts.c_ptr());
+        expr * rhs = a.mk_numeral(rational(static_cast<int>(r(21)) - 5), false);
+        expr * f   = r(2) == 0 ? a.mk_le(lhs, rhs) : a.mk_lt(lhs, rhs);
+        // disjunctions force backtracking
+        if (r(4) == 0)
+            f = m.mk_or(f, a.mk_ge(xs.get(r(num_vars)), a.mk_numeral(rational(static_cast<int>(r(11))), false)));
+        fmls.push_back(f);
+    }
+    lbool res[2];
+    for (unsigned k = 0; k < 2; k++) {
+        smt_params p;
+        p.m_arith_mode = k == 0 ? AS_ARITH : AS_DUAL_SIMPLEX;
+        smt::kernel ker(m, p);
+        for (unsigned i = 0; i < fmls.size(); i++)
+            ker.assert_expr(fmls.get(i));
+        res[k] = ker.check();
+        if (res[k] == l_true) {
+            model_ref md;
+            ker.get_model(md);
+            check_model(*md, fmls);
+        }
+        if (k == 1) {
+            num_feasible  += get_stat(ker, "dual simplex certified feasible");
+            num_conflicts += get_stat(ker, "dual simplex certified conflicts");
+        }
+    }
+    VERIFY(res[0] == res[1]);
+}
+
+void tst_dual_simplex() {
+    for (unsigned seed = 0; seed < 10; seed++) {
+        tst_sparse_lu(seed, 10, 20);
+        tst_sparse_lu(seed, 100, 3);
+    }
+    tst_sparse_lu(17, 1000, 0);
+    for (unsigned seed = 0; seed < 10; seed++) {
+        tst_dual_simplex(seed, 30, 20, true);
+        tst_dual_simplex(seed, 30, 20, false);
+    }
+    tst_dual_simplex(3, 2000, 1500, true);
+    unsigned num_feasible = 0, num_conflicts = 0;
+    for (unsigned seed = 0; seed < 10; seed++)
+        tst_theory_arith(seed, 12, 30, num_feasible, num_conflicts);
+    // the floating point results are certified in exact arithmetic
+    VERIFY(num_feasible > 0);
+    VERIFY(num_conflicts > 0);
+}
@@ -216,6 +216,29 @@ int main(int argc, char ** argv) {
     TST(polynorm);
     TST(qe_arith);
     TST(expr_substitution);
+    TST(sat_assumptions);
+    TST(sat_card);
+    TST(sat_par);
+    TST(sat_drat);
+    TST(sat_restart);
+    TST(sat_vivify);
+    TST(bv_lazy_blast);
+    TST(cost_evaluator);
+    TST(mam_cache);
+    TST(smt_lemma_gc);
+    TST(smt_merge);
+    TST(smt_parallel);
+    TST(dual_simplex);
+    TST(arith_lazy_explain);
+    TST(branch_and_cut);
+    TST(branch_and_cut_bench);
+    TST(bv2sat);
+    TST(bv2sat_bench);
+    TST(aig_fraig);
+    TST(sat_max_conflicts);
+    TST(sls_word_evaluator);
+    TST(sls_threads);
+    TST(par_and_then);
 }
 
 void initialize_mam() {}
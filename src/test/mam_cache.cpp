@@ -0,0 +1,134 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    mam_cache.cpp
+
+Abstract:
+
+    Check that the E-matching code trees cached across push/pop are
+    reused, that the cache is flushed when it exceeds
+    smt.qi.max_cached_code_trees, that fresh contexts of the same
+    ast_manager copy the trees compiled by a previous context, and
+    that the results do not depend on the cache.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"arith_decl_plugin.h"
+#include"random_formulas.h"
+
+struct mam_cache_stats {
+    unsigned m_hits, m_flushes, m_cached;
+    mam_cache_stats():m_hits(0), m_flushes(0), m_cached(0) {}
+};
+
+static void tst_push_pop(unsigned max_cached, mam_cache_stats & st) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * int_s = a.mk_int();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), int_s, int_s), m);
+    expr_ref x(m.mk_var(0, int_s), m);
+    expr_ref fx(m.mk_app(f, x.get()), m);
+    symbol name("x");
+    unsigned num_qs = 6;
+    expr_ref_vector qs(m);
+    for (unsigned k = 0; k < num_qs; k++) {
+        expr * pat  = m.mk_pattern(to_app(fx.get()));
+        expr * body = a.mk_ge(fx, a.mk_numeral(rational(k), true));
+        qs.push_back(m.mk_forall(1, &int_s, &name, body, 0, symbol::null, symbol::null, 1, &pat));
+    }
+    expr_ref fc(m.mk_app(f, m.mk_const(symbol("c"), int_s)), m);
+
+    smt_params p;
+    p.m_qi_max_cached_code_trees = max_cached;
+    smt::kernel ker(m, p);
+    for (unsigned round = 0; round < 24; round++) {
+        unsigned k = round % num_qs;
+        ker.push();
+        // both quantifiers share the code tree of the label f, the tree is created for the first one.
+        ker.assert_expr(qs.get(k));
+        ker.assert_expr(qs.get((k + 1) % num_qs));
+        if (round % 2 == 0) {
+            ker.assert_expr(a.mk_lt(fc, a.mk_numeral(rational(k + 1), true)));
+            VERIFY(ker.check() == l_false);
+        }
+        else {
+            ker.assert_expr(a.mk_ge(fc, a.mk_numeral(rational(k + 2), true)));
+            VERIFY(ker.check() == l_true);
+        }
+        ker.pop(1);
+    }
+    st.m_hits    = get_stat(ker, "mam cache hits");
+    st.m_flushes = get_stat(ker, "mam cache flushes");
+    st.m_cached  = get_stat(ker, "mam cached trees");
+}
+
+// fresh contexts sharing an ast_manager copy the code trees instead of compiling them.
+static void tst_fresh_contexts(unsigned max_cached, unsigned & template_hits) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * int_s = a.mk_int();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), int_s, int_s), m);
+    func_decl_ref g(m.mk_func_decl(symbol("g"), int_s, int_s, int_s), m);
+    expr_ref x(m.mk_var(0, int_s), m), y(m.mk_var(1, int_s), m);
+    expr_ref fx(m.mk_app(f, x.get()), m), fy(m.mk_app(f, y.get()), m);
+    expr * gxy_args[2] = { x.get(), y.get() };
+    expr_ref gxy(m.mk_app(g, 2, gxy_args), m);
+    sort * sorts[2]    = { int_s, int_s };
+    symbol names[2]    = { symbol("x"), symbol("y") };
+    // forall x. f(x) >= 1 with the pattern f(x), and forall x, y. g(x, y) >= f(x) + f(y) 
+    // with the multi-pattern { g(x, y), f(x) }.
+    expr * pat1 = m.mk_pattern(to_app(fx.get()));
+    expr_ref q1(m.mk_forall(1, &int_s, names, a.mk_ge(fx, a.mk_numeral(rational(1), true)), 0, symbol::null, symbol::null, 1, &pat1), m);
+    app * mp_args[2] = { to_app(gxy.get()), to_app(fx.get()) };
+    expr * pat2 = m.mk_pattern(2, mp_args);
+    expr_ref q2(m.mk_forall(2, sorts, names, a.mk_ge(gxy, a.mk_add(fx, fy)), 0, symbol::null, symbol::null, 1, &pat2), m);
+    expr_ref c(m.mk_const(symbol("c"), int_s), m), d(m.mk_const(symbol("d"), int_s), m);
+    expr * gcd_args[2] = { c.get(), d.get() };
+    expr_ref gcd(m.mk_app(g, 2, gcd_args), m);
+    expr_ref fc(m.mk_app(f, c.get()), m), fd(m.mk_app(f, d.get()), m);
+
+    template_hits = 0;
+    for (unsigned k = 0; k < 8; k++) {
+        smt_params p;
+        p.m_qi_max_cached_code_trees = max_cached;
+        smt::kernel ker(m, p);
+        // the trees of the labels g and f are created for q2, q1 is inserted in the tree of f.
+        ker.assert_expr(q2);
+        ker.assert_expr(q1);
+        ker.assert_expr(a.mk_ge(fc, a.mk_numeral(rational(0), true)));
+        ker.assert_expr(a.mk_ge(fd, a.mk_numeral(rational(0), true)));
+        ker.assert_expr(a.mk_lt(gcd, a.mk_numeral(rational(k % 3), true)));
+        // g(c, d) >= f(c) + f(d) >= 2
+        VERIFY(ker.check() == l_false);
+        template_hits += get_stat(ker, "mam template hits");
+    }
+}
+
+void tst_mam_cache() {
+    mam_cache_stats st1, st2, st3;
+    tst_push_pop(0, st1);
+    VERIFY(st1.m_hits == 0 && st1.m_cached == 0);
+    tst_push_pop(1024, st2);
+    VERIFY(st2.m_hits > 0 && st2.m_flushes == 0);
+    // the trees of the 6 quantifiers do not fit in the cache.
+    tst_push_pop(4, st3);
+    VERIFY(st3.m_flushes > 0 && st3.m_cached <= 4);
+    unsigned template_hits;
+    tst_fresh_contexts(0, template_hits);
+    VERIFY(template_hits == 0);
+    tst_fresh_contexts(1024, template_hits);
+    // the 2 trees are compiled by the first context, and copied by the other 7.
+    VERIFY(template_hits == 14);
+}
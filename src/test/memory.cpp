@@ -55,6 +55,49 @@ void tst_memory() {
 }
 
 #else
+#include "util.h"
+#include "vector.h"
+
+// allocate and release small and large blocks from several threads.
+// Blocks are released by threads different from the ones that allocated them.
+static void tst_thread_alloc(unsigned num_threads) {
+    unsigned const num_blocks = 20000;
+    ptr_vector<char> blocks;
+    blocks.resize(num_threads * num_blocks, 0);
+    unsigned long long sz0 = memory::get_allocation_size();
+    #pragma omp parallel for
+    for (int t = 0; t < static_cast<int>(num_threads); t++) {
+        for (unsigned i = 0; i < num_blocks; i++) {
+            unsigned idx = t * num_blocks + i;
+            size_t sz = 1 + (idx * 7) % 300;
+            char * b = static_cast<char*>(memory::allocate(sz));
+            memset(b, static_cast<char>(idx), sz);
+            blocks[idx] = b;
+        }
+    }
+    #pragma omp parallel for
+    for (int t = 0; t < static_cast<int>(num_threads); t++) {
+        // thread t releases the blocks allocated by thread (t + 1) % num_threads
+        unsigned first = ((t + 1) % num_threads) * num_blocks;
+        for (unsigned i = 0; i < num_blocks; i++) {
+            unsigned idx = first + i;
+            size_t sz = 1 + (idx * 7) % 300;
+            for (size_t j = 0; j < sz; j++) {
+                VERIFY(blocks[idx][j] == static_cast<char>(idx));
+            }
+            memory::deallocate(blocks[idx]);
+            blocks[idx] = 0;
+        }
+    }
+    unsigned long long sz1 = memory::get_allocation_size();
+    // counters of each thread are synchronized with a delay
+    unsigned long long slack = (num_threads + 1) * 200000ull;
+    std::cout << "allocation size: " << sz0 << " -> " << sz1 << "\n";
+    VERIFY(sz1 <= sz0 + slack && sz0 <= sz1 + slack);
+}
+
 void tst_memory() {    
+    tst_thread_alloc(1);
+    tst_thread_alloc(4);
 }
 #endif
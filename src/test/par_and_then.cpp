@@ -0,0 +1,224 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    par_and_then.cpp
+
+Abstract:
+
+    Compare nested par_and_then splits, executed by the work-stealing
+    scheduler, with the sequential and_then on random clause sets, and
+    check the cancellation of the subgoals of a split and the bound on
+    the number of translated managers.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"tactical.h"
+#include"split_clause_tactic.h"
+#include"smt_tactic.h"
+#include"reg_decl_plugins.h"
+#include"arith_decl_plugin.h"
+#include"z3_omp.h"
+#include"random_formulas.h"
+
+static lbool check(tactic * t, ast_manager & m, expr_ref_vector const & fmls, expr_ref_vector const & tags) {
+    tactic_ref tac = t;
+    goal_ref g = alloc(goal, m, true, true);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        g->assert_expr(fmls.get(i), tags.get(i));
+    model_ref md;
+    proof_ref pr(m);
+    expr_dependency_ref core(m);
+    std::string reason;
+    lbool r = check_sat(*tac, g, md, pr, core, reason);
+    if (r == l_true)
+        check_model(*md.get(), fmls);
+    if (r == l_false) {
+        ptr_vector<expr> ts;
+        m.linearize(core, ts);
+        expr_ref_vector guarded(m), core_tags(m);
+        for (unsigned i = 0; i < fmls.size(); i++)
+            guarded.push_back(m.mk_implies(tags.get(i), fmls.get(i)));
+        core_tags.append(ts.size(), ts.c_ptr());
+        check_core(guarded, tags, core_tags);
+    }
+    return r;
+}
+
+static tactic * mk_nested_split(unsigned depth) {
+    if (depth == 0)
+        return mk_smt_tactic();
+    return par_and_then(mk_split_clause_tactic(), mk_nested_split(depth - 1));
+}
+
+static void tst_random_clauses(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    random_gen r(seed);
+    unsigned num_vars = 5;
+    expr_ref_vector xs(m), fmls(m), tags(m);
+    for (unsigned i = 0; i < num_vars; i++)
+        xs.push_back(m.mk_fresh_const("x", a.mk_int()));
+    unsigned num_clauses = 12 + r(20);
+    for (unsigned i = 0; i < num_clauses; i++) {
+        expr_ref_vector lits(m);
+        unsigned sz = 2 + r(2);
+        for (unsigned j = 0; j < sz; j++) {
+            unsigned x = r(num_vars), y = (x + 1 + r(num_vars - 1)) % num_vars;
+            // mostly negative bounds, so that about half of the instances are unsat.
+            int c = static_cast<int>(r(7)) - 5;
+            lits.push_back(a.mk_le(a.mk_sub(xs.get(x), xs.get(y)), a.mk_numeral(rational(c), true)));
+        }
+        fmls.push_back(m.mk_or(lits.size(), lits.c_ptr()));
+        tags.push_back(m.mk_fresh_const("s", m.mk_bool_sort()));
+    }
+    lbool r1 = check(and_then(mk_split_clause_tactic(), mk_smt_tactic()), m, fmls, tags);
+    lbool r2 = check(mk_nested_split(3), m, fmls, tags);
+    VERIFY(r1 == r2);
+}
+
+static ast_manager * g_root_manager = 0;
+static unsigned      g_num_managers = 0;  // translated managers with a live wait_tactic
+static unsigned      g_max_managers = 0;
+static unsigned      g_num_waiting  = 0;
+static unsigned      g_num_canceled = 0;
+static unsigned      g_num_timeouts = 0;
+
+/**
+   \brief Tactic for the subgoals of a split clause. It decides the subgoal
+   containing the literal "win" to be satisfiable. When m_wait is true, it
+   waits for the other subgoals to be canceled, otherwise it returns them
+   after 1ms.
+*/
+class wait_tactic : public tactic {
+    ast_manager & m;
+    bool          m_wait;
+    volatile bool m_cancel;
+
+    virtual void set_cancel(bool f) { m_cancel = f; }
+
+public:
+    wait_tactic(ast_manager & m, bool wait):m(m), m_wait(wait), m_cancel(false) {
+        #pragma omp critical (par_and_then_test)
+        {
+            if (&m != g_root_manager) {
+                g_num_managers++;
+                if (g_num_managers > g_max_managers)
+                    g_max_managers = g_num_managers;
+            }
+        }
+    }
+
+    virtual ~wait_tactic() {
+        #pragma omp critical (par_and_then_test)
+        {
+            if (&m != g_root_manager)
+                g_num_managers--;
+        }
+    }
+
+    virtual void operator()(goal_ref const & in, goal_ref_buffer & result, model_converter_ref & mc,
+                            proof_converter_ref & pc, expr_dependency_ref & core) {
+        mc = 0; pc = 0; core = 0;
+        for (unsigned i = 0; i < in->size(); i++) {
+            if (is_app(in->form(i)) && to_app(in->form(i))->get_decl()->get_name() == "win") {
+                in->reset();
+                result.push_back(in.get());
+                return;
+            }
+        }
+        if (!m_wait) {
+            z3_sleep(1);
+            result.push_back(in.get());
+            return;
+        }
+        #pragma omp critical (par_and_then_test)
+        {
+            g_num_waiting++;
+        }
+        for (unsigned i = 0; i < 5000 && !m_cancel; i++)
+            z3_sleep(1);
+        bool canceled = m_cancel;
+        #pragma omp critical (par_and_then_test)
+        {
+            if (canceled)
+                g_num_canceled++;
+            else
+                g_num_timeouts++;
+        }
+        if (canceled)
+            throw tactic_exception(TACTIC_CANCELED_MSG);
+        result.push_back(in.get());
+    }
+
+    virtual void cleanup() {}
+
+    virtual tactic * translate(ast_manager & m) { return alloc(wait_tactic, m, m_wait); }
+};
+
+static void split(ast_manager & m, expr_ref_vector const & lits, bool wait, goal_ref_buffer & result) {
+    tactic_ref t = par_and_then(mk_split_clause_tactic(), alloc(wait_tactic, m, wait));
+    goal_ref g = alloc(goal, m, false, false);
+    g->assert_expr(m.mk_or(lits.size(), lits.c_ptr()));
+    model_converter_ref mc;
+    proof_converter_ref pc;
+    expr_dependency_ref core(m);
+    (*t)(g, result, mc, pc, core);
+}
+
+static void tst_early_cancel() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    g_root_manager = &m;
+    g_num_waiting  = 0;
+    g_num_canceled = 0;
+    g_num_timeouts = 0;
+    // the other threads steal the first subgoal, which is satisfiable.
+    expr_ref_vector lits(m);
+    lits.push_back(m.mk_const(symbol("win"), m.mk_bool_sort()));
+    for (unsigned i = 0; i < 5; i++)
+        lits.push_back(m.mk_fresh_const("p", m.mk_bool_sort()));
+    goal_ref_buffer result;
+    split(m, lits, true, result);
+    VERIFY(is_decided_sat(result));
+    VERIFY(g_num_timeouts == 0);
+    VERIFY(g_num_canceled == g_num_waiting);
+    VERIFY(g_num_managers == 0);
+}
+
+static void tst_manager_bound(unsigned num_threads) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    g_root_manager = &m;
+    g_num_managers = 0;
+    g_max_managers = 0;
+    expr_ref_vector lits(m);
+    for (unsigned i = 0; i < 30; i++)
+        lits.push_back(m.mk_fresh_const("p", m.mk_bool_sort()));
+    goal_ref_buffer result;
+    omp_set_num_threads(num_threads);
+    split(m, lits, false, result);
+    VERIFY(result.size() == lits.size());
+    VERIFY(g_max_managers > 0);
+    // at most 4 translated managers per thread are alive.
+    VERIFY(g_max_managers <= 4 * num_threads);
+    VERIFY(g_num_managers == 0);
+}
+
+void tst_par_and_then() {
+    int num_threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    for (unsigned seed = 0; seed < 40; seed++)
+        tst_random_clauses(seed);
+    tst_early_cancel();
+    tst_manager_bound(1);
+    tst_manager_bound(2);
+    omp_set_num_threads(num_threads);
+}
@@ -0,0 +1,212 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    random_formulas.cpp
+
+Abstract:
+
+    Random problems, and checks of models and unsat cores, shared by the
+    tests of the solvers.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include<algorithm>
+#include"random_formulas.h"
+#include"arith_decl_plugin.h"
+#include"smt_kernel.h"
+#include"smt_params.h"
+
+void mk_random_3sat(random_gen & r, unsigned num_vars, unsigned num_clauses, clause_set & cs, unsigned first_var) {
+    SASSERT(first_var < num_vars);
+    for (unsigned i = 0; i < num_clauses; i++) {
+        sat::literal_vector c;
+        for (unsigned j = 0; j < 3; j++)
+            c.push_back(sat::literal(first_var + r(num_vars - first_var), r(2) == 0));
+        cs.push_back(c);
+    }
+}
+
+void add_clauses(sat::solver & s, unsigned num_vars, clause_set const & cs) {
+    for (unsigned i = 0; i < num_vars; i++)
+        s.mk_var(false, true);
+    for (unsigned i = 0; i < cs.size(); i++) {
+        sat::literal_vector c(cs[i]);
+        s.mk_clause(c.size(), c.c_ptr());
+    }
+}
+
+void check_model(sat::solver const & s, clause_set const & cs, sat::literal_vector const & asms) {
+    sat::model const & md = s.get_model();
+    for (unsigned i = 0; i < cs.size(); i++) {
+        bool sat = false;
+        for (unsigned j = 0; !sat && j < cs[i].size(); j++)
+            sat = sat::value_at(cs[i][j], md) == l_true;
+        VERIFY(sat);
+    }
+    for (unsigned i = 0; i < asms.size(); i++)
+        VERIFY(sat::value_at(asms[i], md) == l_true);
+}
+
+void check_core(sat::solver & s, sat::literal_vector const & asms) {
+    sat::literal_vector core(s.get_core());
+    for (unsigned i = 0; i < core.size(); i++)
+        VERIFY(std::find(asms.begin(), asms.end(), core[i]) != asms.end());
+    VERIFY(s.check(core.size(), core.c_ptr()) == l_false);
+}
+
+void mk_random_3sat(random_gen & r, expr_ref_vector const & atoms, unsigned num_clauses, expr_ref_vector & fmls) {
+    ast_manager & m = fmls.get_manager();
+    for (unsigned i = 0; i < num_clauses; i++) {
+        expr * lits[3];
+        for (unsigned j = 0; j < 3; j++) {
+            expr * l = atoms.get(r(atoms.size()));
+            lits[j]  = r(2) == 0 ? m.mk_not(l) : l;
+        }
+        fmls.push_back(m.mk_or(3, lits));
+    }
+}
+
+void mk_diff_atoms(random_gen & r, expr_ref_vector const & xs, unsigned num_atoms, int min_k, int max_k, expr_ref_vector & atoms) {
+    SASSERT(xs.size() > 1 && min_k <= max_k);
+    arith_util a(atoms.get_manager());
+    unsigned n = xs.size();
+    for (unsigned i = 0; i < num_atoms; i++) {
+        unsigned x = r(n), y = (x + 1 + r(n - 1)) % n;
+        int k = min_k + static_cast<int>(r(max_k - min_k + 1));
+        atoms.push_back(a.mk_le(a.mk_sub(xs.get(x), xs.get(y)), a.mk_numeral(rational(k), true)));
+    }
+}
+
+void check_model(model & md, expr_ref_vector const & fmls) {
+    ast_manager & m = fmls.get_manager();
+    for (unsigned i = 0; i < fmls.size(); i++) {
+        expr_ref v(m);
+        VERIFY(md.eval(fmls.get(i), v, true));
+        VERIFY(m.is_true(v));
+    }
+}
+
+void check_core(expr_ref_vector const & fmls, expr_ref_vector const & asms, expr_ref_vector const & core) {
+    ast_manager & m = fmls.get_manager();
+    for (unsigned i = 0; i < core.size(); i++)
+        VERIFY(asms.contains(core.get(i)));
+    smt_params p;
+    smt::kernel k(m, p);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        k.assert_expr(fmls.get(i));
+    VERIFY(k.check(core.size(), core.c_ptr()) == l_false);
+}
+
+static unsigned sum_stat(statistics & st, char const * key) {
+    // the same key is updated by every module that has the statistic.
+    unsigned r = 0;
+    for (unsigned i = 0; i < st.size(); i++) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), key) == 0)
+            r += st.get_uint_value(i);
+    }
+    return r;
+}
+
+unsigned get_stat(smt::kernel & k, char const * key) {
+    statistics st;
+    k.collect_statistics(st);
+    return sum_stat(st, key);
+}
+
+unsigned get_stat(sat::solver & s, char const * key) {
+    statistics st;
+    s.collect_statistics(st);
+    return sum_stat(st, key);
+}
+
+random_bv_gen::random_bv_gen(ast_manager & _m, unsigned seed, unsigned sz):
+    m(_m), m_util(_m), m_rand(seed), m_sz(sz), m_pinned(_m), m_vars(_m), m_bools(_m) {
+    for (unsigned i = 0; i < 4; i++)
+        m_vars.push_back(m.mk_fresh_const("x", m_util.mk_sort(sz)));
+    for (unsigned i = 0; i < 2; i++)
+        m_bools.push_back(m.mk_fresh_const("b", m.mk_bool_sort()));
+}
+
+expr * random_bv_gen::pin(expr * e) {
+    m_pinned.push_back(e);
+    return e;
+}
+
+expr * random_bv_gen::mk_binary(decl_kind k, expr * a, expr * b) {
+    return pin(m.mk_app(m_util.get_fid(), k, a, b));
+}
+
+expr * random_bv_gen::mk_op(expr * a, expr * b) {
+    // divisors are zero in some formulas, to cover the division by zero cases.
+    expr * d = m_rand(4) == 0 ? pin(m_util.mk_numeral(rational(0), m_sz)) : b;
+    expr * s = mk_binary(OP_BUREM_I, b, pin(m_util.mk_numeral(rational(m_sz + 2), m_sz)));
+    expr * args[2] = { a, b };
+    unsigned h = m_sz / 2;
+    switch (m_rand(20)) {
+    case 0:  return m_util.mk_bv_add(a, b);
+    case 1:  return m_util.mk_bv_sub(a, b);
+    case 2:  return m_util.mk_bv_mul(a, b);
+    case 3:  return m_util.mk_bv_neg(a);
+    case 4:  return m_util.mk_bv_not(a);
+    case 5:  return mk_binary(OP_BAND, a, b);
+    case 6:  return mk_binary(OP_BNAND, a, b);
+    case 7:  return m_util.mk_bv_xor(2, args);
+    case 8:  return mk_binary(OP_BUDIV_I, a, d);
+    case 9:  return mk_binary(OP_BUREM_I, a, d);
+    case 10: return mk_binary(OP_BSDIV_I, a, d);
+    case 11: return mk_binary(OP_BSMOD_I, a, d);
+    case 12: return mk_binary(OP_BSREM_I, a, d);
+    case 13: return m_util.mk_bv_shl(a, s);
+    case 14: return m_util.mk_bv_lshr(a, s);
+    case 15: return m_util.mk_bv_ashr(a, s);
+    case 16: return m_util.mk_concat(pin(m_util.mk_extract(h - 1, 0, a)), pin(m_util.mk_extract(m_sz - 1, h, b)));
+    case 17: return m_util.mk_sign_extend(m_sz - h, pin(m_util.mk_extract(h - 1, 0, a)));
+    case 18: return m_util.mk_zero_extend(h, pin(m_util.mk_extract(m_sz - 1, h, a)));
+    default: return m.mk_ite(mk_atom(0), a, b);
+    }
+}
+
+expr * random_bv_gen::mk_term(unsigned depth) {
+    if (depth == 0 || m_rand(4) == 0) {
+        if (m_rand(5) == 0)
+            return pin(m_util.mk_numeral(rational(m_rand(1 << 15)), m_sz));
+        return m_vars.get(m_rand(m_vars.size()));
+    }
+    expr * a = mk_term(depth - 1);
+    expr * b = mk_term(depth - 1);
+    return pin(mk_op(a, b));
+}
+
+expr * random_bv_gen::mk_atom(unsigned depth) {
+    if (depth == 0 && m_rand(3) == 0)
+        return m_bools.get(m_rand(m_bools.size()));
+    expr * a = mk_term(depth);
+    expr * b = mk_term(depth);
+    switch (m_rand(9)) {
+    case 0:  return pin(m.mk_eq(a, b));
+    case 1:  return pin(m.mk_not(pin(m.mk_eq(a, b))));
+    case 2:  return pin(m_util.mk_ule(a, b));
+    case 3:  return pin(m.mk_not(pin(m_util.mk_ule(a, b))));
+    case 4:  return pin(m_util.mk_sle(a, b));
+    case 5:  return pin(m.mk_not(pin(m_util.mk_sle(a, b))));
+    case 6:  return mk_binary(OP_SLT, a, b);
+    case 7:  return mk_binary(OP_ULT, a, b);
+    default: return mk_binary(OP_UGT, a, b);
+    }
+}
+
+expr * random_bv_gen::mk_formula(unsigned depth) {
+    expr * a = mk_atom(depth);
+    switch (m_rand(3)) {
+    case 0:  return pin(m.mk_or(a, mk_atom(depth)));
+    case 1:  return pin(m.mk_and(a, mk_atom(depth)));
+    default: return a;
+    }
+}
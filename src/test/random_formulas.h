@@ -0,0 +1,108 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    random_formulas.h
+
+Abstract:
+
+    Random problems, and checks of models and unsat cores, shared by the
+    tests of the solvers.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#ifndef _RANDOM_FORMULAS_H_
+#define _RANDOM_FORMULAS_H_
+
+#include"sat_solver.h"
+#include"model.h"
+#include"bv_decl_plugin.h"
+#include"util.h"
+
+namespace smt {
+    class kernel;
+}
+
+typedef vector<sat::literal_vector> clause_set;
+
+/**
+   \brief Add num_clauses random 3-SAT clauses over the variables first_var, ..., num_vars - 1 to cs.
+*/
+void mk_random_3sat(random_gen & r, unsigned num_vars, unsigned num_clauses, clause_set & cs, unsigned first_var = 0);
+
+/**
+   \brief Create the variables 0, ..., num_vars - 1 and the clauses cs in s.
+*/
+void add_clauses(sat::solver & s, unsigned num_vars, clause_set const & cs);
+
+/**
+   \brief Check that the model of s satisfies cs and asms.
+*/
+void check_model(sat::solver const & s, clause_set const & cs, sat::literal_vector const & asms);
+
+/**
+   \brief Check that the core of s is a subset of asms that is inconsistent with the clauses of s.
+*/
+void check_core(sat::solver & s, sat::literal_vector const & asms);
+
+/**
+   \brief Add num_clauses random clauses with three literals over atoms to fmls.
+*/
+void mk_random_3sat(random_gen & r, expr_ref_vector const & atoms, unsigned num_clauses, expr_ref_vector & fmls);
+
+/**
+   \brief Add num_atoms random difference logic atoms x - y <= k to atoms,
+   where x and y are distinct elements of xs, and min_k <= k <= max_k.
+*/
+void mk_diff_atoms(random_gen & r, expr_ref_vector const & xs, unsigned num_atoms, int min_k, int max_k, expr_ref_vector & atoms);
+
+/**
+   \brief Check that md satisfies fmls, using model completion.
+*/
+void check_model(model & md, expr_ref_vector const & fmls);
+
+/**
+   \brief Check that core is a subset of asms that is inconsistent with fmls.
+*/
+void check_core(expr_ref_vector const & fmls, expr_ref_vector const & asms, expr_ref_vector const & core);
+
+/**
+   \brief Generator of random bit-vector formulas of size sz over four bit-vector
+   constants and two Boolean constants. The divisors of the division operators are
+   zero in some formulas.
+*/
+class random_bv_gen {
+    ast_manager &   m;
+    bv_util         m_util;
+    random_gen      m_rand;
+    unsigned        m_sz;
+    expr_ref_vector m_pinned;
+
+    expr * pin(expr * e);
+    expr * mk_binary(decl_kind k, expr * a, expr * b);
+    expr * mk_op(expr * a, expr * b);
+
+public:
+    expr_ref_vector m_vars;
+    expr_ref_vector m_bools;
+
+    random_bv_gen(ast_manager & m, unsigned seed, unsigned sz);
+
+    expr * mk_term(unsigned depth);
+    expr * mk_atom(unsigned depth);
+    expr * mk_formula(unsigned depth);
+};
+
+/**
+   \brief Return the sum of the values of the statistic key of k, or 0 if k has no such statistic.
+*/
+unsigned get_stat(smt::kernel & k, char const * key);
+unsigned get_stat(sat::solver & s, char const * key);
+
+#endif /* _RANDOM_FORMULAS_H_ */
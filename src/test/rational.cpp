@@ -22,6 +22,9 @@ Revision History:
 #include"trace.h"
 #include"ext_gcd.h"
 #include"timeit.h"
+#ifdef _RATIONAL_THREAD_LOCAL_MANAGER
+#include<pthread.h>
+#endif
 
 static void tst1() {
     rational r1(1);
@@ -454,6 +457,89 @@ static void tst11(bool use_ints) {
 }
 
 
+// small integer fast paths at the boundaries of the machine word.
+static void tst12() {
+    rational max_int(INT_MAX);
+    rational min_int(INT_MIN);
+    rational r(max_int);
+    r += rational(1);
+    VERIFY(r == rational(static_cast<int64>(INT_MAX) + 1, rational::i64()));
+    VERIFY(r.is_big() && max_int < r && !(r < max_int));
+    r -= rational(1);
+    VERIFY(r == max_int);
+    r = min_int;
+    r -= rational(1);
+    VERIFY(r == rational(static_cast<int64>(INT_MIN) - 1, rational::i64()));
+    r = min_int;
+    r *= rational(-1);
+    VERIFY(r == rational(-static_cast<int64>(INT_MIN), rational::i64()));
+    r = max_int;
+    r *= max_int;
+    VERIFY(r == rational(static_cast<int64>(INT_MAX) * INT_MAX, rational::i64()));
+    VERIFY(rational(1, 3) < rational(1, 2) && !(rational(1, 2) < rational(1, 3)));
+    VERIFY(rational(-1, 2) < rational(-1, 3));
+    VERIFY(rational(2, 4) == rational(1, 2) && rational(1, 2) != rational(1));
+}
+
+// big numerals created by a thread and updated or deleted by other threads.
+static void tst13() {
+    unsigned const num_threads = 4;
+    unsigned const n = 200;
+    vector<rational> nums;
+    nums.resize(num_threads * n);
+    #pragma omp parallel for
+    for (int t = 0; t < static_cast<int>(num_threads); t++) {
+        rational big = power(rational(3), 100);
+        for (unsigned i = 0; i < n; i++) 
+            nums[t * n + i] = big + rational(i);
+    }
+    #pragma omp parallel for
+    for (int t = 0; t < static_cast<int>(num_threads); t++) {
+        unsigned first = ((t + 1) % num_threads) * n;
+        for (unsigned i = 0; i < n; i++) {
+            nums[first + i] *= rational(2);
+            nums[first + i] -= rational(2*i);
+        }
+    }
+    rational expected = power(rational(3), 100) * rational(2);
+    for (unsigned i = 0; i < nums.size(); i++) {
+        VERIFY(nums[i] == expected);
+    }
+}
+
+#ifdef _RATIONAL_THREAD_LOCAL_MANAGER
+// short lived threads update the numerals created by threads that already terminated.
+// The manager of a terminated thread is reused by the next thread.
+static rational * g_tst14_nums;
+
+static void * tst14_thread(void * arg) {
+    unsigned i = static_cast<unsigned>(reinterpret_cast<size_t>(arg));
+    g_tst14_nums[i] *= rational(2);
+    g_tst14_nums[i] += power(rational(3), 80);
+    return 0;
+}
+
+static void tst14() {
+    unsigned const num_threads = 4;
+    unsigned const num_rounds  = 50;
+    vector<rational> nums;
+    nums.resize(num_threads, rational(0));
+    g_tst14_nums = nums.c_ptr();
+    for (unsigned r = 0; r < num_rounds; r++) {
+        pthread_t threads[num_threads];
+        for (unsigned i = 0; i < num_threads; i++)
+            VERIFY(pthread_create(&threads[i], 0, tst14_thread, reinterpret_cast<void*>(static_cast<size_t>(i))) == 0);
+        for (unsigned i = 0; i < num_threads; i++)
+            VERIFY(pthread_join(threads[i], 0) == 0);
+    }
+    // nums[i] = 3^80 * (2^num_rounds - 1)
+    rational expected = power(rational(3), 80) * (power(rational(2), num_rounds) - rational(1));
+    for (unsigned i = 0; i < num_threads; i++) {
+        VERIFY(nums[i] == expected);
+    }
+}
+#endif
+
 void tst_rational() {
     TRACE("rational", tout << "starting rational test...\n";);
     std::cout << "sizeof(rational): " << sizeof(rational) << "\n";
@@ -478,4 +564,9 @@ void tst_rational() {
     tst11(true);
     tst10(true);
     tst10(false);
+    tst12();
+    tst13();
+#ifdef _RATIONAL_THREAD_LOCAL_MANAGER
+    tst14();
+#endif
 }
@@ -0,0 +1,106 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_assumptions.cpp
+
+Abstract:
+
+    Test SAT solver under assumptions, and the incremental SAT based solver.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"sat_solver.h"
+#include"inc_sat_solver.h"
+#include"bv_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"ast_pp.h"
+
+static bool in_core(sat::literal_vector const & core, sat::literal l) {
+    return std::find(core.begin(), core.end(), l) != core.end();
+}
+
+static void tst_sat_core() {
+    params_ref p;
+    sat::solver s(p, 0);
+    sat::bool_var x0 = s.mk_var(true);
+    sat::bool_var x1 = s.mk_var(true);
+    sat::bool_var x2 = s.mk_var(true);
+    sat::bool_var x3 = s.mk_var(true);
+    sat::literal l0(x0, false), l1(x1, false), l2(x2, false), l3(x3, false);
+    s.mk_clause(l0, l1);
+    s.mk_clause(~l0, l2);
+    VERIFY(s.check() == l_true);
+
+    sat::literal asms1[3] = { ~l1, ~l2, l3 };
+    VERIFY(s.check(3, asms1) == l_false);
+    sat::literal_vector const & core = s.get_core();
+    std::cout << "core: " << core << "\n";
+    VERIFY(in_core(core, ~l1));
+    VERIFY(in_core(core, ~l2));
+    VERIFY(!in_core(core, l3));
+
+    sat::literal asms2[1] = { ~l1 };
+    VERIFY(s.check(1, asms2) == l_true);
+    VERIFY(sat::value_at(l0, s.get_model()) == l_true);
+    VERIFY(sat::value_at(l2, s.get_model()) == l_true);
+
+    // contradictory assumptions
+    sat::literal asms3[2] = { l3, ~l3 };
+    VERIFY(s.check(2, asms3) == l_false);
+    VERIFY(s.get_core().size() == 2);
+
+    // clauses can be added between calls
+    s.mk_clause(~l2, l3);
+    sat::literal asms4[2] = { ~l1, ~l3 };
+    VERIFY(s.check(2, asms4) == l_false);
+    VERIFY(s.check() == l_true);
+}
+
+static void tst_inc_sat_solver() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    sort_ref s8(bv.mk_sort(8), m);
+    app_ref x(m.mk_const(symbol("x"), s8), m);
+    app_ref y(m.mk_const(symbol("y"), s8), m);
+    app_ref a(m.mk_const(symbol("a"), m.mk_bool_sort()), m);
+    app_ref b(m.mk_const(symbol("b"), m.mk_bool_sort()), m);
+    expr_ref x_eq_y(m.mk_eq(x, y), m);
+    expr_ref ult(bv.mk_ule(x, bv.mk_numeral(rational(3), 8)), m);
+    expr_ref y5(m.mk_eq(y, bv.mk_numeral(rational(5), 8)), m);
+
+    ref<solver> slv = mk_inc_sat_solver(m, params_ref());
+    slv->assert_expr(m.mk_implies(a, x_eq_y));
+    slv->assert_expr(ult);
+    VERIFY(slv->check_sat(0, 0) == l_true);
+
+    slv->push();
+    slv->assert_expr(y5);
+    expr * asms[2] = { a.get(), b.get() };
+    VERIFY(slv->check_sat(2, asms) == l_false);
+    ptr_vector<expr> core;
+    slv->get_unsat_core(core);
+    VERIFY(core.size() == 1 && core[0] == a.get());
+    VERIFY(slv->check_sat(0, 0) == l_true);
+    model_ref md;
+    slv->get_model(md);
+    expr_ref val(m);
+    VERIFY(md->eval(y->get_decl(), val));
+    std::cout << "y: " << mk_pp(val, m) << "\n";
+    slv->pop(1);
+
+    // y = 5 was popped
+    VERIFY(slv->check_sat(2, asms) == l_true);
+}
+
+void tst_sat_assumptions() {
+    tst_sat_core();
+    tst_inc_sat_solver();
+}
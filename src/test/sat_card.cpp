@@ -0,0 +1,123 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_card.cpp
+
+Abstract:
+
+    Test cardinality and pseudo-Boolean constraints in the SAT solver.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"sat_solver.h"
+#include"sat_card_extension.h"
+#include"goal2sat.h"
+#include"pb_decl_plugin.h"
+#include"reg_decl_plugins.h"
+
+// x_1 + ... + x_n >= k, and x_1 + ... + x_n <= k-1
+static void tst_card_conflict(unsigned n, unsigned k) {
+    params_ref p;
+    sat::solver s(p, 0);
+    sat::card_extension * card = alloc(sat::card_extension);
+    s.set_extension(card);
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < n; i++)
+        lits.push_back(sat::literal(s.mk_var(), false));
+    card->add_at_least(k, lits.size(), lits.c_ptr());
+    card->add_at_most(k - 1, lits.size(), lits.c_ptr());
+    VERIFY(s.check() == l_false);
+}
+
+// 2*x_0 + 3*x_1 + 4*x_2 + 5*x_3 >= 8, and x_i => ~x_j for i != j
+static void tst_pb_sat() {
+    params_ref p;
+    sat::solver s(p, 0);
+    sat::card_extension * card = alloc(sat::card_extension);
+    s.set_extension(card);
+    sat::literal_vector lits;
+    for (unsigned i = 0; i < 4; i++)
+        lits.push_back(sat::literal(s.mk_var(), false));
+    unsigned weights[4] = { 2, 3, 4, 5 };
+    card->add_at_least(8, lits.size(), lits.c_ptr(), weights);
+    VERIFY(s.check() == l_true);
+    unsigned sum = 0;
+    for (unsigned i = 0; i < 4; i++)
+        if (sat::value_at(lits[i], s.get_model()) == l_true)
+            sum += weights[i];
+    VERIFY(sum >= 8);
+    // at most two of them can be true
+    card->add_at_most(2, lits.size(), lits.c_ptr());
+    VERIFY(s.check() == l_true);
+    // 3 + 5 and 4 + 5 are the only remaining solutions
+    s.mk_clause(~lits[1], ~lits[3]);
+    VERIFY(s.check() == l_true);
+    VERIFY(sat::value_at(lits[2], s.get_model()) == l_true);
+    VERIFY(sat::value_at(lits[3], s.get_model()) == l_true);
+    s.mk_clause(~lits[2], ~lits[3]);
+    VERIFY(s.check() == l_false);
+}
+
+// pigeon hole problem using cardinality atoms in goal2sat.
+static void tst_pigeon_hole(unsigned n) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    pb_util pb(m);
+    goal g(m, true, false);
+    expr_ref_vector ps(m);
+    for (unsigned i = 0; i <= n; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            std::stringstream strm;
+            strm << "p_" << i << "_" << j;
+            ps.push_back(m.mk_const(symbol(strm.str().c_str()), m.mk_bool_sort()));
+        }
+    }
+    // every pigeon is in at least one hole
+    for (unsigned i = 0; i <= n; i++)
+        g.assert_expr(pb.mk_at_least_k(n, ps.c_ptr() + i*n, 1));
+    // every hole has at most one pigeon
+    for (unsigned j = 0; j < n; j++) {
+        ptr_buffer<expr> hole;
+        for (unsigned i = 0; i <= n; i++)
+            hole.push_back(ps.get(i*n + j));
+        g.assert_expr(pb.mk_at_most_k(hole.size(), hole.c_ptr(), 1));
+    }
+    params_ref p;
+    sat::solver s(p, 0);
+    atom2bool_var map(m);
+    goal2sat g2s;
+    g2s(g, p, s, map);
+    VERIFY(s.get_extension() != 0);
+    VERIFY(s.check() == l_false);
+    // a nested constraint: at most n-1 of the pigeons 0..n-1 are in hole 0 or
+    // not at most one pigeon is in hole 0.
+    goal g2(m, true, false);
+    ptr_buffer<expr> hole;
+    for (unsigned i = 0; i < n; i++)
+        hole.push_back(ps.get(i*n));
+    g2.assert_expr(m.mk_or(pb.mk_at_least_k(hole.size(), hole.c_ptr(), n),
+                           m.mk_not(pb.mk_at_most_k(hole.size(), hole.c_ptr(), 1))));
+    sat::solver s2(p, 0);
+    atom2bool_var map2(m);
+    g2s(g2, p, s2, map2);
+    VERIFY(s2.check() == l_true);
+    unsigned num_true = 0;
+    for (unsigned i = 0; i < n; i++)
+        if (sat::value_at(map2.to_bool_var(hole[i]), s2.get_model()) == l_true)
+            num_true++;
+    VERIFY(num_true >= 2);
+}
+
+void tst_sat_card() {
+    tst_card_conflict(5, 3);
+    tst_card_conflict(10, 1);
+    tst_pb_sat();
+    tst_pigeon_hole(5);
+}
@@ -0,0 +1,205 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Test DRAT proofs produced by the SAT solver.
+    The proofs are checked using a naive forward DRUP checker.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include<fstream>
+#include<algorithm>
+#include"random_formulas.h"
+
+struct drat_step {
+    bool                m_del;
+    sat::literal_vector m_lits;
+};
+
+static void read_text_proof(char const * file_name, vector<drat_step> & steps) {
+    std::ifstream in(file_name);
+    std::string tok;
+    drat_step step;
+    step.m_del = false;
+    while (in >> tok) {
+        if (tok == "d") {
+            step.m_del = true;
+            continue;
+        }
+        int l = atoi(tok.c_str());
+        if (l == 0) {
+            steps.push_back(step);
+            step.m_del = false;
+            step.m_lits.reset();
+        }
+        else {
+            step.m_lits.push_back(sat::literal(l > 0 ? l : -l, l < 0));
+        }
+    }
+}
+
+static void read_binary_proof(char const * file_name, vector<drat_step> & steps) {
+    std::ifstream in(file_name, std::ios::binary);
+    int c;
+    while ((c = in.get()) != EOF) {
+        VERIFY(c == 'a' || c == 'd');
+        drat_step step;
+        step.m_del = c == 'd';
+        while (true) {
+            unsigned u = 0, shift = 0;
+            do {
+                c = in.get();
+                VERIFY(c != EOF);
+                u |= (c & 127) << shift;
+                shift += 7;
+            }
+            while (c & 128);
+            if (u == 0)
+                break;
+            step.m_lits.push_back(sat::literal(u / 2, (u & 1) != 0));
+        }
+        steps.push_back(step);
+    }
+}
+
+// return true if unit propagation on cs and the negation of c produces a conflict.
+static bool is_rup(clause_set const & cs, sat::literal_vector const & c, unsigned num_vars) {
+    svector<lbool> value(2 * num_vars, l_undef);
+    for (unsigned i = 0; i < c.size(); i++) {
+        if (value[c[i].index()] == l_false)
+            return true; // tautology
+        value[c[i].index()] = l_false;
+        value[(~c[i]).index()] = l_true;
+    }
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (unsigned i = 0; i < cs.size(); i++) {
+            sat::literal_vector const & d = cs[i];
+            unsigned num_undef = 0;
+            sat::literal unit;
+            bool sat = false;
+            for (unsigned j = 0; !sat && j < d.size(); j++) {
+                lbool v = value[d[j].index()];
+                if (v == l_true)
+                    sat = true;
+                else if (v == l_undef) {
+                    num_undef++;
+                    unit = d[j];
+                }
+            }
+            if (sat || num_undef > 1)
+                continue;
+            if (num_undef == 0)
+                return true;
+            value[unit.index()] = l_true;
+            value[(~unit).index()] = l_false;
+            progress = true;
+        }
+    }
+    return false;
+}
+
+static void check_proof(clause_set cs, unsigned num_vars, vector<drat_step> & steps) {
+    for (unsigned i = 0; i < cs.size(); i++)
+        std::sort(cs[i].begin(), cs[i].end());
+    VERIFY(!steps.empty());
+    unsigned num_del = 0;
+    for (unsigned i = 0; i < steps.size(); i++) {
+        sat::literal_vector & c = steps[i].m_lits;
+        std::sort(c.begin(), c.end());
+        if (steps[i].m_del) {
+            unsigned j = 0;
+            for (; j < cs.size(); j++) {
+                if (cs[j].size() == c.size() && std::equal(c.begin(), c.end(), cs[j].begin()))
+                    break;
+            }
+            VERIFY(j < cs.size()); // deleted clauses must be in the clause set
+            if (j + 1 < cs.size())
+                cs[j] = cs.back();
+            cs.pop_back();
+            num_del++;
+        }
+        else {
+            VERIFY(is_rup(cs, c, num_vars));
+            cs.push_back(c);
+        }
+    }
+    // the proof ends with the empty clause
+    VERIFY(!steps.back().m_del && steps.back().m_lits.empty());
+    std::cout << "proof steps: " << steps.size() << " deletions: " << num_del << "\n";
+}
+
+static void tst_drat(clause_set const & cs, unsigned num_vars, bool binary) {
+    char const * file_name = binary ? "sat_drat_test.bdrat" : "sat_drat_test.drat";
+    {
+        params_ref p;
+        p.set_sym("drat.file", symbol(file_name));
+        p.set_bool("drat.binary", binary);
+        // trigger simplification, inprocessing and garbage collection early
+        p.set_uint("burst_search", 10);
+        p.set_uint("restart.initial", 10);
+        p.set_uint("gc.initial", 50);
+        p.set_uint("gc.increment", 10);
+        p.set_uint("inprocess.interval", 20);
+        p.set_double("inprocess.ratio", 1.0);
+        sat::solver s(p, 0);
+        // variable 0 is not used, as in DIMACS files
+        add_clauses(s, num_vars, cs);
+        VERIFY(s.check() == l_false);
+    }
+    vector<drat_step> steps;
+    if (binary)
+        read_binary_proof(file_name, steps);
+    else
+        read_text_proof(file_name, steps);
+    check_proof(cs, num_vars, steps);
+    remove(file_name);
+}
+
+// n+1 pigeons do not fit in n holes
+static void mk_php(unsigned n, clause_set & cs, unsigned & num_vars) {
+    num_vars = (n + 1) * n + 1;
+    for (unsigned i = 0; i <= n; i++) {
+        sat::literal_vector c;
+        for (unsigned j = 0; j < n; j++)
+            c.push_back(sat::literal(1 + i * n + j, false));
+        cs.push_back(c);
+    }
+    for (unsigned j = 0; j < n; j++) {
+        for (unsigned i1 = 0; i1 <= n; i1++) {
+            for (unsigned i2 = i1 + 1; i2 <= n; i2++) {
+                sat::literal_vector c;
+                c.push_back(sat::literal(1 + i1 * n + j, true));
+                c.push_back(sat::literal(1 + i2 * n + j, true));
+                cs.push_back(c);
+            }
+        }
+    }
+}
+
+void tst_sat_drat() {
+    clause_set cs;
+    unsigned num_vars;
+    mk_php(5, cs, num_vars);
+    tst_drat(cs, num_vars, false);
+    tst_drat(cs, num_vars, true);
+    random_gen r(0);
+    for (unsigned k = 0; k < 10; k++) {
+        cs.reset();
+        num_vars = 50;
+        // far above the phase transition, the problems are unsatisfiable
+        mk_random_3sat(r, num_vars, 6 * num_vars, cs, 1);
+        tst_drat(cs, num_vars, k % 2 == 0);
+    }
+}
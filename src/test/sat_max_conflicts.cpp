@@ -0,0 +1,57 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_max_conflicts.cpp
+
+Abstract:
+
+    Check that sat::solver::check gives up right after the burst search,
+    without simplifying the problem, when sat.max_conflicts is already
+    exhausted.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"random_formulas.h"
+
+static lbool check(unsigned max_conflicts, unsigned & num_elim) {
+    random_gen r(0);
+    unsigned num_vars = 200;
+    clause_set cs;
+    mk_random_3sat(r, num_vars, (num_vars * 426) / 100, cs);
+    // num_vars is equivalent to 0, and eliminated by the scc pass of the simplifier.
+    sat::literal_vector c;
+    c.push_back(sat::literal(num_vars, true));
+    c.push_back(sat::literal(0, false));
+    cs.push_back(c);
+    c[0].neg();
+    c[1].neg();
+    cs.push_back(c);
+    params_ref p;
+    p.set_uint("burst_search", 100);
+    p.set_uint("max_conflicts", max_conflicts);
+    sat::solver s(p, 0);
+    add_clauses(s, num_vars + 1, cs);
+    lbool res = s.check();
+    if (res == l_true)
+        check_model(s, cs, sat::literal_vector());
+    VERIFY(max_conflicts == UINT_MAX || get_stat(s, "conflicts") <= max_conflicts + 1);
+    num_elim = get_stat(s, "elim bool vars");
+    return res;
+}
+
+void tst_sat_max_conflicts() {
+    unsigned num_elim = 0;
+    VERIFY(check(10, num_elim) == l_undef);
+    VERIFY(num_elim == 0);
+    // the budget is exhausted after the simplification.
+    VERIFY(check(150, num_elim) == l_undef);
+    VERIFY(num_elim > 0);
+    VERIFY(check(UINT_MAX, num_elim) != l_undef);
+}
@@ -0,0 +1,145 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_par.cpp
+
+Abstract:
+
+    Test the parallel portfolio of SAT solvers, and cube and conquer.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include<sstream>
+#include"random_formulas.h"
+#include"dimacs.h"
+
+static lbool check(unsigned num_threads, unsigned num_vars, clause_set & cs, sat::literal_vector const & asms, unsigned cube_depth = 0) {
+    params_ref p;
+    p.set_uint("threads", num_threads);
+    p.set_uint("lookahead.cube_depth", cube_depth);
+    sat::solver s(p, 0);
+    add_clauses(s, num_vars, cs);
+    lbool r = s.check(asms.size(), asms.c_ptr());
+    if (r == l_true)
+        check_model(s, cs, asms);
+    if (r == l_false && !asms.empty())
+        check_core(s, asms);
+    return r;
+}
+
+static void tst_random_3sat(unsigned seed, unsigned num_vars) {
+    random_gen r(seed);
+    clause_set cs;
+    // close to the phase transition
+    mk_random_3sat(r, num_vars, (num_vars * 426) / 100, cs);
+    sat::literal_vector asms;
+    lbool r1 = check(1, num_vars, cs, asms);
+    lbool r4 = check(4, num_vars, cs, asms);
+    std::cout << "seed: " << seed << " result: " << r1 << "\n";
+    VERIFY(r1 == r4);
+    for (unsigned i = 0; i < 5; i++)
+        asms.push_back(sat::literal(r(num_vars), r(2) == 0));
+    r1 = check(1, num_vars, cs, asms);
+    r4 = check(4, num_vars, cs, asms);
+    VERIFY(r1 == r4);
+}
+
+static void tst_cube(unsigned seed, unsigned num_vars) {
+    random_gen r(seed);
+    clause_set cs;
+    mk_random_3sat(r, num_vars, (num_vars * 426) / 100, cs);
+    sat::literal_vector asms;
+    lbool r1 = check(1, num_vars, cs, asms);
+    VERIFY(r1 == check(1, num_vars, cs, asms, 3));
+    VERIFY(r1 == check(4, num_vars, cs, asms, 5));
+
+    // the cubes partition the search space.
+    params_ref p;
+    p.set_uint("lookahead.cube_depth", 4);
+    sat::solver s(p, 0);
+    add_clauses(s, num_vars, cs);
+    vector<sat::literal_vector> cubes;
+    lbool r2 = s.cube(cubes);
+    std::cout << "seed: " << seed << " cubes: " << cubes.size() << "\n";
+    VERIFY(cubes.size() <= 16);
+    VERIFY(r2 == l_undef || r1 == l_false);
+    bool found = false;
+    for (unsigned i = 0; i < cubes.size(); i++) {
+        VERIFY(cubes[i].size() <= 4);
+        if (check(1, num_vars, cs, cubes[i]) == l_true)
+            found = true;
+    }
+    VERIFY(found == (r1 == l_true));
+}
+
+// variable 0 is not used by DIMACS, and must not occur in a cube.
+static void tst_dimacs_cube(unsigned seed, unsigned num_vars) {
+    random_gen r(seed);
+    std::stringstream in;
+    in << "p cnf " << num_vars << " " << 4 * num_vars << "\n";
+    for (unsigned i = 0; i < 4 * num_vars; i++) {
+        for (unsigned j = 0; j < 3; j++)
+            in << (r(2) == 0 ? "-" : "") << (r(num_vars) + 1) << " ";
+        in << "0\n";
+    }
+    params_ref p;
+    p.set_uint("lookahead.cube_depth", 6);
+    sat::solver s(p, 0);
+    parse_dimacs(in, s);
+    vector<sat::literal_vector> cubes;
+    s.cube(cubes);
+    for (unsigned i = 0; i < cubes.size(); i++) {
+        for (unsigned j = 0; j < cubes[i].size(); j++)
+            VERIFY(cubes[i][j].var() != 0);
+    }
+}
+
+// the portfolio does not clear a cancel requested by the caller.
+static void tst_cancel(unsigned seed, unsigned num_vars, unsigned cube_depth) {
+    random_gen r(seed);
+    clause_set cs;
+    mk_random_3sat(r, num_vars, (num_vars * 426) / 100, cs);
+    params_ref p;
+    p.set_uint("threads", 4);
+    p.set_uint("lookahead.cube_depth", cube_depth);
+    sat::solver s(p, 0);
+    add_clauses(s, num_vars, cs);
+    s.set_cancel(true);
+    try {
+        // a copy may still finish before it is canceled.
+        s.check();
+    }
+    catch (sat::solver_exception &) {
+    }
+    p.set_uint("threads", 1);
+    p.set_uint("lookahead.cube_depth", 0);
+    s.updt_params(p);
+    bool canceled = false;
+    try {
+        s.check();
+    }
+    catch (sat::solver_exception &) {
+        canceled = true;
+    }
+    VERIFY(canceled);
+    s.set_cancel(false);
+    VERIFY(s.check() != l_undef);
+}
+
+void tst_sat_par() {
+    for (unsigned seed = 1; seed <= 8; seed++)
+        tst_random_3sat(seed, 150);
+    for (unsigned seed = 1; seed <= 8; seed++)
+        tst_cube(seed, 120);
+    for (unsigned seed = 1; seed <= 8; seed++)
+        tst_dimacs_cube(seed, 20);
+    tst_cancel(1, 120, 0);
+    tst_cancel(1, 120, 4);
+}
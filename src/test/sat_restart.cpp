@@ -0,0 +1,57 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_restart.cpp
+
+Abstract:
+
+    Test ema restarts and the tiered learned clause database.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"statistics.h"
+#include"random_formulas.h"
+
+static lbool check(params_ref const & p, unsigned num_vars, clause_set & cs) {
+    sat::solver s(p, 0);
+    add_clauses(s, num_vars, cs);
+    lbool r = s.check();
+    if (r == l_true)
+        check_model(s, cs, sat::literal_vector());
+    statistics st;
+    s.collect_statistics(st);
+    st.display(std::cout);
+    return r;
+}
+
+static void tst_random_3sat(unsigned seed, unsigned num_vars) {
+    random_gen r(seed);
+    clause_set cs;
+    // close to the phase transition
+    mk_random_3sat(r, num_vars, (num_vars * 426) / 100, cs);
+    params_ref p;
+    lbool r1 = check(p, num_vars, cs);
+    // small thresholds, so that restart blocking and gc are exercised.
+    p.set_sym("restart", symbol("ema"));
+    p.set_uint("restart.initial", 20);
+    p.set_uint("restart.blocking.min", 100);
+    p.set_sym("gc", symbol("tiered"));
+    p.set_uint("gc.initial", 100);
+    p.set_uint("gc.increment", 20);
+    p.set_uint("gc.k", 2);
+    lbool r2 = check(p, num_vars, cs);
+    std::cout << "seed: " << seed << " result: " << r1 << "\n";
+    VERIFY(r1 == r2);
+}
+
+void tst_sat_restart() {
+    for (unsigned seed = 1; seed <= 10; seed++)
+        tst_random_3sat(seed, 200);
+}
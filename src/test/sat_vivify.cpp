@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.cpp
+
+Abstract:
+
+    Check clause vivification in the inprocessing rounds of the SAT solver:
+    the results do not change, and the clauses left in the solver, in
+    particular the strengthened ones, are implied by the input clauses.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"random_formulas.h"
+
+/**
+   \brief Check that the input clauses cs imply the clause lits.
+*/
+static void check_implied(unsigned num_vars, clause_set const & cs, unsigned num_lits, sat::literal const * lits) {
+    sat::solver s(params_ref(), 0);
+    add_clauses(s, num_vars, cs);
+    sat::literal_vector asms;
+    for (unsigned i = 0; i < num_lits; i++)
+        asms.push_back(~lits[i]);
+    VERIFY(s.check(asms.size(), asms.c_ptr()) == l_false);
+}
+
+static void check_implied(unsigned num_vars, clause_set const & cs, sat::clause * const * begin, sat::clause * const * end) {
+    for (sat::clause * const * it = begin; it != end; ++it) {
+        sat::clause const & c = *(*it);
+        sat::literal_vector lits;
+        for (unsigned i = 0; i < c.size(); i++)
+            lits.push_back(c[i]);
+        check_implied(num_vars, cs, lits.size(), lits.c_ptr());
+    }
+}
+
+static lbool check(params_ref const & p, unsigned num_vars, clause_set const & cs, unsigned & num_vivified) {
+    sat::solver s(p, 0);
+    add_clauses(s, num_vars, cs);
+    lbool r = s.check();
+    if (r == l_true)
+        check_model(s, cs, sat::literal_vector());
+    num_vivified += get_stat(s, "vivify literals");
+    check_implied(num_vars, cs, s.begin_clauses(), s.end_clauses());
+    check_implied(num_vars, cs, s.begin_learned(), s.end_learned());
+    svector<sat::solver::bin_clause> bins;
+    s.collect_bin_clauses(bins, true);
+    s.collect_bin_clauses(bins, false);
+    for (unsigned i = 0; i < bins.size(); i++) {
+        sat::literal lits[2] = { bins[i].first, bins[i].second };
+        check_implied(num_vars, cs, 2, lits);
+    }
+    return r;
+}
+
+static void tst_random_3sat(unsigned seed, unsigned num_vars, unsigned & num_vivified) {
+    random_gen r(seed);
+    clause_set cs;
+    mk_random_3sat(r, num_vars, (num_vars * 426) / 100, cs);
+    params_ref p;
+    p.set_uint("inprocess.interval", 0);
+    unsigned num_vivified0 = 0;
+    lbool r1 = check(p, num_vars, cs, num_vivified0);
+    VERIFY(num_vivified0 == 0);
+    // frequent inprocessing rounds with a large budget.
+    p.set_uint("inprocess.interval", 20);
+    p.set_double("inprocess.ratio", 1.0);
+    lbool r2 = check(p, num_vars, cs, num_vivified);
+    VERIFY(r1 != l_undef);
+    VERIFY(r1 == r2);
+}
+
+void tst_sat_vivify() {
+    unsigned num_vivified = 0;
+    for (unsigned seed = 1; seed <= 10; seed++)
+        tst_random_3sat(seed, 100, num_vivified);
+    VERIFY(num_vivified > 0);
+}
@@ -0,0 +1,107 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    sls_threads.cpp
+
+Abstract:
+
+    Run the SLS tactic with several walkers (sls.threads > 1) on random
+    bit-vector formulas with a planted solution, and check the model of
+    the winning walker. Check that walkers reseed from the shared best
+    assignment on an unsatisfiable formula.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"sls_tactic.h"
+#include"tactical.h"
+#include"reg_decl_plugins.h"
+#include"random_formulas.h"
+
+static lbool check(ast_manager & m, expr_ref_vector const & fmls, unsigned seed, unsigned restarts, statistics & st) {
+    params_ref p;
+    p.set_uint("threads", 4);
+    p.set_uint("random_seed", seed);
+    p.set_uint("restarts", restarts);
+    tactic_ref t = mk_qfbv_sls_tactic(m, p);
+    goal_ref g = alloc(goal, m, true, false);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        g->assert_expr(fmls.get(i));
+    model_ref md;
+    proof_ref pr(m);
+    expr_dependency_ref core(m);
+    std::string reason;
+    lbool r = check_sat(*t, g, md, pr, core, reason);
+    if (r == l_true)
+        check_model(*md.get(), fmls);
+    t->collect_statistics(st);
+    return r;
+}
+
+/**
+   \brief Add to fmls num_fmls formulas over the constants of gen that are made true by a random assignment.
+*/
+static void mk_planted(ast_manager & m, random_bv_gen & gen, unsigned seed, unsigned sz, unsigned num_fmls, expr_ref_vector & fmls) {
+    bv_util bv(m);
+    random_gen r(seed);
+    model planted(m);
+    for (unsigned i = 0; i < gen.m_vars.size(); i++)
+        planted.register_decl(to_app(gen.m_vars.get(i))->get_decl(), bv.mk_numeral(rational(r(1 << 15)), sz));
+    for (unsigned i = 0; i < gen.m_bools.size(); i++)
+        planted.register_decl(to_app(gen.m_bools.get(i))->get_decl(), r(2) == 0 ? m.mk_true() : m.mk_false());
+    for (unsigned i = 0; i < num_fmls; i++) {
+        expr_ref f(gen.mk_formula(2), m), v(m);
+        VERIFY(planted.eval(f, v, true));
+        fmls.push_back(m.is_true(v) ? f.get() : m.mk_not(f));
+    }
+}
+
+static bool tst_planted(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    unsigned sz = 16;
+    random_bv_gen gen(m, seed, sz);
+    expr_ref_vector fmls(m);
+    mk_planted(m, gen, seed, sz, 8, fmls);
+    statistics st;
+    return check(m, fmls, seed, 100, st) == l_true;
+}
+
+static unsigned tst_reseed(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    unsigned sz = 16;
+    random_bv_gen gen(m, seed, sz);
+    expr_ref_vector fmls(m);
+    // the walkers reach different scores on the satisfiable part.
+    mk_planted(m, gen, seed, sz, 20, fmls);
+    // no square is 3 modulo 4.
+    expr_ref x(m.mk_const(symbol("x"), bv.mk_sort(8)), m);
+    fmls.push_back(m.mk_eq(bv.mk_bv_urem(bv.mk_bv_mul(x, x), bv.mk_numeral(rational(4), 8)), bv.mk_numeral(rational(3), 8)));
+    statistics st;
+    VERIFY(check(m, fmls, seed, 20, st) == l_undef);
+    for (unsigned i = 0; i < st.size(); i++) {
+        if (st.is_uint(i) && strcmp(st.get_key(i), "sls reseeds") == 0)
+            return st.get_uint_value(i);
+    }
+    return 0;
+}
+
+void tst_sls_threads() {
+    unsigned num_sat = 0;
+    for (unsigned seed = 0; seed < 20; seed++)
+        if (tst_planted(seed))
+            num_sat++;
+    VERIFY(num_sat > 0);
+    unsigned num_reseeds = 0;
+    for (unsigned seed = 0; seed < 4; seed++)
+        num_reseeds += tst_reseed(seed);
+    VERIFY(num_reseeds > 0);
+}
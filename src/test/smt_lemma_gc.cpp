@@ -0,0 +1,98 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_lemma_gc.cpp
+
+Abstract:
+
+    Check the glue based tiered lemma garbage collection of smt::context
+    (smt.lemma_gc.tiered=true) on incremental random 3-SAT problems:
+    lemmas are deleted, and the results agree with the default garbage
+    collection.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"random_formulas.h"
+
+static void check(smt::kernel & k, expr_ref_vector const & fmls, expr_ref_vector const & asms, svector<lbool> & rs) {
+    ast_manager & m = fmls.get_manager();
+    lbool r = k.check(asms.size(), asms.c_ptr());
+    if (r == l_true) {
+        model_ref md;
+        k.get_model(md);
+        check_model(*md, fmls);
+        check_model(*md, asms);
+    }
+    if (r == l_false) {
+        expr_ref_vector core(m);
+        for (unsigned i = 0; i < k.get_unsat_core_size(); i++)
+            core.push_back(k.get_unsat_core_expr(i));
+        check_core(fmls, asms, core);
+    }
+    rs.push_back(r);
+}
+
+/**
+   \brief Solve a sequence of queries with random assumptions, and return the results
+   in rs and the number of deleted clauses in num_del.
+*/
+static void tst_queries(unsigned seed, bool tiered, svector<lbool> & rs, unsigned & num_del) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_gen r(seed);
+    unsigned num_atoms = 150;
+    expr_ref_vector atoms(m), fmls(m);
+    for (unsigned i = 0; i < num_atoms; i++)
+        atoms.push_back(m.mk_fresh_const("p", m.mk_bool_sort()));
+    // below the phase transition, so that most of the queries are satisfiable.
+    mk_random_3sat(r, atoms, (num_atoms * 400) / 100, fmls);
+    smt_params p;
+    p.m_lemma_gc_tiered     = tiered;
+    p.m_lemma_gc_initial    = 100;
+    p.m_recent_lemmas_size  = 10;
+    p.m_lemma_gc_core_glue  = 2;
+    p.m_lemma_gc_tier2_glue = 4;
+    smt::kernel k(m, p);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        k.assert_expr(fmls.get(i));
+    for (unsigned i = 0; i < 30; i++) {
+        expr_ref_vector asms(m);
+        svector<unsigned> idxs;
+        for (unsigned j = 0; j < 6; j++) {
+            // distinct atoms, an assumption and its negation are not reported together in the core.
+            unsigned idx = r(num_atoms);
+            if (idxs.contains(idx))
+                continue;
+            idxs.push_back(idx);
+            expr * l = atoms.get(idx);
+            asms.push_back(r(2) == 0 ? m.mk_not(l) : l);
+        }
+        check(k, fmls, asms, rs);
+    }
+    num_del = get_stat(k, "del clause");
+}
+
+void tst_smt_lemma_gc() {
+    unsigned num_del_tiered = 0;
+    for (unsigned seed = 0; seed < 4; seed++) {
+        svector<lbool> rs1, rs2;
+        unsigned num_del1 = 0, num_del2 = 0;
+        tst_queries(seed, false, rs1, num_del1);
+        tst_queries(seed, true, rs2, num_del2);
+        VERIFY(rs1.size() == rs2.size());
+        for (unsigned i = 0; i < rs1.size(); i++)
+            VERIFY(rs1[i] == rs2[i]);
+        num_del_tiered += num_del2;
+    }
+    VERIFY(num_del_tiered > 0);
+}
@@ -0,0 +1,114 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_merge.cpp
+
+Abstract:
+
+    Micro-benchmark for the congruence closure core (enode merge and
+    congruence table lookups) of the SMT kernel. It also checks that the
+    equivalence classes are the ones induced by the merged equalities.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_context.h"
+#include"reg_decl_plugins.h"
+#include"statistics.h"
+#include"stopwatch.h"
+
+/**
+   \brief Check that the terms ts[i] are in the same equivalence class as ts[j] iff
+   cls[i] == cls[j].
+*/
+static void check_classes(smt::context & ctx, expr_ref_vector const & ts, unsigned_vector const & cls) {
+    u_map<unsigned> root2cls;
+    for (unsigned i = 0; i < ts.size(); i++) {
+        unsigned r = ctx.get_enode(ts.get(i))->get_root()->get_owner_id();
+        unsigned c;
+        if (!root2cls.find(r, c)) {
+            c = cls[i];
+            root2cls.insert(r, c);
+        }
+        VERIFY(c == cls[i]);
+    }
+    VERIFY(root2cls.size() == cls.back() + 1);
+}
+
+/**
+   \brief Create n constants a_i, the terms f(a_i), f(f(a_i)) and g(a_i, a_{i+1}), and
+   the equivalences s_i <=> a_i = a_{i+1}. Then, in each round, check satisfiability 
+   assuming most of the s_i, and the negation of the others. Every check merges long 
+   equivalence classes, and the congruence table is used to detect the induced equalities 
+   f(a_i) = f(a_{i+1}), and g(a_i, a_{i+1}) = g(a_{i+1}, a_{i+2}) through f(f(a_i)). 
+   Only the time spent in the checks is reported. After every check, the classes of the 
+   a_i, f(a_i) and g(a_i, a_{i+1}) must be exactly the ones induced by the assumptions.
+*/
+static void tst_merge_chain(unsigned n, unsigned num_rounds) {
+    smt_params params;
+    // model construction and relevancy propagation are not part of the benchmark.
+    params.m_model         = false;
+    params.m_relevancy_lvl = 0;
+    ast_manager m;
+    reg_decl_plugins(m);
+    smt::context ctx(m, params);
+
+    sort_ref s(m.mk_uninterpreted_sort(symbol("U")), m);
+    func_decl_ref f(m.mk_func_decl(symbol("f"), s, s), m);
+    func_decl_ref g(m.mk_func_decl(symbol("g"), s, s, s), m);
+    expr_ref_vector as(m), ss(m), fas(m), gas(m);
+    for (unsigned i = 0; i < n; i++) {
+        as.push_back(m.mk_const(symbol(i), s));
+        ss.push_back(m.mk_fresh_const("s", m.mk_bool_sort()));
+    }
+    for (unsigned i = 0; i + 1 < n; i++) {
+        // f(f(a_i)) = g(a_i, a_{i+1}) makes sure all terms are internalized.
+        expr_ref fa(m.mk_app(f, as.get(i)), m);
+        expr_ref ffa(m.mk_app(f, fa.get()), m);
+        expr_ref ga(m.mk_app(g, as.get(i), as.get(i+1)), m);
+        fas.push_back(fa);
+        gas.push_back(ga);
+        ctx.assert_expr(m.mk_eq(ffa, ga));
+        ctx.assert_expr(m.mk_iff(ss.get(i), m.mk_eq(as.get(i), as.get(i+1))));
+    }
+    VERIFY(ctx.check() == l_true);
+
+    stopwatch sw;
+    expr_ref_vector assumptions(m);
+    unsigned_vector cls;
+    for (unsigned r = 0; r < num_rounds; r++) {
+        assumptions.reset();
+        cls.reset();
+        cls.push_back(0);
+        for (unsigned i = 0; i + 1 < n; i++) {
+            // leave some gaps, so that several classes are merged in each round.
+            bool gap = (i + r) % 7 == 0;
+            assumptions.push_back(gap ? m.mk_not(ss.get(i)) : ss.get(i));
+            cls.push_back(gap ? cls.back() + 1 : cls.back());
+        }
+        sw.start();
+        VERIFY(ctx.check(assumptions.size(), assumptions.c_ptr()) == l_true);
+        sw.stop();
+        check_classes(ctx, as, cls);
+        cls.pop_back(); // f(a_{n-1}) and g(a_{n-1}, a_n) do not exist.
+        check_classes(ctx, fas, cls);
+        check_classes(ctx, gas, cls);
+    }
+
+    statistics st;
+    ctx.collect_statistics(st);
+    std::cout << "n: " << n << ", rounds: " << num_rounds << ", time: " << sw.get_seconds() << " secs\n";
+    st.display(std::cout);
+}
+
+void tst_smt_merge() {
+    tst_merge_chain(1000, 10);
+    tst_merge_chain(3000, 20);
+    tst_merge_chain(10000, 10);
+}
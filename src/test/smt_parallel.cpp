@@ -0,0 +1,104 @@
+/*++
+Copyright (c) 2026 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Test the parallel cube-and-conquer mode of smt::kernel.
+
+Author:
+
+    Z3 developers 2026-10-17
+
+Notes:
+
+--*/
+#include"smt_kernel.h"
+#include"smt_params.h"
+#include"reg_decl_plugins.h"
+#include"arith_decl_plugin.h"
+#include"random_formulas.h"
+
+static unsigned g_num_par_cubes = 0;
+
+static lbool check(ast_manager & m, unsigned num_threads, expr_ref_vector const & fmls, expr_ref_vector const & asms) {
+    smt_params p;
+    p.m_threads                = num_threads;
+    p.m_threads_cube_conflicts = 20;
+    smt::kernel k(m, p);
+    for (unsigned i = 0; i < fmls.size(); i++)
+        k.assert_expr(fmls.get(i));
+    lbool r = k.check(asms.size(), asms.c_ptr());
+    unsigned num_cubes = get_stat(k, "parallel cubes");
+    if (num_threads == 1) {
+        VERIFY(num_cubes == 0);
+    }
+    g_num_par_cubes += num_cubes;
+    if (r == l_true) {
+        model_ref md;
+        k.get_model(md);
+        check_model(*md, fmls);
+        check_model(*md, asms);
+    }
+    if (r == l_false && !asms.empty()) {
+        expr_ref_vector core(m);
+        for (unsigned i = 0; i < k.get_unsat_core_size(); i++)
+            core.push_back(k.get_unsat_core_expr(i));
+        check_core(fmls, asms, core);
+    }
+    return r;
+}
+
+/**
+   \brief Random 3-SAT over propositional variables (arith = false) or
+   difference logic atoms x_i - x_j <= c (arith = true).
+*/
+static void tst_random_3sat(unsigned seed, unsigned num_atoms, bool arith) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    random_gen r(seed);
+    expr_ref_vector atoms(m), fmls(m), asms(m);
+    unsigned num_vars = num_atoms / 4 + 2;
+    expr_ref_vector xs(m);
+    for (unsigned i = 0; i < num_vars; i++)
+        xs.push_back(m.mk_fresh_const("x", a.mk_int()));
+    if (arith) {
+        mk_diff_atoms(r, xs, num_atoms, -5, 5, atoms);
+    }
+    else {
+        for (unsigned i = 0; i < num_atoms; i++)
+            atoms.push_back(m.mk_fresh_const("p", m.mk_bool_sort()));
+    }
+    // close to the phase transition
+    mk_random_3sat(r, atoms, (num_atoms * 426) / 100, fmls);
+    lbool r1 = check(m, 1, fmls, asms);
+    lbool r4 = check(m, 4, fmls, asms);
+    std::cout << "seed: " << seed << " arith: " << arith << " result: " << r1 << "\n";
+    VERIFY(r1 == r4);
+    // guard some clauses with assumptions
+    for (unsigned i = 0; i < 5; i++) {
+        expr * s = m.mk_fresh_const("s", m.mk_bool_sort());
+        asms.push_back(s);
+        for (unsigned j = 0; j < 6; j++) {
+            expr * l = atoms.get(r(num_atoms));
+            fmls.push_back(m.mk_implies(s, r(2) == 0 ? m.mk_not(l) : l));
+        }
+    }
+    r1 = check(m, 1, fmls, asms);
+    r4 = check(m, 4, fmls, asms);
+    VERIFY(r1 == r4);
+}
+
+void tst_smt_parallel() {
+    for (unsigned seed = 0; seed < 8; seed++) {
+        tst_random_3sat(seed, 120, false);
+        tst_random_3sat(seed, 80, true);
+    }
+    std::cout << "parallel cubes: " << g_num_par_cubes << "\n";
+    // the cube-and-conquer mode must have been used by some of the 4 thread checks.
+    VERIFY(g_num_par_cubes > 0);
+}
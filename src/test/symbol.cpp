@@ -19,6 +19,8 @@ Revision History:
 #include<iostream>
 #include"symbol.h"
 #include"debug.h"
+#include"vector.h"
+#include"string_buffer.h"
 
 static void tst1() {
     symbol s1("foo");
@@ -51,8 +53,31 @@ static void tst1() {
     SASSERT(lt(symbol("zzz"), symbol("zzzb")));
 }
 
+// intern the same strings concurrently, all threads must obtain the same symbols.
+static void tst2() {
+    unsigned const num_threads = 4;
+    unsigned const num_syms    = 5000;
+    vector<svector<symbol> > syms;
+    syms.resize(num_threads);
+    #pragma omp parallel for
+    for (int t = 0; t < static_cast<int>(num_threads); t++) {
+        for (unsigned i = 0; i < num_syms; i++) {
+            string_buffer<64> buffer;
+            buffer << "tst2!" << ((i + t * 37) % num_syms);
+            syms[t].push_back(symbol(buffer.c_str()));
+        }
+    }
+    for (unsigned t = 1; t < num_threads; t++) {
+        for (unsigned i = 0; i < num_syms; i++) {
+            VERIFY(syms[t][i] == syms[0][(i + t * 37) % num_syms]);
+        }
+    }
+    VERIFY(syms[0][0] == symbol("tst2!0"));
+}
+
 void tst_symbol() {
     tst1();
+    tst2();
 }
 
 
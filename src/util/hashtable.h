@@ -394,11 +394,18 @@ public:
        Store the entry/slot of the table in et.
     */
     bool insert_if_not_there_core(data const & e, entry * & et) {
+        return insert_if_not_there_core(e, get_hash(e), et);
+    }
+
+    /**
+       \brief Similar to the previous method, but the hash-code of e was already computed by the caller.
+    */
+    bool insert_if_not_there_core(data const & e, unsigned hash, entry * & et) {
+        SASSERT(hash == get_hash(e));
         if ((m_size + m_num_deleted) << 2 > (m_capacity * 3)) {
             // if ((m_size + m_num_deleted) * 2 > (m_capacity)) {
             expand_table();
         }
-        unsigned hash     = get_hash(e);
         unsigned mask     = m_capacity - 1;
         unsigned idx      = hash & mask;
         entry * begin     = m_table + idx;
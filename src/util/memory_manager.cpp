@@ -130,10 +130,13 @@ void memory::set_max_size(size_t max_size) {
 
 static bool g_finalizing = false;
 
+static void release_thread_cache();
+
 void memory::finalize() {
     if (g_memory_initialized) {
         g_finalizing = true;
         mem_finalize();
+        release_thread_cache();
         g_memory_initialized = false;
         g_finalizing = false;
     }
@@ -224,6 +227,130 @@ static void synchronize_counters(bool allocating) {
     }
 }
 
+#ifndef _WINDOWS
+// Small blocks are recycled using thread local free lists, one for each block size.
+// This avoids the cost of malloc/free (and the contention inside malloc) for the small objects
+// that are created and deleted all the time. A block may be released by a thread different
+// from the one that allocated it, it is then cached by the releasing thread.
+// The cache of a thread is released when the thread terminates.
+// The free lists are not used on Windows, since there is no portable way to release them
+// when a thread terminates.
+#include<pthread.h>
+
+// blocks with at most SMALL_BLOCK_SIZE bytes (including the extra field) are cached.
+#define SMALL_BLOCK_SIZE  256
+#define NUM_SIZE_CLASSES  (SMALL_BLOCK_SIZE/8 + 1)
+// maximum number of bytes in the free lists of a thread.
+#define MAX_CACHED_BYTES  (1 << 20)
+
+struct thread_cache {
+    void * m_free[NUM_SIZE_CLASSES]; // the first word of a free block points to the next block
+    size_t m_size;                   // number of bytes in the free lists
+};
+
+__thread thread_cache * g_thread_cache = 0;
+static pthread_key_t    g_thread_cache_key;
+static pthread_once_t   g_thread_cache_key_once = PTHREAD_ONCE_INIT;
+
+static void release_blocks(thread_cache * c) {
+    for (unsigned i = 0; i < NUM_SIZE_CLASSES; i++) {
+        void * b = c->m_free[i];
+        while (b != 0) {
+            void * next = *static_cast<void**>(b);
+            free(b);
+            b = next;
+        }
+        c->m_free[i] = 0;
+    }
+    c->m_size = 0;
+}
+
+// invoked by pthreads when a thread that has a cache terminates.
+static void del_thread_cache(void * p) {
+    thread_cache * c = static_cast<thread_cache*>(p);
+    release_blocks(c);
+    free(c);
+    g_thread_cache = 0;
+    if (g_memory_thread_alloc_size != 0)
+        synchronize_counters(false);
+}
+
+static void mk_thread_cache_key() {
+    pthread_key_create(&g_thread_cache_key, del_thread_cache);
+}
+
+static thread_cache * get_thread_cache() {
+    thread_cache * c = g_thread_cache;
+    if (c == 0) {
+        c = static_cast<thread_cache*>(calloc(1, sizeof(thread_cache)));
+        if (c == 0)
+            throw_out_of_memory();
+        pthread_once(&g_thread_cache_key_once, mk_thread_cache_key);
+        pthread_setspecific(g_thread_cache_key, c);
+        g_thread_cache = c;
+    }
+    return c;
+}
+
+static void release_thread_cache() {
+    if (g_thread_cache != 0)
+        release_blocks(g_thread_cache);
+}
+
+void memory::deallocate(void * p) {
+    size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
+    size_t sz      = *sz_p;
+    void * real_p  = reinterpret_cast<void*>(sz_p);
+    g_memory_thread_alloc_size -= sz;
+    thread_cache * c = g_thread_cache;
+    if (sz <= SMALL_BLOCK_SIZE && c != 0 && c->m_size + sz <= MAX_CACHED_BYTES) {
+        *static_cast<void**>(real_p) = c->m_free[sz >> 3];
+        c->m_free[sz >> 3] = real_p;
+        c->m_size += sz;
+    }
+    else {
+        free(real_p);
+    }
+    if (g_memory_thread_alloc_size < -SYNCH_THRESHOLD) {
+        synchronize_counters(false);
+    }
+}
+
+void * memory::allocate(size_t s) {
+    if (s == 0) 
+        return 0;
+    s = s + sizeof(size_t); // we allocate an extra field!
+    void * r;
+    if (s <= SMALL_BLOCK_SIZE) {
+        s = (s + 7) & ~static_cast<size_t>(7); // size of the free list containing the block
+        thread_cache * c = get_thread_cache();
+        r = c->m_free[s >> 3];
+        if (r != 0) {
+            c->m_free[s >> 3] = *static_cast<void**>(r);
+            c->m_size -= s;
+        }
+        else {
+            r = malloc(s);
+        }
+    }
+    else {
+        r = malloc(s);
+    }
+    if (r == 0) 
+        throw_out_of_memory();
+    *(static_cast<size_t*>(r)) = s;
+    g_memory_thread_alloc_size += s;
+    if (g_memory_thread_alloc_size > SYNCH_THRESHOLD) {
+        synchronize_counters(true);
+    }
+    return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
+}
+
+#else
+
+static void release_thread_cache() {
+}
+
 void memory::deallocate(void * p) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
     size_t sz      = *sz_p;
@@ -250,6 +377,8 @@ void * memory::allocate(size_t s) {
     return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
 }
 
+#endif
+
 #else
 // ==================================
 // ==================================
@@ -258,6 +387,9 @@ void * memory::allocate(size_t s) {
 // ==================================
 // allocate & deallocate without using thread local storage
 
+static void release_thread_cache() {
+}
+
 void memory::deallocate(void * p) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
     size_t sz      = *sz_p;
@@ -176,6 +176,58 @@ public:
 
     static bool is_small(mpq const & a) { return is_small(a.m_num) && is_small(a.m_den); }
 
+    /**
+       \brief Fast paths for numerals that are integers fitting in a machine word.
+       They do not use the state of the manager, and return false (leaving \c c unchanged)
+       when an argument is not a small integer or the result does not fit in a machine word.
+       \c c must not be a big number.
+    */
+    static bool is_small_int(mpq const & a) { return is_small(a.m_num) && is_small(a.m_den) && a.m_den.m_val == 1; }
+
+    static bool small_int_add(mpq const & a, mpq const & b, mpq & c) { 
+        return is_small_int(a) && is_small_int(b) && set_small_int(c, static_cast<int64>(a.m_num.m_val) + static_cast<int64>(b.m_num.m_val));
+    }
+
+    static bool small_int_sub(mpq const & a, mpq const & b, mpq & c) { 
+        return is_small_int(a) && is_small_int(b) && set_small_int(c, static_cast<int64>(a.m_num.m_val) - static_cast<int64>(b.m_num.m_val));
+    }
+
+    static bool small_int_mul(mpq const & a, mpq const & b, mpq & c) { 
+        return is_small_int(a) && is_small_int(b) && set_small_int(c, static_cast<int64>(a.m_num.m_val) * static_cast<int64>(b.m_num.m_val));
+    }
+
+    static bool set_small_int(mpq & c, int64 v) {
+        SASSERT(is_small(c));
+        if (v < INT_MIN || v > INT_MAX)
+            return false;
+        c.m_num.m_val = static_cast<int>(v);
+        c.m_den.m_val = 1;
+        return true;
+    }
+
+    /**
+       \brief Copy a small numeral \c b into \c a. Both must be small.
+    */
+    static void small_set(mpq & a, mpq const & b) {
+        SASSERT(is_small(a) && is_small(b));
+        a.m_num.m_val = b.m_num.m_val;
+        a.m_den.m_val = b.m_den.m_val;
+    }
+
+    /**
+       \brief Compare small numerals (the denominators are positive).
+    */
+    static bool small_eq(mpq const & a, mpq const & b) {
+        SASSERT(is_small(a) && is_small(b));
+        return a.m_num.m_val == b.m_num.m_val && a.m_den.m_val == b.m_den.m_val;
+    }
+
+    static bool small_lt(mpq const & a, mpq const & b) {
+        SASSERT(is_small(a) && is_small(b));
+        return static_cast<int64>(a.m_num.m_val) * static_cast<int64>(b.m_den.m_val) < 
+            static_cast<int64>(b.m_num.m_val) * static_cast<int64>(a.m_den.m_val);
+    }
+
     static mpq mk_q(int v) { return mpq(v); }
 
     mpq mk_q(int n, int d) { mpq r; set(r, n, d); return r; }
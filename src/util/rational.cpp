@@ -23,7 +23,82 @@ Revision History:
 #include<strsafe.h>
 #endif
 
+#ifdef _RATIONAL_THREAD_LOCAL_MANAGER
+#include<pthread.h>
+
+__thread unsynch_mpq_manager * rational::g_mpq_manager = 0;
+
+/**
+   \brief Manager used by a thread for its numerals.
+
+   A numeral may be deleted or updated by a thread different from the one that created it,
+   and the cells of big numerals belong to the allocator of the manager that created them.
+   So, the managers are only deleted by rational::finalize. When a thread terminates, 
+   its manager is returned to a pool, and it is reused by the next thread that needs one.
+   Thus, the number of managers is bounded by the number of threads running at the same time.
+*/
+struct thread_mpq_manager {
+    unsynch_mpq_manager *  m_manager; // 0 after rational::finalize
+    unsynch_mpq_manager ** m_slot;    // thread local pointer of the owner, 0 if the owner terminated.
+};
+
+static ptr_vector<thread_mpq_manager> g_thread_managers; // all entries
+static ptr_vector<thread_mpq_manager> g_free_managers;   // entries whose owner terminated
+static pthread_key_t                  g_thread_manager_key;
+static pthread_once_t                 g_thread_manager_key_once = PTHREAD_ONCE_INIT;
+
+static void thread_manager_exit(void * p) {
+    thread_mpq_manager * e = static_cast<thread_mpq_manager*>(p);
+    bool del_entry;
+    #pragma omp critical (rational_managers)
+    {
+        // the manager is not used by this thread anymore, even by the destructors of other thread local objects.
+        if (e->m_slot != 0)
+            *(e->m_slot) = 0;
+        e->m_slot = 0;
+        // the entry is not in g_thread_managers after rational::finalize
+        del_entry = e->m_manager == 0;
+        if (!del_entry)
+            g_free_managers.push_back(e);
+    }
+    if (del_entry)
+        dealloc(e);
+}
+
+static void mk_thread_manager_key() {
+    pthread_key_create(&g_thread_manager_key, thread_manager_exit);
+}
+
+unsynch_mpq_manager & rational::mk_thread_manager() {
+    pthread_once(&g_thread_manager_key_once, mk_thread_manager_key);
+    // the entry of this thread survives rational::finalize, and it is not used anymore.
+    thread_mpq_manager * old_e = static_cast<thread_mpq_manager*>(pthread_getspecific(g_thread_manager_key));
+    if (old_e != 0) {
+        SASSERT(old_e->m_manager == 0);
+        dealloc(old_e);
+    }
+    thread_mpq_manager * e = 0;
+    #pragma omp critical (rational_managers)
+    {
+        if (!g_free_managers.empty()) {
+            e = g_free_managers.back();
+            g_free_managers.pop_back();
+        }
+        else {
+            e = alloc(thread_mpq_manager);
+            e->m_manager = alloc(unsynch_mpq_manager);
+            g_thread_managers.push_back(e);
+        }
+        e->m_slot = &g_mpq_manager;
+    }
+    pthread_setspecific(g_thread_manager_key, e);
+    g_mpq_manager = e->m_manager;
+    return *(e->m_manager);
+}
+#else
 synch_mpq_manager *  rational::g_mpq_manager = 0;
+#endif
+
 rational             rational::m_zero(0);
 rational             rational::m_one(1);
 rational             rational::m_minus_one(-1);
@@ -54,14 +129,33 @@ rational rational::power_of_two(unsigned k) {
 }
 
 void rational::initialize() {
+#ifndef _RATIONAL_THREAD_LOCAL_MANAGER
     if (!g_mpq_manager) {
         g_mpq_manager = alloc(synch_mpq_manager);
     }
+#endif
 }
 
 void rational::finalize() {
     m_powers_of_two.finalize();
+#ifdef _RATIONAL_THREAD_LOCAL_MANAGER
+    #pragma omp critical (rational_managers)
+    {
+        for (unsigned i = 0; i < g_thread_managers.size(); i++) {
+            thread_mpq_manager * e = g_thread_managers[i];
+            dealloc(e->m_manager);
+            e->m_manager = 0;
+            if (e->m_slot != 0)
+                *(e->m_slot) = 0; // the owner is still running, it will create a new manager if needed.
+            else
+                dealloc(e);
+        }
+        g_thread_managers.finalize();
+        g_free_managers.finalize();
+    }
+#else
     dealloc(g_mpq_manager);
     g_mpq_manager = 0;
+#endif
 }
 
@@ -21,15 +21,27 @@ Revision History:
 
 #include"mpq.h"
 
+#ifdef _USE_THREAD_LOCAL
+// Each thread creates and updates numerals using its own unsynchronized manager.
+#define _RATIONAL_THREAD_LOCAL_MANAGER
+#endif
+
 class rational {
     mpq   m_val;
     static rational                  m_zero;
     static rational                  m_one;
     static rational                  m_minus_one;
     static vector<rational>          m_powers_of_two;
-    static synch_mpq_manager *       g_mpq_manager;
-    
-    static synch_mpq_manager & m() { return *g_mpq_manager; }
+#ifdef _RATIONAL_THREAD_LOCAL_MANAGER
+    typedef unsynch_mpq_manager      manager;
+    static __thread manager *        g_mpq_manager;
+    static manager & mk_thread_manager();
+    static manager & m() { manager * r = g_mpq_manager; return r != 0 ? *r : mk_thread_manager(); }
+#else
+    typedef synch_mpq_manager        manager;
+    static manager *                 g_mpq_manager;
+    static manager & m() { return *g_mpq_manager; }
+#endif
 
 public:
     static void initialize();
@@ -40,9 +52,14 @@ public:
     */
     rational() {}
     
-    rational(rational const & r) { m().set(m_val, r.m_val); }
+    rational(rational const & r) { 
+        if (manager::is_small(r.m_val))
+            manager::small_set(m_val, r.m_val);
+        else
+            m().set(m_val, r.m_val); 
+    }
 
-    explicit rational(int n) { m().set(m_val, n); }
+    explicit rational(int n):m_val(n) {}
 
     explicit rational(unsigned n) { m().set(m_val, n); }
       
@@ -60,7 +77,10 @@ public:
     struct ui64 {};
     rational(uint64 i, ui64) { m().set(m_val, i); }
     
-    ~rational() { m().del(m_val); }
+    ~rational() { 
+        if (!manager::is_small(m_val))
+            m().del(m_val); 
+    }
     
     mpq const & to_mpq() const { return m_val; }
 
@@ -68,13 +88,13 @@ public:
     
     void reset() { m().reset(m_val); }
 
-    bool is_int() const { return m().is_int(m_val); }
+    bool is_int() const { return manager::is_int(m_val); }
 
-    bool is_small() const { return m().is_small(m_val); }
+    bool is_small() const { return manager::is_small(m_val); }
 
     bool is_big() const { return !is_small(); }
     
-    unsigned hash() const { return m().hash(m_val); }
+    unsigned hash() const { return manager::hash(m_val); }
 
     struct hash_proc {  unsigned operator()(rational const& r) const { return r.hash(); }  };
 
@@ -118,7 +138,10 @@ public:
     rational const & get_infinitesimal() const { return m_zero; }
     
     rational & operator=(rational const & r) {
-        m().set(m_val, r.m_val);
+        if (manager::is_small(m_val) && manager::is_small(r.m_val))
+            manager::small_set(m_val, r.m_val);
+        else
+            m().set(m_val, r.m_val);
         return *this;
     }
 
@@ -127,17 +150,20 @@ public:
     friend inline rational denominator(rational const & r) { rational result; m().get_denominator(r.m_val, result.m_val); return result; }
     
     rational & operator+=(rational const & r) { 
-        m().add(m_val, r.m_val, m_val);
+        if (!manager::small_int_add(m_val, r.m_val, m_val))
+            m().add(m_val, r.m_val, m_val);
         return *this; 
     }
 
     rational & operator-=(rational const & r) { 
-        m().sub(m_val, r.m_val, m_val);
+        if (!manager::small_int_sub(m_val, r.m_val, m_val))
+            m().sub(m_val, r.m_val, m_val);
         return *this; 
     }
 
     rational & operator*=(rational const & r) {
-        m().mul(m_val, r.m_val, m_val);
+        if (!manager::small_int_mul(m_val, r.m_val, m_val))
+            m().mul(m_val, r.m_val, m_val);
         return *this; 
     }    
 
@@ -210,10 +236,14 @@ public:
     const rational operator--(int) { rational tmp(*this); --(*this); return tmp; }
 
     friend inline bool operator==(rational const & r1, rational const & r2) {
+        if (manager::is_small(r1.m_val) && manager::is_small(r2.m_val))
+            return manager::small_eq(r1.m_val, r2.m_val);
         return rational::m().eq(r1.m_val, r2.m_val);
     }
 
     friend inline bool operator<(rational const & r1, rational const & r2) { 
+        if (manager::is_small(r1.m_val) && manager::is_small(r2.m_val))
+            return manager::small_lt(r1.m_val, r2.m_val);
         return rational::m().lt(r1.m_val, r2.m_val);
     }
     
@@ -222,31 +252,31 @@ public:
     }
 
     bool is_zero() const {
-        return m().is_zero(m_val);
+        return manager::is_zero(m_val);
     }
 
     bool is_one() const {
-        return m().is_one(m_val);
+        return manager::is_one(m_val);
     }
 
     bool is_minus_one() const {
-        return m().is_minus_one(m_val);
+        return manager::is_minus_one(m_val);
     }
 
     bool is_neg() const {
-        return m().is_neg(m_val);
+        return manager::is_neg(m_val);
     }
     
     bool is_pos() const {
-        return m().is_pos(m_val);
+        return manager::is_pos(m_val);
     }
     
     bool is_nonneg() const {
-        return m().is_nonneg(m_val);
+        return manager::is_nonneg(m_val);
     }
     
     bool is_nonpos() const {
-        return m().is_nonpos(m_val);
+        return manager::is_nonpos(m_val);
     }
 
     bool is_even() const {
@@ -27,23 +27,45 @@ const symbol symbol::null;
 
 /**
    \brief Symbol table manager. It stores the symbol strings created at runtime.
+
+   The table is split in shards selected by the hash-code of the string. 
+   Each shard has its own lock, so threads interning different strings 
+   (e.g., parsers running in separate contexts) rarely wait for each other.
 */
 class internal_symbol_table {
-    region        m_region; //!< Region used to store symbol strings.
-    str_hashtable m_table;  //!< Table of created symbol strings.
+    struct shard {
+        omp_lock_t    m_lock;
+        region        m_region; //!< Region used to store symbol strings.
+        str_hashtable m_table;  //!< Table of created symbol strings.
+        shard() { omp_init_lock(&m_lock); }
+        ~shard() { omp_destroy_lock(&m_lock); }
+    };
+
+    struct scoped_lock {
+        omp_lock_t & m_lock;
+        scoped_lock(omp_lock_t & l):m_lock(l) { omp_set_lock(&m_lock); }
+        ~scoped_lock() { omp_unset_lock(&m_lock); }
+    };
+
+    static const unsigned LOG_NUM_SHARDS = 5;
+    static const unsigned NUM_SHARDS     = 1 << LOG_NUM_SHARDS;
+    shard m_shards[NUM_SHARDS];
+
 public:
 
     char const * get_str(char const * d) {
         char * result;
-        #pragma omp critical (cr_symbol) 
-        {
+        // str_hashtable uses the low bits of the hash-code, the shard is selected using the high bits.
+        unsigned h = str_hash_proc()(d);
+        shard & s  = m_shards[h >> (32 - LOG_NUM_SHARDS)];
+        scoped_lock lock(s.m_lock);
         char * r_d = const_cast<char *>(d);
         str_hashtable::entry * e;
-        if (m_table.insert_if_not_there_core(r_d, e)) {
+        if (s.m_table.insert_if_not_there_core(r_d, h, e)) {
             // new entry
             size_t l   = strlen(d);
             // store the hash-code before the string
-            size_t * mem = static_cast<size_t*>(m_region.allocate(l + 1 + sizeof(size_t)));
+            size_t * mem = static_cast<size_t*>(s.m_region.allocate(l + 1 + sizeof(size_t)));
             *mem = e->get_hash();
             mem++;
             result = reinterpret_cast<char*>(mem);
@@ -54,8 +76,7 @@ public:
         else {
             result = e->get_data();
         }
-        SASSERT(m_table.contains(result));
-        }
+        SASSERT(s.m_table.contains(result));
         return result;
     }
 };
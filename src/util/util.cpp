@@ -156,6 +156,9 @@ void escaped::display(std::ostream & out) const {
 #undef ARRAYSIZE
 #endif
 #include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
 #endif
 
 void z3_bound_num_procs() {
@@ -172,3 +175,18 @@ void z3_bound_num_procs() {
     // or hidden throttles.
 #endif
 }
+
+void z3_sleep(unsigned ms) {
+#ifdef _WINDOWS
+    Sleep(ms);
+#else
+    if (ms == 0) {
+        sched_yield();
+        return;
+    }
+    struct timespec t;
+    t.tv_sec  = ms / 1000;
+    t.tv_nsec = (ms % 1000) * 1000000;
+    nanosleep(&t, 0);
+#endif
+}
@@ -406,5 +406,11 @@ inline size_t megabytes_to_bytes(unsigned mb) {
 
 void z3_bound_num_procs();
 
+/**
+   \brief Suspend the current thread for \c ms milliseconds.
+   When \c ms is 0, the thread only yields the processor.
+*/
+void z3_sleep(unsigned ms);
+
 #endif /* _UTIL_H_ */
 
@@ -26,13 +26,20 @@ Notes:
 #define omp_set_num_threads(SZ) ((void)0)
 #define omp_get_thread_num() 0
 #define omp_get_num_procs()  1
+#define omp_get_max_threads() 1
 #define omp_set_nested(V) ((void)0)
 #define omp_init_nest_lock(L) ((void) 0)
 #define omp_destroy_nest_lock(L) ((void) 0)
 #define omp_set_nest_lock(L) ((void) 0)
 #define omp_unset_nest_lock(L) ((void) 0)
+#define omp_init_lock(L) ((void) 0)
+#define omp_destroy_lock(L) ((void) 0)
+#define omp_set_lock(L) ((void) 0)
+#define omp_unset_lock(L) ((void) 0)
 struct omp_nest_lock_t {
 };
+struct omp_lock_t {
+};
 #endif
 
 #endif